@@ -51,6 +51,15 @@ void CoreArgParser::parse()
   if (m_parser.isSet(CoreArgs::configOption)) {
     Settings::setSettingsFile(m_parser.value(CoreArgs::configOption));
   }
+
+  if (m_parser.isSet(CoreArgs::statsIntervalOption)) {
+    bool ok = false;
+    m_statsInterval = m_parser.value(CoreArgs::statsIntervalOption).toInt(&ok);
+    if (!ok || m_statsInterval < 0) {
+      QTextStream(stdout) << "invalid stats interval, statistics will not be logged\n";
+      m_statsInterval = 0;
+    }
+  }
 }
 
 [[noreturn]] void CoreArgParser::showHelpText() const
@@ -102,3 +111,8 @@ bool CoreArgParser::singleInstanceOnly() const
 {
   return m_singleInstance;
 }
+
+int CoreArgParser::statsInterval() const
+{
+  return m_statsInterval;
+}
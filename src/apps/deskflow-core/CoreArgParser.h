@@ -34,6 +34,11 @@ public:
   bool serverMode() const;
   bool clientMode() const;
   bool singleInstanceOnly() const;
+  /**
+   * @brief statsInterval
+   * @return seconds between event queue statistics log dumps, 0 when not requested
+   */
+  int statsInterval() const;
 
 private:
   [[noreturn]] void showHelpText() const;
@@ -42,5 +47,6 @@ private:
   bool m_clientMode = false;
   bool m_serverMode = false;
   bool m_singleInstance = true;
+  int m_statsInterval = 0;
   static const QString s_headerText;
 };
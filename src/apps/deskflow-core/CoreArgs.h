@@ -20,5 +20,11 @@ struct CoreArgs
   inline static const auto configOption =
       QCommandLineOption({"s", "settings"}, "override configuration file to use", "configFile");
 
-  inline static const auto options = {helpOption, versionOption, multiInstanceOption, configOption};
+  inline static const auto statsIntervalOption = QCommandLineOption(
+      "stats-interval", "Collect event queue and connection statistics and log them every <seconds>", "seconds"
+  );
+
+  inline static const auto options = {
+      helpOption, versionOption, multiInstanceOption, configOption, statsIntervalOption
+  };
 };
@@ -13,9 +13,11 @@
 #include "base/Log.h"
 #include "common/Constants.h"
 #include "common/ExitCodes.h"
+#include "common/Settings.h"
 #include "deskflow/ClientApp.h"
 #include "deskflow/ServerApp.h"
 #include "deskflow/ipc/CoreIpcServer.h"
+#include "io/ConnectionStats.h"
 
 #if defined(Q_OS_WIN)
 #include "arch/win32/ArchMiscWindows.h"
@@ -26,6 +28,7 @@
 #include <QSharedMemory>
 #include <QTextStream>
 #include <QThread>
+#include <QTimer>
 
 void qtMessageHandler(QtMsgType type, const QMessageLogContext &context, const QString &message)
 {
@@ -52,6 +55,22 @@ void qtMessageHandler(QtMsgType type, const QMessageLogContext &context, const Q
   }
 }
 
+void logEventQueueStats(const EventQueueStats &stats)
+{
+  const auto lines = stats.report();
+  LOG_INFO("event queue stats: max depth %zu, %zu event type(s)", stats.maxDepth(), lines.size());
+  for (const auto &line : lines) {
+    LOG_INFO("event queue stats: %s", line.c_str());
+  }
+}
+
+void logConnectionStats()
+{
+  for (const auto &line : ConnectionStats::reportAll()) {
+    LOG_INFO("connection stats: %s", line.c_str());
+  }
+}
+
 void showHelp(const CoreArgParser &parser)
 {
   QTextStream(stdout) << parser.helpText();
@@ -116,12 +135,29 @@ int main(int argc, char **argv)
 
   parser.parse();
 
-  EventQueue events;
+  const auto defaultBuffer = Settings::value(Settings::Core::LockFreeEventQueue).toBool()
+                                 ? EventQueue::DefaultBuffer::LockFree
+                                 : EventQueue::DefaultBuffer::Simple;
+  EventQueue events(defaultBuffer);
+  if (const auto bulkBudget = Settings::value(Settings::Core::BulkEventBudget).toInt(); bulkBudget > 0) {
+    events.setBulkBudget(std::chrono::milliseconds(bulkBudget));
+  }
   const auto processName = QFileInfo(argv[0]).fileName();
 
   App *coreApp = createApp(parser, events, processName);
 
+  if (const auto statsInterval = parser.statsInterval(); statsInterval > 0) {
+    events.stats().setEnabled(true);
+    const auto statsTimer = new QTimer(&app); // NOSONAR - Qt managed
+    QObject::connect(statsTimer, &QTimer::timeout, &app, [&events] {
+      logEventQueueStats(events.stats());
+      logConnectionStats();
+    });
+    statsTimer->start(statsInterval * 1000);
+  }
+
   const auto ipcServer = new deskflow::core::ipc::CoreIpcServer(&app); // NOSONAR - Qt managed
+  ipcServer->setEventQueueStats(&events.stats());
   QObject::connect(
       ipcServer, &deskflow::core::ipc::IpcServer::stopProcessRequested, coreApp, &App::quit, Qt::DirectConnection
   );
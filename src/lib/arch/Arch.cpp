@@ -8,6 +8,8 @@
 
 #include "arch/Arch.h"
 
+#include "arch/MonotonicClock.h"
+
 #include <thread>
 
 #if defined(Q_OS_WIN)
@@ -51,7 +53,5 @@ void Arch::sleep(double timeout)
 
 double Arch::time()
 {
-  auto sinceEpoch = std::chrono::steady_clock::now().time_since_epoch();
-  auto uSecSinceEpoch = std::chrono::duration_cast<std::chrono::microseconds>(sinceEpoch).count();
-  return double(uSecSinceEpoch / 1000000);
+  return MonotonicClock::toSeconds(MonotonicClock::now().time_since_epoch());
 }
@@ -91,7 +91,7 @@ public:
   /**
    * @brief time
    * @return Returns the number of seconds since some arbitrary starting time.
-   * This should return as high a precision as reasonable.
+   * This is \c MonotonicClock in seconds, use the clock directly for integer ticks.
    */
   static double time();
 
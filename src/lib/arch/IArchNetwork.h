@@ -9,6 +9,7 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -44,6 +45,22 @@ An opaque type representing a network address.
 */
 using ArchNetAddress = ArchNetAddressImpl *;
 
+/*!
+\class ArchPollSetImpl
+\brief Internal poll set data.
+An architecture dependent type holding the necessary data for a
+persistent poll set.
+*/
+class ArchPollSetImpl;
+
+/*!
+\var ArchPollSet
+\brief Opaque poll set type.
+An opaque type representing a set of sockets that stay registered for
+polling between waits.
+*/
+using ArchPollSet = ArchPollSetImpl *;
+
 //! Interface for architecture dependent networking
 /*!
 This interface defines the networking operations required by
@@ -98,6 +115,25 @@ public:
     unsigned short m_revents;
   };
 
+  //! The kernel's view of a TCP connection, from \c getTcpInfo()
+  struct TcpInfo
+  {
+    double m_rtt = 0.0;         //!< Smoothed round trip time in seconds
+    double m_rttVariance = 0.0; //!< Round trip time variation in seconds
+    uint32_t m_retransmits = 0; //!< Segments retransmitted over the connection's life
+  };
+
+  //! A ready socket reported by \c waitPollSet()
+  class PollSetEvent
+  {
+  public:
+    //! The cookie the socket was registered with
+    uint64_t m_cookie;
+
+    //! The result events, as for \c PollEntry::m_revents
+    unsigned short m_revents;
+  };
+
   //! @name manipulators
   //@{
 
@@ -189,10 +225,69 @@ public:
   /*!
   Cause a thread that's in a pollSocket() call to return.  This
   call may return before the thread is unblocked.  If the thread is
-  not in a pollSocket() call this call has no effect.
+  not in a pollSocket() call its next call returns immediately.
   */
   virtual void unblockPollSocket(ArchThread thread) = 0;
 
+  //! Create a persistent poll set
+  /*!
+  Returns a new poll set, or nullptr if the architecture has no
+  persistent polling mechanism, in which case callers should use
+  \c pollSocket() instead.  Unlike \c pollSocket(), a poll set keeps its
+  sockets registered between waits so the cost of a wait depends on the
+  number of ready sockets rather than the number of registered ones.
+  */
+  virtual ArchPollSet newPollSet()
+  {
+    return nullptr;
+  }
+
+  //! Destroy a poll set
+  /*!
+  Destroys \c set.  Registered sockets are not closed.
+  */
+  virtual void closePollSet(ArchPollSet)
+  {
+  }
+
+  //! Register a socket with a poll set
+  /*!
+  Adds socket \c s to \c set, or changes its registration if it was
+  already added, so that \c waitPollSet() reports it with \c cookie when
+  any of \c events (a combination of PollEventMask::In and
+  PollEventMask::Out) occur.  Errors are always reported.  \c cookie
+  may be any value except all ones, which is reserved.  The socket must be removed with
+  \c removePollSetSocket() before it is closed.
+  */
+  virtual void setPollSetSocket(ArchPollSet, ArchSocket, unsigned short, uint64_t)
+  {
+  }
+
+  //! Unregister a socket from a poll set
+  /*!
+  Removes socket \c s from \c set.  Does nothing if \c s isn't in it.
+  */
+  virtual void removePollSetSocket(ArchPollSet, ArchSocket)
+  {
+  }
+
+  //! Wait on a poll set
+  /*!
+  Waits up to \c timeout seconds (or indefinitely if \c timeout < 0)
+  for sockets in \c set to become ready, fills in at most \c max
+  entries of \c events and returns the number filled in.  Sockets
+  stay registered and are reported again on the next wait for as long
+  as they remain ready.  A poll set must always be waited on by the
+  same thread, which \c unblockPollSocket() can wake as it would
+  \c pollSocket().
+
+  (Cancellation point)
+  */
+  virtual int waitPollSet(ArchPollSet, PollSetEvent[], int, double)
+  {
+    return 0;
+  }
+
   //! Read data from socket
   /*!
   Read up to \c len bytes from socket \c s in \c buf and return the
@@ -211,6 +306,44 @@ public:
   */
   virtual size_t writeSocket(ArchSocket s, const void *buf, size_t len) = 0;
 
+  //! Read data from socket into several buffers
+  /*!
+  Like \c readSocket() but fills the \c count buffers in \c buffers in
+  order with one call where the architecture allows.  Returns the total
+  number of bytes read.
+  */
+  virtual size_t readSocketv(ArchSocket s, const std::span<uint8_t> buffers[], size_t count)
+  {
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+      const size_t n = readSocket(s, buffers[i].data(), buffers[i].size());
+      total += n;
+      if (n < buffers[i].size()) {
+        break;
+      }
+    }
+    return total;
+  }
+
+  //! Write data to socket from several buffers
+  /*!
+  Like \c writeSocket() but writes the \c count buffers in \c buffers
+  in order with one call where the architecture allows.  Returns the
+  total number of bytes written.
+  */
+  virtual size_t writeSocketv(ArchSocket s, const std::span<const uint8_t> buffers[], size_t count)
+  {
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+      const size_t n = writeSocket(s, buffers[i].data(), buffers[i].size());
+      total += n;
+      if (n < buffers[i].size()) {
+        break;
+      }
+    }
+    return total;
+  }
+
   //! Reset the writable poll hint for a socket
   /*!
   Tells pollSocket() to wait for a fresh writable notification instead of
@@ -228,6 +361,17 @@ public:
   */
   virtual void throwErrorOnSocket(ArchSocket s) = 0;
 
+  //! Get TCP connection state
+  /*!
+  Fills in \c info from the kernel's state for the connected TCP socket
+  \c s and returns true, or returns false if the platform doesn't
+  report it.
+  */
+  virtual bool getTcpInfo(ArchSocket, TcpInfo &)
+  {
+    return false;
+  }
+
   //! Turn Nagle algorithm on or off on socket
   /*!
   Set socket to send messages immediately (true) or to collect small
@@ -0,0 +1,43 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "arch/MonotonicClock.h"
+
+#include <QtSystemDetection>
+
+#if defined(Q_OS_WIN)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <time.h>
+#endif
+
+//
+// MonotonicClock
+//
+
+MonotonicClock::time_point MonotonicClock::now() noexcept
+{
+#if defined(Q_OS_WIN)
+  static const int64_t frequency = [] {
+    LARGE_INTEGER value;
+    QueryPerformanceFrequency(&value);
+    return value.QuadPart;
+  }();
+
+  LARGE_INTEGER counter;
+  QueryPerformanceCounter(&counter);
+
+  // split the conversion so counter * 1e9 can't overflow
+  const int64_t seconds = counter.QuadPart / frequency;
+  const int64_t remainder = counter.QuadPart % frequency;
+  return time_point(duration(seconds * 1'000'000'000 + remainder * 1'000'000'000 / frequency));
+#else
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return time_point(duration(static_cast<rep>(now.tv_sec) * 1'000'000'000 + now.tv_nsec));
+#endif
+}
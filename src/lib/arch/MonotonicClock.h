@@ -0,0 +1,46 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+//! Monotonic high resolution clock
+/*!
+A \c std::chrono clock counting integer nanoseconds from an arbitrary
+starting point.  Unlike the wall clock it never jumps when the system
+time is stepped, so it is safe for deadlines and latency measurements.
+It is built on \c CLOCK_MONOTONIC on Unix and on the performance
+counter on Windows.
+*/
+struct MonotonicClock
+{
+  using rep = int64_t;
+  using period = std::nano;
+  using duration = std::chrono::duration<rep, period>;
+  using time_point = std::chrono::time_point<MonotonicClock>;
+  static constexpr bool is_steady = true;
+
+  //! Get the current time
+  static time_point now() noexcept;
+
+  //! Convert seconds to ticks
+  /*!
+  For converting the \c double seconds taken by older APIs, rounds to
+  the nearest tick.
+  */
+  static constexpr duration fromSeconds(double seconds)
+  {
+    return duration(static_cast<rep>(seconds * 1.0e+9 + (seconds < 0.0 ? -0.5 : 0.5)));
+  }
+
+  //! Convert ticks to seconds
+  static constexpr double toSeconds(duration ticks)
+  {
+    return static_cast<double>(ticks.count()) / 1.0e+9;
+  }
+};
@@ -9,10 +9,11 @@
 
 #include "arch/Arch.h"
 #include "arch/ArchException.h"
+#include "arch/MonotonicClock.h"
 
+#include <algorithm>
 #include <cerrno>
 #include <signal.h>
-#include <sys/time.h>
 #include <time.h>
 
 #define SIGWAKEUP SIGUSR1
@@ -26,6 +27,123 @@ static void setSignalSet(sigset_t *sigset)
   sigaddset(sigset, SIGUSR2);
 }
 
+//
+// ArchWaiter
+//
+
+//! Blocks one thread until it's woken
+/*!
+A thread waiting on a condition variable blocks on its own waiter, which
+is queued on the condition variable.  Signalling the condition variable
+wakes queued waiters and cancelling a thread wakes its waiter directly,
+so cancellation doesn't depend on the condition variable or the mutex
+the thread waits with.
+*/
+class ArchWaiter
+{
+public:
+  ArchWaiter()
+  {
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+#if !defined(Q_OS_MACOS)
+    // time out against the monotonic clock so waits aren't stretched or
+    // cut short when the wall clock is stepped
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+#endif
+    pthread_cond_init(&m_cond, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(&m_mutex, nullptr);
+  }
+  ArchWaiter(ArchWaiter const &) = delete;
+  ArchWaiter(ArchWaiter &&) = delete;
+
+  ~ArchWaiter()
+  {
+    pthread_cond_destroy(&m_cond);
+    pthread_mutex_destroy(&m_mutex);
+  }
+
+  ArchWaiter &operator=(ArchWaiter const &) = delete;
+  ArchWaiter &operator=(ArchWaiter &&) = delete;
+
+  // forget wakes meant for earlier waits
+  void reset()
+  {
+    pthread_mutex_lock(&m_mutex);
+    m_woken = false;
+    pthread_mutex_unlock(&m_mutex);
+  }
+
+  // wake the thread, or stop its next wait from blocking
+  void wake()
+  {
+    pthread_mutex_lock(&m_mutex);
+    m_woken = true;
+    pthread_cond_signal(&m_cond);
+    pthread_mutex_unlock(&m_mutex);
+  }
+
+  // wake the thread and keep its waits from blocking until takeCancel()
+  void cancel()
+  {
+    pthread_mutex_lock(&m_mutex);
+    m_cancelled = true;
+    pthread_cond_signal(&m_cond);
+    pthread_mutex_unlock(&m_mutex);
+  }
+
+  // check for and clear a cancel
+  bool takeCancel()
+  {
+    pthread_mutex_lock(&m_mutex);
+    const bool cancelled = m_cancelled;
+    m_cancelled = false;
+    pthread_mutex_unlock(&m_mutex);
+    return cancelled;
+  }
+
+  // block until woken or cancelled, or for timeout seconds if it isn't
+  // negative.  returns false on timeout.
+  bool wait(double timeout)
+  {
+    const auto timeoutNs = MonotonicClock::fromSeconds(timeout).count();
+    const auto finalNs = MonotonicClock::now().time_since_epoch().count() + timeoutNs;
+    pthread_mutex_lock(&m_mutex);
+    int status = 0;
+    while (!m_woken && !m_cancelled && status != ETIMEDOUT) {
+      if (timeout < 0.0) {
+        status = pthread_cond_wait(&m_cond, &m_mutex);
+        continue;
+      }
+#if defined(Q_OS_MACOS)
+      // macOS can't change the condition variable clock but does support
+      // a relative timeout, which isn't affected by the wall clock
+      const auto nowNs = MonotonicClock::now().time_since_epoch().count();
+      const auto remainingNs = std::max(MonotonicClock::rep{0}, finalNs - nowNs);
+      const timespec relativeTime = {
+          static_cast<time_t>(remainingNs / 1'000'000'000), static_cast<long>(remainingNs % 1'000'000'000)
+      };
+      status = pthread_cond_timedwait_relative_np(&m_cond, &m_mutex, &relativeTime);
+#else
+      const timespec finalTime = {
+          static_cast<time_t>(finalNs / 1'000'000'000), static_cast<long>(finalNs % 1'000'000'000)
+      };
+      status = pthread_cond_timedwait(&m_cond, &m_mutex, &finalTime);
+#endif
+    }
+    const bool woken = m_woken || m_cancelled;
+    pthread_mutex_unlock(&m_mutex);
+    return woken;
+  }
+
+private:
+  pthread_mutex_t m_mutex;
+  pthread_cond_t m_cond;
+  bool m_woken = false;
+  bool m_cancelled = false;
+};
+
 //
 // ArchThreadImpl
 //
@@ -46,8 +164,20 @@ public:
   bool m_exited = false;
   void *m_result = nullptr;
   void *m_networkData = nullptr;
+  ArchWaiter m_waiter;
 };
 
+namespace {
+
+// the calling thread, if it's on the thread list.  lets condition
+// variable waits find their thread without the thread list lock.
+thread_local ArchThreadImpl *s_currentThread = nullptr;
+
+// waiter for threads not on the thread list, which can't be cancelled
+thread_local ArchWaiter s_foreignWaiter;
+
+} // namespace
+
 //
 // ArchMultithreadPosix
 //
@@ -71,6 +201,7 @@ ArchMultithreadPosix::ArchMultithreadPosix()
   m_mainThread = new ArchThreadImpl;
   m_mainThread->m_thread = pthread_self();
   insert(m_mainThread);
+  s_currentThread = m_mainThread;
 
   // install SIGWAKEUP handler.  this causes SIGWAKEUP to interrupt
   // system calls.  we use that when cancelling a thread to force it
@@ -102,6 +233,9 @@ ArchMultithreadPosix::~ArchMultithreadPosix()
 {
   assert(s_instance != nullptr);
   s_instance = nullptr;
+  if (s_currentThread == m_mainThread) {
+    s_currentThread = nullptr;
+  }
 }
 
 void ArchMultithreadPosix::setNetworkDataForCurrentThread(void *data)
@@ -124,85 +258,72 @@ ArchMultithreadPosix *ArchMultithreadPosix::getInstance()
 
 ArchCond ArchMultithreadPosix::newCondVar()
 {
-  auto *cond = new ArchCondImpl;
-  int status = pthread_cond_init(&cond->m_cond, nullptr);
-  (void)status;
-  assert(status == 0);
-  return cond;
+  return new ArchCondImpl;
 }
 
 void ArchMultithreadPosix::closeCondVar(ArchCond cond)
 {
-  int status = pthread_cond_destroy(&cond->m_cond);
-  (void)status;
-  assert(status == 0);
+  assert(cond->m_waiters.empty());
   delete cond;
 }
 
 void ArchMultithreadPosix::signalCondVar(ArchCond cond)
 {
-  int status = pthread_cond_signal(&cond->m_cond);
-  (void)status;
-  assert(status == 0);
+  // wake while still holding the lock, so a waiter that timed out can't
+  // take the signal and then have the wake land on its next wait
+  std::scoped_lock lock{cond->m_mutex};
+  if (!cond->m_waiters.empty()) {
+    cond->m_waiters.front()->wake();
+    cond->m_waiters.erase(cond->m_waiters.begin());
+  }
 }
 
 void ArchMultithreadPosix::broadcastCondVar(ArchCond cond)
 {
-  int status = pthread_cond_broadcast(&cond->m_cond);
-  (void)status;
-  assert(status == 0);
+  std::scoped_lock lock{cond->m_mutex};
+  for (auto *waiter : cond->m_waiters) {
+    waiter->wake();
+  }
+  cond->m_waiters.clear();
 }
 
 bool ArchMultithreadPosix::waitCondVar(ArchCond cond, ArchMutex mutex, double timeout)
 {
-  // we can't wait on a condition variable and also wake it up for
-  // cancellation since we don't use posix cancellation.  so we
-  // must wake up periodically to check for cancellation.  we
-  // can't simply go back to waiting after the check since the
-  // condition may have changed and we'll have lost the signal.
-  // so we have to return to the caller.  since the caller will
-  // always check for spurious wakeups the only drawback here is
-  // performance:  we're waking up a lot more than desired.
-  if (static const double maxCancellationLatency = 0.1; timeout < 0.0 || timeout > maxCancellationLatency) {
-    timeout = maxCancellationLatency;
-  }
+  // we don't use posix cancellation.  instead each thread blocks on its
+  // own waiter, which cancelThread() wakes.  a cancel that comes before
+  // the wait stops it blocking.
+  ArchThreadImpl *self = s_currentThread;
+  ArchWaiter &waiter = self != nullptr ? self->m_waiter : s_foreignWaiter;
+  waiter.reset();
 
-  // see if we should cancel this thread
-  testCancelThread();
-
-  // get final time
-  struct timeval now;
-  gettimeofday(&now, nullptr);
-  struct timespec finalTime;
-  finalTime.tv_sec = now.tv_sec;
-  finalTime.tv_nsec = now.tv_usec * 1000;
-  auto timeout_sec = (long)timeout;
-  auto timeout_nsec = (long)(1.0e+9 * (timeout - timeout_sec));
-  finalTime.tv_sec += timeout_sec;
-  finalTime.tv_nsec += timeout_nsec;
-  if (finalTime.tv_nsec >= 1000000000) {
-    finalTime.tv_nsec -= 1000000000;
-    finalTime.tv_sec += 1;
+  // queue the waiter before letting go of the mutex, so a signal sent
+  // once the mutex is free can't be missed
+  {
+    std::scoped_lock lock{cond->m_mutex};
+    cond->m_waiters.push_back(&waiter);
   }
+  pthread_mutex_unlock(&mutex->m_mutex);
 
   // wait
-  int status = pthread_cond_timedwait(&cond->m_cond, &mutex->m_mutex, &finalTime);
-
-  // check for cancel again
-  testCancelThread();
-
-  switch (status) {
-  case 0:
-    // success
-    return true;
+  bool woken = waiter.wait(timeout);
 
-  case ETIMEDOUT:
-    return false;
+  // stop waiting.  if we're no longer queued then we were signalled,
+  // maybe as the wait timed out, and must take the signal.
+  {
+    std::scoped_lock lock{cond->m_mutex};
+    if (const auto queued = std::ranges::find(cond->m_waiters, &waiter); queued != cond->m_waiters.end()) {
+      cond->m_waiters.erase(queued);
+    } else {
+      woken = true;
+    }
+  }
+  pthread_mutex_lock(&mutex->m_mutex);
 
-  default:
-    assert(0 && "condition variable wait error");
-    return false;
+  // see if we should cancel this thread
+  if (self != nullptr && waiter.takeCancel()) {
+    testCancelThreadImpl(self);
   }
+  return woken;
 }
 
 ArchMutex ArchMultithreadPosix::newMutex()
@@ -369,8 +490,10 @@ void ArchMultithreadPosix::cancelThread(ArchThread thread)
     }
   }
 
-  // force thread to exit system calls if wakeup is true
+  // force thread to exit condition variable waits and system calls
+  // if wakeup is true
   if (wakeup) {
+    thread->m_waiter.cancel();
     pthread_kill(thread->m_thread, SIGWAKEUP);
   }
 }
@@ -534,6 +657,9 @@ ArchThreadImpl *ArchMultithreadPosix::findNoRefOrInsert(pthread_t thread)
     impl = new ArchThreadImpl;
     impl->m_thread = thread;
     insert(impl);
+    if (pthread_equal(thread, pthread_self())) {
+      s_currentThread = impl;
+    }
   }
   return impl;
 }
@@ -593,6 +719,7 @@ void ArchMultithreadPosix::testCancelThreadImpl(ArchThreadImpl *thread)
   if (thread->m_cancel && !thread->m_cancelling) {
     thread->m_cancelling = true;
     thread->m_cancel = false;
+    thread->m_waiter.takeCancel();
     cancel = true;
   }
 
@@ -627,6 +754,7 @@ void ArchMultithreadPosix::doThreadFunc(ArchThread thread)
   {
     std::scoped_lock lock{m_threadMutex};
   }
+  s_currentThread = thread;
 
   void *result = nullptr;
   try {
@@ -644,6 +772,7 @@ void ArchMultithreadPosix::doThreadFunc(ArchThread thread)
       std::scoped_lock lock{m_threadMutex};
       thread->m_exited = true;
     }
+    s_currentThread = nullptr;
     closeThread(thread);
     throw;
   }
@@ -654,6 +783,7 @@ void ArchMultithreadPosix::doThreadFunc(ArchThread thread)
     thread->m_result = result;
     thread->m_exited = true;
   }
+  s_currentThread = nullptr;
 
   // done with thread
   closeThread(thread);
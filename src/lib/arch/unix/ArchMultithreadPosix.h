@@ -12,13 +12,18 @@
 #include <list>
 #include <mutex>
 #include <pthread.h>
+#include <vector>
 
 #define ARCH_MULTITHREAD ArchMultithreadPosix
 
+class ArchWaiter;
+
 class ArchCondImpl
 {
 public:
-  pthread_cond_t m_cond;
+  // threads waiting, oldest first.  guarded by m_mutex.
+  std::mutex m_mutex;
+  std::vector<ArchWaiter *> m_waiters;
 };
 
 class ArchMutexImpl
@@ -12,18 +12,28 @@
 #include "arch/unix/ArchMultithreadPosix.h"
 #include "arch/unix/XArchUnix.h"
 
+#include <algorithm>
 #include <arpa/inet.h>
+#include <array>
+#include <atomic>
+#include <cmath>
 #include <cstring>
 #include <errno.h>
 #include <fcntl.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #if !defined(TCP_NODELAY)
 #include <netinet/tcp.h>
 #endif
 
+#if defined(Q_OS_LINUX)
+#include <netinet/tcp.h>
+#include <sys/eventfd.h>
+#endif
+
 static const int s_family[] = {
     PF_UNSPEC,
     PF_INET,
@@ -32,6 +42,58 @@ static const int s_family[] = {
 
 static const int s_type[] = {SOCK_DGRAM, SOCK_STREAM};
 
+// most buffers passed to one readv() or writev(), the rest are left for
+// the next call
+static const size_t s_maxIoBuffers = 64;
+
+#if defined(Q_OS_LINUX)
+// poll set cookie of the unblock pipe
+static const uint64_t s_unblockCookie = ~uint64_t{0};
+#endif
+
+//
+// ArchNetworkBSD::UnblockChannel
+//
+
+/*
+An eventfd where available, otherwise a pipe, that wakes a thread from
+pollSocket() or waitPollSet().  m_state tracks whether the thread is in
+a poll so that unblockPollSocket() only makes a system call when there
+is a sleeping thread to wake.  A wakeup while the thread isn't polling
+is remembered and makes its next poll return immediately.
+*/
+class ArchNetworkBSD::UnblockChannel
+{
+public:
+  enum State : int
+  {
+    Idle,
+    Polling,
+    Woken
+  };
+
+  // returns false if woken since the last poll, the poll must not block
+  bool beginPoll()
+  {
+    return m_state.exchange(Polling) != Woken;
+  }
+
+  void endPoll()
+  {
+    m_state.store(Idle);
+  }
+
+  // returns true if the thread was polling and must be signalled
+  bool wake()
+  {
+    return m_state.exchange(Woken) == Polling;
+  }
+
+  int m_readFd = -1;
+  int m_writeFd = -1;
+  std::atomic<int> m_state = Idle;
+};
+
 //
 // ArchNetworkBSD::Deps
 //
@@ -163,8 +225,9 @@ void ArchNetworkBSD::listenOnSocket(ArchSocket s)
 {
   assert(s != nullptr);
 
-  // hardcoding backlog
-  if (listen(s->m_fd, 3) == -1) {
+  // let the system size the backlog, the listener drains it in batches
+  // and many clients reconnect at once when the server restarts
+  if (listen(s->m_fd, SOMAXCONN) == -1) {
     throwError(errno);
   }
 }
@@ -183,9 +246,14 @@ ArchSocket ArchNetworkBSD::acceptSocket(ArchSocket s, ArchNetAddress *addr)
   auto *newSocket = new ArchSocketImpl;
   *addr = new ArchNetAddressImpl;
 
-  // accept on socket
+  // accept on socket.  where we can, make the new socket non-blocking
+  // and close-on-exec in the same call.
   auto len = ((*addr)->m_len);
+#if defined(Q_OS_LINUX)
+  int fd = accept4(s->m_fd, TYPED_ADDR(struct sockaddr, (*addr)), &len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
   int fd = accept(s->m_fd, TYPED_ADDR(struct sockaddr, (*addr)), &len);
+#endif
   (*addr)->m_len = len;
   if (fd == -1) {
     int err = errno;
@@ -199,7 +267,9 @@ ArchSocket ArchNetworkBSD::acceptSocket(ArchSocket s, ArchNetAddress *addr)
   }
 
   try {
+#if !defined(Q_OS_LINUX)
     setBlockingOnSocket(fd, false);
+#endif
 #if defined(__APPLE__)
     int on = 1;
     setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
@@ -270,30 +340,32 @@ int ArchNetworkBSD::pollSocket(PollEntry pe[], int num, double timeout)
   }
   int n = num;
 
-  // add the unblock pipe
-  const int *unblockPipe = getUnblockPipe();
-  if (unblockPipe != nullptr) {
-    pfd[n].fd = unblockPipe[0]; // test
+  // prepare timeout, rounding up so we never return before it's up
+  int t = (timeout < 0.0) ? -1 : static_cast<int>(std::ceil(1000.0 * timeout));
+
+  // add the unblock channel
+  UnblockChannel *unblock = getUnblockChannel();
+  if (unblock != nullptr) {
+    pfd[n].fd = unblock->m_readFd;
     pfd[n].events = POLLIN;
     ++n;
+    if (!unblock->beginPoll()) {
+      t = 0;
+    }
   }
 
-  // prepare timeout
-  int t = (timeout < 0.0) ? -1 : static_cast<int>(1000.0 * timeout);
-
   // do the poll
   n = m_pDeps->poll(pfd, n, t);
 
-  // reset the unblock pipe
-  if (n > 0 && unblockPipe != nullptr && (pfd[num].revents & POLLIN) != 0) {
-    // the unblock event was signalled.  flush the pipe.
-    char dummy[100];
-    do {
-      m_pDeps->read(unblockPipe[0], dummy, sizeof(dummy));
-    } while (errno != EAGAIN);
+  // reset the unblock channel
+  if (unblock != nullptr) {
+    unblock->endPoll();
+    if (n > 0 && (pfd[num].revents & POLLIN) != 0) {
+      drainUnblockChannel(unblock);
 
-    // don't count this unblock pipe in return value
-    --n;
+      // don't count the unblock channel in return value
+      --n;
+    }
   }
 
   // handle results
@@ -329,13 +401,151 @@ int ArchNetworkBSD::pollSocket(PollEntry pe[], int num, double timeout)
 
 void ArchNetworkBSD::unblockPollSocket(ArchThread thread)
 {
-  const int *unblockPipe = getUnblockPipeForThread(thread);
-  if (unblockPipe != nullptr) {
-    char dummy = 0;
-    std::ignore = write(unblockPipe[1], &dummy, 1);
+  UnblockChannel *unblock = getUnblockChannelForThread(thread);
+  if (unblock == nullptr || !unblock->wake()) {
+    // not polling, its next poll won't block
+    return;
+  }
+
+#if defined(Q_OS_LINUX)
+  if (unblock->m_readFd == unblock->m_writeFd) {
+    const uint64_t one = 1;
+    std::ignore = write(unblock->m_writeFd, &one, sizeof(one));
+    return;
+  }
+#endif
+  char dummy = 0;
+  std::ignore = write(unblock->m_writeFd, &dummy, 1);
+}
+
+#if defined(Q_OS_LINUX)
+
+ArchPollSet ArchNetworkBSD::newPollSet()
+{
+  const int fd = epoll_create1(EPOLL_CLOEXEC);
+  if (fd == -1) {
+    // callers fall back to pollSocket()
+    return nullptr;
+  }
+  return new ArchPollSetImpl{fd, -1, {}};
+}
+
+void ArchNetworkBSD::closePollSet(ArchPollSet set)
+{
+  assert(set != nullptr);
+
+  close(set->m_fd);
+  delete set;
+}
+
+void ArchNetworkBSD::setPollSetSocket(ArchPollSet set, ArchSocket s, unsigned short events, uint64_t cookie)
+{
+  assert(set != nullptr);
+  assert(s != nullptr);
+  assert(cookie != s_unblockCookie);
+
+  // level triggered, like poll(), so a job that doesn't drain its socket
+  // is run again on the next wait
+  struct epoll_event ev = {};
+  if ((events & PollEventMask::In) != 0) {
+    ev.events |= EPOLLIN;
+  }
+  if ((events & PollEventMask::Out) != 0) {
+    ev.events |= EPOLLOUT;
+  }
+  ev.data.u64 = cookie;
+
+  if (epoll_ctl(set->m_fd, EPOLL_CTL_MOD, s->m_fd, &ev) == -1) {
+    if (errno != ENOENT || epoll_ctl(set->m_fd, EPOLL_CTL_ADD, s->m_fd, &ev) == -1) {
+      throwError(errno);
+    }
+  }
+}
+
+void ArchNetworkBSD::removePollSetSocket(ArchPollSet set, ArchSocket s)
+{
+  assert(set != nullptr);
+  assert(s != nullptr);
+
+  // the kernel drops closed descriptors by itself so failure is harmless
+  epoll_ctl(set->m_fd, EPOLL_CTL_DEL, s->m_fd, nullptr);
+}
+
+int ArchNetworkBSD::waitPollSet(ArchPollSet set, PollSetEvent events[], int max, double timeout)
+{
+  assert(set != nullptr);
+  assert(events != nullptr && max > 0);
+
+  // the unblock channel belongs to the waiting thread, which never
+  // changes, so it only has to be registered on the first wait
+  UnblockChannel *unblock = getUnblockChannel();
+  if (unblock != nullptr && set->m_unblockFd == -1) {
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.u64 = s_unblockCookie;
+    if (epoll_ctl(set->m_fd, EPOLL_CTL_ADD, unblock->m_readFd, &ev) == 0) {
+      set->m_unblockFd = unblock->m_readFd;
+    }
+  }
+
+  // one extra entry so the unblock pipe never hides a ready socket
+  if (set->m_ready.size() < static_cast<size_t>(max) + 1) {
+    set->m_ready.resize(static_cast<size_t>(max) + 1);
+  }
+
+  // prepare timeout, rounding up so we never return before it's up
+  int t = (timeout < 0.0) ? -1 : static_cast<int>(std::ceil(1000.0 * timeout));
+
+  if (unblock != nullptr && !unblock->beginPoll()) {
+    t = 0;
+  }
+
+  // do the wait
+  int n = epoll_wait(set->m_fd, set->m_ready.data(), max + 1, t);
+  if (unblock != nullptr) {
+    unblock->endPoll();
   }
+  if (n == -1) {
+    if (errno == EINTR) {
+      // interrupted system call
+      m_pDeps->testCancelThread();
+      return 0;
+    }
+    throwError(errno);
+  }
+
+  // translate results
+  int count = 0;
+  for (int i = 0; i < n; ++i) {
+    const struct epoll_event &ev = set->m_ready[i];
+    if (ev.data.u64 == s_unblockCookie) {
+      drainUnblockChannel(unblock);
+      continue;
+    }
+    if (count == max) {
+      // still ready so it'll be reported again on the next wait
+      continue;
+    }
+
+    PollSetEvent &event = events[count++];
+    event.m_cookie = ev.data.u64;
+    event.m_revents = 0;
+    if ((ev.events & EPOLLIN) != 0) {
+      event.m_revents |= PollEventMask::In;
+    }
+    if ((ev.events & EPOLLOUT) != 0) {
+      event.m_revents |= PollEventMask::Out;
+    }
+    if ((ev.events & EPOLLERR) != 0) {
+      event.m_revents |= PollEventMask::Error;
+    }
+  }
+
+  return count;
 }
 
+#endif
+
 size_t ArchNetworkBSD::readSocket(ArchSocket s, void *buf, size_t len)
 {
   assert(s != nullptr);
@@ -364,6 +574,48 @@ size_t ArchNetworkBSD::writeSocket(ArchSocket s, const void *buf, size_t len)
   return n;
 }
 
+size_t ArchNetworkBSD::readSocketv(ArchSocket s, const std::span<uint8_t> buffers[], size_t count)
+{
+  assert(s != nullptr);
+
+  std::array<struct iovec, s_maxIoBuffers> iov;
+  count = std::min(count, iov.size());
+  for (size_t i = 0; i < count; ++i) {
+    iov[i].iov_base = buffers[i].data();
+    iov[i].iov_len = buffers[i].size();
+  }
+
+  ssize_t n = readv(s->m_fd, iov.data(), static_cast<int>(count));
+  if (n == -1) {
+    if (errno == EINTR || errno == EAGAIN) {
+      return 0;
+    }
+    throwError(errno);
+  }
+  return n;
+}
+
+size_t ArchNetworkBSD::writeSocketv(ArchSocket s, const std::span<const uint8_t> buffers[], size_t count)
+{
+  assert(s != nullptr);
+
+  std::array<struct iovec, s_maxIoBuffers> iov;
+  count = std::min(count, iov.size());
+  for (size_t i = 0; i < count; ++i) {
+    iov[i].iov_base = const_cast<uint8_t *>(buffers[i].data());
+    iov[i].iov_len = buffers[i].size();
+  }
+
+  ssize_t n = writev(s->m_fd, iov.data(), static_cast<int>(count));
+  if (n == -1) {
+    if (errno == EINTR || errno == EAGAIN) {
+      return 0;
+    }
+    throwError(errno);
+  }
+  return n;
+}
+
 void ArchNetworkBSD::throwErrorOnSocket(ArchSocket s)
 {
   assert(s != nullptr);
@@ -399,6 +651,27 @@ void ArchNetworkBSD::setBlockingOnSocket(int fd, bool blocking) const
   }
 }
 
+bool ArchNetworkBSD::getTcpInfo(ArchSocket s, TcpInfo &info)
+{
+  assert(s != nullptr);
+
+#if defined(Q_OS_LINUX)
+  tcp_info tcpInfo{};
+  auto size = static_cast<socklen_t>(sizeof(tcpInfo));
+  if (getsockopt(s->m_fd, IPPROTO_TCP, TCP_INFO, &tcpInfo, &size) == -1) {
+    return false;
+  }
+  info.m_rtt = 1.0e-6 * tcpInfo.tcpi_rtt;
+  info.m_rttVariance = 1.0e-6 * tcpInfo.tcpi_rttvar;
+  info.m_retransmits = tcpInfo.tcpi_total_retrans;
+  return true;
+#else
+  // not reported in a portable form elsewhere
+  (void)info;
+  return false;
+#endif
+}
+
 bool ArchNetworkBSD::setNoDelayOnSocket(ArchSocket s, bool noDelay)
 {
   assert(s != nullptr);
@@ -696,35 +969,61 @@ bool ArchNetworkBSD::isEqualAddr(ArchNetAddress a, ArchNetAddress b)
   return (a->m_len == b->m_len && memcmp(&a->m_addr, &b->m_addr, a->m_len) == 0);
 }
 
-const int *ArchNetworkBSD::getUnblockPipe()
+ArchNetworkBSD::UnblockChannel *ArchNetworkBSD::getUnblockChannel()
 {
   ArchMultithreadPosix *mt = ArchMultithreadPosix::getInstance();
   ArchThread thread = mt->newCurrentThread();
-  const int *p = getUnblockPipeForThread(thread);
+  auto *unblock = getUnblockChannelForThread(thread);
   ARCH->closeThread(thread);
-  return p;
+  if (unblock != nullptr) {
+    return unblock;
+  }
+
+  // only the thread that polls creates its channel
+  unblock = new UnblockChannel;
+#if defined(Q_OS_LINUX)
+  unblock->m_readFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  unblock->m_writeFd = unblock->m_readFd;
+#endif
+  if (unblock->m_readFd == -1) {
+    int unblockPipe[2];
+    if (pipe(unblockPipe) == -1) {
+      delete unblock;
+      return nullptr;
+    }
+    unblock->m_readFd = unblockPipe[0];
+    unblock->m_writeFd = unblockPipe[1];
+    try {
+      setBlockingOnSocket(unblock->m_readFd, false);
+    } catch (...) {
+      close(unblock->m_readFd);
+      close(unblock->m_writeFd);
+      delete unblock;
+      return nullptr;
+    }
+  }
+  mt->setNetworkDataForCurrentThread(unblock);
+  return unblock;
 }
 
-const int *ArchNetworkBSD::getUnblockPipeForThread(ArchThread thread)
+ArchNetworkBSD::UnblockChannel *ArchNetworkBSD::getUnblockChannelForThread(ArchThread thread)
 {
-  ArchMultithreadPosix *mt = ArchMultithreadPosix::getInstance();
-  auto *unblockPipe = static_cast<int *>(mt->getNetworkDataForThread(thread));
-  if (unblockPipe == nullptr) {
-    unblockPipe = new int[2];
-    if (pipe(unblockPipe) != -1) {
-      try {
-        setBlockingOnSocket(unblockPipe[0], false);
-        mt->setNetworkDataForCurrentThread(unblockPipe);
-      } catch (...) {
-        delete[] unblockPipe;
-        unblockPipe = nullptr;
-      }
-    } else {
-      delete[] unblockPipe;
-      unblockPipe = nullptr;
-    }
+  return static_cast<UnblockChannel *>(ArchMultithreadPosix::getInstance()->getNetworkDataForThread(thread));
+}
+
+void ArchNetworkBSD::drainUnblockChannel(const UnblockChannel *unblock)
+{
+  // reading an eventfd resets its counter in one go
+  if (unblock->m_readFd == unblock->m_writeFd) {
+    uint64_t count;
+    m_pDeps->read(unblock->m_readFd, &count, sizeof(count));
+    return;
   }
-  return unblockPipe;
+
+  char dummy[100];
+  do {
+    m_pDeps->read(unblock->m_readFd, dummy, sizeof(dummy));
+  } while (errno != EAGAIN);
 }
 
 [[noreturn]] void ArchNetworkBSD::throwError(int err) const
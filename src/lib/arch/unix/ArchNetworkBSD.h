@@ -10,10 +10,17 @@
 #include "arch/IArchMultithread.h"
 #include "arch/IArchNetwork.h"
 
+#include <QtSystemDetection>
+
 #include <memory>
 #include <mutex>
 #include <poll.h>
 #include <sys/socket.h>
+#include <vector>
+
+#if defined(Q_OS_LINUX)
+#include <sys/epoll.h>
+#endif
 
 #define ARCH_NETWORK ArchNetworkBSD
 #define TYPED_ADDR(type_, addr_) (reinterpret_cast<type_ *>(&addr_->m_addr))
@@ -30,6 +37,16 @@ public:
   int m_refCount;
 };
 
+#if defined(Q_OS_LINUX)
+class ArchPollSetImpl
+{
+public:
+  int m_fd;
+  int m_unblockFd;
+  std::vector<struct epoll_event> m_ready;
+};
+#endif
+
 class ArchNetAddressImpl
 {
 public:
@@ -82,9 +99,19 @@ public:
   bool connectSocket(ArchSocket s, ArchNetAddress name) override;
   int pollSocket(PollEntry[], int num, double timeout) override;
   void unblockPollSocket(ArchThread thread) override;
+#if defined(Q_OS_LINUX)
+  ArchPollSet newPollSet() override;
+  void closePollSet(ArchPollSet set) override;
+  void setPollSetSocket(ArchPollSet set, ArchSocket s, unsigned short events, uint64_t cookie) override;
+  void removePollSetSocket(ArchPollSet set, ArchSocket s) override;
+  int waitPollSet(ArchPollSet set, PollSetEvent events[], int max, double timeout) override;
+#endif
   size_t readSocket(ArchSocket s, void *buf, size_t len) override;
   size_t writeSocket(ArchSocket s, const void *buf, size_t len) override;
+  size_t readSocketv(ArchSocket s, const std::span<uint8_t> buffers[], size_t count) override;
+  size_t writeSocketv(ArchSocket s, const std::span<const uint8_t> buffers[], size_t count) override;
   void throwErrorOnSocket(ArchSocket) override;
+  bool getTcpInfo(ArchSocket s, TcpInfo &info) override;
   bool setNoDelayOnSocket(ArchSocket, bool noDelay) override;
   void setKeepAliveOnSocket(ArchSocket, bool keepAlive) override;
   bool setReuseAddrOnSocket(ArchSocket, bool reuse) override;
@@ -101,8 +128,12 @@ public:
   bool isEqualAddr(ArchNetAddress, ArchNetAddress) override;
 
 private:
-  const int *getUnblockPipe();
-  const int *getUnblockPipeForThread(ArchThread);
+  // per thread wakeup channel for pollSocket() and waitPollSet()
+  class UnblockChannel;
+
+  UnblockChannel *getUnblockChannel();
+  UnblockChannel *getUnblockChannelForThread(ArchThread);
+  void drainUnblockChannel(const UnblockChannel *);
   void setBlockingOnSocket(int fd, bool blocking) const;
   [[noreturn]] void throwError(int) const override;
   [[noreturn]] void throwNameError(int) const override;
@@ -14,6 +14,7 @@
 #include "arch/win32/XArchWindows.h"
 #include "base/Log.h"
 
+#include <cmath>
 #include <malloc.h>
 
 static const int s_family[] = {
@@ -295,8 +296,9 @@ void ArchNetworkWinsock::listenOnSocket(ArchSocket s)
 {
   assert(s != nullptr);
 
-  // hardcoding backlog
-  if (listen_winsock(s->m_socket, 3) != ERROR_SUCCESS) {
+  // let the system size the backlog, the listener drains it in batches
+  // and many clients reconnect at once when the server restarts
+  if (listen_winsock(s->m_socket, SOMAXCONN) != ERROR_SUCCESS) {
     throwError(getsockerror_winsock());
   }
 }
@@ -433,8 +435,8 @@ int ArchNetworkWinsock::pollSocket(PollEntry pe[], int num, double timeout)
   }
   events[n++] = *unblockEvent;
 
-  // prepare timeout
-  DWORD t = (timeout < 0.0) ? INFINITE : (DWORD)(1000.0 * timeout);
+  // prepare timeout, rounding up so we never return before it's up
+  DWORD t = (timeout < 0.0) ? INFINITE : (DWORD)std::ceil(1000.0 * timeout);
   if (canWrite) {
     // if we know we can write then don't block
     t = 0;
@@ -10,7 +10,10 @@
 #include "EventTypes.h"
 
 #include <assert.h>
+#include <cstddef>
 #include <cstdlib>
+#include <cstring>
+#include <type_traits>
 
 using deskflow::EventTypes;
 
@@ -38,11 +41,19 @@ private:
 //! Event
 /*!
  \c Event holds an event type and a pointer to event data. It is movable, but not copyable
+
+ Small POD data (such as the mouse motion, button and wheel info sent for
+ every input event) can be stored inline in the event instead, which
+ avoids a malloc()/free() pair per event.
 */
 class Event
 {
 public:
   using Flags = uint32_t;
+
+  //! Largest data that can be stored inline
+  static constexpr size_t kInlineDataSize = 16;
+
   struct EventFlags
   {
     inline static const Flags NoFlags = 0x00;            //!< No flags
@@ -79,6 +90,27 @@ public:
     // do nothing
   }
 
+  //! Create \c Event with inline data (POD)
+  /*!
+  Copies \p data into the event itself rather than taking a pointer to
+  it, so nothing is allocated and nothing is freed by \c deleteData().
+  \c getData() returns a pointer to the copy which is valid for as long
+  as the event is not moved or destroyed.
+  */
+  template <typename T>
+    requires(
+        std::is_class_v<T> && std::is_trivially_copyable_v<T> && sizeof(T) <= kInlineDataSize &&
+        alignof(T) <= alignof(void *)
+    )
+  Event(EventTypes type, void *target, const T &data, Flags flags = EventFlags::NoFlags)
+      : m_type(type),
+        m_target(target),
+        m_flags(flags),
+        m_hasInlineData(true)
+  {
+    std::memcpy(m_inlineData, &data, sizeof(T));
+  }
+
   //! @name manipulators
   //@{
 
@@ -97,7 +129,9 @@ public:
 
     default:
       if ((event.getFlags() & EventFlags::DontFreeData) == 0) {
-        free(event.getData());
+        if (!event.hasInlineData()) {
+          free(event.getData());
+        }
         delete event.getDataObject();
       }
       break;
@@ -143,7 +177,17 @@ public:
   */
   void *getData() const
   {
-    return m_data;
+    return m_hasInlineData ? const_cast<unsigned char *>(m_inlineData) : m_data;
+  }
+
+  //! Check if the event data is stored inline
+  /*!
+  Returns true if the event data (POD) lives inside the event rather
+  than in a separate allocation.
+  */
+  bool hasInlineData() const
+  {
+    return m_hasInlineData;
   }
 
   //! Get the event data (non-POD)
@@ -171,7 +215,12 @@ public:
 private:
   EventTypes m_type = EventTypes::Unknown;
   void *m_target = nullptr;
-  void *m_data = nullptr;
+  union
+  {
+    void *m_data = nullptr;
+    alignas(void *) unsigned char m_inlineData[kInlineDataSize];
+  };
   Flags m_flags = EventFlags::NoFlags;
+  bool m_hasInlineData = false;
   EventData *m_dataObject = nullptr;
 };
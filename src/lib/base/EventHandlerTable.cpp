@@ -0,0 +1,61 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "base/EventHandlerTable.h"
+
+#include <bit>
+
+//
+// EventHandlerTable
+//
+
+EventHandlerTable::EventHandlerTable(std::vector<Entry> entries) : m_entries(std::move(entries))
+{
+  if (m_entries.empty()) {
+    return;
+  }
+
+  // keep the load factor at or below one half so probes stay short
+  const size_t capacity = std::bit_ceil(m_entries.size() * 2);
+  m_slots.assign(capacity, 0);
+  m_shift = static_cast<uint32_t>(64 - std::countr_zero(capacity));
+
+  for (size_t i = 0; i < m_entries.size(); ++i) {
+    size_t slot = slotFor(m_entries[i].m_type, m_entries[i].m_target);
+    while (m_slots[slot] != 0) {
+      slot = (slot + 1) & (capacity - 1);
+    }
+    m_slots[slot] = static_cast<uint32_t>(i + 1);
+  }
+}
+
+const IEventQueue::EventHandler *EventHandlerTable::find(EventTypes type, void *target) const
+{
+  if (m_slots.empty()) {
+    return nullptr;
+  }
+
+  const size_t mask = m_slots.size() - 1;
+  for (size_t slot = slotFor(type, target);; slot = (slot + 1) & mask) {
+    const uint32_t index = m_slots[slot];
+    if (index == 0) {
+      return nullptr;
+    }
+    const Entry &entry = m_entries[index - 1];
+    if (entry.m_target == target && entry.m_type == type) {
+      return entry.m_handler.get();
+    }
+  }
+}
+
+size_t EventHandlerTable::slotFor(EventTypes type, const void *target) const
+{
+  // fibonacci hashing, the top bits of the product are well mixed even
+  // though the low bits of the target pointer are always zero
+  const auto key = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(target)) ^
+                   (static_cast<uint64_t>(type) << 32 | static_cast<uint64_t>(type));
+  return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> m_shift);
+}
@@ -0,0 +1,83 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include "base/IEventQueue.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+//! Immutable table of event handlers
+/*!
+Maps a (target, event type) pair to a handler with a flat open
+addressing hash, so a lookup is a multiply and a short linear probe over
+a contiguous array.
+
+A table is never modified once built.  \c EventQueue publishes a new
+table for every registration change, which lets any thread look up and
+call a handler without taking a lock.  Handlers are shared between
+successive tables so building a new table does not copy them.
+*/
+class EventHandlerTable
+{
+public:
+  using HandlerPtr = std::shared_ptr<const IEventQueue::EventHandler>;
+
+  struct Entry
+  {
+    void *m_target;
+    EventTypes m_type;
+    HandlerPtr m_handler;
+  };
+
+  EventHandlerTable() = default;
+  explicit EventHandlerTable(std::vector<Entry> entries);
+  EventHandlerTable(EventHandlerTable const &) = delete;
+  EventHandlerTable(EventHandlerTable &&) = delete;
+  ~EventHandlerTable() = default;
+
+  EventHandlerTable &operator=(EventHandlerTable const &) = delete;
+  EventHandlerTable &operator=(EventHandlerTable &&) = delete;
+
+  //! @name accessors
+  //@{
+
+  //! Find a handler
+  /*!
+  Returns the handler for \p type on \p target, or nullptr if there is
+  none.  The handler remains valid for as long as the table does.
+  */
+  const IEventQueue::EventHandler *find(EventTypes type, void *target) const;
+
+  //! Get all entries
+  /*!
+  Returns the entries in no particular order, for building the next
+  table.
+  */
+  const std::vector<Entry> &entries() const
+  {
+    return m_entries;
+  }
+
+  //! Get number of handlers
+  size_t size() const
+  {
+    return m_entries.size();
+  }
+
+  //@}
+
+private:
+  size_t slotFor(EventTypes type, const void *target) const;
+
+  std::vector<Entry> m_entries;
+
+  // index + 1 into m_entries, 0 marks an empty slot
+  std::vector<uint32_t> m_slots;
+  uint32_t m_shift = 0;
+};
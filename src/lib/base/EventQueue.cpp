@@ -9,14 +9,24 @@
 #include "base/EventQueue.h"
 
 #include "arch/Arch.h"
-#include "base/EventQueueTimer.h"
+#include "base/FinalAction.h"
+#include "base/LockFreeEventQueueBuffer.h"
 #include "base/Log.h"
 #include "base/SimpleEventQueueBuffer.h"
 #include "common/ExitCodes.h"
 #include "mt/Lock.h"
 #include "mt/Mutex.h"
 
+#include <algorithm>
 #include <stdexcept>
+#include <string>
+
+// posted to the buffer to wake the loop for the bulk lane, the slab
+// never hands this id out
+static constexpr uint32_t kBulkWakeID = EventSlab::kInvalidID;
+
+// seconds waitForReady() waits for the loop to start
+static constexpr int kReadyTimeout = 10;
 
 // interrupt handler.  this just adds a quit event to the queue.
 static void interrupt(Arch::ThreadSignal, void *data)
@@ -29,17 +39,22 @@ static void interrupt(Arch::ThreadSignal, void *data)
 // EventQueue
 //
 
-EventQueue::EventQueue() : m_readyMutex(new Mutex), m_readyCondVar(new CondVar<bool>(m_readyMutex, false))
+EventQueue::EventQueue(DefaultBuffer defaultBuffer)
+    : m_defaultBuffer(defaultBuffer),
+      m_handlers(new EventHandlerTable),
+      m_readyMutex(new Mutex),
+      m_readyCondVar(new CondVar<bool>(m_readyMutex, false))
 {
   ARCH->setSignalHandler(Arch::ThreadSignal::Interrupt, &interrupt, this);
   ARCH->setSignalHandler(Arch::ThreadSignal::Terminate, &interrupt, this);
-  m_buffer = std::make_unique<SimpleEventQueueBuffer>();
+  m_buffer = newDefaultBuffer();
 }
 
 EventQueue::~EventQueue()
 {
   delete m_readyCondVar;
   delete m_readyMutex;
+  delete m_handlers.load();
 
   ARCH->setSignalHandler(Arch::ThreadSignal::Interrupt, nullptr, nullptr);
   ARCH->setSignalHandler(Arch::ThreadSignal::Terminate, nullptr, nullptr);
@@ -81,7 +96,7 @@ void EventQueue::adoptBuffer(IEventQueueBuffer *buffer)
 
   LOG_DEBUG("adopting new buffer");
 
-  if (m_events.size() != 0) {
+  if (!m_events.empty()) {
     // this can come as a nasty surprise to programmers expecting
     // their events to be raised, only to have them deleted.
     LOG_DEBUG("discarding %d event(s)", m_events.size());
@@ -89,28 +104,45 @@ void EventQueue::adoptBuffer(IEventQueueBuffer *buffer)
 
   // discard old buffer and old events
   m_buffer.reset();
-  for (auto i = m_events.begin(); i != m_events.end(); ++i) {
-    Event::deleteData(i->second);
-  }
   m_events.clear();
-  m_oldEventIDs.clear();
+  m_bulkEvents.clear();
+  m_bulkWakePending = false;
+  m_lastQueuedID = EventSlab::kInvalidID;
 
   // use new buffer
   m_buffer.reset(buffer);
   if (buffer == nullptr) {
-    m_buffer = std::make_unique<SimpleEventQueueBuffer>();
+    m_buffer = newDefaultBuffer();
+  }
+}
+
+std::unique_ptr<IEventQueueBuffer> EventQueue::newDefaultBuffer() const
+{
+  if (m_defaultBuffer == DefaultBuffer::LockFree) {
+    return std::make_unique<LockFreeEventQueueBuffer>();
   }
+  return std::make_unique<SimpleEventQueueBuffer>();
 }
 
 bool EventQueue::processEvent(Event &event, double timeout, Stopwatch &timer)
 {
-  // if no events are waiting then handle timers and then wait
+  // bulk work that has waited long enough goes ahead of everything else
+  if (takeBulkEvent(event, true)) {
+    return true;
+  }
+
+  // if no events are waiting then handle timers and bulk work and then wait
   while (m_buffer->isEmpty()) {
     // handle timers first
     if (hasTimerExpired(event)) {
       return true;
     }
 
+    // otherwise bulk work only runs when nothing else is due
+    if (takeBulkEvent(event, false)) {
+      return true;
+    }
+
     // get time remaining in timeout
     double timeLeft = timeout - timer.getTime();
     if (timeout >= 0.0 && timeLeft <= 0.0) {
@@ -125,6 +157,11 @@ bool EventQueue::processEvent(Event &event, double timeout, Stopwatch &timer)
       timeLeft = timerTimeout;
     }
 
+    // likewise for bulk work that is waiting for its budget to refill
+    if (double bulkTimeout = getNextBulkTimeout(); bulkTimeout >= 0.0 && (timeLeft < 0.0 || bulkTimeout < timeLeft)) {
+      timeLeft = bulkTimeout;
+    }
+
     // wait for an event
     m_buffer->waitForEvent(timeLeft);
   }
@@ -147,8 +184,22 @@ bool EventQueue::processEvent(Event &event, double timeout, Stopwatch &timer)
     return true;
 
   case User: {
-    std::scoped_lock lock{m_mutex};
-    event = removeEvent(dataID);
+    if (dataID == kBulkWakeID) {
+      // the wakeup has done its job, the bulk lane is checked before
+      // the loop waits again
+      {
+        std::scoped_lock lock{m_mutex};
+        m_bulkWakePending = false;
+      }
+      return processEvent(event, timeout, timer);
+    }
+
+    MonotonicClock::time_point queuedAt;
+    {
+      std::scoped_lock lock{m_mutex};
+      event = removeEvent(dataID, &queuedAt);
+    }
+    recordLatency(event, queuedAt);
     return true;
   }
 
@@ -166,16 +217,54 @@ bool EventQueue::getEvent(Event &event, double timeout)
 
 bool EventQueue::dispatchEvent(const Event &event)
 {
+  // announce the dispatch before reading the table, publishHandlers()
+  // checks the count after swapping tables to know if the old one may
+  // still be in use
+  m_dispatching.fetch_add(1, std::memory_order_seq_cst);
+  auto cleanup = deskflow::finally([this] {
+    if (m_dispatching.fetch_sub(1, std::memory_order_acq_rel) == 1 &&
+        m_hasRetiredHandlers.load(std::memory_order_relaxed)) {
+      // don't wait on a thread that is registering handlers, it will
+      // reclaim the tables itself
+      if (std::unique_lock lock{m_handlerMutex, std::try_to_lock}; lock.owns_lock()) {
+        reclaimHandlers();
+      }
+    }
+  });
+
+  const EventHandlerTable *handlers = m_handlers.load(std::memory_order_seq_cst);
   void *target = event.getTarget();
-  if (auto typeHandler = getHandler(event.getType(), target); typeHandler.has_value()) {
-    (*typeHandler)(event);
-    return true;
+  const auto *handler = handlers->find(event.getType(), target);
+  if (handler == nullptr) {
+    handler = handlers->find(EventTypes::Unknown, target);
+  }
+
+  // copy the type, the handler may change the event
+  const EventTypes type = event.getType();
+  const bool measure = m_stats.isEnabled();
+  const bool bulk = laneFor(type) == Lane::Bulk;
+  if (handler == nullptr) {
+    if (measure) {
+      m_stats.recordUnhandled(type);
+    }
+    return false;
   }
-  if (auto anyHandler = getHandler(EventTypes::Unknown, target); anyHandler.has_value()) {
-    (*anyHandler)(event);
+
+  if (!measure && !bulk) {
+    (*handler)(event);
     return true;
   }
-  return false;
+
+  const auto start = MonotonicClock::now();
+  (*handler)(event);
+  const auto handlerTime = MonotonicClock::now() - start;
+  if (measure) {
+    m_stats.recordDispatched(type, handlerTime);
+  }
+  if (bulk) {
+    chargeBulkCredit(handlerTime);
+  }
+  return true;
 }
 
 void EventQueue::addEvent(Event &&event)
@@ -205,31 +294,70 @@ void EventQueue::addEventToBuffer(Event &&event)
 {
   std::scoped_lock lock{m_mutex};
 
+  if (coalesceEvent(event)) {
+    Event::deleteData(event);
+    return;
+  }
+
+  // only read the clock when someone is looking at the stats
+  const bool measure = m_stats.isEnabled();
+  const EventTypes type = event.getType();
+
   // store the event's data locally
-  auto eventID = saveEvent(std::move(event));
+  auto eventID = saveEvent(std::move(event), measure ? MonotonicClock::now() : MonotonicClock::time_point{});
+  if (eventID == EventSlab::kInvalidID) {
+    LOG_ERR("event queue is full, dropping event");
+    Event::deleteData(event);
+    return;
+  }
+  if (measure) {
+    m_stats.recordQueued(type, m_events.size());
+  }
+
+  if (laneFor(type) == Lane::Bulk) {
+    m_bulkEvents.push_back({eventID, MonotonicClock::now()});
+    if (!m_bulkWakePending) {
+      m_bulkWakePending = m_buffer->addEvent(kBulkWakeID);
+    }
+    return;
+  }
 
   // add it
   if (!m_buffer->addEvent(eventID)) {
     // failed to send event
     auto removedEvent = removeEvent(eventID);
     Event::deleteData(removedEvent);
+    return;
+  }
+  m_lastQueuedID = eventID;
+}
+
+bool EventQueue::coalesceEvent(const Event &event)
+{
+  // caller must hold m_mutex.  only the most recently queued event is a
+  // candidate, so nothing is ever merged across an event in between.
+  if (m_coalescers.empty() || m_lastQueuedID == EventSlab::kInvalidID) {
+    return false;
+  }
+
+  Event *queued = m_events.find(m_lastQueuedID);
+  if (queued == nullptr || queued->getType() != event.getType() || queued->getTarget() != event.getTarget()) {
+    return false;
   }
+
+  const auto type = event.getType();
+  const auto coalescer = std::ranges::find_if(m_coalescers, [type](const auto &entry) { return entry.first == type; });
+  return coalescer != m_coalescers.end() && coalescer->second(*queued, event);
 }
 
 EventQueueTimer *EventQueue::newTimer(double duration, void *target)
 {
   assert(duration > 0.0);
 
-  auto timer = new EventQueueTimer;
-  if (target == nullptr) {
-    target = timer;
-  }
+  const auto ticks = MonotonicClock::fromSeconds(duration);
   std::scoped_lock lock{m_mutex};
-  m_timers.insert(timer);
-  // initial duration is requested duration plus whatever's on
-  // the clock currently because the latter will be subtracted
-  // the next time we check for timers.
-  m_timerQueue.push(Timer(timer, duration, duration + m_time.getTime(), target, false));
+  auto *timer = new Timer(ticks, MonotonicClock::now() + ticks, target, false);
+  pushTimer(timer);
   return timer;
 }
 
@@ -237,235 +365,358 @@ EventQueueTimer *EventQueue::newOneShotTimer(double duration, void *target)
 {
   assert(duration > 0.0);
 
-  auto timer = new EventQueueTimer;
-  if (target == nullptr) {
-    target = timer;
-  }
+  const auto ticks = MonotonicClock::fromSeconds(duration);
   std::scoped_lock lock{m_mutex};
-  m_timers.insert(timer);
-  // initial duration is requested duration plus whatever's on
-  // the clock currently because the latter will be subtracted
-  // the next time we check for timers.
-  m_timerQueue.push(Timer(timer, duration, duration + m_time.getTime(), target, true));
+  auto *timer = new Timer(ticks, MonotonicClock::now() + ticks, target, true);
+  pushTimer(timer);
   return timer;
 }
 
-void EventQueue::deleteTimer(EventQueueTimer *timer)
+void EventQueue::deleteTimer(EventQueueTimer *eventQueueTimer)
 {
-  std::scoped_lock lock{m_mutex};
-  for (auto index = m_timerQueue.begin(); index != m_timerQueue.end(); ++index) {
-    if (index->getTimer() == timer) {
-      m_timerQueue.erase(index);
-      break;
+  auto *timer = static_cast<Timer *>(eventQueueTimer);
+  {
+    std::scoped_lock lock{m_mutex};
+    if (timer->m_heapIndex != Timer::kNotQueued) {
+      eraseTimer(timer);
     }
   }
-  if (Timers::iterator index = m_timers.find(timer); index != m_timers.end()) {
-    m_timers.erase(index);
-  }
   delete timer;
 }
 
-void EventQueue::addHandler(EventTypes type, void *target, const EventHandler &handler)
+void EventQueue::resetTimer(EventQueueTimer *eventQueueTimer)
 {
+  auto *timer = static_cast<Timer *>(eventQueueTimer);
   std::scoped_lock lock{m_mutex};
-  m_handlers[target][type] = handler;
+  timer->m_deadline = MonotonicClock::now() + timer->m_duration;
+  if (timer->m_heapIndex == Timer::kNotQueued) {
+    pushTimer(timer);
+  } else if (timer->m_deadline < timer->m_heapDeadline) {
+    timer->m_heapDeadline = timer->m_deadline;
+    siftTimerUp(timer->m_heapIndex);
+  }
+  // otherwise the deadline moved later, which hasTimerExpired() deals
+  // with if the timer ever reaches the top of the heap
 }
 
-void EventQueue::removeHandler(EventTypes type, void *target)
+void EventQueue::setCoalescer(EventTypes type, const EventCoalescer &coalescer)
 {
   std::scoped_lock lock{m_mutex};
-  HandlerTable::iterator index = m_handlers.find(target);
-  if (index != m_handlers.end()) {
-    TypeHandlerTable &typeHandlers = index->second;
-    if (auto index2 = typeHandlers.find(type); index2 != typeHandlers.end()) {
-      typeHandlers.erase(index2);
-    }
-    if (typeHandlers.empty()) {
-      m_handlers.erase(index);
-    }
+  std::erase_if(m_coalescers, [type](const auto &entry) { return entry.first == type; });
+  if (coalescer) {
+    m_coalescers.emplace_back(type, coalescer);
   }
 }
 
-void EventQueue::removeHandlers(void *target)
+void EventQueue::setBulkBudget(MonotonicClock::duration budget)
 {
   std::scoped_lock lock{m_mutex};
-  HandlerTable::iterator index = m_handlers.find(target);
-  if (index != m_handlers.end()) {
-    m_handlers.erase(index);
-  }
+
+  // a zero budget would starve the lane for good
+  m_bulkBudget = std::max(budget, MonotonicClock::duration(1));
+  m_bulkCredit = std::min(m_bulkCredit, m_bulkBudget);
 }
 
-std::optional<EventQueue::EventHandler> EventQueue::getHandler(EventTypes type, void *target) const
+EventQueue::Lane EventQueue::laneFor(EventTypes type)
 {
-  std::scoped_lock lock{m_mutex};
-  if (HandlerTable::const_iterator index = m_handlers.find(target); index != m_handlers.end()) {
-    const TypeHandlerTable &typeHandlers = index->second;
-    TypeHandlerTable::const_iterator index2 = typeHandlers.find(type);
-    if (index2 != typeHandlers.end()) {
-      return index2->second;
-    }
+  switch (type) {
+  case EventTypes::ClipboardSending:
+  // accepting connections does TLS work, a reconnect storm mustn't
+  // delay input for the screens already connected
+  case EventTypes::ListenSocketConnecting:
+    return Lane::Bulk;
+
+  default:
+    return Lane::Interactive;
   }
-  return std::nullopt;
 }
 
-uint32_t EventQueue::saveEvent(Event &&event)
+void EventQueue::addHandler(EventTypes type, void *target, const EventHandler &handler)
 {
-  // choose id
-  uint32_t id;
-  if (!m_oldEventIDs.empty()) {
-    // reuse an id
-    id = m_oldEventIDs.back();
-    m_oldEventIDs.pop_back();
+  std::scoped_lock lock{m_handlerMutex};
+  auto entries = m_handlers.load(std::memory_order_relaxed)->entries();
+  auto newHandler = std::make_shared<const EventHandler>(handler);
+  auto index = std::ranges::find_if(entries, [type, target](const EventHandlerTable::Entry &entry) {
+    return entry.m_target == target && entry.m_type == type;
+  });
+  if (index != entries.end()) {
+    index->m_handler = std::move(newHandler);
   } else {
-    // make a new id
-    id = static_cast<uint32_t>(m_events.size());
+    entries.push_back({target, type, std::move(newHandler)});
   }
+  publishHandlers(std::move(entries));
+}
 
-  // save data
-  m_events[id] = std::move(event);
-  return id;
+void EventQueue::removeHandler(EventTypes type, void *target)
+{
+  std::scoped_lock lock{m_handlerMutex};
+  auto entries = m_handlers.load(std::memory_order_relaxed)->entries();
+  if (std::erase_if(entries, [type, target](const EventHandlerTable::Entry &entry) {
+        return entry.m_target == target && entry.m_type == type;
+      }) != 0) {
+    publishHandlers(std::move(entries));
+  }
 }
 
-Event EventQueue::removeEvent(uint32_t eventID)
+void EventQueue::removeHandlers(void *target)
 {
-  // look up id
-  EventTable::iterator index = m_events.find(eventID);
-  if (index == m_events.end()) {
-    return Event();
+  std::scoped_lock lock{m_handlerMutex};
+  auto entries = m_handlers.load(std::memory_order_relaxed)->entries();
+  if (std::erase_if(entries, [target](const EventHandlerTable::Entry &entry) { return entry.m_target == target; }) !=
+      0) {
+    publishHandlers(std::move(entries));
   }
+}
 
-  // get data
-  Event event = std::move(index->second);
-  m_events.erase(index);
+void EventQueue::publishHandlers(std::vector<EventHandlerTable::Entry> entries)
+{
+  // caller must hold m_handlerMutex
+  const EventHandlerTable *old =
+      m_handlers.exchange(new EventHandlerTable(std::move(entries)), std::memory_order_seq_cst);
+  m_retiredHandlers.emplace_back(old);
+  m_hasRetiredHandlers.store(true, std::memory_order_relaxed);
+  reclaimHandlers();
+}
+
+void EventQueue::reclaimHandlers()
+{
+  // caller must hold m_handlerMutex.  a dispatch that starts after the
+  // count is read here will load the current table, so the retired ones
+  // are unreachable once no dispatch is in progress.
+  if (m_dispatching.load(std::memory_order_seq_cst) == 0) {
+    m_retiredHandlers.clear();
+    m_hasRetiredHandlers.store(false, std::memory_order_relaxed);
+  }
+}
 
-  // save old id for reuse
-  m_oldEventIDs.push_back(eventID);
+uint32_t EventQueue::saveEvent(Event &&event, MonotonicClock::time_point queuedAt)
+{
+  return m_events.insert(std::move(event), queuedAt);
+}
 
-  return event;
+Event EventQueue::removeEvent(uint32_t eventID, MonotonicClock::time_point *queuedAt)
+{
+  return m_events.remove(eventID, queuedAt);
 }
 
 bool EventQueue::hasTimerExpired(Event &event)
 {
-  // return true if there's a timer in the timer priority queue that
-  // has expired.  if returning true then fill in event appropriately
-  // and reset and reinsert the timer.
-  if (m_timerQueue.empty()) {
-    return false;
-  }
+  // return true if there's a timer in the timer heap that has expired.
+  // if returning true then fill in event appropriately and rearm or
+  // unqueue the timer.
+  std::scoped_lock lock{m_mutex};
+  const auto now = MonotonicClock::now();
+  while (!m_timerHeap.empty()) {
+    Timer *timer = m_timerHeap.front();
+    if (timer->m_heapDeadline > now) {
+      return false;
+    }
 
-  // get time elapsed since last check
-  const double time = m_time.getTime();
-  m_time.reset();
+    if (timer->m_deadline > now) {
+      // the timer was reset since it was queued, move it to its real place
+      timer->m_heapDeadline = timer->m_deadline;
+      siftTimerDown(0);
+      continue;
+    }
 
-  // countdown elapsed time
-  for (auto index = m_timerQueue.begin(); index != m_timerQueue.end(); ++index) {
-    (*index) -= time;
+    // prepare event, counting the periods that elapsed since the deadline
+    m_timerEvent.m_timer = timer;
+    m_timerEvent.m_count = static_cast<uint32_t>((now - timer->m_deadline + timer->m_duration) / timer->m_duration);
+    event = Event(EventTypes::Timer, timer->m_target, &m_timerEvent);
+
+    // restart the countdown or remove a one-shot from the heap
+    if (timer->m_oneShot) {
+      eraseTimer(timer);
+    } else {
+      timer->m_deadline = now + timer->m_duration;
+      timer->m_heapDeadline = timer->m_deadline;
+      siftTimerDown(0);
+    }
+    return true;
   }
+  return false;
+}
 
-  // done if no timers are expired
-  if (m_timerQueue.top() > 0.0) {
-    return false;
+double EventQueue::getNextTimerTimeout() const
+{
+  // return -1 if no timers, 0 if the top timer has expired, otherwise
+  // the time until the top timer in the timer heap will expire.  the
+  // top timer may have been reset to a later deadline, in which case
+  // waking early just lets hasTimerExpired() requeue it.
+  std::scoped_lock lock{m_mutex};
+  if (m_timerHeap.empty()) {
+    return -1.0;
   }
+  const auto timeLeft = m_timerHeap.front()->m_heapDeadline - MonotonicClock::now();
+  return std::max(0.0, MonotonicClock::toSeconds(timeLeft));
+}
 
-  // remove timer from queue
-  Timer timer = m_timerQueue.top();
-  m_timerQueue.pop();
-
-  // prepare event and reset the timer's clock
-  timer.fillEvent(m_timerEvent);
-  event = Event(EventTypes::Timer, timer.getTarget(), &m_timerEvent);
-  timer.reset();
-
-  // reinsert timer into queue if it's not a one-shot
-  if (!timer.isOneShot()) {
-    m_timerQueue.push(timer);
+bool EventQueue::takeBulkEvent(Event &event, bool overdueOnly)
+{
+  MonotonicClock::time_point queuedAt;
+  {
+    std::scoped_lock lock{m_mutex};
+    if (m_bulkEvents.empty()) {
+      return false;
+    }
+    const auto now = MonotonicClock::now();
+    if (overdueOnly && now - m_bulkEvents.front().m_queuedAt < kBulkMaxWait) {
+      return false;
+    }
+    if (m_bulkBudget < kBulkSlice) {
+      refillBulkCredit(now);
+      if (m_bulkCredit <= MonotonicClock::duration::zero()) {
+        return false;
+      }
+    }
+    event = removeEvent(m_bulkEvents.front().m_id, &queuedAt);
+    m_bulkEvents.pop_front();
   }
-
+  recordLatency(event, queuedAt);
   return true;
 }
 
-double EventQueue::getNextTimerTimeout() const
+double EventQueue::getNextBulkTimeout()
 {
-  // return -1 if no timers, 0 if the top timer has expired, otherwise
-  // the time until the top timer in the timer priority queue will
-  // expire.
-  if (m_timerQueue.empty()) {
+  // return -1 if the bulk lane is empty, 0 if an event may run now,
+  // otherwise the time until the budget has refilled enough to run one
+  std::scoped_lock lock{m_mutex};
+  if (m_bulkEvents.empty()) {
     return -1.0;
   }
-  if (m_timerQueue.top() <= 0.0) {
+  if (m_bulkBudget >= kBulkSlice) {
     return 0.0;
   }
-  return m_timerQueue.top();
+  refillBulkCredit(MonotonicClock::now());
+  if (m_bulkCredit > MonotonicClock::duration::zero()) {
+    return 0.0;
+  }
+  const double debt = MonotonicClock::toSeconds(MonotonicClock::duration(1) - m_bulkCredit);
+  return debt * MonotonicClock::toSeconds(kBulkSlice) / MonotonicClock::toSeconds(m_bulkBudget);
 }
 
-void *EventQueue::getSystemTarget()
+void EventQueue::refillBulkCredit(MonotonicClock::time_point now)
 {
-  // any unique arbitrary pointer will do
-  return &m_systemTarget;
+  // caller must hold m_mutex
+  if (m_bulkRefilled != MonotonicClock::time_point{}) {
+    const double rate = MonotonicClock::toSeconds(m_bulkBudget) / MonotonicClock::toSeconds(kBulkSlice);
+    const auto earned = MonotonicClock::fromSeconds(MonotonicClock::toSeconds(now - m_bulkRefilled) * rate);
+    m_bulkCredit = std::min(m_bulkCredit + earned, m_bulkBudget);
+  }
+  m_bulkRefilled = now;
 }
 
-void EventQueue::waitForReady() const
+void EventQueue::chargeBulkCredit(MonotonicClock::duration handlerTime)
 {
-  double timeout = Arch::time() + 10;
-  Lock lock(m_readyMutex);
-
-  while (!m_readyCondVar->wait()) {
-    if (Arch::time() > timeout) {
-      throw std::runtime_error("event queue is not ready within 5 sec");
-    }
+  std::scoped_lock lock{m_mutex};
+  if (m_bulkBudget < kBulkSlice) {
+    refillBulkCredit(MonotonicClock::now());
+    m_bulkCredit -= handlerTime;
   }
 }
 
-//
-// EventQueue::Timer
-//
-
-EventQueue::Timer::Timer(EventQueueTimer *timer, double timeout, double initialTime, void *target, bool oneShot)
-    : m_timer(timer),
-      m_timeout(timeout),
-      m_target(target),
-      m_oneShot(oneShot),
-      m_time(initialTime)
+void EventQueue::recordLatency(const Event &event, MonotonicClock::time_point queuedAt)
 {
-  assert(m_timeout > 0.0);
+  // events queued before stats were turned on carry no timestamp
+  if (queuedAt != MonotonicClock::time_point{} && m_stats.isEnabled()) {
+    m_stats.recordLatency(event.getType(), MonotonicClock::now() - queuedAt);
+  }
 }
 
-void EventQueue::Timer::reset()
+void EventQueue::pushTimer(Timer *timer)
 {
-  m_time = m_timeout;
+  timer->m_heapDeadline = timer->m_deadline;
+  m_timerHeap.push_back(timer);
+  timer->m_heapIndex = m_timerHeap.size() - 1;
+  siftTimerUp(timer->m_heapIndex);
 }
 
-EventQueue::Timer &EventQueue::Timer::operator-=(double dt)
+void EventQueue::eraseTimer(Timer *timer)
 {
-  m_time -= dt;
-  return *this;
+  const size_t index = timer->m_heapIndex;
+  Timer *last = m_timerHeap.back();
+  m_timerHeap.pop_back();
+  timer->m_heapIndex = Timer::kNotQueued;
+  if (last != timer) {
+    // fill the hole with the last timer and restore the heap order
+    placeTimer(last, index);
+    siftTimerUp(index);
+    siftTimerDown(last->m_heapIndex);
+  }
 }
 
-EventQueue::Timer::operator double() const
+void EventQueue::siftTimerUp(size_t index)
 {
-  return m_time;
+  Timer *timer = m_timerHeap[index];
+  while (index > 0) {
+    const size_t parent = (index - 1) / 2;
+    if (m_timerHeap[parent]->m_heapDeadline <= timer->m_heapDeadline) {
+      break;
+    }
+    placeTimer(m_timerHeap[parent], index);
+    index = parent;
+  }
+  placeTimer(timer, index);
 }
 
-bool EventQueue::Timer::isOneShot() const
+void EventQueue::siftTimerDown(size_t index)
 {
-  return m_oneShot;
+  Timer *timer = m_timerHeap[index];
+  const size_t size = m_timerHeap.size();
+  for (;;) {
+    size_t child = index * 2 + 1;
+    if (child >= size) {
+      break;
+    }
+    if (child + 1 < size && m_timerHeap[child + 1]->m_heapDeadline < m_timerHeap[child]->m_heapDeadline) {
+      ++child;
+    }
+    if (timer->m_heapDeadline <= m_timerHeap[child]->m_heapDeadline) {
+      break;
+    }
+    placeTimer(m_timerHeap[child], index);
+    index = child;
+  }
+  placeTimer(timer, index);
 }
 
-EventQueueTimer *EventQueue::Timer::getTimer() const
+void EventQueue::placeTimer(Timer *timer, size_t index)
 {
-  return m_timer;
+  m_timerHeap[index] = timer;
+  timer->m_heapIndex = index;
 }
 
-void *EventQueue::Timer::getTarget() const
+void *EventQueue::getSystemTarget()
 {
-  return m_target;
+  // any unique arbitrary pointer will do
+  return &m_systemTarget;
 }
 
-void EventQueue::Timer::fillEvent(TimerEvent &event) const
+void EventQueue::waitForReady() const
 {
-  event.m_timer = m_timer;
-  event.m_count = 0;
-  if (m_time <= 0.0) {
-    event.m_count = static_cast<uint32_t>((m_timeout - m_time) / m_timeout);
+  double timeout = Arch::time() + kReadyTimeout;
+  Lock lock(m_readyMutex);
+
+  // check the flag first, the loop may have signalled before we got here
+  while (!(*m_readyCondVar)) {
+    const double timeLeft = timeout - Arch::time();
+    if (timeLeft <= 0.0) {
+      throw std::runtime_error("event queue is not ready within " + std::to_string(kReadyTimeout) + " sec");
+    }
+    m_readyCondVar->wait(timeLeft);
   }
 }
+
+//
+// EventQueue::Timer
+//
+
+EventQueue::Timer::Timer(Clock::duration duration, Clock::time_point deadline, void *target, bool oneShot)
+    : m_duration(duration),
+      m_deadline(deadline),
+      m_heapDeadline(deadline),
+      m_target(target == nullptr ? this : target),
+      m_oneShot(oneShot)
+{
+  assert(m_duration > Clock::duration::zero());
+}
@@ -8,17 +8,24 @@
 
 #pragma once
 
+#include "arch/MonotonicClock.h"
+#include "base/EventHandlerTable.h"
+#include "base/EventQueueStats.h"
+#include "base/EventQueueTimer.h"
+#include "base/EventSlab.h"
 #include "base/IEventQueue.h"
-#include "base/PriorityQueue.h"
 #include "base/Stopwatch.h"
 #include "mt/CondVar.h"
 
-#include <map>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
 #include <memory>
 #include <mutex>
-#include <optional>
 #include <queue>
-#include <set>
+#include <utility>
+#include <vector>
 
 //! Event queue
 /*!
@@ -28,7 +35,39 @@ delegates the platform dependent parts to a subclass.
 class EventQueue : public IEventQueue
 {
 public:
-  EventQueue();
+  //! Buffer used when no platform buffer has been adopted
+  enum class DefaultBuffer : uint8_t
+  {
+    Simple,  //!< \c SimpleEventQueueBuffer
+    LockFree //!< \c LockFreeEventQueueBuffer
+  };
+
+  //! Scheduling class of an event
+  /*!
+  Interactive events go through the buffer in the order they were
+  added.  Bulk events wait in a lane of their own and are only handed
+  out when no interactive event or timer is due, so a large clipboard
+  transfer or a burst of incoming connections cannot hold up input
+  queued behind it.  A bulk event that has waited \c kBulkMaxWait goes
+  ahead of interactive events, so steady input cannot starve bulk work.
+  Bulk handlers are also paced; see \c setBulkBudget().
+  */
+  enum class Lane : uint8_t
+  {
+    Interactive, //!< Input and everything else
+    Bulk         //!< Background transfers and connection accepting
+  };
+
+  //! Period the bulk budget applies to
+  static constexpr MonotonicClock::duration kBulkSlice = std::chrono::milliseconds(10);
+
+  //! Default time bulk handlers may run in each \c kBulkSlice
+  static constexpr MonotonicClock::duration kDefaultBulkBudget = std::chrono::milliseconds(5);
+
+  //! Longest a bulk event waits behind interactive events
+  static constexpr MonotonicClock::duration kBulkMaxWait = std::chrono::milliseconds(50);
+
+  explicit EventQueue(DefaultBuffer defaultBuffer = DefaultBuffer::Simple);
   EventQueue(EventQueue const &) = delete;
   EventQueue(EventQueue &&) = delete;
   ~EventQueue() override;
@@ -44,18 +83,49 @@ public:
   EventQueueTimer *newTimer(double duration, void *target) override;
   EventQueueTimer *newOneShotTimer(double duration, void *target) override;
   void deleteTimer(EventQueueTimer *) override;
+  void resetTimer(EventQueueTimer *) override;
   void addHandler(EventTypes type, void *target, const EventHandler &handler) override;
   void removeHandler(EventTypes type, void *target) override;
   void removeHandlers(void *target) override;
+  void setCoalescer(EventTypes type, const EventCoalescer &coalescer) override;
   void *getSystemTarget() override;
   void waitForReady() const override;
 
+  //! Set the bulk budget
+  /*!
+  Limits bulk event handlers to \p budget of run time in every
+  \c kBulkSlice.  Unused time carries over up to one slice's worth, and
+  a handler that overruns delays the next bulk event until the debt is
+  paid back.  A budget of \c kBulkSlice or more disables pacing.
+  */
+  void setBulkBudget(MonotonicClock::duration budget);
+
+  //! Get the lane events of \p type are queued in
+  static Lane laneFor(EventTypes type);
+
+  //! Get the queue's instrumentation
+  /*!
+  Collection is off until \c EventQueueStats::setEnabled() is called.
+  */
+  EventQueueStats &stats()
+  {
+    return m_stats;
+  }
+
 private:
-  std::optional<EventHandler> getHandler(EventTypes type, void *target) const;
-  uint32_t saveEvent(Event &&event);
-  Event removeEvent(uint32_t eventID);
+  std::unique_ptr<IEventQueueBuffer> newDefaultBuffer() const;
+  void publishHandlers(std::vector<EventHandlerTable::Entry> entries);
+  void reclaimHandlers();
+  bool coalesceEvent(const Event &event);
+  uint32_t saveEvent(Event &&event, MonotonicClock::time_point queuedAt);
+  Event removeEvent(uint32_t eventID, MonotonicClock::time_point *queuedAt = nullptr);
   bool hasTimerExpired(Event &event);
   double getNextTimerTimeout() const;
+  bool takeBulkEvent(Event &event, bool overdueOnly);
+  double getNextBulkTimeout();
+  void refillBulkCredit(MonotonicClock::time_point now);
+  void chargeBulkCredit(MonotonicClock::duration handlerTime);
+  void recordLatency(const Event &event, MonotonicClock::time_point queuedAt);
   void addEventToBuffer(Event &&event);
 
   //!
@@ -68,56 +138,80 @@ private:
   bool processEvent(Event &event, double timeout, Stopwatch &timer);
 
 private:
-  class Timer
+  //! Timer handle returned by \c newTimer() and \c newOneShotTimer()
+  struct Timer : public EventQueueTimer
   {
-  public:
-    Timer(EventQueueTimer *, double timeout, double initialTime, void *target, bool oneShot);
-    ~Timer() = default;
-
-    void reset();
+    static constexpr size_t kNotQueued = SIZE_MAX;
 
-    Timer &operator-=(double);
+    using Clock = MonotonicClock;
 
-    operator double() const;
+    Timer(Clock::duration duration, Clock::time_point deadline, void *target, bool oneShot);
 
-    bool isOneShot() const;
-    EventQueueTimer *getTimer() const;
-    void *getTarget() const;
-    void fillEvent(TimerEvent &) const;
-
-  private:
-    EventQueueTimer *m_timer;
-    double m_timeout;
+    Clock::duration m_duration;
+    Clock::time_point m_deadline;
+    // the deadline the heap is ordered by.  resetTimer() only pushes the
+    // deadline later in the common case, so this is allowed to lag
+    // behind m_deadline and is caught up when the timer reaches the top
+    Clock::time_point m_heapDeadline;
     void *m_target;
     bool m_oneShot;
-    double m_time;
+    size_t m_heapIndex = kNotQueued;
   };
 
-  using Timers = std::set<EventQueueTimer *>;
-  using TimerQueue = PriorityQueue<Timer>;
-  using EventTable = std::map<uint32_t, Event>;
-  using EventIDList = std::vector<uint32_t>;
-  using TypeHandlerTable = std::map<EventTypes, EventHandler>;
-  using HandlerTable = std::map<void *, TypeHandlerTable>;
+  void pushTimer(Timer *timer);
+  void eraseTimer(Timer *timer);
+  void siftTimerUp(size_t index);
+  void siftTimerDown(size_t index);
+  void placeTimer(Timer *timer, size_t index);
 
   int m_systemTarget = 0;
+  DefaultBuffer m_defaultBuffer;
   mutable std::mutex m_mutex;
 
   // buffer of events
   std::unique_ptr<IEventQueueBuffer> m_buffer;
 
   // saved events
-  EventTable m_events;
-  EventIDList m_oldEventIDs;
+  EventSlab m_events;
+
+  // coalescing.  the last event put in the buffer is remembered so the
+  // next one can be merged into it if it has not been taken yet.
+  std::vector<std::pair<EventTypes, EventCoalescer>> m_coalescers;
+  uint32_t m_lastQueuedID = EventSlab::kInvalidID;
 
-  // timers
-  Stopwatch m_time;
-  Timers m_timers;
-  TimerQueue m_timerQueue;
+  // bulk lane, saved events in arrival order.  a single wakeup id is
+  // posted to the buffer when the lane stops being empty so a waiting
+  // loop notices it.
+  struct BulkEvent
+  {
+    uint32_t m_id;
+    MonotonicClock::time_point m_queuedAt;
+  };
+  std::deque<BulkEvent> m_bulkEvents;
+  bool m_bulkWakePending = false;
+
+  // token bucket pacing bulk handlers, credit goes negative when a
+  // handler overruns
+  MonotonicClock::duration m_bulkBudget = kDefaultBulkBudget;
+  MonotonicClock::duration m_bulkCredit = kDefaultBulkBudget;
+  MonotonicClock::time_point m_bulkRefilled;
+
+  // timers, in a binary min-heap on absolute deadline.  each timer
+  // knows its heap index so it can be moved or erased without a search.
+  std::vector<Timer *> m_timerHeap;
   TimerEvent m_timerEvent;
 
-  // event handlers
-  HandlerTable m_handlers;
+  // event handlers.  the current table is swapped for a new one on
+  // every change so dispatchEvent() can read it without locking.  old
+  // tables are kept until no dispatch is in progress, which also keeps
+  // a handler alive while it removes itself.
+  std::mutex m_handlerMutex;
+  std::atomic<const EventHandlerTable *> m_handlers;
+  std::vector<std::unique_ptr<const EventHandlerTable>> m_retiredHandlers;
+  std::atomic<bool> m_hasRetiredHandlers = false;
+  std::atomic<uint32_t> m_dispatching = 0;
+
+  EventQueueStats m_stats;
 
   Mutex *m_readyMutex = nullptr;
   CondVar<bool> *m_readyCondVar = nullptr;
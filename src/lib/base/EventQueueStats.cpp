@@ -0,0 +1,191 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "base/EventQueueStats.h"
+
+#include "base/String.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace {
+
+template <typename T> void storeMax(std::atomic<T> &target, T value)
+{
+  T current = target.load(std::memory_order_relaxed);
+  while (current < value && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    // current was reloaded, try again
+  }
+}
+
+std::string formatDuration(MonotonicClock::duration duration)
+{
+  const auto ns = static_cast<double>(duration.count());
+  if (ns < 1.0e+3) {
+    return deskflow::string::sprintf("%.0fns", ns);
+  }
+  if (ns < 1.0e+6) {
+    return deskflow::string::sprintf("%.1fus", ns / 1.0e+3);
+  }
+  if (ns < 1.0e+9) {
+    return deskflow::string::sprintf("%.1fms", ns / 1.0e+6);
+  }
+  return deskflow::string::sprintf("%.2fs", ns / 1.0e+9);
+}
+
+std::string formatHistogram(const EventQueueStats::Histogram &histogram)
+{
+  if (histogram.m_count == 0) {
+    return "-";
+  }
+  return deskflow::string::sprintf(
+      "p50 %s p99 %s max %s", formatDuration(histogram.percentile(50.0)).c_str(),
+      formatDuration(histogram.percentile(99.0)).c_str(), formatDuration(histogram.m_max).c_str()
+  );
+}
+
+} // namespace
+
+//
+// EventQueueStats
+//
+
+void EventQueueStats::reset()
+{
+  for (auto &counters : m_counters) {
+    counters.m_queued.store(0, std::memory_order_relaxed);
+    counters.m_dispatched.store(0, std::memory_order_relaxed);
+    counters.m_unhandled.store(0, std::memory_order_relaxed);
+    counters.m_maxDepth.store(0, std::memory_order_relaxed);
+    counters.m_latency.reset();
+    counters.m_handlerTime.reset();
+  }
+  m_maxDepth.store(0, std::memory_order_relaxed);
+}
+
+void EventQueueStats::recordQueued(EventTypes type, size_t depth)
+{
+  storeMax(m_maxDepth, depth);
+  if (auto *counters = countersFor(type); counters != nullptr) {
+    counters->m_queued.fetch_add(1, std::memory_order_relaxed);
+    storeMax(counters->m_maxDepth, depth);
+  }
+}
+
+void EventQueueStats::recordLatency(EventTypes type, MonotonicClock::duration latency)
+{
+  if (auto *counters = countersFor(type); counters != nullptr) {
+    counters->m_latency.add(latency);
+  }
+}
+
+void EventQueueStats::recordDispatched(EventTypes type, MonotonicClock::duration handlerTime)
+{
+  if (auto *counters = countersFor(type); counters != nullptr) {
+    counters->m_dispatched.fetch_add(1, std::memory_order_relaxed);
+    counters->m_handlerTime.add(handlerTime);
+  }
+}
+
+void EventQueueStats::recordUnhandled(EventTypes type)
+{
+  if (auto *counters = countersFor(type); counters != nullptr) {
+    counters->m_unhandled.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+std::vector<EventQueueStats::TypeStats> EventQueueStats::snapshot() const
+{
+  std::vector<TypeStats> result;
+  for (size_t i = 0; i < kTypes; ++i) {
+    const Counters &counters = m_counters[i];
+    TypeStats stats;
+    stats.m_type = static_cast<EventTypes>(i);
+    stats.m_queued = counters.m_queued.load(std::memory_order_relaxed);
+    stats.m_dispatched = counters.m_dispatched.load(std::memory_order_relaxed);
+    stats.m_unhandled = counters.m_unhandled.load(std::memory_order_relaxed);
+    stats.m_maxDepth = counters.m_maxDepth.load(std::memory_order_relaxed);
+    counters.m_latency.load(stats.m_latency);
+    counters.m_handlerTime.load(stats.m_handlerTime);
+    if (stats.m_queued != 0 || stats.m_dispatched != 0 || stats.m_unhandled != 0) {
+      result.push_back(stats);
+    }
+  }
+  return result;
+}
+
+std::vector<std::string> EventQueueStats::report() const
+{
+  std::vector<std::string> lines;
+  for (const auto &stats : snapshot()) {
+    lines.push_back(deskflow::string::sprintf(
+        "type %u: queued %llu, dispatched %llu, unhandled %llu, max depth %zu, wait %s, handler %s",
+        static_cast<unsigned>(stats.m_type), static_cast<unsigned long long>(stats.m_queued),
+        static_cast<unsigned long long>(stats.m_dispatched), static_cast<unsigned long long>(stats.m_unhandled),
+        stats.m_maxDepth, formatHistogram(stats.m_latency).c_str(), formatHistogram(stats.m_handlerTime).c_str()
+    ));
+  }
+  return lines;
+}
+
+EventQueueStats::Counters *EventQueueStats::countersFor(EventTypes type)
+{
+  const auto index = static_cast<size_t>(type);
+  return index < kTypes ? &m_counters[index] : nullptr;
+}
+
+//
+// EventQueueStats::Histogram
+//
+
+MonotonicClock::duration EventQueueStats::Histogram::percentile(double percentile) const
+{
+  if (m_count == 0) {
+    return {};
+  }
+
+  const auto rank = static_cast<uint64_t>(std::ceil(static_cast<double>(m_count) * percentile / 100.0));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBuckets - 1; ++i) {
+    seen += m_buckets[i];
+    if (seen >= std::max<uint64_t>(rank, 1)) {
+      // bucket i holds durations below 2^i nanoseconds
+      return std::min(MonotonicClock::duration(MonotonicClock::rep{1} << i), m_max);
+    }
+  }
+  return m_max;
+}
+
+//
+// EventQueueStats::AtomicHistogram
+//
+
+void EventQueueStats::AtomicHistogram::add(MonotonicClock::duration duration)
+{
+  const auto ns = static_cast<uint64_t>(std::max<MonotonicClock::rep>(duration.count(), 0));
+  const auto bucket = std::min<size_t>(std::bit_width(ns), kBuckets - 1);
+  m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+  storeMax(m_max, static_cast<MonotonicClock::rep>(ns));
+}
+
+void EventQueueStats::AtomicHistogram::load(Histogram &histogram) const
+{
+  histogram.m_count = 0;
+  for (size_t i = 0; i < kBuckets; ++i) {
+    histogram.m_buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+    histogram.m_count += histogram.m_buckets[i];
+  }
+  histogram.m_max = MonotonicClock::duration(m_max.load(std::memory_order_relaxed));
+}
+
+void EventQueueStats::AtomicHistogram::reset()
+{
+  for (auto &bucket : m_buckets) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  m_max.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,154 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include "arch/MonotonicClock.h"
+#include "base/EventTypes.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using deskflow::EventTypes;
+
+//! Event queue instrumentation
+/*!
+Counts, per event type, how many events were queued and dispatched, the
+deepest the queue got, how long events waited between \c addEvent() and
+being taken off the queue, and how long their handlers ran.
+
+Collection is off by default.  While it is off the queue pays for one
+relaxed load per event and never reads the clock, so this can stay
+compiled into release builds.  All counters are relaxed atomics, so a
+report may be taken from any thread while events are flowing; it is a
+close approximation rather than a consistent snapshot.
+
+Durations are kept in power of two histograms, so the reported
+percentiles are upper bounds accurate to within a factor of two.
+*/
+class EventQueueStats
+{
+public:
+  //! Number of histogram buckets, the last one catches everything longer
+  static constexpr size_t kBuckets = 32;
+
+  //! Number of event types tracked
+  static constexpr size_t kTypes = static_cast<size_t>(EventTypes::EISessionClosed) + 1;
+
+  //! Duration histogram
+  struct Histogram
+  {
+    std::array<uint64_t, kBuckets> m_buckets{};
+    uint64_t m_count = 0;
+    MonotonicClock::duration m_max{};
+
+    //! Get the upper bound of the duration at \p percentile (0 to 100)
+    MonotonicClock::duration percentile(double percentile) const;
+  };
+
+  //! Counters for one event type
+  struct TypeStats
+  {
+    EventTypes m_type = EventTypes::Unknown;
+    uint64_t m_queued = 0;
+    uint64_t m_dispatched = 0;
+    uint64_t m_unhandled = 0;
+    size_t m_maxDepth = 0;
+    Histogram m_latency;
+    Histogram m_handlerTime;
+  };
+
+  EventQueueStats() = default;
+  EventQueueStats(EventQueueStats const &) = delete;
+  EventQueueStats(EventQueueStats &&) = delete;
+  ~EventQueueStats() = default;
+
+  EventQueueStats &operator=(EventQueueStats const &) = delete;
+  EventQueueStats &operator=(EventQueueStats &&) = delete;
+
+  //! @name manipulators
+  //@{
+
+  //! Turn collection on or off
+  void setEnabled(bool enabled)
+  {
+    m_enabled.store(enabled, std::memory_order_relaxed);
+  }
+
+  //! Zero all counters
+  void reset();
+
+  //! Record an event added to the queue with \p depth events now waiting
+  void recordQueued(EventTypes type, size_t depth);
+
+  //! Record an event taken off the queue after waiting for \p latency
+  void recordLatency(EventTypes type, MonotonicClock::duration latency);
+
+  //! Record a handler that ran for \p handlerTime
+  void recordDispatched(EventTypes type, MonotonicClock::duration handlerTime);
+
+  //! Record an event that had no handler
+  void recordUnhandled(EventTypes type);
+
+  //@}
+  //! @name accessors
+  //@{
+
+  //! Check if collection is on
+  bool isEnabled() const
+  {
+    return m_enabled.load(std::memory_order_relaxed);
+  }
+
+  //! Get the deepest the queue has been
+  size_t maxDepth() const
+  {
+    return m_maxDepth.load(std::memory_order_relaxed);
+  }
+
+  //! Get counters for every event type that has been seen
+  std::vector<TypeStats> snapshot() const;
+
+  //! Get a report with one line per event type seen
+  /*!
+  Event types are reported by their numeric \c EventTypes value.
+  Returns an empty list if nothing has been recorded.
+  */
+  std::vector<std::string> report() const;
+
+  //@}
+
+private:
+  struct AtomicHistogram
+  {
+    void add(MonotonicClock::duration duration);
+    void load(Histogram &histogram) const;
+    void reset();
+
+    std::array<std::atomic<uint64_t>, kBuckets> m_buckets{};
+    std::atomic<MonotonicClock::rep> m_max = 0;
+  };
+
+  struct Counters
+  {
+    std::atomic<uint64_t> m_queued = 0;
+    std::atomic<uint64_t> m_dispatched = 0;
+    std::atomic<uint64_t> m_unhandled = 0;
+    std::atomic<size_t> m_maxDepth = 0;
+    AtomicHistogram m_latency;
+    AtomicHistogram m_handlerTime;
+  };
+
+  Counters *countersFor(EventTypes type);
+
+  std::atomic<bool> m_enabled = false;
+  std::atomic<size_t> m_maxDepth = 0;
+  std::array<Counters, kTypes> m_counters;
+};
@@ -0,0 +1,120 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "base/EventSlab.h"
+
+#include <algorithm>
+
+//
+// EventSlab
+//
+
+EventSlab::EventSlab(uint32_t initialCapacity)
+{
+  m_slots.reserve(std::clamp<uint32_t>(initialCapacity, 1, kMaxSlots));
+  grow();
+}
+
+EventSlab::~EventSlab()
+{
+  clear();
+}
+
+uint32_t EventSlab::insert(Event &&event, MonotonicClock::time_point queuedAt)
+{
+  if (m_freeHead == kNoSlot) {
+    grow();
+    if (m_freeHead == kNoSlot) {
+      return kInvalidID;
+    }
+  }
+
+  const uint32_t index = m_freeHead;
+  Slot &slot = m_slots[index];
+  m_freeHead = slot.m_nextFree;
+
+  slot.m_event = std::move(event);
+  slot.m_queuedAt = queuedAt;
+  slot.m_nextFree = kNoSlot;
+  slot.m_used = true;
+  ++m_size;
+
+  return (slot.m_generation << kIndexBits) | index;
+}
+
+Event *EventSlab::find(uint32_t dataID)
+{
+  Slot *slot = liveSlot(dataID);
+  return slot != nullptr ? &slot->m_event : nullptr;
+}
+
+Event EventSlab::remove(uint32_t dataID, MonotonicClock::time_point *queuedAt)
+{
+  Slot *slot = liveSlot(dataID);
+  if (slot == nullptr) {
+    return Event();
+  }
+
+  if (queuedAt != nullptr) {
+    *queuedAt = slot->m_queuedAt;
+  }
+  Event event = std::move(slot->m_event);
+  release(dataID & kIndexMask);
+  return event;
+}
+
+void EventSlab::clear()
+{
+  for (uint32_t index = 0; index < m_slots.size(); ++index) {
+    if (m_slots[index].m_used) {
+      Event::deleteData(m_slots[index].m_event);
+      release(index);
+    }
+  }
+}
+
+void EventSlab::grow()
+{
+  // the first call fills the reserved capacity, later calls double it
+  const auto oldSize = static_cast<uint32_t>(m_slots.size());
+  const uint32_t newSize = oldSize == 0 ? static_cast<uint32_t>(m_slots.capacity()) : std::min(oldSize * 2, kMaxSlots);
+  if (newSize <= oldSize) {
+    return;
+  }
+
+  m_slots.resize(newSize);
+
+  // link the new slots in ascending order ahead of the existing free list
+  for (uint32_t index = newSize; index > oldSize; --index) {
+    m_slots[index - 1].m_nextFree = m_freeHead;
+    m_freeHead = index - 1;
+  }
+}
+
+EventSlab::Slot *EventSlab::liveSlot(uint32_t dataID)
+{
+  const uint32_t index = dataID & kIndexMask;
+  if (index >= m_slots.size()) {
+    return nullptr;
+  }
+
+  Slot &slot = m_slots[index];
+  if (!slot.m_used || slot.m_generation != (dataID >> kIndexBits)) {
+    return nullptr;
+  }
+  return &slot;
+}
+
+void EventSlab::release(uint32_t index)
+{
+  Slot &slot = m_slots[index];
+  slot.m_event = Event();
+  slot.m_generation = (slot.m_generation + 1) & kGenerationMask;
+  slot.m_used = false;
+  slot.m_nextFree = m_freeHead;
+  m_freeHead = index;
+  --m_size;
+}
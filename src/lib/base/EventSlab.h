@@ -0,0 +1,126 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include "arch/MonotonicClock.h"
+#include "base/Event.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//! Slab of queued events
+/*!
+Stores events waiting in an \c IEventQueueBuffer and hands out the
+\c dataID that the buffer carries for them.  Slots live in a dense
+vector and freed slots are recycled through an intrusive free list, so
+inserting and removing an event is O(1) and does not allocate once the
+slab has grown to the working set.
+
+A \c dataID packs the slot index with the slot's generation.  The
+generation is bumped every time a slot is released so a stale id (for
+example one still sitting in a buffer that was discarded) never
+matches a newer event that reuses the slot.
+*/
+class EventSlab
+{
+public:
+  //! Returned by \c insert() when the slab is full
+  static constexpr uint32_t kInvalidID = UINT32_MAX;
+
+  explicit EventSlab(uint32_t initialCapacity = kInitialCapacity);
+  EventSlab(EventSlab const &) = delete;
+  EventSlab(EventSlab &&) = delete;
+  ~EventSlab();
+
+  EventSlab &operator=(EventSlab const &) = delete;
+  EventSlab &operator=(EventSlab &&) = delete;
+
+  //! @name manipulators
+  //@{
+
+  //! Store an event
+  /*!
+  Takes ownership of \p event and returns the id to pass to
+  \c IEventQueueBuffer::addEvent().  Returns \c kInvalidID if there
+  are no free slots left, in which case \p event is left untouched.
+  \p queuedAt is kept alongside the event for \c remove() to return.
+  */
+  uint32_t insert(Event &&event, MonotonicClock::time_point queuedAt = {});
+
+  //! Take an event back out
+  /*!
+  Removes and returns the event stored under \p dataID.  Returns an
+  \c Event of type \c Unknown if \p dataID does not refer to a live
+  slot.  If \p queuedAt is not null it is set to the time passed to
+  \c insert().
+  */
+  Event remove(uint32_t dataID, MonotonicClock::time_point *queuedAt = nullptr);
+
+  //! Get a stored event
+  /*!
+  Returns the event stored under \p dataID, which may be modified in
+  place, or nullptr if \p dataID does not refer to a live slot.
+  */
+  Event *find(uint32_t dataID);
+
+  //! Discard all events
+  /*!
+  Frees the data of every stored event and releases every slot.  Ids
+  handed out before the call are invalidated.
+  */
+  void clear();
+
+  //@}
+  //! @name accessors
+  //@{
+
+  //! Get number of stored events
+  size_t size() const
+  {
+    return m_size;
+  }
+
+  //! Check if no events are stored
+  bool empty() const
+  {
+    return m_size == 0;
+  }
+
+  //! Get number of allocated slots
+  size_t capacity() const
+  {
+    return m_slots.size();
+  }
+
+  //@}
+
+private:
+  static constexpr uint32_t kInitialCapacity = 256;
+  static constexpr uint32_t kIndexBits = 24;
+  static constexpr uint32_t kIndexMask = (1u << kIndexBits) - 1;
+  static constexpr uint32_t kGenerationMask = (1u << (32 - kIndexBits)) - 1;
+  static constexpr uint32_t kMaxSlots = kIndexMask;
+  static constexpr uint32_t kNoSlot = UINT32_MAX;
+
+  struct Slot
+  {
+    Event m_event;
+    MonotonicClock::time_point m_queuedAt;
+    uint32_t m_generation = 0;
+    uint32_t m_nextFree = kNoSlot;
+    bool m_used = false;
+  };
+
+  void grow();
+  Slot *liveSlot(uint32_t dataID);
+  void release(uint32_t index);
+
+  std::vector<Slot> m_slots;
+  uint32_t m_freeHead = kNoSlot;
+  size_t m_size = 0;
+};
@@ -90,6 +90,11 @@ enum class EventTypes : uint32_t
   */
   SocketDisconnected,
 
+  /** A host resolver sends this event when a lookup has finished.
+      The data is a pointer to a HostResolver::Result.
+  */
+  HostResolved,
+
   OsxScreenConfirmSleep,
 
   /// This event is sent whenever a server accepts a client.
@@ -110,6 +115,9 @@ enum class EventTypes : uint32_t
   */
   ClientProxyDisconnected,
 
+  /// A client proxy sends this event to itself to send the input events it has batched.
+  ClientProxyInputBatch,
+
   /** This event is sent when the client has correctly responded to the hello message.
       The target is this.
   */
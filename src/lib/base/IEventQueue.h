@@ -29,6 +29,7 @@ class IEventQueue
 {
 public:
   using EventHandler = std::function<void(const Event &)>;
+  using EventCoalescer = std::function<bool(Event &queued, const Event &next)>;
 
   virtual ~IEventQueue() = default;
   class TimerEvent
@@ -116,6 +117,16 @@ public:
   */
   virtual void deleteTimer(EventQueueTimer *) = 0;
 
+  //! Restart a timer
+  /*!
+  Restarts the countdown of a previously created timer so that it next
+  expires its original duration from now.  A one-shot timer that has
+  already expired is armed again.  This is much cheaper than deleting
+  the timer and creating a new one, so use it for timers that are
+  pushed back on activity, like keep alive alarms.
+  */
+  virtual void resetTimer(EventQueueTimer *) = 0;
+
   //! Register an event handler for an event type
   /*!
   Registers an event handler for \p type and \p target.  The \p handler
@@ -139,6 +150,20 @@ public:
   */
   virtual void removeHandlers(void *target) = 0;
 
+  //! Coalesce queued events of a type
+  /*!
+  When an event of \p type is added while the event added just before
+  it has the same type and target and is still waiting on the queue,
+  \p coalescer is called with the two.  If it returns true it has
+  folded \p next into \p queued, and \p next is discarded.  Events are
+  never merged across any other event added in between.  Pass an empty
+  function to stop coalescing \p type.
+
+  The coalescer runs with the queue locked, so it must be quick and
+  must not call back into the queue.
+  */
+  virtual void setCoalescer(EventTypes type, const EventCoalescer &coalescer) = 0;
+
   //! Wait for event queue to become ready
   /*!
   Blocks on the current thread until the event queue is ready for events to
@@ -0,0 +1,166 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "base/LockFreeEventQueueBuffer.h"
+
+#include "arch/Arch.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#if defined(Q_OS_LINUX)
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+//
+// LockFreeEventQueueBuffer
+//
+
+LockFreeEventQueueBuffer::LockFreeEventQueueBuffer(size_t capacity)
+    : m_mask(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1),
+      m_cells(new Cell[m_mask + 1])
+{
+  for (size_t i = 0; i <= m_mask; ++i) {
+    m_cells[i].m_sequence.store(i, std::memory_order_relaxed);
+  }
+
+#if defined(Q_OS_LINUX)
+  m_wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+#endif
+  if (m_wakeFd < 0) {
+    m_parkMutex = ARCH->newMutex();
+    m_parkCond = ARCH->newCondVar();
+  }
+}
+
+LockFreeEventQueueBuffer::~LockFreeEventQueueBuffer()
+{
+#if defined(Q_OS_LINUX)
+  if (m_wakeFd >= 0) {
+    close(m_wakeFd);
+  }
+#endif
+  if (m_parkCond != nullptr) {
+    ARCH->closeCondVar(m_parkCond);
+    ARCH->closeMutex(m_parkMutex);
+  }
+}
+
+void LockFreeEventQueueBuffer::waitForEvent(double timeout)
+{
+  if (!isEmpty() || timeout == 0.0) {
+    return;
+  }
+  park(timeout);
+}
+
+IEventQueueBuffer::Type LockFreeEventQueueBuffer::getEvent(Event &, uint32_t &dataID)
+{
+  // only the consumer moves the head so a relaxed load is enough
+  const size_t pos = m_head.load(std::memory_order_relaxed);
+  Cell &cell = m_cells[pos & m_mask];
+  if (cell.m_sequence.load(std::memory_order_acquire) != pos + 1) {
+    return IEventQueueBuffer::Type::Unknown;
+  }
+
+  dataID = cell.m_dataID;
+
+  // hand the cell back to producers for the next lap around the ring
+  cell.m_sequence.store(pos + m_mask + 1, std::memory_order_release);
+  m_head.store(pos + 1, std::memory_order_relaxed);
+  return IEventQueueBuffer::Type::User;
+}
+
+bool LockFreeEventQueueBuffer::addEvent(uint32_t dataID)
+{
+  size_t pos = m_tail.load(std::memory_order_relaxed);
+  Cell *cell;
+  for (;;) {
+    cell = &m_cells[pos & m_mask];
+    const size_t sequence = cell->m_sequence.load(std::memory_order_acquire);
+    const auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+    if (diff == 0) {
+      // the cell is free for this lap, try to claim it
+      if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // the consumer has not freed this cell yet, the ring is full
+      return false;
+    } else {
+      // another producer claimed the cell first
+      pos = m_tail.load(std::memory_order_relaxed);
+    }
+  }
+
+  cell->m_dataID = dataID;
+  cell->m_sequence.store(pos + 1, std::memory_order_release);
+
+  // pairs with the fence in park(): either the consumer sees this event
+  // before it blocks or we see that it is parked and wake it
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (m_parked.load(std::memory_order_relaxed) && m_parked.exchange(false, std::memory_order_acq_rel)) {
+    wake();
+  }
+  return true;
+}
+
+bool LockFreeEventQueueBuffer::isEmpty() const
+{
+  const size_t pos = m_head.load(std::memory_order_relaxed);
+  return m_cells[pos & m_mask].m_sequence.load(std::memory_order_acquire) != pos + 1;
+}
+
+void LockFreeEventQueueBuffer::park(double timeout)
+{
+#if defined(Q_OS_LINUX)
+  if (m_wakeFd >= 0) {
+    // unlike the condition variable wait the poll isn't a cancellation
+    // point of its own.  a cancel interrupts it so test on either side.
+    ARCH->testCancelThread();
+    m_parked.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (isEmpty()) {
+      pollfd pfd = {m_wakeFd, POLLIN, 0};
+      const int timeoutMs = timeout < 0.0 ? -1 : static_cast<int>(std::ceil(timeout * 1000.0));
+      if (poll(&pfd, 1, timeoutMs) > 0) {
+        uint64_t count;
+        [[maybe_unused]] auto n = read(m_wakeFd, &count, sizeof(count));
+      }
+    }
+    m_parked.store(false, std::memory_order_relaxed);
+    ARCH->testCancelThread();
+    return;
+  }
+#endif
+
+  // holding the mutex from raising the flag until the wait releases it
+  // means a producer that sees the flag cannot broadcast too early
+  ArchMutexLock lock(m_parkMutex);
+  m_parked.store(true, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (isEmpty()) {
+    ARCH->waitCondVar(m_parkCond, m_parkMutex, timeout);
+  }
+  m_parked.store(false, std::memory_order_relaxed);
+}
+
+void LockFreeEventQueueBuffer::wake()
+{
+#if defined(Q_OS_LINUX)
+  if (m_wakeFd >= 0) {
+    const uint64_t one = 1;
+    [[maybe_unused]] auto n = write(m_wakeFd, &one, sizeof(one));
+    return;
+  }
+#endif
+
+  ArchMutexLock lock(m_parkMutex);
+  ARCH->broadcastCondVar(m_parkCond);
+}
@@ -0,0 +1,78 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include "arch/IArchMultithread.h"
+#include "base/IEventQueueBuffer.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+//! Lock-free in-memory event queue buffer
+/*!
+An alternative to \c SimpleEventQueueBuffer built on a bounded
+multi-producer/single-consumer ring.  Any number of threads may call
+\c addEvent() concurrently, but only the event queue thread may call
+\c waitForEvent() and \c getEvent().
+
+Producers never take a lock.  The consumer only parks when the ring is
+empty, and producers only pay for a wakeup (an eventfd write on Linux,
+a condition variable broadcast elsewhere) when the consumer is parked.
+\c waitForEvent() is a cancellation point either way.
+
+The ring is bounded; \c addEvent() returns false when it is full.
+*/
+class LockFreeEventQueueBuffer : public IEventQueueBuffer
+{
+public:
+  static constexpr size_t kDefaultCapacity = 16384;
+
+  /*!
+  \p capacity is rounded up to the next power of two.
+  */
+  explicit LockFreeEventQueueBuffer(size_t capacity = kDefaultCapacity);
+  LockFreeEventQueueBuffer(LockFreeEventQueueBuffer const &) = delete;
+  LockFreeEventQueueBuffer(LockFreeEventQueueBuffer &&) = delete;
+  ~LockFreeEventQueueBuffer() override;
+
+  LockFreeEventQueueBuffer &operator=(LockFreeEventQueueBuffer const &) = delete;
+  LockFreeEventQueueBuffer &operator=(LockFreeEventQueueBuffer &&) = delete;
+
+  // IEventQueueBuffer overrides
+  void init() override
+  {
+    // do nothing
+  }
+  void waitForEvent(double timeout) override;
+  Type getEvent(Event &event, uint32_t &dataID) override;
+  bool addEvent(uint32_t dataID) override;
+  bool isEmpty() const override;
+
+private:
+  struct Cell
+  {
+    std::atomic<size_t> m_sequence;
+    uint32_t m_dataID;
+  };
+
+  void park(double timeout);
+  void wake();
+
+  const size_t m_mask;
+  std::unique_ptr<Cell[]> m_cells;
+
+  // producers and the consumer touch these from different threads, so
+  // keep them on separate cache lines
+  alignas(64) std::atomic<size_t> m_tail = 0;
+  alignas(64) std::atomic<size_t> m_head = 0;
+  alignas(64) std::atomic<bool> m_parked = false;
+
+  int m_wakeFd = -1;
+  ArchMutex m_parkMutex = nullptr;
+  ArchCond m_parkCond = nullptr;
+};
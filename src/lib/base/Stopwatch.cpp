@@ -6,7 +6,6 @@
  */
 
 #include "base/Stopwatch.h"
-#include "arch/Arch.h"
 
 //
 // Stopwatch
@@ -15,21 +14,21 @@
 Stopwatch::Stopwatch(bool triggered) : m_triggered(triggered), m_stopped(triggered)
 {
   if (!triggered) {
-    m_mark = Arch::time();
+    m_mark = now();
   }
 }
 
 double Stopwatch::reset()
 {
   if (m_stopped) {
-    const double dt = m_mark;
-    m_mark = 0.0;
-    return dt;
+    const auto dt = m_mark;
+    m_mark = MonotonicClock::duration{0};
+    return MonotonicClock::toSeconds(dt);
   } else {
-    const double t = Arch::time();
-    const double dt = t - m_mark;
+    const auto t = now();
+    const auto dt = t - m_mark;
     m_mark = t;
-    return dt;
+    return MonotonicClock::toSeconds(dt);
   }
 }
 
@@ -40,7 +39,7 @@ void Stopwatch::stop()
   }
 
   // save the elapsed time
-  m_mark = Arch::time() - m_mark;
+  m_mark = now() - m_mark;
   m_stopped = true;
 }
 
@@ -52,7 +51,7 @@ void Stopwatch::start()
   }
 
   // set the mark such that it reports the time elapsed at stop()
-  m_mark = Arch::time() - m_mark;
+  m_mark = now() - m_mark;
   m_stopped = false;
 }
 
@@ -63,15 +62,20 @@ void Stopwatch::setTrigger()
 }
 
 double Stopwatch::getTime()
+{
+  return MonotonicClock::toSeconds(getElapsed());
+}
+
+MonotonicClock::duration Stopwatch::getElapsed()
 {
   if (m_triggered) {
-    const double dt = m_mark;
+    const auto dt = m_mark;
     start();
     return dt;
   } else if (m_stopped) {
     return m_mark;
   } else {
-    return Arch::time() - m_mark;
+    return now() - m_mark;
   }
 }
 
@@ -81,10 +85,20 @@ bool Stopwatch::isStopped() const
 }
 
 double Stopwatch::getTime() const
+{
+  return MonotonicClock::toSeconds(getElapsed());
+}
+
+MonotonicClock::duration Stopwatch::getElapsed() const
 {
   if (m_stopped) {
     return m_mark;
   } else {
-    return Arch::time() - m_mark;
+    return now() - m_mark;
   }
 }
+
+MonotonicClock::duration Stopwatch::now()
+{
+  return MonotonicClock::now().time_since_epoch();
+}
@@ -7,10 +7,13 @@
 
 #pragma once
 
+#include "arch/MonotonicClock.h"
+
 //! A timer class
 /*!
 This class measures time intervals.  All time interval measurement
-should use this class.
+should use this class.  Time is kept in integer \c MonotonicClock
+ticks, so it is unaffected by changes to the wall clock.
 */
 class Stopwatch
 {
@@ -64,6 +67,13 @@ public:
   returns zero if the trigger is set).
   */
   double getTime();
+
+  //! Get elapsed ticks
+  /*!
+  Same as \c getTime() but returns integer clock ticks, which keep
+  full precision for sub-millisecond measurements.
+  */
+  MonotonicClock::duration getElapsed();
   //@}
   //! @name accessors
   //@{
@@ -81,13 +91,19 @@ public:
   stopwatch to start and will not clear the trigger.
   */
   double getTime() const;
+
+  //! Get elapsed ticks
+  /*!
+  Same as \c getTime() but returns integer clock ticks.
+  */
+  MonotonicClock::duration getElapsed() const;
   //@}
 
 private:
-  double getClock() const;
+  static MonotonicClock::duration now();
 
-private:
-  double m_mark = 0.0;
+  // the start time while running, the elapsed time while stopped
+  MonotonicClock::duration m_mark{0};
   bool m_triggered = false;
   bool m_stopped = false;
 };
@@ -23,6 +23,7 @@
 #include "deskflow/Screen.h"
 #include "deskflow/StreamChunker.h"
 #include "deskflow/ipc/CoreIpc.h"
+#include "io/ConnectionStats.h"
 #include "net/IDataSocket.h"
 #include "net/ISocketFactory.h"
 #include "net/SecureSocket.h"
@@ -33,6 +34,10 @@
 #include <cstdlib>
 #include <cstring>
 
+// how long to wait for a connection attempt before also trying the next
+// address, as recommended by RFC 8305
+static const double s_attemptDelay = 0.25;
+
 //
 // Client
 //
@@ -58,6 +63,7 @@ Client::Client(
       m_serverAddress(address),
       m_socketFactory(socketFactory),
       m_screen(screen),
+      m_resolver(events),
       m_events(events),
       m_useSecureNetwork(Settings::value(Settings::Security::TlsEnabled).toBool()),
       m_maximumClipboardReceiveSize(
@@ -70,12 +76,14 @@ Client::Client(
   // register suspend/resume event handlers
   m_events->addHandler(EventTypes::ScreenSuspend, getEventTarget(), [this](const auto &) { handleSuspend(); });
   m_events->addHandler(EventTypes::ScreenResume, getEventTarget(), [this](const auto &) { handleResume(); });
+  m_events->addHandler(EventTypes::HostResolved, getEventTarget(), [this](const auto &e) { handleResolved(e); });
 }
 
 Client::~Client()
 {
   m_events->removeHandler(EventTypes::ScreenSuspend, getEventTarget());
   m_events->removeHandler(EventTypes::ScreenResume, getEventTarget());
+  m_events->removeHandler(EventTypes::HostResolved, getEventTarget());
 
   cleanupTimer();
   cleanupScreen();
@@ -89,9 +97,9 @@ void Client::setServerAddress(const NetworkAddress &address)
   m_serverAddress = address;
 }
 
-void Client::connect(size_t addressIndex)
+void Client::connect()
 {
-  if (m_stream != nullptr) {
+  if (m_stream != nullptr || isConnecting()) {
     return;
   }
   if (m_suspended) {
@@ -99,46 +107,13 @@ void Client::connect(size_t addressIndex)
     return;
   }
 
-  auto securityLevel = m_useSecureNetwork ? SecurityLevel::PeerAuth : SecurityLevel::PlainText;
-
-  try {
-    // resolve the server hostname.  do this every time we connect
-    // in case we couldn't resolve the address earlier or the address
-    // has changed (which can happen frequently if this is a laptop
-    // being shuttled between various networks).  patch by Brent
-    // Priddy.
-    m_resolvedAddressesCount = m_serverAddress.resolve(addressIndex);
-
-    // m_serverAddress will be null if the hostname address is not reolved
-    if (m_serverAddress.getAddress() != nullptr) {
-      // to help users troubleshoot, show server host name (issue: 60)
-      LOG_DEBUG(
-          "connecting to '%s': %s:%i", m_serverAddress.getHostname().c_str(),
-          ARCH->addrToString(m_serverAddress.getAddress()).c_str(), m_serverAddress.getPort()
-      );
-      ipcSendConnectionState(deskflow::core::ConnectionState::Connecting);
-    }
-
-    // create the socket
-    IDataSocket *socket = m_socketFactory->create(ARCH->getAddrFamily(m_serverAddress.getAddress()), securityLevel);
-    bindNetworkInterface(socket);
-
-    // filter socket messages, including a packetizing filter
-    m_stream = new PacketStreamFilter(m_events, socket, true);
-
-    // connect
-    LOG_VERBOSE("connecting to server");
-    setupConnecting();
-    setupTimer();
-    socket->connect(m_serverAddress);
-  } catch (BaseException &e) {
-    cleanupTimer();
-    cleanupConnecting();
-    cleanupStream();
-    LOG_VERBOSE("connection failed");
-    sendConnectionFailedEvent(e.what());
-    return;
-  }
+  // resolve the server hostname.  do this every time we connect
+  // in case we couldn't resolve the address earlier or the address
+  // has changed (which can happen frequently if this is a laptop
+  // being shuttled between various networks).  patch by Brent
+  // Priddy.  the resolver caches results briefly and doesn't block.
+  m_resolving = true;
+  m_resolver.resolve(m_serverAddress, getEventTarget());
 }
 
 void Client::disconnect(const char *msg)
@@ -184,7 +159,7 @@ bool Client::isConnected() const
 
 bool Client::isConnecting() const
 {
-  return (m_timer != nullptr);
+  return (m_timer != nullptr || m_resolving);
 }
 
 NetworkAddress Client::getServerAddress() const
@@ -423,21 +398,87 @@ void Client::sendConnectionFailedEvent(const char *msg)
   m_events->addEvent(std::move(event));
 }
 
-void Client::setupConnecting()
+void Client::startAttempt()
 {
-  assert(m_stream != nullptr);
+  const auto securityLevel = m_useSecureNetwork ? SecurityLevel::PeerAuth : SecurityLevel::PlainText;
+
+  // start an attempt on the next address that we can create a socket for
+  while (!m_unattempted.empty()) {
+    const NetworkAddress address = m_unattempted.front();
+    m_unattempted.pop_front();
+
+    // to help users troubleshoot, show server host name (issue: 60)
+    LOG_DEBUG(
+        "connecting to '%s': %s:%i", address.getHostname().c_str(), ARCH->addrToString(address.getAddress()).c_str(),
+        address.getPort()
+    );
+
+    IDataSocket *socket = nullptr;
+    deskflow::IStream *stream = nullptr;
+    try {
+      // create the socket
+      socket = m_socketFactory->create(ARCH->getAddrFamily(address.getAddress()), securityLevel);
+      bindNetworkInterface(socket);
+
+      // filter socket messages, including a packetizing filter
+      stream = new PacketStreamFilter(m_events, socket, true);
+      if (auto *stats = stream->getConnectionStats(); stats != nullptr) {
+        stats->setName("server " + address.getHostname());
+      }
+
+      // connect
+      m_attempts.push_back(stream);
+      setupConnecting(stream);
+      socket->connect(address);
+      break;
+    } catch (BaseException &e) {
+      LOG_DEBUG("connection attempt failed: %s", e.what());
+      m_attemptError = e.what();
+      if (stream != nullptr) {
+        cleanupAttempt(stream);
+      } else {
+        delete socket;
+      }
+    }
+  }
+
+  if (m_attempts.empty()) {
+    failConnecting(m_attemptError.c_str());
+  } else if (!m_unattempted.empty() && m_attemptTimer == nullptr) {
+    // try the next address too if this attempt is slow
+    m_attemptTimer = m_events->newOneShotTimer(s_attemptDelay, nullptr);
+    m_events->addHandler(EventTypes::Timer, m_attemptTimer, [this](const auto &) { handleAttemptDelay(); });
+  }
+}
+
+void Client::failConnecting(const char *msg)
+{
+  // copy the message, cleaning up may free it
+  const std::string what = msg;
+  cleanupTimer();
+  cleanupConnecting();
+
+  // the cached addresses may be stale
+  m_resolver.forget(m_serverAddress);
+  LOG_VERBOSE("connection failed");
+  sendConnectionFailedEvent(what.c_str());
+}
+
+void Client::setupConnecting(deskflow::IStream *stream)
+{
+  assert(stream != nullptr);
 
   if (Settings::value(Settings::Security::TlsEnabled).toBool()) {
-    m_events->addHandler(EventTypes::DataSocketSecureConnected, m_stream->getEventTarget(), [this](const auto &) {
-      handleConnected();
+    m_events->addHandler(EventTypes::DataSocketSecureConnected, stream->getEventTarget(), [this, stream](const auto &) {
+      handleConnected(stream);
     });
   } else {
-    m_events->addHandler(EventTypes::DataSocketConnected, m_stream->getEventTarget(), [this](const auto &) {
-      handleConnected();
+    m_events->addHandler(EventTypes::DataSocketConnected, stream->getEventTarget(), [this, stream](const auto &) {
+      handleConnected(stream);
     });
   }
-  m_events->addHandler(EventTypes::DataSocketConnectionFailed, m_stream->getEventTarget(), [this](const auto &e) {
-    handleConnectionFailed(e);
+  m_events->addHandler(EventTypes::DataSocketConnectionFailed, stream->getEventTarget(), [this, stream](const auto &e) {
+    handleConnectionFailed(stream, e);
   });
 }
 
@@ -465,12 +506,12 @@ void Client::setupConnection()
   });
 }
 
-void Client::setupScreen()
+void Client::setupScreen(int16_t protocolMinor)
 {
   assert(m_server == nullptr);
 
   m_ready = false;
-  m_server = new ServerProxy(this, m_stream, m_events);
+  m_server = new ServerProxy(this, m_stream, m_events, protocolMinor);
   m_events->addHandler(EventTypes::ScreenShapeChanged, getEventTarget(), [this](const auto &) {
     handleShapeChanged();
   });
@@ -497,10 +538,32 @@ void Client::cleanup()
 
 void Client::cleanupConnecting()
 {
-  if (m_stream != nullptr) {
-    m_events->removeHandler(EventTypes::DataSocketConnected, m_stream->getEventTarget());
-    m_events->removeHandler(EventTypes::DataSocketSecureConnected, m_stream->getEventTarget());
-    m_events->removeHandler(EventTypes::DataSocketConnectionFailed, m_stream->getEventTarget());
+  if (m_resolving) {
+    m_resolver.cancel(getEventTarget());
+    m_resolving = false;
+  }
+  cleanupAttemptTimer();
+  m_unattempted.clear();
+  while (!m_attempts.empty()) {
+    cleanupAttempt(m_attempts.back());
+  }
+}
+
+void Client::cleanupAttempt(deskflow::IStream *stream)
+{
+  m_events->removeHandler(EventTypes::DataSocketConnected, stream->getEventTarget());
+  m_events->removeHandler(EventTypes::DataSocketSecureConnected, stream->getEventTarget());
+  m_events->removeHandler(EventTypes::DataSocketConnectionFailed, stream->getEventTarget());
+  std::erase(m_attempts, stream);
+  delete stream;
+}
+
+void Client::cleanupAttemptTimer()
+{
+  if (m_attemptTimer != nullptr) {
+    m_events->removeHandler(EventTypes::Timer, m_attemptTimer);
+    m_events->deleteTimer(m_attemptTimer);
+    m_attemptTimer = nullptr;
   }
 }
 
@@ -547,10 +610,46 @@ void Client::cleanupStream()
   m_stream = nullptr;
 }
 
-void Client::handleConnected()
+void Client::handleResolved(const Event &event)
+{
+  // ignore results we stopped waiting for
+  const auto *result = static_cast<const HostResolver::Result *>(event.getDataObject());
+  if (!m_resolving || result == nullptr) {
+    return;
+  }
+  m_resolving = false;
+
+  if (!result->m_error.empty()) {
+    LOG_VERBOSE("connection failed");
+    sendConnectionFailedEvent(result->m_error.c_str());
+    return;
+  }
+
+  LOG_VERBOSE("connecting to server");
+  ipcSendConnectionState(deskflow::core::ConnectionState::Connecting);
+  m_unattempted.assign(result->m_addresses.begin(), result->m_addresses.end());
+  m_attemptError = "No addresses";
+  setupTimer();
+  startAttempt();
+}
+
+void Client::handleAttemptDelay()
+{
+  cleanupAttemptTimer();
+  startAttempt();
+}
+
+void Client::handleConnected(deskflow::IStream *stream)
 {
   LOG_VERBOSE("connected, waiting for hello");
+
+  // keep this attempt and abandon the others
+  std::erase(m_attempts, stream);
+  m_events->removeHandler(EventTypes::DataSocketConnected, stream->getEventTarget());
+  m_events->removeHandler(EventTypes::DataSocketSecureConnected, stream->getEventTarget());
+  m_events->removeHandler(EventTypes::DataSocketConnectionFailed, stream->getEventTarget());
   cleanupConnecting();
+  m_stream = stream;
   setupConnection();
 
   // reset clipboard state
@@ -561,16 +660,17 @@ void Client::handleConnected()
   }
 }
 
-void Client::handleConnectionFailed(const Event &event)
+void Client::handleConnectionFailed(deskflow::IStream *stream, const Event &event)
 {
   auto *info = static_cast<IDataSocket::ConnectionFailedInfo *>(event.getData());
-
-  cleanupTimer();
-  cleanupConnecting();
-  cleanupStream();
-  LOG_VERBOSE("connection failed");
-  sendConnectionFailedEvent(info->m_what.c_str());
+  LOG_DEBUG("connection attempt failed: %s", info->m_what.c_str());
+  m_attemptError = info->m_what;
   delete info;
+
+  // don't wait out the attempt delay before trying the next address
+  cleanupAttempt(stream);
+  cleanupAttemptTimer();
+  startAttempt();
 }
 
 void Client::handleConnectTimeout()
@@ -579,6 +679,7 @@ void Client::handleConnectTimeout()
   cleanupConnecting();
   cleanupConnection();
   cleanupStream();
+  m_resolver.forget(m_serverAddress);
   LOG_VERBOSE("connection timed out");
   sendConnectionFailedEvent("Timed out");
 }
@@ -690,8 +791,13 @@ void Client::handleHello()
   std::string helloBackMessage = protocolName + kMsgHelloBackArgs;
   ProtocolUtil::writef(m_stream, helloBackMessage.c_str(), kProtocolMajorVersion, helloBackMinor, &m_name);
 
+  // the server accepts compressed packets once it has read the hello back
+  if (helloBackMinor >= kCompressionMinorVersion) {
+    m_stream->setCompression(true);
+  }
+
   // now connected but waiting to complete handshake
-  setupScreen();
+  setupScreen(helloBackMinor);
   cleanupTimer();
 
   // make sure we process any remaining messages later.  we won't
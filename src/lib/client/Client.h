@@ -14,10 +14,13 @@
 #include "base/EventTypes.h"
 #include "common/Enums.h"
 #include "deskflow/IClipboard.h"
+#include "net/HostResolver.h"
 #include "net/NetworkAddress.h"
 
 #include <climits>
+#include <deque>
 #include <string>
+#include <vector>
 
 class Event;
 class EventQueueTimer;
@@ -108,9 +111,11 @@ public:
   //! Connect to server
   /*!
   Starts an attempt to connect to the server.  This is ignored if
-  the client is trying to connect or is already connected.
+  the client is trying to connect or is already connected.  The server's
+  host name is resolved in the background and, if it has several
+  addresses, they are tried in turn with staggered, overlapping attempts.
   */
-  void connect(size_t addressIndex = 0);
+  void connect();
   void setServerAddress(const NetworkAddress &address);
 
   //! Disconnect
@@ -156,11 +161,6 @@ public:
   */
   NetworkAddress getServerAddress() const;
 
-  //! Return last resolved adresses count
-  size_t getLastResolvedAddressesCount() const
-  {
-    return m_resolvedAddressesCount;
-  }
   size_t getMaximumClipboardReceiveSizeBytes() const;
 
   //@}
@@ -195,18 +195,24 @@ private:
   void sendClipboard(ClipboardID);
   void sendEvent(deskflow::EventTypes);
   void sendConnectionFailedEvent(const char *msg);
-  void setupConnecting();
+  void startAttempt();
+  void failConnecting(const char *msg);
+  void setupConnecting(deskflow::IStream *stream);
   void setupConnection();
-  void setupScreen();
+  void setupScreen(int16_t protocolMinor);
   void setupTimer();
   void cleanup();
   void cleanupConnecting();
+  void cleanupAttempt(deskflow::IStream *stream);
+  void cleanupAttemptTimer();
   void cleanupConnection();
   void cleanupScreen();
   void cleanupTimer();
   void cleanupStream();
-  void handleConnected();
-  void handleConnectionFailed(const Event &event);
+  void handleResolved(const Event &event);
+  void handleAttemptDelay();
+  void handleConnected(deskflow::IStream *stream);
+  void handleConnectionFailed(deskflow::IStream *stream, const Event &event);
   void handleConnectTimeout();
   void handleOutputError();
   void handleDisconnected();
@@ -226,6 +232,12 @@ private:
   deskflow::Screen *m_screen = nullptr;
   deskflow::IStream *m_stream = nullptr;
   EventQueueTimer *m_timer = nullptr;
+  HostResolver m_resolver;
+  bool m_resolving = false;
+  std::deque<NetworkAddress> m_unattempted;
+  std::vector<deskflow::IStream *> m_attempts;
+  EventQueueTimer *m_attemptTimer = nullptr;
+  std::string m_attemptError;
   ServerProxy *m_server = nullptr;
   bool m_ready = false;
   bool m_active = false;
@@ -244,5 +256,4 @@ private:
   int32_t m_relativeRestoreY = 0;
   size_t m_maximumClipboardReceiveSize = 0;
   size_t m_maximumClipboardSize = INT_MAX;
-  size_t m_resolvedAddressesCount = 0;
 };
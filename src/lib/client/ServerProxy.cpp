@@ -15,21 +15,25 @@
 #include "deskflow/ClipboardChunk.h"
 #include "deskflow/DeskflowException.h"
 #include "deskflow/OptionTypes.h"
+#include "deskflow/ProtocolCodec.h"
 #include "deskflow/ProtocolTypes.h"
 #include "deskflow/ProtocolUtil.h"
 #include "deskflow/StreamChunker.h"
 #include "deskflow/ipc/CoreIpc.h"
+#include "io/ConnectionStats.h"
 #include "io/IStream.h"
 
 #include <cstring>
+#include <utility>
 
 //
 // ServerProxy
 //
 
-ServerProxy::ServerProxy(Client *client, deskflow::IStream *stream, IEventQueue *events)
+ServerProxy::ServerProxy(Client *client, deskflow::IStream *stream, IEventQueue *events, int16_t protocolMinor)
     : m_client(client),
       m_stream(stream),
+      m_protocolMinor(protocolMinor),
       m_events(events)
 {
   assert(m_client != nullptr);
@@ -47,13 +51,24 @@ ServerProxy::ServerProxy(Client *client, deskflow::IStream *stream, IEventQueue
     ClipboardChunk::send(m_stream, e.getDataObject());
   });
 
+  // count the connection's messages in the handler table
+  if (auto *stats = m_stream->getConnectionStats(); stats != nullptr) {
+    stats->setMessageCounter(&m_handlers);
+  }
+
   // send heartbeat
   setKeepAliveRate(kKeepAliveRate);
 }
 
 ServerProxy::~ServerProxy()
 {
+  if (!m_handlers.empty()) {
+    LOG_DEBUG("messages from server: %s", m_handlers.report().c_str());
+  }
   setKeepAliveRate(-1.0);
+  if (auto *stats = m_stream->getConnectionStats(); stats != nullptr) {
+    stats->setMessageCounter(nullptr);
+  }
   m_events->removeHandler(EventTypes::StreamInputReady, m_stream->getEventTarget());
   m_events->removeHandler(EventTypes::ClipboardSending, this);
 }
@@ -61,11 +76,8 @@ ServerProxy::~ServerProxy()
 void ServerProxy::resetKeepAliveAlarm()
 {
   if (m_keepAliveAlarmTimer != nullptr) {
-    m_events->removeHandler(EventTypes::Timer, m_keepAliveAlarmTimer);
-    m_events->deleteTimer(m_keepAliveAlarmTimer);
-    m_keepAliveAlarmTimer = nullptr;
-  }
-  if (m_keepAliveAlarm > 0.0) {
+    m_events->resetTimer(m_keepAliveAlarmTimer);
+  } else if (m_keepAliveAlarm > 0.0) {
     m_keepAliveAlarmTimer = m_events->newOneShotTimer(m_keepAliveAlarm, nullptr);
     m_events->addHandler(EventTypes::Timer, m_keepAliveAlarmTimer, [this](const auto &) { handleKeepAliveAlarm(); });
   }
@@ -73,12 +85,21 @@ void ServerProxy::resetKeepAliveAlarm()
 
 void ServerProxy::setKeepAliveRate(double rate)
 {
+  // the alarm duration changes so the timer has to be replaced
+  if (m_keepAliveAlarmTimer != nullptr) {
+    m_events->removeHandler(EventTypes::Timer, m_keepAliveAlarmTimer);
+    m_events->deleteTimer(m_keepAliveAlarmTimer);
+    m_keepAliveAlarmTimer = nullptr;
+  }
   m_keepAliveAlarm = rate * kKeepAlivesUntilDeath;
   resetKeepAliveAlarm();
 }
 
 void ServerProxy::handleData()
 {
+  // input latency counts the time from here to injection as queueing
+  m_readTime = MonotonicClock::now();
+
   // handle messages until there are no more.  first read message code.
   uint8_t code[4];
   uint32_t n = m_stream->read(code, 4);
@@ -140,6 +161,7 @@ ServerProxy::ConnectionResult ServerProxy::parseHandshakeMessage(const uint8_t *
     setOptions();
 
     // handshake is complete
+    addMessageHandlers();
     m_parser = &ServerProxy::parseMessage;
 
     if (const auto missedKeyboardLayouts = m_layoutManager.getMissedLayouts(); !missedKeyboardLayouts.empty()) {
@@ -156,7 +178,7 @@ ServerProxy::ConnectionResult ServerProxy::parseHandshakeMessage(const uint8_t *
 
   else if (memcmp(code, kMsgCKeepAlive, 4) == 0) {
     // echo keep alives and reset alarm
-    ProtocolUtil::writef(m_stream, kMsgCKeepAlive);
+    deskflow::protocol::KeepAlive::write(m_stream);
     resetKeepAliveAlarm();
   }
 
@@ -209,129 +231,116 @@ ServerProxy::ConnectionResult ServerProxy::parseMessage(const uint8_t *code)
 {
   using enum ConnectionResult;
 
-  if (memcmp(code, kMsgDMouseMove, 4) == 0) {
-    mouseMove();
+  const auto *handler = m_handlers.find(code);
+  if (handler == nullptr) {
+    return Unknown;
   }
-
-  else if (memcmp(code, kMsgDMouseRelMove, 4) == 0) {
-    mouseRelativeMove();
+  if (const auto result = (*handler)(); result != Okay) {
+    return result;
   }
 
-  else if (memcmp(code, kMsgDMouseWheel, 4) == 0) {
-    mouseWheel();
+  // send a reply.  this is intended to work around a delay when
+  // running a linux server and an OS X (any BSD?) client.  the
+  // client waits to send an ACK (if the system control flag
+  // net.inet.tcp.delayed_ack is 1) in hopes of piggybacking it
+  // on a data packet.  we provide that packet here.  i don't
+  // know why a delayed ACK should cause the server to wait since
+  // TCP_NODELAY is enabled.
+  deskflow::protocol::Noop::write(m_stream);
+
+  return Okay;
+}
+
+void ServerProxy::addMessageHandlers()
+{
+  using enum ConnectionResult;
+
+  // most messages only need their handler called
+  const auto add = [this](const char *code, void (ServerProxy::*handler)()) {
+    m_handlers.add(code, [this, handler] {
+      (this->*handler)();
+      return Okay;
+    });
+  };
+
+  m_handlers.clear();
+  add(kMsgDMouseMove, &ServerProxy::mouseMove);
+  add(kMsgDMouseRelMove, &ServerProxy::mouseRelativeMove);
+  add(kMsgDMouseWheel, &ServerProxy::mouseWheel);
+  add(kMsgDKeyUp, &ServerProxy::keyUp);
+  add(kMsgDMouseDown, &ServerProxy::mouseDown);
+  add(kMsgDMouseUp, &ServerProxy::mouseUp);
+  add(kMsgDKeyRepeat, &ServerProxy::keyRepeat);
+  add(kMsgCEnter, &ServerProxy::enter);
+  add(kMsgCLeave, &ServerProxy::leave);
+  add(kMsgCClipboard, &ServerProxy::grabClipboard);
+  add(kMsgCScreenSaver, &ServerProxy::screensaver);
+  add(kMsgQInfo, &ServerProxy::queryInfo);
+  add(kMsgCInfoAck, &ServerProxy::infoAcknowledgment);
+  add(kMsgDClipboard, &ServerProxy::setClipboard);
+  add(kMsgCResetOptions, &ServerProxy::resetOptions);
+  add(kMsgDSetOptions, &ServerProxy::setOptions);
+  add(kMsgDSecureInputNotification, &ServerProxy::secureInputNotification);
+
+  // an older protocol has no such messages, so they are treated as unknown
+  if (m_protocolMinor >= kInputBatchMinorVersion) {
+    add(kMsgDInputBatch, &ServerProxy::inputBatch);
+  }
+  if (m_protocolMinor >= kInputLatencyMinorVersion) {
+    add(kMsgDClock, &ServerProxy::clock);
   }
 
-  else if (memcmp(code, kMsgDKeyDown, 4) == 0) {
+  m_handlers.add(kMsgDKeyDown, [this] {
     uint16_t id = 0;
     uint16_t mask = 0;
     uint16_t button = 0;
-    ProtocolUtil::readf(m_stream, kMsgDKeyDown + 4, &id, &mask, &button);
+    deskflow::protocol::KeyDown::read(m_stream, id, mask, button);
     LOG_VERBOSE("recv key down id=0x%08x, mask=0x%04x, button=0x%04x", id, mask, button);
 
     keyDown(id, mask, button, "");
-  }
+    return Okay;
+  });
 
-  else if (memcmp(code, kMsgDKeyDownLang, 4) == 0) {
+  m_handlers.add(kMsgDKeyDownLang, [this] {
     std::string lang;
     uint16_t id = 0;
     uint16_t mask = 0;
     uint16_t button = 0;
 
-    ProtocolUtil::readf(m_stream, kMsgDKeyDownLang + 4, &id, &mask, &button, &lang);
+    deskflow::protocol::KeyDownLang::read(m_stream, id, mask, button, lang);
     LOG_VERBOSE("recv key down id=0x%08x, mask=0x%04x, button=0x%04x, lang=\"%s\"", id, mask, button, lang.c_str());
 
     keyDown(id, mask, button, lang);
-  }
-
-  else if (memcmp(code, kMsgDKeyUp, 4) == 0) {
-    keyUp();
-  }
-
-  else if (memcmp(code, kMsgDMouseDown, 4) == 0) {
-    mouseDown();
-  }
-
-  else if (memcmp(code, kMsgDMouseUp, 4) == 0) {
-    mouseUp();
-  }
-
-  else if (memcmp(code, kMsgDKeyRepeat, 4) == 0) {
-    keyRepeat();
-  }
+    return Okay;
+  });
 
-  else if (memcmp(code, kMsgCKeepAlive, 4) == 0) {
+  m_handlers.add(kMsgCKeepAlive, [this] {
     // echo keep alives and reset alarm
-    ProtocolUtil::writef(m_stream, kMsgCKeepAlive);
+    deskflow::protocol::KeepAlive::write(m_stream);
     resetKeepAliveAlarm();
-  }
+    if (m_protocolMinor >= kInputLatencyMinorVersion) {
+      queryClock();
+    }
+    return Okay;
+  });
 
-  else if (memcmp(code, kMsgCNoop, 4) == 0) {
+  m_handlers.add(kMsgCNoop, [] {
     // accept and discard no-op
-  }
-
-  else if (memcmp(code, kMsgCEnter, 4) == 0) {
-    enter();
-  }
-
-  else if (memcmp(code, kMsgCLeave, 4) == 0) {
-    leave();
-  }
-
-  else if (memcmp(code, kMsgCClipboard, 4) == 0) {
-    grabClipboard();
-  }
-
-  else if (memcmp(code, kMsgCScreenSaver, 4) == 0) {
-    screensaver();
-  }
-
-  else if (memcmp(code, kMsgQInfo, 4) == 0) {
-    queryInfo();
-  }
-
-  else if (memcmp(code, kMsgCInfoAck, 4) == 0) {
-    infoAcknowledgment();
-  }
-
-  else if (memcmp(code, kMsgDClipboard, 4) == 0) {
-    setClipboard();
-  }
-
-  else if (memcmp(code, kMsgCResetOptions, 4) == 0) {
-    resetOptions();
-  }
-
-  else if (memcmp(code, kMsgDSetOptions, 4) == 0) {
-    setOptions();
-  }
-
-  else if (memcmp(code, kMsgDSecureInputNotification, 4) == 0) {
-    secureInputNotification();
-  }
+    return Okay;
+  });
 
-  else if (memcmp(code, kMsgCClose, 4) == 0) {
+  m_handlers.add(kMsgCClose, [this] {
     // server wants us to hangup
     LOG_VERBOSE("recv close");
     requestDisconnect(nullptr);
     return Disconnect;
-  } else if (memcmp(code, kMsgEBad, 4) == 0) {
+  });
+
+  m_handlers.add(kMsgEBad, [this] {
     LOG_ERR("server disconnected due to a protocol error");
     requestDisconnect("server reported a protocol error");
     return Disconnect;
-  } else {
-    return Unknown;
-  }
-
-  // send a reply.  this is intended to work around a delay when
-  // running a linux server and an OS X (any BSD?) client.  the
-  // client waits to send an ACK (if the system control flag
-  // net.inet.tcp.delayed_ack is 1) in hopes of piggybacking it
-  // on a data packet.  we provide that packet here.  i don't
-  // know why a delayed ACK should cause the server to wait since
-  // TCP_NODELAY is enabled.
-  ProtocolUtil::writef(m_stream, kMsgCNoop);
-
-  return Okay;
+  });
 }
 
 void ServerProxy::handleKeepAliveAlarm()
@@ -380,20 +389,41 @@ void ServerProxy::onClipboardChanged(ClipboardID id, const IClipboard *clipboard
   StreamChunker::sendClipboard(data, data.size(), id, m_seqNum, m_events, this);
 }
 
+template <typename Forward> void ServerProxy::inject(std::optional<uint32_t> captured, Forward forward)
+{
+  if (!captured.has_value()) {
+    forward();
+    return;
+  }
+  const auto start = MonotonicClock::now();
+  forward();
+  m_latency.record(*captured, m_readTime, start, MonotonicClock::now(), m_stream->getConnectionStats());
+}
+
 void ServerProxy::flushCompressedMouse()
 {
   if (m_compressMouse) {
     m_compressMouse = false;
-    m_client->mouseMove(m_xMouse, m_yMouse);
+    inject(std::exchange(m_motionCapture, std::nullopt), [this] { m_client->mouseMove(m_xMouse, m_yMouse); });
   }
   if (m_compressMouseRelative) {
     m_compressMouseRelative = false;
-    m_client->mouseRelativeMove(m_dxMouse, m_dyMouse);
+    inject(std::exchange(m_motionCapture, std::nullopt), [this] {
+      m_client->mouseRelativeMove(m_dxMouse, m_dyMouse);
+    });
     m_dxMouse = 0;
     m_dyMouse = 0;
   }
 }
 
+void ServerProxy::queryClock()
+{
+  deskflow::protocol::QueryClock::write(m_stream, deskflow::InputRecords::toTime(MonotonicClock::now()));
+  if (const auto report = m_latency.takeReport(); !report.empty()) {
+    deskflow::protocol::LatencyReport::write(m_stream, report);
+  }
+}
+
 void ServerProxy::sendInfo(const ClientInfo &info)
 {
   LOG_VERBOSE("sending info shape=%d,%d %dx%d", info.m_x, info.m_y, info.m_w, info.m_h);
@@ -512,7 +542,7 @@ void ServerProxy::enter()
   int16_t y;
   uint16_t mask;
   uint32_t seqNum;
-  ProtocolUtil::readf(m_stream, kMsgCEnter + 4, &x, &y, &seqNum, &mask);
+  deskflow::protocol::Enter::read(m_stream, x, y, seqNum, mask);
   LOG_VERBOSE("recv enter, %d,%d %d %04x", x, y, seqNum, mask);
 
   // discard old compressed mouse motion, if any
@@ -520,6 +550,7 @@ void ServerProxy::enter()
   m_compressMouseRelative = false;
   m_dxMouse = 0;
   m_dyMouse = 0;
+  m_motionCapture.reset();
   m_seqNum = seqNum;
   m_serverLayout = "";
   m_isUserNotifiedAboutLayoutSyncError = false;
@@ -599,27 +630,32 @@ void ServerProxy::keyDown(uint16_t id, uint16_t mask, uint16_t button, const std
     LOG_VERBOSE("key down translated to id=0x%08x, mask=0x%04x", id2, mask2);
 
   // forward
-  m_client->keyDown(id2, mask2, button, lang);
+  inject(m_inputCapture, [&] { m_client->keyDown(id2, mask2, button, lang); });
 }
 
 void ServerProxy::keyRepeat()
 {
-  // get mouse up to date
-  flushCompressedMouse();
-
   // parse
   uint16_t id;
   uint16_t mask;
   uint16_t count;
   uint16_t button;
   std::string lang;
-  ProtocolUtil::readf(m_stream, kMsgDKeyRepeat + 4, &id, &mask, &count, &button, &lang);
+  deskflow::protocol::KeyRepeat::read(m_stream, id, mask, count, button, lang);
   LOG(
       (CLOG_VERBOSE "recv key repeat id=0x%08x, mask=0x%04x, count=%d, "
                     "button=0x%04x, lang=\"%s\"",
        id, mask, count, button, lang.c_str())
   );
 
+  keyRepeat(id, mask, count, button, lang);
+}
+
+void ServerProxy::keyRepeat(uint16_t id, uint16_t mask, uint16_t count, uint16_t button, const std::string &lang)
+{
+  // get mouse up to date
+  flushCompressedMouse();
+
   // translate
   KeyID id2 = translateKey(static_cast<KeyID>(id));
   KeyModifierMask mask2 = translateModifierMask(static_cast<KeyModifierMask>(mask));
@@ -627,21 +663,26 @@ void ServerProxy::keyRepeat()
     LOG_VERBOSE("key repeat translated to id=0x%08x, mask=0x%04x", id2, mask2);
 
   // forward
-  m_client->keyRepeat(id2, mask2, count, button, lang);
+  inject(m_inputCapture, [&] { m_client->keyRepeat(id2, mask2, count, button, lang); });
 }
 
 void ServerProxy::keyUp()
 {
-  // get mouse up to date
-  flushCompressedMouse();
-
   // parse
   uint16_t id;
   uint16_t mask;
   uint16_t button;
-  ProtocolUtil::readf(m_stream, kMsgDKeyUp + 4, &id, &mask, &button);
+  deskflow::protocol::KeyUp::read(m_stream, id, mask, button);
   LOG_VERBOSE("recv key up id=0x%08x, mask=0x%04x, button=0x%04x", id, mask, button);
 
+  keyUp(id, mask, button);
+}
+
+void ServerProxy::keyUp(uint16_t id, uint16_t mask, uint16_t button)
+{
+  // get mouse up to date
+  flushCompressedMouse();
+
   // translate
   KeyID id2 = translateKey(static_cast<KeyID>(id));
   KeyModifierMask mask2 = translateModifierMask(static_cast<KeyModifierMask>(mask));
@@ -649,50 +690,64 @@ void ServerProxy::keyUp()
     LOG_VERBOSE("key up translated to id=0x%08x, mask=0x%04x", id2, mask2);
 
   // forward
-  m_client->keyUp(id2, mask2, button);
+  inject(m_inputCapture, [&] { m_client->keyUp(id2, mask2, button); });
 }
 
 void ServerProxy::mouseDown()
 {
-  // get mouse up to date
-  flushCompressedMouse();
-
   // parse
   int8_t id;
-  ProtocolUtil::readf(m_stream, kMsgDMouseDown + 4, &id);
+  deskflow::protocol::MouseDown::read(m_stream, id);
   LOG_VERBOSE("recv mouse down id=%d", id);
 
-  // forward
-  m_client->mouseDown(static_cast<ButtonID>(id));
+  mouseDown(static_cast<ButtonID>(id));
 }
 
-void ServerProxy::mouseUp()
+void ServerProxy::mouseDown(ButtonID id)
 {
   // get mouse up to date
   flushCompressedMouse();
 
+  // forward
+  inject(m_inputCapture, [&] { m_client->mouseDown(id); });
+}
+
+void ServerProxy::mouseUp()
+{
   // parse
   int8_t id;
-  ProtocolUtil::readf(m_stream, kMsgDMouseUp + 4, &id);
+  deskflow::protocol::MouseUp::read(m_stream, id);
   LOG_VERBOSE("recv mouse up id=%d", id);
 
+  mouseUp(static_cast<ButtonID>(id));
+}
+
+void ServerProxy::mouseUp(ButtonID id)
+{
+  // get mouse up to date
+  flushCompressedMouse();
+
   // forward
-  m_client->mouseUp(static_cast<ButtonID>(id));
+  inject(m_inputCapture, [&] { m_client->mouseUp(id); });
 }
 
 void ServerProxy::mouseMove()
 {
   // parse
-  bool ignore;
   int16_t x;
   int16_t y;
-  ProtocolUtil::readf(m_stream, kMsgDMouseMove + 4, &x, &y);
+  deskflow::protocol::MouseMove::read(m_stream, x, y);
 
+  mouseMove(x, y, m_stream->isReady());
+}
+
+void ServerProxy::mouseMove(int32_t x, int32_t y, bool moreInput)
+{
   // note if we should ignore the move
-  ignore = m_ignoreMouse;
+  bool ignore = m_ignoreMouse;
 
   // compress mouse motion events if more input follows
-  if (!ignore && !m_compressMouse && m_stream->isReady()) {
+  if (!ignore && !m_compressMouse && moreInput) {
     m_compressMouse = true;
   }
 
@@ -704,28 +759,33 @@ void ServerProxy::mouseMove()
     m_yMouse = y;
     m_dxMouse = 0;
     m_dyMouse = 0;
+    m_motionCapture = m_inputCapture;
   }
   LOG_VERBOSE("recv mouse move %d,%d", x, y);
 
   // forward
   if (!ignore) {
-    m_client->mouseMove(x, y);
+    inject(m_inputCapture, [&] { m_client->mouseMove(x, y); });
   }
 }
 
 void ServerProxy::mouseRelativeMove()
 {
   // parse
-  bool ignore;
   int16_t dx;
   int16_t dy;
-  ProtocolUtil::readf(m_stream, kMsgDMouseRelMove + 4, &dx, &dy);
+  deskflow::protocol::MouseRelMove::read(m_stream, dx, dy);
 
+  mouseRelativeMove(dx, dy, m_stream->isReady());
+}
+
+void ServerProxy::mouseRelativeMove(int32_t dx, int32_t dy, bool moreInput)
+{
   // note if we should ignore the move
-  ignore = m_ignoreMouse;
+  bool ignore = m_ignoreMouse;
 
   // compress mouse motion events if more input follows
-  if (!ignore && !m_compressMouseRelative && m_stream->isReady()) {
+  if (!ignore && !m_compressMouseRelative && moreInput) {
     m_compressMouseRelative = true;
   }
 
@@ -734,28 +794,117 @@ void ServerProxy::mouseRelativeMove()
     ignore = true;
     m_dxMouse += dx;
     m_dyMouse += dy;
+    m_motionCapture = m_inputCapture;
   }
   LOG_VERBOSE("recv mouse relative move %d,%d", dx, dy);
 
   // forward
   if (!ignore) {
-    m_client->mouseRelativeMove(dx, dy);
+    inject(m_inputCapture, [&] { m_client->mouseRelativeMove(dx, dy); });
   }
 }
 
 void ServerProxy::mouseWheel()
 {
-  // get mouse up to date
-  flushCompressedMouse();
-
   // parse
   int16_t xDelta;
   int16_t yDelta;
-  ProtocolUtil::readf(m_stream, kMsgDMouseWheel + 4, &xDelta, &yDelta);
+  deskflow::protocol::MouseWheel::read(m_stream, xDelta, yDelta);
   LOG_VERBOSE("recv mouse wheel %+d,%+d", xDelta, yDelta);
 
+  mouseWheel(xDelta, yDelta);
+}
+
+void ServerProxy::mouseWheel(int32_t xDelta, int32_t yDelta)
+{
+  // get mouse up to date
+  flushCompressedMouse();
+
   // forward
-  m_client->mouseWheel(xDelta, yDelta);
+  inject(m_inputCapture, [&] { m_client->mouseWheel(xDelta, yDelta); });
+}
+
+void ServerProxy::inputBatch()
+{
+  using enum deskflow::InputRecords::Record::Type;
+
+  // parse
+  uint32_t base;
+  std::string records;
+  deskflow::protocol::InputBatch::read(m_stream, base, records);
+  if (!deskflow::InputRecords::decode(base, records, m_inputBatch)) {
+    throw BadClientException("invalid input batch");
+  }
+  LOG_VERBOSE("recv %d input events", static_cast<int>(m_inputBatch.size()));
+
+  // forward each event as if it had its own message
+  for (size_t i = 0; i < m_inputBatch.size(); ++i) {
+    const auto &record = m_inputBatch[i];
+    m_inputCapture = record.m_time;
+    const bool moreInput = i + 1 < m_inputBatch.size() || m_stream->isReady();
+    const auto id = static_cast<uint16_t>(record.m_id);
+    const auto mask = static_cast<uint16_t>(record.m_mask);
+    const auto button = static_cast<uint16_t>(record.m_button);
+    switch (record.m_type) {
+    case MouseMove:
+      LOG_VERBOSE("recv mouse move %d,%d", record.m_x, record.m_y);
+      mouseMove(record.m_x, record.m_y, moreInput);
+      break;
+
+    case MouseRelativeMove:
+      LOG_VERBOSE("recv mouse relative move %d,%d", record.m_x, record.m_y);
+      mouseRelativeMove(record.m_x, record.m_y, moreInput);
+      break;
+
+    case MouseWheel:
+      LOG_VERBOSE("recv mouse wheel %+d,%+d", record.m_x, record.m_y);
+      mouseWheel(record.m_x, record.m_y);
+      break;
+
+    case MouseDown:
+      LOG_VERBOSE("recv mouse down id=%d", record.m_id);
+      mouseDown(static_cast<ButtonID>(record.m_id));
+      break;
+
+    case MouseUp:
+      LOG_VERBOSE("recv mouse up id=%d", record.m_id);
+      mouseUp(static_cast<ButtonID>(record.m_id));
+      break;
+
+    case KeyDown:
+      LOG(
+          (CLOG_VERBOSE "recv key down id=0x%08x, mask=0x%04x, button=0x%04x, lang=\"%s\"", id, mask, button,
+           record.m_language.c_str())
+      );
+      keyDown(id, mask, button, record.m_language);
+      break;
+
+    case KeyRepeat:
+      LOG(
+          (CLOG_VERBOSE "recv key repeat id=0x%08x, mask=0x%04x, count=%d, button=0x%04x, lang=\"%s\"", id, mask,
+           record.m_count, button, record.m_language.c_str())
+      );
+      keyRepeat(id, mask, static_cast<uint16_t>(record.m_count), button, record.m_language);
+      break;
+
+    case KeyUp:
+      LOG_VERBOSE("recv key up id=0x%08x, mask=0x%04x, button=0x%04x", id, mask, button);
+      keyUp(id, mask, button);
+      break;
+    }
+  }
+  m_inputCapture.reset();
+}
+
+void ServerProxy::clock()
+{
+  // parse
+  uint32_t sent;
+  uint32_t serverTime;
+  deskflow::protocol::Clock::read(m_stream, sent, serverTime);
+
+  m_latency.addClockSample(sent, serverTime, deskflow::InputRecords::toTime(MonotonicClock::now()));
+  LOG_VERBOSE("recv clock, offset %dms rtt %ums", m_latency.getClockOffset(), m_latency.getClockRtt());
 }
 
 void ServerProxy::screensaver()
@@ -8,11 +8,20 @@
 
 #pragma once
 
+#include "arch/MonotonicClock.h"
 #include "common/Enums.h"
 #include "deskflow/ClipboardChunk.h"
 #include "deskflow/ClipboardTypes.h"
+#include "deskflow/InputLatency.h"
+#include "deskflow/InputRecords.h"
 #include "deskflow/KeyTypes.h"
 #include "deskflow/KeyboardLayoutManager.h"
+#include "deskflow/MessageTable.h"
+#include "deskflow/MouseTypes.h"
+#include "deskflow/ProtocolTypes.h"
+
+#include <functional>
+#include <optional>
 
 class Client;
 class ClientInfo;
@@ -33,9 +42,12 @@ class ServerProxy
 public:
   /*!
   Process messages from the server on \p stream and forward to
-  \p client.
+  \p client.  \p protocolMinor is the protocol minor version agreed
+  with the server.
   */
-  ServerProxy(Client *client, deskflow::IStream *stream, IEventQueue *events);
+  ServerProxy(
+      Client *client, deskflow::IStream *stream, IEventQueue *events, int16_t protocolMinor = kProtocolMinorVersion
+  );
   ServerProxy(ServerProxy const &) = delete;
   ServerProxy(ServerProxy &&) = delete;
   ~ServerProxy();
@@ -63,9 +75,19 @@ protected:
   ConnectionResult parseMessage(const uint8_t *code);
 
 private:
+  // fill m_handlers with the messages that follow the handshake
+  void addMessageHandlers();
+
   // if compressing mouse motion then send the last motion now
   void flushCompressedMouse();
 
+  // call forward, which injects an event, measuring its latency if the
+  // server's capture time is known
+  template <typename Forward> void inject(std::optional<uint32_t> captured, Forward forward);
+
+  // send the clock query and latency report that go with a keep alive
+  void queryClock();
+
   void sendInfo(const ClientInfo &);
 
   void resetKeepAliveAlarm();
@@ -88,12 +110,21 @@ private:
   void grabClipboard();
   void keyDown(uint16_t id, uint16_t mask, uint16_t button, const std::string &lang);
   void keyRepeat();
+  void keyRepeat(uint16_t id, uint16_t mask, uint16_t count, uint16_t button, const std::string &lang);
   void keyUp();
+  void keyUp(uint16_t id, uint16_t mask, uint16_t button);
   void mouseDown();
+  void mouseDown(ButtonID id);
   void mouseUp();
+  void mouseUp(ButtonID id);
   void mouseMove();
+  void mouseMove(int32_t x, int32_t y, bool moreInput);
   void mouseRelativeMove();
+  void mouseRelativeMove(int32_t dx, int32_t dy, bool moreInput);
   void mouseWheel();
+  void mouseWheel(int32_t xDelta, int32_t yDelta);
+  void inputBatch();
+  void clock();
   void screensaver();
   void resetOptions();
   void setOptions();
@@ -105,6 +136,7 @@ private:
 
 private:
   using MessageParser = ConnectionResult (ServerProxy::*)(const uint8_t *);
+  using MessageHandler = std::function<ConnectionResult()>;
 
   Client *m_client = nullptr;
   deskflow::IStream *m_stream = nullptr;
@@ -118,6 +150,17 @@ private:
   int32_t m_dxMouse = 0;
   int32_t m_dyMouse = 0;
 
+  // decoded input batch, kept to reuse its storage
+  std::vector<deskflow::InputRecords::Record> m_inputBatch;
+
+  // input latency.  capture times are on the server's clock, for the
+  // batched event being forwarded and for the compressed motion
+  int16_t m_protocolMinor = kProtocolMinorVersion;
+  deskflow::InputLatency m_latency;
+  MonotonicClock::time_point m_readTime;
+  std::optional<uint32_t> m_inputCapture;
+  std::optional<uint32_t> m_motionCapture;
+
   bool m_ignoreMouse = false;
 
   KeyModifierID m_modifierTranslationTable[kKeyModifierIDLast];
@@ -126,6 +169,7 @@ private:
   EventQueueTimer *m_keepAliveAlarmTimer = nullptr;
 
   MessageParser m_parser = &ServerProxy::parseHandshakeMessage;
+  deskflow::MessageTable<MessageHandler> m_handlers;
   IEventQueue *m_events = nullptr;
   std::string m_serverLayout = "";
   std::string m_clipboardDataCached;
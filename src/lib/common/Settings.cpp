@@ -199,6 +199,9 @@ QVariant Settings::defaultValue(const QString &key)
   if (key == Core::Port)
     return 24800;
 
+  if (key == Core::BulkEventBudget)
+    return 5; // ms in every 10 ms
+
   if (key == Core::ProcessMode) {
 #ifdef Q_OS_WIN
     if (!Settings::isPortableMode())
@@ -231,6 +234,9 @@ QVariant Settings::defaultValue(const QString &key)
   if (key == Server::ClipboardSize)
     return 3; // 3 MiB
 
+  if (key == Server::WriteBatchDelay)
+    return 0; // us, 0 is off
+
   return QVariant();
 }
 
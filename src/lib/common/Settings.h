@@ -56,6 +56,8 @@ public:
     inline static const auto Display = QStringLiteral("core/display");
     inline static const auto UseHooks = QStringLiteral("core/useHooks");
     inline static const auto Language = QStringLiteral("core/language");
+    inline static const auto LockFreeEventQueue = QStringLiteral("core/lockFreeEventQueue");
+    inline static const auto BulkEventBudget = QStringLiteral("core/bulkEventBudget");
     inline static const auto EnableEnterCommand = QStringLiteral("core/enableEnterCommand");
     inline static const auto ScreenEnterCommand = QStringLiteral("core/enterCommand");
     inline static const auto EnableExitCommand = QStringLiteral("core/enableExitCommand");
@@ -104,6 +106,7 @@ public:
   struct Server
   {
     inline static const auto ClipboardSize = QStringLiteral("server/clipboardSize");
+    inline static const auto CoalesceMotion = QStringLiteral("server/coalesceMotion");
     inline static const auto DefaultLockToComputerState = QStringLiteral("server/defaultLockToComputerState");
     inline static const auto DisableLockToComputer = QStringLiteral("server/disableLockToComputer");
     inline static const auto EnableClipboard = QStringLiteral("server/enableClipboard");
@@ -120,6 +123,7 @@ public:
     inline static const auto SwitchDelay = QStringLiteral("server/switchDelay");
     inline static const auto SwitchDoubleTap = QStringLiteral("server/switchDoubleTap");
     inline static const auto Win32KeepForeground = QStringLiteral("server/win32KeepForeground");
+    inline static const auto WriteBatchDelay = QStringLiteral("server/writeBatchDelay");
     inline static const auto XdpRestoreToken = QStringLiteral("server/xdpRestoreToken");
   };
 
@@ -266,6 +270,8 @@ private:
     , Core::Display
     , Core::UseHooks
     , Core::Language
+    , Core::LockFreeEventQueue
+    , Core::BulkEventBudget
     , Daemon::ConfigFile
     , Daemon::Elevate
     , Daemon::LogFile
@@ -291,6 +297,7 @@ private:
     , Security::KeySize
     , Security::TlsEnabled
     , Server::ClipboardSize
+    , Server::CoalesceMotion
     , Server::DefaultLockToComputerState
     , Server::DisableLockToComputer
     , Server::EnableClipboard
@@ -307,6 +314,7 @@ private:
     , Server::SwitchDelay
     , Server::SwitchDoubleTap
     , Server::Win32KeepForeground
+    , Server::WriteBatchDelay
   };
 
   // When checking the default values this list contains the ones that default to false.
@@ -320,11 +328,13 @@ private:
     , Core::PreventSleep
     , Core::EnableEnterCommand
     , Core::EnableExitCommand
+    , Core::LockFreeEventQueue
     , Client::DynamicConnectionRetry
     , Client::InvertYScroll
     , Client::InvertXScroll
     , Log::ToFile
     , Log::GuiDebug
+    , Server::CoalesceMotion
     , Server::DefaultLockToComputerState
     , Server::DisableLockToComputer
     , Server::EnableHeatbeat
@@ -173,34 +173,22 @@ void ClientApp::handleClientConnected()
   ipcSendConnectionState(deskflow::core::ConnectionState::Connected);
   // Reset server index on successful connection
   m_currentServerIndex = 0;
-  m_lastServerAddressIndex = 0;
 }
 
 void ClientApp::handleClientFailed(const Event &e)
 {
-  if ((++m_lastServerAddressIndex) < m_client->getLastResolvedAddressesCount()) {
-    // Try next resolved address for current hostname
-    std::unique_ptr<Client::FailInfo> info(static_cast<Client::FailInfo *>(e.getData()));
+  // the client has already tried every resolved address, try next server in list
+  tryNextServer();
 
-    LOG_WARN("failed to connect to server=%s, trying next resolved address", qPrintable(info->m_what));
+  if (m_currentServerIndex == 0) {
+    // We've cycled through all servers, treat as refused
+    handleClientRefused(e);
+  } else {
+    std::unique_ptr<Client::FailInfo> info(static_cast<Client::FailInfo *>(e.getData()));
+    LOG_WARN("failed to connect to server=%s, trying next server in list", qPrintable(info->m_what));
     if (!m_suspended) {
       scheduleClientRestart(retryTime());
     }
-  } else {
-    // All resolved addresses exhausted, try next server in list
-    m_lastServerAddressIndex = 0;
-    tryNextServer();
-
-    if (m_currentServerIndex == 0) {
-      // We've cycled through all servers, treat as refused
-      handleClientRefused(e);
-    } else {
-      std::unique_ptr<Client::FailInfo> info(static_cast<Client::FailInfo *>(e.getData()));
-      LOG_WARN("failed to connect to server=%s, trying next server in list", qPrintable(info->m_what));
-      if (!m_suspended) {
-        scheduleClientRestart(retryTime());
-      }
-    }
   }
 }
 
@@ -285,7 +273,7 @@ bool ClientApp::startClient()
     }
 
     m_client->setServerAddress(getCurrentServerAddress());
-    m_client->connect(m_lastServerAddressIndex);
+    m_client->connect();
 
     return true;
   } catch (ScreenUnavailableException &e) {
@@ -94,6 +94,5 @@ private:
   deskflow::Screen *m_clientScreen = nullptr;
   QList<NetworkAddress> m_serverAddresses;
   size_t m_currentServerIndex = 0;
-  size_t m_lastServerAddressIndex = 0;
   uint m_retryCount = 0;
 };
@@ -13,51 +13,11 @@
 // IPrimaryScreen::ButtonInfo
 //
 
-IPrimaryScreen::ButtonInfo *IPrimaryScreen::ButtonInfo::alloc(ButtonID id, KeyModifierMask mask)
-{
-  auto *info = (ButtonInfo *)malloc(sizeof(ButtonInfo));
-  info->m_button = id;
-  info->m_mask = mask;
-  return info;
-}
-
-IPrimaryScreen::ButtonInfo *IPrimaryScreen::ButtonInfo::alloc(const ButtonInfo &x)
-{
-  auto *info = (ButtonInfo *)malloc(sizeof(ButtonInfo));
-  info->m_button = x.m_button;
-  info->m_mask = x.m_mask;
-  return info;
-}
-
 bool IPrimaryScreen::ButtonInfo::equal(const ButtonInfo *a, const ButtonInfo *b)
 {
   return (a->m_button == b->m_button && a->m_mask == b->m_mask);
 }
 
-//
-// IPrimaryScreen::MotionInfo
-//
-
-IPrimaryScreen::MotionInfo *IPrimaryScreen::MotionInfo::alloc(int32_t x, int32_t y)
-{
-  auto *info = (MotionInfo *)malloc(sizeof(MotionInfo));
-  info->m_x = x;
-  info->m_y = y;
-  return info;
-}
-
-//
-// IPrimaryScreen::WheelInfo
-//
-
-IPrimaryScreen::WheelInfo *IPrimaryScreen::WheelInfo::alloc(int32_t xDelta, int32_t yDelta)
-{
-  auto *info = (WheelInfo *)malloc(sizeof(WheelInfo));
-  info->m_xDelta = xDelta;
-  info->m_yDelta = yDelta;
-  return info;
-}
-
 //
 // IPrimaryScreen::HotKeyInfo
 //
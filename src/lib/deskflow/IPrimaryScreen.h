@@ -21,6 +21,10 @@ class IPrimaryScreen
 public:
   virtual ~IPrimaryScreen() = default;
   //! Button event data
+  /*!
+  Button, motion and wheel data is small enough to be stored inline in
+  the \c Event rather than allocated.
+  */
   class ButtonInfo
   {
   public:
@@ -28,8 +32,6 @@ public:
     {
       // do nothing
     }
-    static ButtonInfo *alloc(ButtonID, KeyModifierMask);
-    static ButtonInfo *alloc(const ButtonInfo &);
 
     static bool equal(const ButtonInfo *, const ButtonInfo *);
 
@@ -40,9 +42,6 @@ public:
   //! Motion event data
   class MotionInfo
   {
-  public:
-    static MotionInfo *alloc(int32_t x, int32_t y);
-
   public:
     int32_t m_x;
     int32_t m_y;
@@ -50,9 +49,6 @@ public:
   //! Wheel motion event data
   class WheelInfo
   {
-  public:
-    static WheelInfo *alloc(int32_t xDelta, int32_t yDelta);
-
   public:
     int32_t m_xDelta;
     int32_t m_yDelta;
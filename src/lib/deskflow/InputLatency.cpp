@@ -0,0 +1,111 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "deskflow/InputLatency.h"
+
+#include "deskflow/InputRecords.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+
+namespace deskflow {
+
+//
+// InputLatency
+//
+
+void InputLatency::addClockSample(uint32_t sent, uint32_t serverTime, uint32_t received)
+{
+  // times wrap, so differences are taken modulo 2^32
+  ClockSample sample;
+  sample.m_rtt = received - sent;
+  if (sample.m_rtt > static_cast<uint32_t>(std::numeric_limits<int32_t>::max())) {
+    return;
+  }
+  sample.m_offset = static_cast<int32_t>(serverTime - (sent + sample.m_rtt / 2));
+
+  if (m_windowSamples == 0 || sample.m_rtt < m_windowBest.m_rtt) {
+    m_windowBest = sample;
+  }
+  if (!m_hasClock || sample.m_rtt < m_clock.m_rtt) {
+    m_clock = sample;
+    m_hasClock = true;
+  }
+
+  // clocks drift apart, so a short round trip long ago isn't kept forever
+  if (++m_windowSamples == kClockWindow) {
+    m_clock = m_windowBest;
+    m_windowSamples = 0;
+  }
+}
+
+void InputLatency::record(
+    uint32_t captured, MonotonicClock::time_point read, MonotonicClock::time_point start,
+    MonotonicClock::time_point end, ConnectionStats *stats
+)
+{
+  using enum ConnectionStats::LatencyPart;
+
+  if (!m_hasClock) {
+    return;
+  }
+
+  // an event can seem to arrive before it was captured by up to half the
+  // round trip of the clock sample, count that as no time at all
+  const uint32_t capturedHere = captured - static_cast<uint32_t>(m_clock.m_offset);
+  const auto networkMs = std::max(0, static_cast<int32_t>(InputRecords::toTime(read) - capturedHere));
+
+  const auto add = [this, stats](ConnectionStats::LatencyPart part, MonotonicClock::duration latency) {
+    ++m_report[static_cast<size_t>(part)][ConnectionStats::latencyBucket(latency)];
+    if (stats != nullptr) {
+      stats->recordLatency(part, latency);
+    }
+  };
+  add(Network, std::chrono::milliseconds(networkMs));
+  add(Queue, start - read);
+  add(Injection, end - start);
+  m_hasReport = true;
+}
+
+std::vector<uint32_t> InputLatency::takeReport()
+{
+  std::vector<uint32_t> report;
+  if (!m_hasReport) {
+    return report;
+  }
+
+  report.reserve(kReportSize);
+  for (auto &histogram : m_report) {
+    for (auto &count : histogram) {
+      report.push_back(static_cast<uint32_t>(std::min<uint64_t>(count, std::numeric_limits<uint32_t>::max())));
+      count = 0;
+    }
+  }
+  m_hasReport = false;
+  return report;
+}
+
+bool InputLatency::addReport(const std::vector<uint32_t> &report, ConnectionStats *stats)
+{
+  if (report.size() != kReportSize) {
+    return false;
+  }
+  if (stats == nullptr) {
+    return true;
+  }
+
+  for (size_t part = 0; part < ConnectionStats::kLatencyParts; ++part) {
+    ConnectionStats::LatencyHistogram histogram{};
+    const auto counts = report.begin() + static_cast<std::ptrdiff_t>(part * ConnectionStats::kLatencyBuckets);
+    std::copy_n(counts, ConnectionStats::kLatencyBuckets, histogram.begin());
+    stats->addLatency(static_cast<ConnectionStats::LatencyPart>(part), histogram);
+  }
+  return true;
+}
+
+} // namespace deskflow
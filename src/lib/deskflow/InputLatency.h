@@ -0,0 +1,122 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include "arch/MonotonicClock.h"
+#include "io/ConnectionStats.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace deskflow {
+
+//! End to end input latency
+/*!
+Measures, on the client, how long input events take from capture on the
+server to injection.  Input batches carry each event's capture time on
+the server's clock, so the client needs the offset between the clocks:
+on each keep alive it sends its time in a \c kMsgQClock and the server
+replies with both times in a \c kMsgDClock.  As with NTP the offset is
+the server's time less the middle of the round trip, and of the last
+few samples the one with the shortest round trip is used since it has
+the least queueing in it.
+
+Latency is split into the time from capture to the client reading the
+message, from then until injection starts, and injection itself.  It is
+counted in the connection's ConnectionStats and in a report the client
+sends the server in a \c kMsgDLatency, so both ends can show it.
+*/
+class InputLatency
+{
+public:
+  //! Clock samples after which the best of them replaces the offset
+  static constexpr int kClockWindow = 8;
+
+  //! Number of counts in a latency report
+  static constexpr size_t kReportSize = ConnectionStats::kLatencyParts * ConnectionStats::kLatencyBuckets;
+
+  //! @name manipulators
+  //@{
+
+  //! Add a clock sample
+  /*!
+  \p sent and \p received are when the client sent its query and read
+  the reply, on its clock, and \p serverTime is when the server replied,
+  on its clock.  All are InputRecords::toTime() milliseconds.
+  */
+  void addClockSample(uint32_t sent, uint32_t serverTime, uint32_t received);
+
+  //! Record an injected event
+  /*!
+  Records the latency of an event the server captured at \p captured, on
+  its clock, whose message was read at \p read and which was injected
+  from \p start to \p end.  The latency is counted in \p stats, unless
+  it's nullptr, and in the next report.  Does nothing until the clock
+  offset is known.
+  */
+  void record(
+      uint32_t captured, MonotonicClock::time_point read, MonotonicClock::time_point start,
+      MonotonicClock::time_point end, ConnectionStats *stats
+  );
+
+  //! Take the latency recorded since the last report
+  /*!
+  Returns the counts of each part's histogram in turn, in
+  ConnectionStats::LatencyPart order, or an empty list if nothing has
+  been recorded.
+  */
+  std::vector<uint32_t> takeReport();
+
+  //@}
+  //! @name accessors
+  //@{
+
+  //! Check if the clock offset is known
+  bool hasClockOffset() const
+  {
+    return m_hasClock;
+  }
+
+  //! Get the server's clock less the client's, in milliseconds
+  int32_t getClockOffset() const
+  {
+    return m_clock.m_offset;
+  }
+
+  //! Get the round trip of the clock sample in use, in milliseconds
+  uint32_t getClockRtt() const
+  {
+    return m_clock.m_rtt;
+  }
+
+  //! Add a latency report
+  /*!
+  Adds the counts in \p report, made by takeReport(), to \p stats unless
+  it's nullptr.  Returns false if \p report is malformed.
+  */
+  static bool addReport(const std::vector<uint32_t> &report, ConnectionStats *stats);
+
+  //@}
+
+private:
+  struct ClockSample
+  {
+    uint32_t m_rtt = 0;
+    int32_t m_offset = 0;
+  };
+
+  bool m_hasClock = false;
+  ClockSample m_clock;
+  ClockSample m_windowBest;
+  int m_windowSamples = 0;
+  std::array<ConnectionStats::LatencyHistogram, ConnectionStats::kLatencyParts> m_report{};
+  bool m_hasReport = false;
+};
+
+} // namespace deskflow
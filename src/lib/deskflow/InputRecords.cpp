@@ -0,0 +1,238 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "deskflow/InputRecords.h"
+
+#include <chrono>
+
+namespace {
+
+using Record = deskflow::InputRecords::Record;
+using enum Record::Type;
+
+void putVarint(std::string &out, uint32_t value)
+{
+  while (value >= 0x80) {
+    out += static_cast<char>((value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+  out += static_cast<char>(value);
+}
+
+void putSigned(std::string &out, int32_t value)
+{
+  // zigzag, so small negative numbers are short too
+  const auto bits = static_cast<uint32_t>(value);
+  putVarint(out, (bits << 1) ^ (value < 0 ? 0xffffffffU : 0));
+}
+
+class Reader
+{
+public:
+  explicit Reader(std::string_view data) : m_data(data)
+  {
+    // do nothing
+  }
+
+  bool done() const
+  {
+    return m_next == m_data.size();
+  }
+
+  bool getByte(uint8_t &value)
+  {
+    if (done()) {
+      return false;
+    }
+    value = static_cast<uint8_t>(m_data[m_next++]);
+    return true;
+  }
+
+  bool getVarint(uint32_t &value)
+  {
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+      uint8_t byte = 0;
+      if (!getByte(byte)) {
+        return false;
+      }
+      value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool getSigned(int32_t &value)
+  {
+    uint32_t bits = 0;
+    if (!getVarint(bits)) {
+      return false;
+    }
+    value = static_cast<int32_t>((bits >> 1) ^ (0U - (bits & 1)));
+    return true;
+  }
+
+  bool getString(std::string &value)
+  {
+    uint32_t length = 0;
+    if (!getVarint(length) || length > m_data.size() - m_next) {
+      return false;
+    }
+    value.assign(m_data.substr(m_next, length));
+    m_next += length;
+    return true;
+  }
+
+private:
+  std::string_view m_data;
+  size_t m_next = 0;
+};
+
+} // namespace
+
+namespace deskflow {
+
+//
+// InputRecords
+//
+
+void InputRecords::add(const Record &record)
+{
+  if (m_count == 0) {
+    m_base = record.m_time;
+  }
+  ++m_count;
+
+  m_records += static_cast<char>(record.m_type);
+  putVarint(m_records, record.m_time - m_base);
+  switch (record.m_type) {
+  case MouseMove:
+    putSigned(m_records, static_cast<int32_t>(static_cast<uint32_t>(record.m_x) - static_cast<uint32_t>(m_x)));
+    putSigned(m_records, static_cast<int32_t>(static_cast<uint32_t>(record.m_y) - static_cast<uint32_t>(m_y)));
+    m_x = record.m_x;
+    m_y = record.m_y;
+    break;
+
+  case MouseRelativeMove:
+  case MouseWheel:
+    putSigned(m_records, record.m_x);
+    putSigned(m_records, record.m_y);
+    break;
+
+  case MouseDown:
+  case MouseUp:
+    putVarint(m_records, record.m_id);
+    break;
+
+  case KeyDown:
+  case KeyRepeat:
+  case KeyUp:
+    putVarint(m_records, record.m_id);
+    putVarint(m_records, record.m_mask);
+    putVarint(m_records, record.m_button);
+    if (record.m_type == KeyRepeat) {
+      putVarint(m_records, record.m_count);
+    }
+    if (record.m_type != KeyUp) {
+      putVarint(m_records, static_cast<uint32_t>(record.m_language.size()));
+      m_records += record.m_language;
+    }
+    break;
+  }
+}
+
+void InputRecords::clear()
+{
+  m_records.clear();
+  m_count = 0;
+  m_base = 0;
+  m_x = 0;
+  m_y = 0;
+}
+
+bool InputRecords::decode(uint32_t base, std::string_view records, std::vector<Record> &out)
+{
+  out.clear();
+  Reader reader(records);
+  int32_t x = 0;
+  int32_t y = 0;
+  while (!reader.done()) {
+    auto &record = out.emplace_back();
+    uint8_t type = 0;
+    uint32_t time = 0;
+    if (!reader.getByte(type) || !reader.getVarint(time)) {
+      return false;
+    }
+    record.m_type = static_cast<Record::Type>(type);
+    record.m_time = base + time;
+
+    bool ok = false;
+    switch (record.m_type) {
+    case MouseMove: {
+      int32_t dx = 0;
+      int32_t dy = 0;
+      ok = reader.getSigned(dx) && reader.getSigned(dy);
+      x = static_cast<int32_t>(static_cast<uint32_t>(x) + static_cast<uint32_t>(dx));
+      y = static_cast<int32_t>(static_cast<uint32_t>(y) + static_cast<uint32_t>(dy));
+      record.m_x = x;
+      record.m_y = y;
+      break;
+    }
+
+    case MouseRelativeMove:
+    case MouseWheel:
+      ok = reader.getSigned(record.m_x) && reader.getSigned(record.m_y);
+      break;
+
+    case MouseDown:
+    case MouseUp:
+      ok = reader.getVarint(record.m_id);
+      break;
+
+    case KeyDown:
+    case KeyRepeat:
+    case KeyUp:
+      ok = reader.getVarint(record.m_id) && reader.getVarint(record.m_mask) && reader.getVarint(record.m_button) &&
+           (record.m_type != KeyRepeat || reader.getVarint(record.m_count)) &&
+           (record.m_type == KeyUp || reader.getString(record.m_language));
+      break;
+
+    default:
+      // a type this version doesn't know, whose length can't be known
+      break;
+    }
+    if (!ok) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool InputRecords::isMotionOnly(std::string_view records)
+{
+  Reader reader(records);
+  while (!reader.done()) {
+    uint8_t type = 0;
+    uint32_t time = 0;
+    int32_t dx = 0;
+    int32_t dy = 0;
+    if (!reader.getByte(type) || type != static_cast<uint8_t>(MouseMove) || !reader.getVarint(time) ||
+        !reader.getSigned(dx) || !reader.getSigned(dy)) {
+      return false;
+    }
+  }
+  return !records.empty();
+}
+
+uint32_t InputRecords::toTime(MonotonicClock::time_point time)
+{
+  const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch());
+  return static_cast<uint32_t>(ms.count());
+}
+
+} // namespace deskflow
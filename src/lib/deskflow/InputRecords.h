@@ -0,0 +1,130 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include "arch/MonotonicClock.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace deskflow {
+
+//! Input events encoded for an input batch message
+/*!
+Packs a run of input events into the compact form carried by
+\c kMsgDInputBatch.  Each record is a type byte, the milliseconds since
+the batch's first event as a varint, then the event's fields as varints.
+Signed fields are zigzag encoded and absolute mouse positions are sent
+as the change from the previous position in the batch, so a run of
+small movements takes a few bytes each.
+*/
+class InputRecords
+{
+public:
+  //! One input event
+  struct Record
+  {
+    enum class Type : uint8_t
+    {
+      MouseMove = 1,     //!< \c m_x, \c m_y is the new position
+      MouseRelativeMove, //!< \c m_x, \c m_y is the motion
+      MouseWheel,        //!< \c m_x, \c m_y is the wheel motion
+      MouseDown,         //!< \c m_id is the button
+      MouseUp,           //!< \c m_id is the button
+      KeyDown,           //!< \c m_id, \c m_mask, \c m_button, \c m_language
+      KeyRepeat,         //!< As \c KeyDown, and \c m_count
+      KeyUp              //!< \c m_id, \c m_mask, \c m_button
+    };
+
+    Type m_type = Type::MouseMove;
+    uint32_t m_time = 0; //!< Sender's clock, in milliseconds
+    int32_t m_x = 0;
+    int32_t m_y = 0;
+    uint32_t m_id = 0;
+    uint32_t m_mask = 0;
+    uint32_t m_count = 0;
+    uint32_t m_button = 0;
+    std::string m_language;
+  };
+
+  //! Most records a sender puts in one batch
+  static constexpr size_t kMaxRecords = 64;
+
+  //! @name manipulators
+  //@{
+
+  //! Add an event to the batch
+  void add(const Record &record);
+
+  //! Empty the batch
+  void clear();
+
+  //@}
+  //! @name accessors
+  //@{
+
+  //! Check if the batch has no events
+  bool empty() const
+  {
+    return m_count == 0;
+  }
+
+  //! Get the number of events in the batch
+  size_t getCount() const
+  {
+    return m_count;
+  }
+
+  //! Get the time of the first event, which other times are relative to
+  uint32_t getBase() const
+  {
+    return m_base;
+  }
+
+  //! Get the encoded events
+  const std::string &getRecords() const
+  {
+    return m_records;
+  }
+
+  //! Decode a batch
+  /*!
+  Decodes the events encoded in \p records, whose times are relative to
+  \p base, into \p out.  Returns false if \p records is malformed.
+  */
+  static bool decode(uint32_t base, std::string_view records, std::vector<Record> &out);
+
+  //! Check if a batch is only absolute mouse motion
+  /*!
+  Returns true if \p records holds at least one event and every event is
+  a \c MouseMove, in which case the batch ends with the pointer where
+  its last move puts it whatever the moves before.  Returns false if
+  \p records is malformed.
+  */
+  static bool isMotionOnly(std::string_view records);
+
+  //! Get a time as the milliseconds records carry
+  /*!
+  The result wraps every 49 days, so only the difference between two
+  times close together means anything.
+  */
+  static uint32_t toTime(MonotonicClock::time_point time);
+
+  //@}
+
+private:
+  std::string m_records;
+  size_t m_count = 0;
+  uint32_t m_base = 0;
+  int32_t m_x = 0;
+  int32_t m_y = 0;
+};
+
+} // namespace deskflow
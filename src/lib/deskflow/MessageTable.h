@@ -0,0 +1,223 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include "io/ConnectionStats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace deskflow {
+
+//! Get a message code as one integer
+/*!
+Reads the first 4 bytes of \p code most significant first, so codes
+compare the way their text does.
+*/
+template <typename Char> constexpr uint32_t messageCode(const Char *code)
+{
+  static_assert(sizeof(Char) == 1, "message codes are bytes");
+  return (static_cast<uint32_t>(static_cast<uint8_t>(code[0])) << 24) |
+         (static_cast<uint32_t>(static_cast<uint8_t>(code[1])) << 16) |
+         (static_cast<uint32_t>(static_cast<uint8_t>(code[2])) << 8) |
+         static_cast<uint32_t>(static_cast<uint8_t>(code[3]));
+}
+
+//! Message dispatch table
+/*!
+Maps message codes to handlers.  The table is sorted by code so finding
+a handler is a binary search on one integer rather than a string
+comparison per known message, and it counts the messages each handler
+is given.  Protocol versions add to, or replace, the handlers of the
+versions before them.
+
+The table also counts the messages sent on its connection, by code, so
+it can be a connection's ConnectionStats::MessageCounter.  Handlers are
+found, and messages counted, on the thread that owns the table; the
+counts can be read from any thread.
+*/
+template <typename Handler> class MessageTable : public ConnectionStats::MessageCounter
+{
+  //! A message count that is read from other threads
+  struct alignas(std::atomic_ref<uint64_t>::required_alignment) Count
+  {
+    uint64_t m_value = 0;
+
+    void increment()
+    {
+      std::atomic_ref(m_value).fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t load() const
+    {
+      return std::atomic_ref(const_cast<uint64_t &>(m_value)).load(std::memory_order_relaxed);
+    }
+  };
+
+public:
+  //! A message and its handler
+  struct Entry
+  {
+    uint32_t m_code = 0;
+    Handler m_handler;
+    Count m_count; //!< Messages given to the handler
+  };
+
+  //! @name manipulators
+  //@{
+
+  //! Set the handler for a message
+  /*!
+  \p code is the message's format or code, only its first 4 characters
+  are used.  Replaces any handler the message already has.
+  */
+  void add(const char *code, Handler handler)
+  {
+    const uint32_t key = messageCode(code);
+    const auto entry = std::ranges::lower_bound(m_entries, key, {}, &Entry::m_code);
+    if (entry != m_entries.end() && entry->m_code == key) {
+      entry->m_handler = std::move(handler);
+    } else {
+      std::scoped_lock lock{m_mutex};
+      m_entries.insert(entry, Entry{key, std::move(handler), {}});
+    }
+  }
+
+  //! Remove every handler
+  void clear()
+  {
+    std::scoped_lock lock{m_mutex};
+    m_entries.clear();
+  }
+
+  //! Find the handler for a message
+  /*!
+  Returns the handler for the message with code \p code, counting the
+  message, or nullptr if the message has no handler.
+  */
+  Handler *find(const uint8_t *code)
+  {
+    const uint32_t key = messageCode(code);
+    const auto entry = std::ranges::lower_bound(m_entries, key, {}, &Entry::m_code);
+    if (entry == m_entries.end() || entry->m_code != key) {
+      return nullptr;
+    }
+    entry->m_count.increment();
+    return &entry->m_handler;
+  }
+
+  //! Count a message sent, \p code is its first 4 bytes
+  void countSent(const void *code) override
+  {
+    const uint32_t key = messageCode(static_cast<const uint8_t *>(code));
+    auto sent = std::ranges::lower_bound(m_sent, key, {}, &Sent::m_code);
+    if (sent == m_sent.end() || sent->m_code != key) {
+      std::scoped_lock lock{m_mutex};
+      sent = m_sent.insert(sent, Sent{key, {}});
+    }
+    sent->m_count.increment();
+  }
+
+  //@}
+  //! @name accessors
+  //@{
+
+  //! Check if the table has no handlers
+  bool empty() const
+  {
+    return m_entries.empty();
+  }
+
+  //! Get the messages received and sent, in code order
+  std::vector<ConnectionStats::MessageCount> messageCounts() const override
+  {
+    std::scoped_lock lock{m_mutex};
+    std::vector<ConnectionStats::MessageCount> counts;
+
+    // both tables are in code order, so merge them
+    auto entry = m_entries.begin();
+    auto sent = m_sent.begin();
+    while (entry != m_entries.end() || sent != m_sent.end()) {
+      const bool isEntry = sent == m_sent.end() || (entry != m_entries.end() && entry->m_code <= sent->m_code);
+      const bool isSent = entry == m_entries.end() || (sent != m_sent.end() && sent->m_code <= entry->m_code);
+      ConnectionStats::MessageCount count;
+      const uint32_t code = isEntry ? entry->m_code : sent->m_code;
+      for (size_t i = 0; i < count.m_code.size(); ++i) {
+        count.m_code[i] = static_cast<char>(code >> (24 - 8 * i));
+      }
+      if (isEntry) {
+        count.m_in = (entry++)->m_count.load();
+      }
+      if (isSent) {
+        count.m_out = (sent++)->m_count.load();
+      }
+      if (count.m_in != 0 || count.m_out != 0) {
+        counts.push_back(count);
+      }
+    }
+    return counts;
+  }
+
+  //! Get the handlers, in code order
+  const std::vector<Entry> &getEntries() const
+  {
+    return m_entries;
+  }
+
+  //! Get the message counts as text
+  /*!
+  Lists each message handled at least once with its count, busiest
+  first, e.g. "DMMV 1200, DKDN 31".
+  */
+  std::string report() const
+  {
+    std::vector<const Entry *> handled;
+    for (const auto &entry : m_entries) {
+      if (entry.m_count.load() != 0) {
+        handled.push_back(&entry);
+      }
+    }
+    std::ranges::stable_sort(handled, [](const Entry *a, const Entry *b) {
+      return a->m_count.load() > b->m_count.load();
+    });
+
+    std::string text;
+    for (const auto *entry : handled) {
+      if (!text.empty()) {
+        text += ", ";
+      }
+      for (int shift = 24; shift >= 0; shift -= 8) {
+        text += static_cast<char>(entry->m_code >> shift);
+      }
+      text += ' ';
+      text += std::to_string(entry->m_count.load());
+    }
+    return text;
+  }
+
+  //@}
+
+private:
+  //! Messages sent with one code
+  struct Sent
+  {
+    uint32_t m_code = 0;
+    Count m_count;
+  };
+
+  // locked only to change the tables' layout, and to read them from
+  // other threads
+  mutable std::mutex m_mutex;
+  std::vector<Entry> m_entries;
+  std::vector<Sent> m_sent;
+};
+
+} // namespace deskflow
@@ -7,9 +7,74 @@
 
 #include "deskflow/PacketStreamFilter.h"
 #include "base/IEventQueue.h"
+#include "deskflow/InputRecords.h"
 #include "deskflow/ProtocolTypes.h"
+#include "io/ConnectionStats.h"
 
+#include <algorithm>
+#include <array>
 #include <cstring>
+#include <string_view>
+#include <vector>
+
+// most buffers gathered into one packet without copying
+static const size_t s_maxPacketBuffers = 7;
+
+// smallest packet worth compressing.  input events are far smaller so
+// they never pay for it.
+static const uint32_t s_compressMinSize = 1024;
+
+// zlib's fastest level, which still shrinks clipboard text several times
+static const int s_compressLevel = 1;
+
+// packets at least 4 times this size are only compressed if a sample of
+// this size from their middle compresses to 7/8 or less
+static const uint32_t s_compressProbeSize = 4096;
+
+// set in a packet's length if the packet is compressed
+static const uint32_t s_compressedFlag = 0x80000000U;
+
+// bytes in a message code
+static const size_t s_codeSize = 4;
+
+// bytes before an input batch's records: code, base time, records length
+static const size_t s_inputBatchHeaderSize = 12;
+
+// check if a packet only moves the pointer to an absolute position
+static bool isMotion(const std::span<const uint8_t> buffers[], size_t count)
+{
+  if (count == 0 || buffers[0].size() < s_codeSize) {
+    return false;
+  }
+  const uint8_t *data = buffers[0].data();
+  if (memcmp(data, kMsgDMouseMove, s_codeSize) == 0) {
+    return true;
+  }
+
+  // protocol 1.9 sends motion in input batches, and a batch of nothing
+  // else is as good as its last move.  messages are written in one buffer.
+  if (count != 1 || buffers[0].size() <= s_inputBatchHeaderSize ||
+      memcmp(data, kMsgDInputBatch, s_codeSize) != 0) {
+    return false;
+  }
+  const std::string_view records(
+      reinterpret_cast<const char *>(data) + s_inputBatchHeaderSize, buffers[0].size() - s_inputBatchHeaderSize
+  );
+  return deskflow::InputRecords::isMotionOnly(records);
+}
+
+static void encodeLength(uint8_t (&length)[4], uint32_t size)
+{
+  length[0] = (uint8_t)((size >> 24) & 0xff);
+  length[1] = (uint8_t)((size >> 16) & 0xff);
+  length[2] = (uint8_t)((size >> 8) & 0xff);
+  length[3] = (uint8_t)(size & 0xff);
+}
+
+static uint32_t decodeLength(const uint8_t *length)
+{
+  return ((uint32_t)length[0] << 24) | ((uint32_t)length[1] << 16) | ((uint32_t)length[2] << 8) | (uint32_t)length[3];
+}
 
 //
 // PacketStreamFilter
@@ -26,6 +91,8 @@ void PacketStreamFilter::close()
 {
   std::scoped_lock lock{m_mutex};
   m_size = 0;
+  m_deflatedSize = 0;
+  m_inflated.clear();
   m_buffer.pop(m_buffer.getSize());
   StreamFilter::close();
 }
@@ -43,17 +110,32 @@ uint32_t PacketStreamFilter::read(void *buffer, uint32_t n)
     return 0;
   }
 
+  // a compressed packet is read from its inflated copy
+  const uint8_t *inflated = nullptr;
+  if (!m_inflated.isEmpty()) {
+    inflated = reinterpret_cast<const uint8_t *>(m_inflated.constData()) + (m_packetSize - m_size);
+  }
+
   // read no more than what's left in the buffered packet
   if (n > m_size) {
     n = m_size;
   }
 
   // read it
-  if (buffer != nullptr) {
-    memcpy(buffer, m_buffer.peek(n), n);
+  if (inflated != nullptr) {
+    if (buffer != nullptr) {
+      memcpy(buffer, inflated, n);
+    }
+  } else {
+    if (buffer != nullptr) {
+      m_buffer.peek(buffer, n);
+    }
+    m_buffer.pop(n);
   }
-  m_buffer.pop(n);
   m_size -= n;
+  if (m_size == 0) {
+    m_inflated.clear();
+  }
 
   // get next packet's size if we've finished with this packet and
   // there's enough data to do so.
@@ -66,24 +148,158 @@ uint32_t PacketStreamFilter::read(void *buffer, uint32_t n)
   return n;
 }
 
+void PacketStreamFilter::setMotionLimit(uint32_t highWater)
+{
+  std::scoped_lock lock{m_outputMutex};
+  m_motionLimit = highWater;
+  if (highWater == 0) {
+    writeHeldMotion();
+  }
+}
+
+void PacketStreamFilter::setCompression(bool enabled)
+{
+  {
+    std::scoped_lock lock{m_mutex};
+    m_acceptCompressed = enabled;
+  }
+  std::scoped_lock lock{m_outputMutex};
+  m_compress = enabled;
+}
+
 void PacketStreamFilter::write(const void *buffer, uint32_t count)
 {
-  // write the length of the payload
+  const std::span<const uint8_t> payload(static_cast<const uint8_t *>(buffer), count);
+  writev(&payload, 1);
+}
+
+void PacketStreamFilter::writev(const std::span<const uint8_t> buffers[], size_t count)
+{
+  std::scoped_lock lock{m_outputMutex};
+  if (m_motionLimit == 0) {
+    writePacket(buffers, count);
+    return;
+  }
+
+  // absolute motion is only worth sending if it's the latest, so while
+  // the stream is backed up keep just the latest
+  if (isMotion(buffers, count)) {
+    if (!m_heldMotion.empty()) {
+      ++m_motionCoalesced;
+      m_heldMotion.clear();
+    }
+    if (getStream()->getOutputSize() > m_motionLimit) {
+      for (size_t i = 0; i < count; ++i) {
+        m_heldMotion.insert(m_heldMotion.end(), buffers[i].begin(), buffers[i].end());
+      }
+      return;
+    }
+  } else {
+    writeHeldMotion();
+  }
+  writePacket(buffers, count);
+}
+
+void PacketStreamFilter::writePacket(const std::span<const uint8_t> buffers[], size_t count)
+{
+  // the buffers are one packet
+  uint32_t size = 0;
+  for (size_t i = 0; i < count; ++i) {
+    size += static_cast<uint32_t>(buffers[i].size());
+  }
+
+  // count the message in the connection's message table
+  auto *stats = getStream()->getConnectionStats();
+  if (stats != nullptr && count != 0 && buffers[0].size() >= s_codeSize) {
+    stats->recordMessageOut(buffers[0].data());
+  }
+
+  if (m_compress && size >= s_compressMinSize && writeCompressedPacket(buffers, count, size)) {
+    return;
+  }
+
+  // write the length of the payload and the payload together
+  uint8_t length[4];
+  encodeLength(length, size);
+
+  std::array<std::span<const uint8_t>, s_maxPacketBuffers + 1> packet;
+  if (count + 1 > packet.size()) {
+    // too many pieces to gather, so send them through a copy
+    std::vector<uint8_t> joined(sizeof(length));
+    memcpy(joined.data(), length, sizeof(length));
+    for (size_t i = 0; i < count; ++i) {
+      joined.insert(joined.end(), buffers[i].begin(), buffers[i].end());
+    }
+    getStream()->write(joined.data(), static_cast<uint32_t>(joined.size()));
+    return;
+  }
+
+  packet[0] = std::span<const uint8_t>(length, sizeof(length));
+  std::copy(buffers, buffers + count, packet.begin() + 1);
+  getStream()->writev(packet.data(), count + 1);
+}
+
+bool PacketStreamFilter::writeCompressedPacket(const std::span<const uint8_t> buffers[], size_t count, uint32_t size)
+{
+  // note -- m_outputMutex must be locked on entry
+
+  std::vector<uint8_t> joined;
+  const uint8_t *payload = buffers[0].data();
+  if (count != 1) {
+    joined.reserve(size);
+    for (size_t i = 0; i < count; ++i) {
+      joined.insert(joined.end(), buffers[i].begin(), buffers[i].end());
+    }
+    payload = joined.data();
+  }
+
+  // already compressed data, like images, won't shrink.  for large packets
+  // find that out from a sample rather than the whole packet.
+  if (size >= 4 * s_compressProbeSize) {
+    const uint8_t *probe = payload + size / 2;
+    const QByteArray sample = qCompress(probe, s_compressProbeSize, s_compressLevel);
+    if (static_cast<uint32_t>(sample.size()) > s_compressProbeSize / 8 * 7) {
+      return false;
+    }
+  }
+
+  const QByteArray deflated = qCompress(payload, size, s_compressLevel);
+  const auto deflatedSize = static_cast<uint32_t>(deflated.size());
+  if (deflatedSize >= size) {
+    return false;
+  }
+  ++m_compressed;
+  m_compressedSaved += size - deflatedSize;
+
   uint8_t length[4];
-  length[0] = (uint8_t)((count >> 24) & 0xff);
-  length[1] = (uint8_t)((count >> 16) & 0xff);
-  length[2] = (uint8_t)((count >> 8) & 0xff);
-  length[3] = (uint8_t)(count & 0xff);
-  getStream()->write(length, sizeof(length));
+  encodeLength(length, deflatedSize | s_compressedFlag);
+  const std::span<const uint8_t> packet[] = {
+      std::span<const uint8_t>(length, sizeof(length)),
+      std::span<const uint8_t>(reinterpret_cast<const uint8_t *>(deflated.constData()), deflatedSize)
+  };
+  getStream()->writev(packet, 2);
+  return true;
+}
+
+bool PacketStreamFilter::writeHeldMotion()
+{
+  // note -- m_outputMutex must be locked on entry
 
-  // write the payload
-  getStream()->write(buffer, count);
+  if (m_heldMotion.empty()) {
+    return false;
+  }
+  const std::span<const uint8_t> motion(m_heldMotion);
+  writePacket(&motion, 1);
+  m_heldMotion.clear();
+  return true;
 }
 
 void PacketStreamFilter::shutdownInput()
 {
   std::scoped_lock lock{m_mutex};
   m_size = 0;
+  m_deflatedSize = 0;
+  m_inflated.clear();
   m_buffer.pop(m_buffer.getSize());
   StreamFilter::shutdownInput();
 }
@@ -100,26 +316,78 @@ uint32_t PacketStreamFilter::getSize() const
   return isReadyNoLock() ? m_size : 0;
 }
 
+deskflow::IStream::OutputStats PacketStreamFilter::getOutputStats() const
+{
+  OutputStats stats = StreamFilter::getOutputStats();
+  std::scoped_lock lock{m_outputMutex};
+  stats.m_motionCoalesced += m_motionCoalesced;
+  stats.m_compressed += m_compressed;
+  stats.m_compressedSaved += m_compressedSaved;
+  return stats;
+}
+
 bool PacketStreamFilter::isReadyNoLock() const
 {
-  return (m_size != 0 && m_buffer.getSize() >= m_size);
+  return (m_size != 0 && (!m_inflated.isEmpty() || m_buffer.getSize() >= m_size));
 }
 
 bool PacketStreamFilter::readPacketSize()
 {
   // note -- m_mutex must be locked on entry
 
-  if (m_size == 0 && m_buffer.getSize() >= 4) {
+  if (m_size == 0 && m_deflatedSize == 0 && m_buffer.getSize() >= 4) {
     uint8_t buffer[4];
-    memcpy(buffer, m_buffer.peek(sizeof(buffer)), sizeof(buffer));
+    m_buffer.peek(buffer, sizeof(buffer));
     m_buffer.pop(sizeof(buffer));
-    m_size =
-        ((uint32_t)buffer[0] << 24) | ((uint32_t)buffer[1] << 16) | ((uint32_t)buffer[2] << 8) | (uint32_t)buffer[3];
-    if (m_size > PROTOCOL_MAX_MESSAGE_LENGTH) {
+    uint32_t size = decodeLength(buffer);
+    if ((size & s_compressedFlag) != 0) {
+      // only a peer that agreed to compression may send compressed
+      // packets, and a compressed packet is never empty
+      size &= ~s_compressedFlag;
+      if (!m_acceptCompressed || size == 0) {
+        m_events->addEvent(Event(EventTypes::StreamInputFormatError, getEventTarget()));
+        return false;
+      }
+      m_deflatedSize = size;
+    } else {
+      m_size = size;
+      m_packetSize = size;
+    }
+    if (size > PROTOCOL_MAX_MESSAGE_LENGTH) {
       m_events->addEvent(Event(EventTypes::StreamInputFormatError, getEventTarget()));
       return false;
     }
   }
+
+  // a compressed packet can only be read once all of it has arrived
+  if (m_deflatedSize != 0 && m_buffer.getSize() >= m_deflatedSize) {
+    return inflatePacket();
+  }
+  return true;
+}
+
+bool PacketStreamFilter::inflatePacket()
+{
+  // note -- m_mutex must be locked on entry
+
+  const auto *deflated = static_cast<const uint8_t *>(m_buffer.peek(m_deflatedSize));
+
+  // the original size comes first.  check it before qUncompress() sizes
+  // its buffer with it.
+  const uint32_t size = m_deflatedSize >= 4 ? decodeLength(deflated) : 0;
+  if (size != 0 && size <= PROTOCOL_MAX_MESSAGE_LENGTH) {
+    m_inflated = qUncompress(deflated, m_deflatedSize);
+  }
+  m_buffer.pop(m_deflatedSize);
+  m_deflatedSize = 0;
+
+  if (size == 0 || static_cast<uint32_t>(m_inflated.size()) != size) {
+    m_inflated.clear();
+    m_events->addEvent(Event(EventTypes::StreamInputFormatError, getEventTarget()));
+    return false;
+  }
+  m_size = size;
+  m_packetSize = size;
   return true;
 }
 
@@ -159,12 +427,19 @@ void PacketStreamFilter::filterEvent(const Event &event)
     if (!readMore()) {
       return;
     }
+  } else if (event.getType() == EventTypes::StreamOutputFlushed) {
+    // the stream has caught up.  it's not flushed if there was motion
+    // waiting for that.
+    std::scoped_lock lock{m_outputMutex};
+    if (writeHeldMotion()) {
+      return;
+    }
   } else if (event.getType() == EventTypes::StreamInputShutdown) {
     // discard this if we have buffered data
     std::scoped_lock lock{m_mutex};
     m_inputShutdown = true;
-    if (m_size != 0) {
-      if (m_buffer.getSize() >= m_size) {
+    if (m_size != 0 || m_deflatedSize != 0) {
+      if (isReadyNoLock()) {
         // we have a complete packet, so we can process it before
         // shutting down.
         return;
@@ -174,6 +449,7 @@ void PacketStreamFilter::filterEvent(const Event &event)
       // signal an error and then shut down.
       m_events->addEvent(Event(EventTypes::StreamInputFormatError, getEventTarget()));
       m_size = 0;
+      m_deflatedSize = 0;
     }
   }
 
@@ -10,13 +10,27 @@
 #include "io/StreamBuffer.h"
 #include "io/StreamFilter.h"
 
+#include <QByteArray>
+
 #include <mutex>
+#include <vector>
 
 class IEventQueue;
 
 //! Packetizing stream filter
 /*!
 Filters a stream to read and write packets.
+
+With a motion limit set, absolute mouse motion, and input batches of
+nothing but absolute motion, are held back while the stream has more
+than that many bytes waiting to be sent, and only the latest held back
+motion is sent once the stream catches up or before the next other
+message.  Other messages are never held back or reordered.
+
+With compression on, packets of 1 KiB or more are sent deflated when
+that makes them smaller, flagged by the top bit of their length, and
+compressed packets read are inflated back to the original packet.
+Without compression a flagged packet is a format error.
 */
 class PacketStreamFilter : public StreamFilter
 {
@@ -24,13 +38,23 @@ public:
   PacketStreamFilter(IEventQueue *events, deskflow::IStream *stream, bool adoptStream = true);
   ~PacketStreamFilter() override = default;
 
+  //! Hold back mouse motion for a slow stream
+  /*!
+  Hold back absolute mouse motion, alone or in input batches, while more
+  than \p highWater bytes are waiting to be sent.  Zero, the default, never holds motion back.
+  */
+  void setMotionLimit(uint32_t highWater);
+
   // IStream overrides
   void close() override;
   uint32_t read(void *buffer, uint32_t n) override;
   void write(const void *buffer, uint32_t n) override;
+  void writev(const std::span<const uint8_t> buffers[], size_t count) override;
+  void setCompression(bool enabled) override;
   void shutdownInput() override;
   bool isReady() const override;
   uint32_t getSize() const override;
+  OutputStats getOutputStats() const override;
 
 protected:
   // StreamFilter overrides
@@ -41,10 +65,36 @@ private:
   bool readPacketSize();
   bool readMore();
 
+  // replace the buffered compressed packet with the original packet
+  bool inflatePacket();
+
+  // write buffers as one packet, with its length first
+  void writePacket(const std::span<const uint8_t> buffers[], size_t count);
+
+  // write buffers as one compressed packet and return true, or return
+  // false if compressing doesn't make them smaller
+  bool writeCompressedPacket(const std::span<const uint8_t> buffers[], size_t count, uint32_t size);
+
+  // write held back motion, if any, and return true if there was some.
+  // must have m_outputMutex locked.
+  bool writeHeldMotion();
+
 private:
   mutable std::mutex m_mutex;
   uint32_t m_size = 0;
+  uint32_t m_packetSize = 0;
   StreamBuffer m_buffer;
+  uint32_t m_deflatedSize = 0;
+  QByteArray m_inflated;
+  bool m_acceptCompressed = false;
   bool m_inputShutdown = false;
   IEventQueue *m_events = nullptr;
+
+  mutable std::mutex m_outputMutex;
+  uint32_t m_motionLimit = 0;
+  std::vector<uint8_t> m_heldMotion;
+  uint64_t m_motionCoalesced = 0;
+  bool m_compress = false;
+  uint64_t m_compressed = 0;
+  uint64_t m_compressedSaved = 0;
 };
@@ -0,0 +1,521 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include "deskflow/DeskflowException.h"
+#include "deskflow/ProtocolTypes.h"
+#include "io/IOException.h"
+#include "io/IStream.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+//! Compile time protocol message codecs
+/*!
+Each message is a \c Message type named after its format, in the
+notation of \c ProtocolUtil::writef().  The format is parsed while
+compiling, so encoding and decoding are straight line code that writes
+into a caller's buffer, with no varargs, format parsing or temporary
+vectors, and produces exactly the bytes \c ProtocolUtil does.
+*/
+namespace deskflow::protocol {
+
+//! A message format usable as a template argument
+/*!
+Supported specifiers are \c %1i, \c %2i and \c %4i for integers, \c %1I,
+\c %2I and \c %4I for lists of integers and \c %s for strings.  The
+format must start with the 4 character message code.
+*/
+template <size_t N> struct Format
+{
+  consteval Format(const char (&text)[N]) // NOSONAR - implicit so a string literal can be a template argument
+  {
+    std::copy_n(text, N, m_text);
+  }
+
+  constexpr std::string_view view() const
+  {
+    return {m_text, N - 1};
+  }
+
+  char m_text[N]{};
+};
+
+//! One part of a message
+struct Field
+{
+  enum class Kind : uint8_t
+  {
+    Literal, //!< Characters sent as they are
+    Int,     //!< An integer, most significant byte first
+    IntList, //!< A 4 byte count followed by that many integers
+    String   //!< A 4 byte length followed by that many bytes
+  };
+
+  Kind m_kind = Kind::Literal;
+  uint8_t m_width = 0;   //!< Bytes per integer
+  uint16_t m_offset = 0; //!< Where a literal starts in the format
+  uint16_t m_length = 0; //!< Length of a literal
+};
+
+namespace detail {
+
+// parse a format into fields, or only count them if fields is nullptr.
+// a throw makes a bad format fail to compile.
+consteval size_t parseFormat(std::string_view format, Field *fields)
+{
+  size_t count = 0;
+  size_t i = 0;
+  while (i < format.size()) {
+    Field field;
+    if (format[i] != '%') {
+      // the message code is a literal of its own
+      const size_t start = i;
+      while (i < format.size() && format[i] != '%' && !(start == 0 && i == 4)) {
+        ++i;
+      }
+      field.m_offset = static_cast<uint16_t>(start);
+      field.m_length = static_cast<uint16_t>(i - start);
+    } else {
+      ++i;
+      uint8_t width = 0;
+      while (i < format.size() && format[i] >= '0' && format[i] <= '9') {
+        width = static_cast<uint8_t>(width * 10 + (format[i] - '0'));
+        ++i;
+      }
+      if (i == format.size()) {
+        throw "incomplete format specifier";
+      }
+      switch (format[i]) {
+      case 'i':
+        field.m_kind = Field::Kind::Int;
+        break;
+      case 'I':
+        field.m_kind = Field::Kind::IntList;
+        break;
+      case 's':
+        field.m_kind = Field::Kind::String;
+        break;
+      default:
+        throw "unsupported format specifier";
+      }
+      if (field.m_kind == Field::Kind::String ? width != 0 : (width != 1 && width != 2 && width != 4)) {
+        throw "unsupported format width";
+      }
+      field.m_width = width;
+      ++i;
+    }
+    if (fields != nullptr) {
+      fields[count] = field;
+    }
+    ++count;
+  }
+  return count;
+}
+
+template <auto F> consteval auto parseFields()
+{
+  std::array<Field, parseFormat(F.view(), nullptr)> fields{};
+  parseFormat(F.view(), fields.data());
+  return fields;
+}
+
+template <typename T> constexpr uint32_t toWire(const T &value)
+{
+  if constexpr (std::is_enum_v<T>) {
+    return static_cast<uint32_t>(static_cast<std::underlying_type_t<T>>(value));
+  } else {
+    static_assert(std::is_integral_v<T>, "integer fields take integers or enums");
+    return static_cast<uint32_t>(value);
+  }
+}
+
+constexpr uint8_t *putInt(uint8_t *out, uint32_t value, size_t width)
+{
+  for (size_t shift = width * 8; shift > 0; shift -= 8) {
+    *out++ = static_cast<uint8_t>(value >> (shift - 8));
+  }
+  return out;
+}
+
+// reads message bytes from memory
+class SpanReader
+{
+public:
+  explicit SpanReader(std::span<const uint8_t> data) : m_data(data)
+  {
+    // do nothing
+  }
+
+  bool take(void *out, size_t n)
+  {
+    if (n > m_data.size()) {
+      return false;
+    }
+    if (n != 0) {
+      memcpy(out, m_data.data(), n);
+    }
+    m_data = m_data.subspan(n);
+    return true;
+  }
+
+private:
+  std::span<const uint8_t> m_data;
+};
+
+// reads message bytes from a stream
+class StreamReader
+{
+public:
+  explicit StreamReader(deskflow::IStream *stream) : m_stream(stream)
+  {
+    // do nothing
+  }
+
+  bool take(void *out, size_t n)
+  {
+    auto *bytes = static_cast<uint8_t *>(out);
+    while (n > 0) {
+      const uint32_t count = m_stream->read(bytes, static_cast<uint32_t>(n));
+      if (count == 0) {
+        return false;
+      }
+      bytes += count;
+      n -= count;
+    }
+    return true;
+  }
+
+private:
+  deskflow::IStream *m_stream;
+};
+
+template <typename Reader> bool takeInt(Reader &reader, size_t width, uint32_t &value)
+{
+  std::array<uint8_t, 4> bytes{};
+  if (!reader.take(bytes.data(), width)) {
+    return false;
+  }
+  value = 0;
+  for (size_t i = 0; i < width; ++i) {
+    value = (value << 8) | bytes[i];
+  }
+  return true;
+}
+
+} // namespace detail
+
+//! A protocol message
+/*!
+\p F is the message's format, which fixes its layout.  The values
+passed to the functions here are the format's fields in order:
+integers (or enums) for \c %i, a \c std::string or anything that
+converts to \c std::string_view for \c %s and a \c std::vector of
+integers for \c %I.
+*/
+template <Format F> class Message
+{
+public:
+  //! The format the message is defined by
+  static constexpr auto kFormat = F;
+
+  //! The parts of the message
+  static constexpr auto kFields = detail::parseFields<F>();
+
+  static_assert(
+      kFields[0].m_kind == Field::Kind::Literal && kFields[0].m_length == 4, "a message starts with a 4 character code"
+  );
+
+  //! Number of values in the message
+  static constexpr size_t kValues = std::ranges::count_if(kFields, [](const Field &field) {
+    return field.m_kind != Field::Kind::Literal;
+  });
+
+  //! Whether every message of this kind has the same size
+  static constexpr bool kFixedSize = std::ranges::none_of(kFields, [](const Field &field) {
+    return field.m_kind == Field::Kind::IntList || field.m_kind == Field::Kind::String;
+  });
+
+  //! Size of the message with empty strings and lists
+  static constexpr size_t kMinSize = [] {
+    size_t size = 0;
+    for (const auto &field : kFields) {
+      switch (field.m_kind) {
+      case Field::Kind::Literal:
+        size += field.m_length;
+        break;
+      case Field::Kind::Int:
+        size += field.m_width;
+        break;
+      default:
+        size += 4;
+        break;
+      }
+    }
+    return size;
+  }();
+
+  //! Get the encoded size
+  template <typename... Values> static constexpr size_t size(const Values &...values)
+  {
+    static_assert(sizeof...(Values) == kValues, "wrong number of values for the message format");
+    const auto args = std::forward_as_tuple(values...);
+    return [&args]<size_t... I>(std::index_sequence<I...>) {
+      return kMinSize + (extraSize<I>(args) + ... + 0);
+    }(std::make_index_sequence<kFields.size()>());
+  }
+
+  //! Encode a message
+  /*!
+  Writes the message to \p out, which must have room for \c size()
+  bytes, and returns the number of bytes written.
+  */
+  template <typename... Values> static size_t encode(std::span<uint8_t> out, const Values &...values)
+  {
+    static_assert(sizeof...(Values) == kValues, "wrong number of values for the message format");
+    assert(out.size() >= size(values...));
+    const auto args = std::forward_as_tuple(values...);
+    uint8_t *end = [&args]<size_t... I>(uint8_t *p, std::index_sequence<I...>) {
+      ((p = encodeField<I>(p, args)), ...);
+      return p;
+    }(out.data(), std::make_index_sequence<kFields.size()>());
+    return static_cast<size_t>(end - out.data());
+  }
+
+  //! Decode a message
+  /*!
+  Reads a whole message, code included, from \p in.  Returns false if
+  \p in is too short or doesn't match the format.
+  */
+  template <typename... Values> static bool decode(std::span<const uint8_t> in, Values &...values)
+  {
+    detail::SpanReader reader(in);
+    return decodeFrom<0>(reader, values...);
+  }
+
+  //! Write a message to a stream
+  /*!
+  Encodes the message on the stack, unless it is unusually large, and
+  writes it with a single \c writev().
+  */
+  template <typename... Values> static void write(deskflow::IStream *stream, const Values &...values)
+  {
+    assert(stream != nullptr);
+    if constexpr (kFixedSize) {
+      std::array<uint8_t, kMinSize> buffer;
+      encode(buffer, values...);
+      const std::span<const uint8_t> message(buffer);
+      stream->writev(&message, 1);
+    } else {
+      const size_t n = size(values...);
+      std::array<uint8_t, kStackSize> local;
+      std::unique_ptr<uint8_t[]> heap;
+      uint8_t *buffer = local.data();
+      if (n > local.size()) {
+        heap = std::make_unique_for_overwrite<uint8_t[]>(n);
+        buffer = heap.get();
+      }
+      encode({buffer, n}, values...);
+      const std::span<const uint8_t> message(buffer, n);
+      stream->writev(&message, 1);
+    }
+  }
+
+  //! Read a message from a stream
+  /*!
+  Reads the rest of a message whose code the caller has already read,
+  like \c ProtocolUtil::readf() given the format after its code.
+  Returns false if the stream ends early or the data doesn't match the
+  format.  Throws \c BadClientException if a string or list is longer
+  than the protocol allows.
+  */
+  template <typename... Values> static bool read(deskflow::IStream *stream, Values &...values)
+  {
+    assert(stream != nullptr);
+    try {
+      detail::StreamReader reader(stream);
+      if constexpr (kFixedSize) {
+        // one read for the whole message
+        std::array<uint8_t, kMinSize - 4> body;
+        if (!reader.take(body.data(), body.size())) {
+          return false;
+        }
+        detail::SpanReader bodyReader(body);
+        return decodeFrom<1>(bodyReader, values...);
+      } else {
+        return decodeFrom<1>(reader, values...);
+      }
+    } catch (IOException &) {
+      return false;
+    }
+  }
+
+private:
+  // largest variable size message encoded on the stack
+  static constexpr size_t kStackSize = 256;
+
+  // index of each field's value, literals have none
+  static constexpr auto kValueIndex = [] {
+    std::array<size_t, kFields.size()> indices{};
+    size_t next = 0;
+    for (size_t i = 0; i < kFields.size(); ++i) {
+      indices[i] = kFields[i].m_kind == Field::Kind::Literal ? 0 : next++;
+    }
+    return indices;
+  }();
+
+  template <size_t I, typename Args> static constexpr size_t extraSize(const Args &args)
+  {
+    constexpr Field field = kFields[I];
+    if constexpr (field.m_kind == Field::Kind::String) {
+      return std::string_view(std::get<kValueIndex[I]>(args)).size();
+    } else if constexpr (field.m_kind == Field::Kind::IntList) {
+      return std::get<kValueIndex[I]>(args).size() * field.m_width;
+    } else {
+      return 0;
+    }
+  }
+
+  template <size_t I, typename Args> static uint8_t *encodeField(uint8_t *out, const Args &args)
+  {
+    constexpr Field field = kFields[I];
+    if constexpr (field.m_kind == Field::Kind::Literal) {
+      memcpy(out, F.m_text + field.m_offset, field.m_length);
+      return out + field.m_length;
+    } else if constexpr (field.m_kind == Field::Kind::Int) {
+      return detail::putInt(out, detail::toWire(std::get<kValueIndex[I]>(args)), field.m_width);
+    } else if constexpr (field.m_kind == Field::Kind::String) {
+      const std::string_view text(std::get<kValueIndex[I]>(args));
+      out = detail::putInt(out, static_cast<uint32_t>(text.size()), 4);
+      if (!text.empty()) {
+        memcpy(out, text.data(), text.size());
+      }
+      return out + text.size();
+    } else {
+      const auto &list = std::get<kValueIndex[I]>(args);
+      out = detail::putInt(out, static_cast<uint32_t>(list.size()), 4);
+      for (const auto &value : list) {
+        out = detail::putInt(out, detail::toWire(value), field.m_width);
+      }
+      return out;
+    }
+  }
+
+  template <size_t First, typename Reader, typename... Values> static bool decodeFrom(Reader &reader, Values &...values)
+  {
+    static_assert(sizeof...(Values) == kValues, "wrong number of values for the message format");
+    auto args = std::forward_as_tuple(values...);
+    return [&reader, &args]<size_t... I>(std::index_sequence<I...>) {
+      return ((I < First || decodeField<I>(reader, args)) && ...);
+    }(std::make_index_sequence<kFields.size()>());
+  }
+
+  template <size_t I, typename Reader, typename Args> static bool decodeField(Reader &reader, Args &args)
+  {
+    constexpr Field field = kFields[I];
+    if constexpr (field.m_kind == Field::Kind::Literal) {
+      std::array<char, field.m_length> text;
+      return reader.take(text.data(), text.size()) && memcmp(text.data(), F.m_text + field.m_offset, text.size()) == 0;
+    } else {
+      auto &value = std::get<kValueIndex[I]>(args);
+      using Value = std::remove_reference_t<decltype(value)>;
+      if constexpr (field.m_kind == Field::Kind::Int) {
+        uint32_t wire = 0;
+        if (!detail::takeInt(reader, field.m_width, wire)) {
+          return false;
+        }
+        value = static_cast<Value>(wire);
+        return true;
+      } else if constexpr (field.m_kind == Field::Kind::String) {
+        uint32_t length = 0;
+        if (!detail::takeInt(reader, 4, length)) {
+          return false;
+        }
+        if (length > PROTOCOL_MAX_STRING_LENGTH) {
+          throw BadClientException("Too long message received");
+        }
+        value.resize(length);
+        return reader.take(value.data(), length);
+      } else {
+        uint32_t count = 0;
+        if (!detail::takeInt(reader, 4, count)) {
+          return false;
+        }
+        if (count > PROTOCOL_MAX_LIST_LENGTH) {
+          throw BadClientException("Too long message received");
+        }
+        value.clear();
+        for (uint32_t i = 0; i < count; ++i) {
+          uint32_t wire = 0;
+          if (!detail::takeInt(reader, field.m_width, wire)) {
+            return false;
+          }
+          value.push_back(static_cast<typename Value::value_type>(wire));
+        }
+        return true;
+      }
+    }
+  }
+};
+
+//! @name Messages
+/*!
+The messages in \c ProtocolTypes.h, whose \c kMsg strings are these
+formats.
+*/
+//@{
+using Noop = Message<"CNOP">;
+using Close = Message<"CBYE">;
+using Enter = Message<"CINN%2i%2i%4i%2i">;
+using Leave = Message<"COUT">;
+using GrabClipboard = Message<"CCLP%1i%4i">;
+using ScreenSaver = Message<"CSEC%1i">;
+using ResetOptions = Message<"CROP">;
+using InfoAck = Message<"CIAK">;
+using KeepAlive = Message<"CALV">;
+using KeyDownLang = Message<"DKDL%2i%2i%2i%s">;
+using KeyDown = Message<"DKDN%2i%2i%2i">;
+using KeyDown1_0 = Message<"DKDN%2i%2i">;
+using KeyRepeat = Message<"DKRP%2i%2i%2i%2i%s">;
+using KeyRepeat1_0 = Message<"DKRP%2i%2i%2i">;
+using KeyUp = Message<"DKUP%2i%2i%2i">;
+using KeyUp1_0 = Message<"DKUP%2i%2i">;
+using MouseDown = Message<"DMDN%1i">;
+using MouseUp = Message<"DMUP%1i">;
+using MouseMove = Message<"DMMV%2i%2i">;
+using MouseRelMove = Message<"DMRM%2i%2i">;
+using MouseWheel = Message<"DMWM%2i%2i">;
+using MouseWheel1_0 = Message<"DMWM%2i">;
+using InputBatch = Message<"DINB%4i%s">;
+using Clipboard = Message<"DCLP%1i%4i%1i%s">;
+using Info = Message<"DINF%2i%2i%2i%2i%2i%2i%2i">;
+using SetOptions = Message<"DSOP%4I">;
+using FileTransfer = Message<"DFTR%1i%s">;
+using DragInfo = Message<"DDRG%2i%s">;
+using SecureInputNotification = Message<"SECN%s">;
+using LanguageSynchronisation = Message<"LSYN%s">;
+using Clock = Message<"DCLK%4i%4i">;
+using LatencyReport = Message<"DLAT%4I">;
+using QueryInfo = Message<"QINF">;
+using QueryClock = Message<"QCLK%4i">;
+using Incompatible = Message<"EICV%2i%2i">;
+using Busy = Message<"EBSY">;
+using Unknown = Message<"EUNK">;
+using Bad = Message<"EBAD">;
+//@}
+
+} // namespace deskflow::protocol
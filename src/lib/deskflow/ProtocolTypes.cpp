@@ -7,43 +7,51 @@
 
 #include "deskflow/ProtocolTypes.h"
 
+#include "deskflow/ProtocolCodec.h"
+
+using namespace deskflow::protocol;
+
 // The protocol name string within the hello and hello back messages must be
 // 7 chars for backward compatibility (Synergy and Barrier are 7 chars).
 const char *const kMsgHello = "%7s%2i%2i";
 const char *const kMsgHelloArgs = "%2i%2i";
 const char *const kMsgHelloBack = "%7s%2i%2i%s";
 const char *const kMsgHelloBackArgs = "%2i%2i%s";
-const char *const kMsgCNoop = "CNOP";
-const char *const kMsgCClose = "CBYE";
-const char *const kMsgCEnter = "CINN%2i%2i%4i%2i";
-const char *const kMsgCLeave = "COUT";
-const char *const kMsgCClipboard = "CCLP%1i%4i";
-const char *const kMsgCScreenSaver = "CSEC%1i";
-const char *const kMsgCResetOptions = "CROP";
-const char *const kMsgCInfoAck = "CIAK";
-const char *const kMsgCKeepAlive = "CALV";
-const char *const kMsgDKeyDownLang = "DKDL%2i%2i%2i%s";
-const char *const kMsgDKeyDown = "DKDN%2i%2i%2i";
-const char *const kMsgDKeyDown1_0 = "DKDN%2i%2i";
-const char *const kMsgDKeyRepeat = "DKRP%2i%2i%2i%2i%s";
-const char *const kMsgDKeyRepeat1_0 = "DKRP%2i%2i%2i";
-const char *const kMsgDKeyUp = "DKUP%2i%2i%2i";
-const char *const kMsgDKeyUp1_0 = "DKUP%2i%2i";
-const char *const kMsgDMouseDown = "DMDN%1i";
-const char *const kMsgDMouseUp = "DMUP%1i";
-const char *const kMsgDMouseMove = "DMMV%2i%2i";
-const char *const kMsgDMouseRelMove = "DMRM%2i%2i";
-const char *const kMsgDMouseWheel = "DMWM%2i%2i";
-const char *const kMsgDMouseWheel1_0 = "DMWM%2i";
-const char *const kMsgDClipboard = "DCLP%1i%4i%1i%s";
-const char *const kMsgDInfo = "DINF%2i%2i%2i%2i%2i%2i%2i";
-const char *const kMsgDSetOptions = "DSOP%4I";
-const char *const kMsgDFileTransfer = "DFTR%1i%s";
-const char *const kMsgDDragInfo = "DDRG%2i%s";
-const char *const kMsgDSecureInputNotification = "SECN%s";
-const char *const kMsgDLanguageSynchronisation = "LSYN%s";
-const char *const kMsgQInfo = "QINF";
-const char *const kMsgEIncompatible = "EICV%2i%2i";
-const char *const kMsgEBusy = "EBSY";
-const char *const kMsgEUnknown = "EUNK";
-const char *const kMsgEBad = "EBAD";
+const char *const kMsgCNoop = Noop::kFormat.m_text;
+const char *const kMsgCClose = Close::kFormat.m_text;
+const char *const kMsgCEnter = Enter::kFormat.m_text;
+const char *const kMsgCLeave = Leave::kFormat.m_text;
+const char *const kMsgCClipboard = GrabClipboard::kFormat.m_text;
+const char *const kMsgCScreenSaver = ScreenSaver::kFormat.m_text;
+const char *const kMsgCResetOptions = ResetOptions::kFormat.m_text;
+const char *const kMsgCInfoAck = InfoAck::kFormat.m_text;
+const char *const kMsgCKeepAlive = KeepAlive::kFormat.m_text;
+const char *const kMsgDKeyDownLang = KeyDownLang::kFormat.m_text;
+const char *const kMsgDKeyDown = KeyDown::kFormat.m_text;
+const char *const kMsgDKeyDown1_0 = KeyDown1_0::kFormat.m_text;
+const char *const kMsgDKeyRepeat = KeyRepeat::kFormat.m_text;
+const char *const kMsgDKeyRepeat1_0 = KeyRepeat1_0::kFormat.m_text;
+const char *const kMsgDKeyUp = KeyUp::kFormat.m_text;
+const char *const kMsgDKeyUp1_0 = KeyUp1_0::kFormat.m_text;
+const char *const kMsgDMouseDown = MouseDown::kFormat.m_text;
+const char *const kMsgDMouseUp = MouseUp::kFormat.m_text;
+const char *const kMsgDMouseMove = MouseMove::kFormat.m_text;
+const char *const kMsgDMouseRelMove = MouseRelMove::kFormat.m_text;
+const char *const kMsgDMouseWheel = MouseWheel::kFormat.m_text;
+const char *const kMsgDMouseWheel1_0 = MouseWheel1_0::kFormat.m_text;
+const char *const kMsgDInputBatch = InputBatch::kFormat.m_text;
+const char *const kMsgDClipboard = Clipboard::kFormat.m_text;
+const char *const kMsgDInfo = Info::kFormat.m_text;
+const char *const kMsgDSetOptions = SetOptions::kFormat.m_text;
+const char *const kMsgDFileTransfer = FileTransfer::kFormat.m_text;
+const char *const kMsgDDragInfo = DragInfo::kFormat.m_text;
+const char *const kMsgDSecureInputNotification = SecureInputNotification::kFormat.m_text;
+const char *const kMsgDLanguageSynchronisation = LanguageSynchronisation::kFormat.m_text;
+const char *const kMsgDClock = Clock::kFormat.m_text;
+const char *const kMsgDLatency = LatencyReport::kFormat.m_text;
+const char *const kMsgQInfo = QueryInfo::kFormat.m_text;
+const char *const kMsgQClock = QueryClock::kFormat.m_text;
+const char *const kMsgEIncompatible = Incompatible::kFormat.m_text;
+const char *const kMsgEBusy = Busy::kFormat.m_text;
+const char *const kMsgEUnknown = Unknown::kFormat.m_text;
+const char *const kMsgEBad = Bad::kFormat.m_text;
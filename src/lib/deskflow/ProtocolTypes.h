@@ -45,7 +45,41 @@ static const int16_t kProtocolMajorVersion = 1;
  * @note When incrementing the minor version, the Deskflow application version should also increment
  * @since Protocol version 1.0
  */
-static const int16_t kProtocolMinorVersion = 8;
+static const int16_t kProtocolMinorVersion = 9;
+
+/**
+ * @brief First protocol minor version that accepts compressed packets
+ *
+ * Once this version or later is negotiated, either side may send packets
+ * compressed, flagged by the top bit of the packet length.
+ *
+ * @see PacketStreamFilter::setCompression
+ * @since Protocol version 1.9
+ */
+static const int16_t kCompressionMinorVersion = 9;
+
+/**
+ * @brief First protocol minor version that sends input in batches
+ *
+ * Once this version or later is negotiated, the primary may send input
+ * events to the secondary in a \c kMsgDInputBatch.
+ *
+ * @see kMsgDInputBatch
+ * @since Protocol version 1.9
+ */
+static const int16_t kInputBatchMinorVersion = 9;
+
+/**
+ * @brief First protocol minor version that measures input latency
+ *
+ * Once this version or later is negotiated, the secondary queries the
+ * primary's clock with each keep alive and reports the latency of the
+ * input it injects.
+ *
+ * @see kMsgQClock, kMsgDLatency
+ * @since Protocol version 1.9
+ */
+static const int16_t kInputLatencyMinorVersion = 9;
 
 /**
  * @brief Default TCP port for Deskflow connections
@@ -863,6 +897,39 @@ extern const char *const kMsgDMouseWheel;
  */
 extern const char *const kMsgDMouseWheel1_0;
 
+/**
+ * @brief Batched input events
+ *
+ * **Message Code**: `"DINB"`
+ * **Direction**: Primary → Secondary
+ * **Format**: `"DINB%4i%s"`
+ * **Parameters**:
+ * - `$1`: Time of the first event (4 bytes, unsigned) - Sender's clock, in milliseconds
+ * - `$2`: Events (string) - Records encoded by deskflow::InputRecords
+ *
+ * Carries a run of mouse and key events in one message.  Each record is a
+ * type byte, the milliseconds since `$1` as a varint, then the event's
+ * fields as varints:
+ *
+ * | Type | Event | Fields |
+ * |---|---|---|
+ * | 1 | Mouse move | X, Y change from the previous move in the batch (zigzag) |
+ * | 2 | Relative mouse move | X, Y motion (zigzag) |
+ * | 3 | Mouse wheel | X, Y delta (zigzag) |
+ * | 4 | Mouse down | Button |
+ * | 5 | Mouse up | Button |
+ * | 6 | Key down | Key, modifier mask, key button, language (length and bytes) |
+ * | 7 | Key repeat | Key, modifier mask, key button, count, language |
+ * | 8 | Key up | Key, modifier mask, key button |
+ *
+ * The first mouse move in a batch is relative to (0, 0).  Events are
+ * applied in order, exactly as if each had been sent as its own message.
+ *
+ * @see kMsgDMouseMove, kMsgDKeyDownLang
+ * @since Protocol version 1.9
+ */
+extern const char *const kMsgDInputBatch;
+
 /** @} */ // end of protocol_mouse group
 
 /**
@@ -1126,6 +1193,47 @@ extern const char *const kMsgDSecureInputNotification;
  */
 extern const char *const kMsgDLanguageSynchronisation;
 
+/**
+ * @brief Clock reading
+ *
+ * **Message Code**: `"DCLK"`
+ * **Direction**: Primary → Secondary
+ * **Format**: `"DCLK%4i%4i"`
+ * **Parameters**:
+ * - `$1`: Secondary time (4 bytes, unsigned) - `$1` of the kMsgQClock being answered
+ * - `$2`: Primary time (4 bytes, unsigned) - Primary's clock when replying, in milliseconds
+ *
+ * Lets the secondary estimate the offset between the two clocks, so it
+ * can tell how long ago the events in a kMsgDInputBatch were captured.
+ *
+ * @see kMsgQClock, deskflow::InputLatency
+ * @since Protocol version 1.9
+ */
+extern const char *const kMsgDClock;
+
+/**
+ * @brief Input latency report
+ *
+ * **Message Code**: `"DLAT"`
+ * **Direction**: Secondary → Primary
+ * **Format**: `"DLAT%4I"`
+ * **Parameters**:
+ * - `$1`: Counts (list of 4 byte integers) - Latency histograms
+ *
+ * Counts the input events injected since the last report by how long
+ * they took from capture to injection.  The list holds 3 histograms of
+ * 24 buckets each: capture to the message being read, message read to
+ * injection starting, and injection.  Bucket `i` counts latencies under
+ * 2^i microseconds, the last bucket also counts anything longer.
+ *
+ * Sent with the reply to a kMsgCKeepAlive, when there is anything to
+ * report.
+ *
+ * @see deskflow::InputLatency
+ * @since Protocol version 1.9
+ */
+extern const char *const kMsgDLatency;
+
 /** @} */ // end of protocol_system group
 
 /** @} */ // end of protocol_data group
@@ -1159,6 +1267,23 @@ extern const char *const kMsgDLanguageSynchronisation;
  */
 extern const char *const kMsgQInfo;
 
+/**
+ * @brief Query primary clock
+ *
+ * **Message Code**: `"QCLK"`
+ * **Direction**: Secondary → Primary
+ * **Format**: `"QCLK%4i"`
+ * **Parameters**:
+ * - `$1`: Secondary time (4 bytes, unsigned) - Secondary's clock when sending, in milliseconds
+ *
+ * Sent by the secondary with each reply to a kMsgCKeepAlive.  The
+ * primary answers straight away with a kMsgDClock.
+ *
+ * @see kMsgDClock
+ * @since Protocol version 1.9
+ */
+extern const char *const kMsgQClock;
+
 /** @} */ // end of protocol_queries group
 
 /**
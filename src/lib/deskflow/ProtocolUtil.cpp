@@ -23,6 +23,9 @@
 
 namespace {
 
+// largest formatting buffer kept for the next message
+const size_t s_maxKeptBufferSize = 64 * 1024;
+
 void writeInt(uint32_t Value, uint32_t Length, std::vector<uint8_t> &Buffer)
 {
   switch (Length) {
@@ -114,18 +117,26 @@ void ProtocolUtil::vwritef(deskflow::IStream *stream, const char *fmt, uint32_t
     return;
   }
 
-  // fill buffer
-  std::vector<uint8_t> Buffer;
+  // fill buffer.  the buffer is reused by each thread's messages so
+  // formatting doesn't allocate, unless a message was unusually large.
+  thread_local std::vector<uint8_t> Buffer;
+  Buffer.clear();
+  Buffer.reserve(size);
   writef(Buffer, fmt, args);
+  const std::span<const uint8_t> message(Buffer.data(), size);
 
   try {
     // write buffer
-    stream->write(Buffer.data(), size);
+    stream->writev(&message, 1);
     LOG_VERBOSE("wrote %d bytes", size);
   } catch (const BaseException &exception) {
     LOG_VERBOSE("exception <%s> during wrote %d bytes into stream", exception.what(), size);
     throw;
   }
+
+  if (Buffer.capacity() > s_maxKeptBufferSize) {
+    std::vector<uint8_t>().swap(Buffer);
+  }
 }
 
 void ProtocolUtil::vreadf(deskflow::IStream *stream, const char *fmt, va_list args)
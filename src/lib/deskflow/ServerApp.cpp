@@ -462,6 +462,8 @@ ClientListener *ServerApp::openClientListener(const NetworkAddress &address)
 Server *ServerApp::openServer(ServerConfig &config, PrimaryClient *primaryClient)
 {
   auto *server = new Server(config, primaryClient, m_serverScreen, getEvents());
+  server->setMotionCoalescing(Settings::value(Settings::Server::CoalesceMotion).toBool());
+  server->setWriteBatching(std::chrono::microseconds(Settings::value(Settings::Server::WriteBatchDelay).toInt()));
   try {
     getEvents()->addHandler(EventTypes::ServerScreenSwitched, server, [this](const auto &) { handleScreenSwitched(); });
 
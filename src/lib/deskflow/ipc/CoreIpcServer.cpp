@@ -6,8 +6,10 @@
 
 #include "CoreIpcServer.h"
 
+#include "base/EventQueueStats.h"
 #include "base/Log.h"
 #include "common/Constants.h"
+#include "io/ConnectionStats.h"
 
 #include <QLocalSocket>
 
@@ -27,9 +29,13 @@ CoreIpcServer &CoreIpcServer::instance()
   return *s_instance;
 }
 
+void CoreIpcServer::setEventQueueStats(EventQueueStats *stats)
+{
+  m_eventQueueStats = stats;
+}
+
 void CoreIpcServer::processCommand(QLocalSocket *clientSocket, const QString &command, const QStringList &parts)
 {
-  Q_UNUSED(parts)
   if (command == QStringLiteral("stop")) {
     LOG_DEBUG("core ipc server got stop message");
     writeToClientSocket(clientSocket, QStringLiteral("ok"));
@@ -37,7 +43,52 @@ void CoreIpcServer::processCommand(QLocalSocket *clientSocket, const QString &co
     Q_EMIT stopProcessRequested();
     return;
   }
+  if (command == QStringLiteral("eventStats")) {
+    processEventStatsCommand(clientSocket, parts);
+    return;
+  }
+  if (command == QStringLiteral("connectionStats")) {
+    // reply with one "; " separated entry per network connection
+    QStringList entries;
+    for (const auto &line : ConnectionStats::reportAll()) {
+      entries.append(QString::fromStdString(line));
+    }
+    writeToClientSocket(clientSocket, QStringLiteral("connectionStats=%1").arg(entries.join(QStringLiteral("; "))));
+    return;
+  }
   LOG_WARN("core ipc server got unknown command: %s", command.toUtf8().constData());
 }
 
+void CoreIpcServer::processEventStatsCommand(QLocalSocket *clientSocket, const QStringList &parts)
+{
+  // eventStats         reply with one "; " separated entry per event type
+  // eventStats=on|off  start or stop collecting
+  // eventStats=reset   zero the counters
+  if (m_eventQueueStats == nullptr) {
+    writeToClientSocket(clientSocket, QStringLiteral("error=no event queue"));
+    return;
+  }
+
+  const auto action = parts.size() >= 2 ? parts.at(1) : QString();
+  if (action == QStringLiteral("on") || action == QStringLiteral("off")) {
+    LOG_DEBUG("core ipc server turning event stats %s", action.toUtf8().constData());
+    m_eventQueueStats->setEnabled(action == QStringLiteral("on"));
+    writeToClientSocket(clientSocket, QStringLiteral("ok"));
+  } else if (action == QStringLiteral("reset")) {
+    m_eventQueueStats->reset();
+    writeToClientSocket(clientSocket, QStringLiteral("ok"));
+  } else if (action.isEmpty()) {
+    QStringList entries;
+    for (const auto &line : m_eventQueueStats->report()) {
+      entries.append(QString::fromStdString(line));
+    }
+    if (!m_eventQueueStats->isEnabled()) {
+      entries.prepend(QStringLiteral("disabled"));
+    }
+    writeToClientSocket(clientSocket, QStringLiteral("eventStats=%1").arg(entries.join(QStringLiteral("; "))));
+  } else {
+    writeToClientSocket(clientSocket, QStringLiteral("error=unknown eventStats action"));
+  }
+}
+
 } // namespace deskflow::core::ipc
@@ -11,6 +11,7 @@
 #include <QObject>
 #include <QSet>
 
+class EventQueueStats;
 class QLocalSocket;
 
 namespace deskflow::core::ipc {
@@ -24,8 +25,17 @@ public:
 
   static CoreIpcServer &instance();
 
+  /**
+   * @brief Set the event queue stats reported by the \c eventStats command
+   * @param stats Must outlive the server, or nullptr to report nothing
+   */
+  void setEventQueueStats(EventQueueStats *stats);
+
 private:
   void processCommand(QLocalSocket *clientSocket, const QString &command, const QStringList &parts) override;
+  void processEventStatsCommand(QLocalSocket *clientSocket, const QStringList &parts);
+
+  EventQueueStats *m_eventQueueStats = nullptr;
 };
 
 } // namespace deskflow::core::ipc
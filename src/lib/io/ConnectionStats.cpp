@@ -0,0 +1,270 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "io/ConnectionStats.h"
+
+#include "base/String.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+// most message codes listed in a report line
+const size_t s_maxReportedMessages = 8;
+
+// latency parts as reported, in LatencyPart order
+const std::array<const char *, ConnectionStats::kLatencyParts> s_latencyPartNames = {"network", "queue", "injection"};
+
+struct Registry
+{
+  std::mutex m_mutex;
+  std::vector<const ConnectionStats *> m_connections;
+};
+
+Registry &registry()
+{
+  static Registry s_registry;
+  return s_registry;
+}
+
+template <typename T> void storeMax(std::atomic<T> &target, T value)
+{
+  T current = target.load(std::memory_order_relaxed);
+  while (current < value && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    // current was reloaded, try again
+  }
+}
+
+std::string formatDuration(MonotonicClock::duration duration)
+{
+  const auto ns = static_cast<double>(duration.count());
+  if (ns < 1.0e+6) {
+    return deskflow::string::sprintf("%.0fus", ns / 1.0e+3);
+  }
+  if (ns < 1.0e+9) {
+    return deskflow::string::sprintf("%.1fms", ns / 1.0e+6);
+  }
+  return deskflow::string::sprintf("%.2fs", ns / 1.0e+9);
+}
+
+MonotonicClock::duration load(const std::atomic<MonotonicClock::rep> &value)
+{
+  return MonotonicClock::duration(value.load(std::memory_order_relaxed));
+}
+
+// the limit of the bucket the latency at \p fraction of the counts is in
+MonotonicClock::duration latencyPercentile(const ConnectionStats::LatencyHistogram &histogram, double fraction)
+{
+  uint64_t total = 0;
+  for (const auto count : histogram) {
+    total += count;
+  }
+  const auto rank = std::max(uint64_t{1}, static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(total))));
+  uint64_t seen = 0;
+  size_t bucket = 0;
+  for (; bucket + 1 < histogram.size(); ++bucket) {
+    seen += histogram[bucket];
+    if (seen >= rank) {
+      break;
+    }
+  }
+  return std::chrono::microseconds(uint64_t{1} << bucket);
+}
+
+} // namespace
+
+//
+// ConnectionStats
+//
+
+ConnectionStats::ConnectionStats()
+{
+  auto &connections = registry();
+  std::scoped_lock lock{connections.m_mutex};
+  connections.m_connections.push_back(this);
+}
+
+ConnectionStats::~ConnectionStats()
+{
+  auto &connections = registry();
+  std::scoped_lock lock{connections.m_mutex};
+  std::erase(connections.m_connections, this);
+}
+
+void ConnectionStats::setName(const std::string &name)
+{
+  std::scoped_lock lock{m_mutex};
+  m_name = name;
+}
+
+void ConnectionStats::recordInput(size_t n, uint32_t buffered)
+{
+  m_bytesIn.fetch_add(n, std::memory_order_relaxed);
+  storeMax(m_inputHighWater, buffered);
+}
+
+void ConnectionStats::recordOutputBuffered(uint32_t buffered)
+{
+  storeMax(m_outputHighWater, buffered);
+}
+
+void ConnectionStats::setMessageCounter(MessageCounter *counter)
+{
+  // taking the lock waits for any snapshot() still reading the old counter
+  std::scoped_lock lock{m_mutex};
+  m_messageCounter.store(counter, std::memory_order_release);
+}
+
+void ConnectionStats::recordRtt(MonotonicClock::duration rtt)
+{
+  const auto value = rtt.count();
+  m_rtt.store(value, std::memory_order_relaxed);
+  storeMax(m_maxRtt, value);
+
+  // zero means no sample yet
+  if (m_rttSamples.fetch_add(1, std::memory_order_relaxed) == 0) {
+    m_minRtt.store(value, std::memory_order_relaxed);
+  } else {
+    auto current = m_minRtt.load(std::memory_order_relaxed);
+    while (value < current && !m_minRtt.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+      // current was reloaded, try again
+    }
+  }
+}
+
+void ConnectionStats::recordTcpInfo(MonotonicClock::duration rtt, MonotonicClock::duration rttVar, uint32_t retransmits)
+{
+  m_tcpRtt.store(rtt.count(), std::memory_order_relaxed);
+  m_tcpRttVar.store(rttVar.count(), std::memory_order_relaxed);
+  m_tcpRetransmits.store(retransmits, std::memory_order_relaxed);
+  m_hasTcpInfo.store(true, std::memory_order_relaxed);
+}
+
+void ConnectionStats::recordLatency(LatencyPart part, MonotonicClock::duration latency)
+{
+  m_latency[static_cast<size_t>(part)][latencyBucket(latency)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void ConnectionStats::addLatency(LatencyPart part, const LatencyHistogram &histogram)
+{
+  auto &buckets = m_latency[static_cast<size_t>(part)];
+  for (size_t i = 0; i < kLatencyBuckets; ++i) {
+    if (histogram[i] != 0) {
+      buckets[i].fetch_add(histogram[i], std::memory_order_relaxed);
+    }
+  }
+}
+
+ConnectionStats::Snapshot ConnectionStats::snapshot() const
+{
+  Snapshot snapshot;
+  snapshot.m_bytesIn = m_bytesIn.load(std::memory_order_relaxed);
+  snapshot.m_bytesOut = m_bytesOut.load(std::memory_order_relaxed);
+  snapshot.m_inputHighWater = m_inputHighWater.load(std::memory_order_relaxed);
+  snapshot.m_outputHighWater = m_outputHighWater.load(std::memory_order_relaxed);
+  snapshot.m_tlsRecordsIn = m_tlsRecordsIn.load(std::memory_order_relaxed);
+  snapshot.m_tlsRecordsOut = m_tlsRecordsOut.load(std::memory_order_relaxed);
+  snapshot.m_rttSamples = m_rttSamples.load(std::memory_order_relaxed);
+  snapshot.m_rtt = load(m_rtt);
+  snapshot.m_minRtt = load(m_minRtt);
+  snapshot.m_maxRtt = load(m_maxRtt);
+  snapshot.m_hasTcpInfo = m_hasTcpInfo.load(std::memory_order_relaxed);
+  snapshot.m_tcpRtt = load(m_tcpRtt);
+  snapshot.m_tcpRttVar = load(m_tcpRttVar);
+  snapshot.m_tcpRetransmits = m_tcpRetransmits.load(std::memory_order_relaxed);
+  for (size_t part = 0; part < kLatencyParts; ++part) {
+    for (size_t i = 0; i < kLatencyBuckets; ++i) {
+      snapshot.m_latency[part][i] = m_latency[part][i].load(std::memory_order_relaxed);
+    }
+  }
+
+  std::scoped_lock lock{m_mutex};
+  snapshot.m_name = m_name;
+  if (const auto *counter = m_messageCounter.load(std::memory_order_relaxed); counter != nullptr) {
+    snapshot.m_messages = counter->messageCounts();
+  }
+  return snapshot;
+}
+
+std::string ConnectionStats::report() const
+{
+  auto stats = snapshot();
+
+  std::string line = deskflow::string::sprintf(
+      "%s: in %llu bytes, out %llu bytes, buffered in max %u, buffered out max %u",
+      stats.m_name.empty() ? "unnamed" : stats.m_name.c_str(), static_cast<unsigned long long>(stats.m_bytesIn),
+      static_cast<unsigned long long>(stats.m_bytesOut), stats.m_inputHighWater, stats.m_outputHighWater
+  );
+  if (stats.m_tlsRecordsIn != 0 || stats.m_tlsRecordsOut != 0) {
+    line += deskflow::string::sprintf(
+        ", tls records in %llu out %llu", static_cast<unsigned long long>(stats.m_tlsRecordsIn),
+        static_cast<unsigned long long>(stats.m_tlsRecordsOut)
+    );
+  }
+  if (stats.m_rttSamples != 0) {
+    line += deskflow::string::sprintf(
+        ", rtt %s min %s max %s", formatDuration(stats.m_rtt).c_str(), formatDuration(stats.m_minRtt).c_str(),
+        formatDuration(stats.m_maxRtt).c_str()
+    );
+  }
+  if (stats.m_hasTcpInfo) {
+    line += deskflow::string::sprintf(
+        ", tcp rtt %s var %s, retransmits %u", formatDuration(stats.m_tcpRtt).c_str(),
+        formatDuration(stats.m_tcpRttVar).c_str(), stats.m_tcpRetransmits
+    );
+  }
+  for (size_t part = 0; part < kLatencyParts; ++part) {
+    const auto &histogram = stats.m_latency[part];
+    if (std::ranges::any_of(histogram, [](uint64_t count) { return count != 0; })) {
+      // bucket limits, so each is an upper bound
+      line += deskflow::string::sprintf(
+          ", %s latency p50 <%s p99 <%s", s_latencyPartNames[part],
+          formatDuration(latencyPercentile(histogram, 0.5)).c_str(),
+          formatDuration(latencyPercentile(histogram, 0.99)).c_str()
+      );
+    }
+  }
+
+  // busiest messages first
+  std::ranges::stable_sort(stats.m_messages, [](const MessageCount &a, const MessageCount &b) {
+    return a.m_in + a.m_out > b.m_in + b.m_out;
+  });
+  if (stats.m_messages.size() > s_maxReportedMessages) {
+    stats.m_messages.resize(s_maxReportedMessages);
+  }
+  for (const auto &count : stats.m_messages) {
+    line += deskflow::string::sprintf(
+        ", %.4s %llu/%llu", count.m_code.data(), static_cast<unsigned long long>(count.m_in),
+        static_cast<unsigned long long>(count.m_out)
+    );
+  }
+  return line;
+}
+
+std::vector<std::string> ConnectionStats::reportAll()
+{
+  auto &connections = registry();
+  std::scoped_lock lock{connections.m_mutex};
+  std::vector<std::string> lines;
+  lines.reserve(connections.m_connections.size());
+  for (const auto *stats : connections.m_connections) {
+    lines.push_back(stats->report());
+  }
+  return lines;
+}
+
+size_t ConnectionStats::latencyBucket(MonotonicClock::duration latency)
+{
+  const auto us = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+  if (us <= 0) {
+    return 0;
+  }
+  const auto bucket = static_cast<size_t>(std::bit_width(static_cast<uint64_t>(us)));
+  return std::min(bucket, kLatencyBuckets - 1);
+}
@@ -0,0 +1,204 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include "arch/MonotonicClock.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//! Network connection telemetry
+/*!
+Counts the traffic on one connection: bytes and messages each way, with
+messages counted by their 4 byte code, the most data its input and
+output buffers have held, TLS records, keep alive round trip times,
+where the platform reports it, the kernel's TCP round trip estimate and,
+for protocol 1.9 connections, histograms of the time input events take
+from capture on the server to injection on the client.
+
+Messages are counted by the connection's MessageCounter, the protocol's
+message table, which already looks up every message it receives.
+
+Every live instance is listed in a process wide registry so that all
+connections can be reported from any thread, e.g. by the core IPC
+server.  Counters are relaxed atomics apart from the name and the
+message counter, which have their own lock, so a report is a close
+approximation rather than a consistent snapshot.
+*/
+class ConnectionStats
+{
+public:
+  //! Messages with one code
+  struct MessageCount
+  {
+    std::array<char, 4> m_code{};
+    uint64_t m_in = 0;
+    uint64_t m_out = 0;
+  };
+
+  //! Counts a connection's messages by code
+  class MessageCounter
+  {
+  public:
+    virtual ~MessageCounter() = default;
+
+    //! Count a message sent, \p code is its first 4 bytes
+    virtual void countSent(const void *code) = 0;
+
+    //! Get the messages received and sent, in code order
+    virtual std::vector<MessageCount> messageCounts() const = 0;
+  };
+
+  //! A part of the time from input capture to injection
+  enum class LatencyPart
+  {
+    Network,  //!< Capture on the server to the client reading the message
+    Queue,    //!< Message read to injection starting
+    Injection //!< Injecting the event into the client's screen
+  };
+
+  //! Number of latency parts
+  static constexpr size_t kLatencyParts = 3;
+
+  //! Number of latency histogram buckets
+  static constexpr size_t kLatencyBuckets = 24;
+
+  //! Latency counts, bucket \c i counts latencies under 2^i microseconds
+  /*!
+  Each bucket holds the latencies from the previous bucket's limit up to
+  its own, the last bucket also holds everything longer.
+  */
+  using LatencyHistogram = std::array<uint64_t, kLatencyBuckets>;
+
+  //! Counters for one connection
+  struct Snapshot
+  {
+    std::string m_name;
+    uint64_t m_bytesIn = 0;
+    uint64_t m_bytesOut = 0;
+    uint32_t m_inputHighWater = 0;
+    uint32_t m_outputHighWater = 0;
+    uint64_t m_tlsRecordsIn = 0;
+    uint64_t m_tlsRecordsOut = 0;
+    uint64_t m_rttSamples = 0;
+    MonotonicClock::duration m_rtt{};    //!< Latest keep alive round trip
+    MonotonicClock::duration m_minRtt{}; //!< Shortest keep alive round trip
+    MonotonicClock::duration m_maxRtt{}; //!< Longest keep alive round trip
+    bool m_hasTcpInfo = false;
+    MonotonicClock::duration m_tcpRtt{};    //!< Kernel's smoothed round trip time
+    MonotonicClock::duration m_tcpRttVar{}; //!< Kernel's round trip time variation
+    uint32_t m_tcpRetransmits = 0;          //!< Segments the kernel has retransmitted
+    //! Input latency counts, indexed by LatencyPart
+    std::array<LatencyHistogram, kLatencyParts> m_latency{};
+    std::vector<MessageCount> m_messages;
+  };
+
+  ConnectionStats();
+  ConnectionStats(ConnectionStats const &) = delete;
+  ConnectionStats(ConnectionStats &&) = delete;
+  ~ConnectionStats();
+
+  ConnectionStats &operator=(ConnectionStats const &) = delete;
+  ConnectionStats &operator=(ConnectionStats &&) = delete;
+
+  //! @name manipulators
+  //@{
+
+  //! Set the name the connection is reported under
+  void setName(const std::string &name);
+
+  //! Record \p n bytes received, leaving \p buffered bytes unread
+  void recordInput(size_t n, uint32_t buffered);
+
+  //! Record \p n bytes sent
+  void recordOutput(size_t n)
+  {
+    m_bytesOut.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  //! Record \p buffered bytes waiting to be sent
+  void recordOutputBuffered(uint32_t buffered);
+
+  //! Record TLS records received and sent
+  void recordTlsRecords(uint64_t in, uint64_t out)
+  {
+    m_tlsRecordsIn.fetch_add(in, std::memory_order_relaxed);
+    m_tlsRecordsOut.fetch_add(out, std::memory_order_relaxed);
+  }
+
+  //! Set what counts the connection's messages
+  /*!
+  \p counter, or nullptr for none, is read by snapshot() and told about
+  each message sent.  It must stay valid until replaced, and messages
+  must be sent on the thread that sets it.
+  */
+  void setMessageCounter(MessageCounter *counter);
+
+  //! Record a message sent, \p code is its first 4 bytes
+  void recordMessageOut(const void *code)
+  {
+    if (auto *counter = m_messageCounter.load(std::memory_order_acquire); counter != nullptr) {
+      counter->countSent(code);
+    }
+  }
+
+  //! Record a keep alive round trip
+  void recordRtt(MonotonicClock::duration rtt);
+
+  //! Record the kernel's view of the connection
+  void recordTcpInfo(MonotonicClock::duration rtt, MonotonicClock::duration rttVar, uint32_t retransmits);
+
+  //! Record one input event's latency
+  void recordLatency(LatencyPart part, MonotonicClock::duration latency);
+
+  //! Add latencies counted elsewhere, e.g. by the other end of the connection
+  void addLatency(LatencyPart part, const LatencyHistogram &histogram);
+
+  //@}
+  //! @name accessors
+  //@{
+
+  //! Get the counters
+  Snapshot snapshot() const;
+
+  //! Get the counters as one line
+  std::string report() const;
+
+  //! Get a report with one line per live connection
+  static std::vector<std::string> reportAll();
+
+  //! Get the LatencyHistogram bucket \p latency is counted in
+  static size_t latencyBucket(MonotonicClock::duration latency);
+
+  //@}
+
+private:
+  std::atomic<uint64_t> m_bytesIn = 0;
+  std::atomic<uint64_t> m_bytesOut = 0;
+  std::atomic<uint32_t> m_inputHighWater = 0;
+  std::atomic<uint32_t> m_outputHighWater = 0;
+  std::atomic<uint64_t> m_tlsRecordsIn = 0;
+  std::atomic<uint64_t> m_tlsRecordsOut = 0;
+  std::atomic<uint64_t> m_rttSamples = 0;
+  std::atomic<MonotonicClock::rep> m_rtt = 0;
+  std::atomic<MonotonicClock::rep> m_minRtt = 0;
+  std::atomic<MonotonicClock::rep> m_maxRtt = 0;
+  std::atomic<bool> m_hasTcpInfo = false;
+  std::atomic<MonotonicClock::rep> m_tcpRtt = 0;
+  std::atomic<MonotonicClock::rep> m_tcpRttVar = 0;
+  std::atomic<uint32_t> m_tcpRetransmits = 0;
+  std::array<std::array<std::atomic<uint64_t>, kLatencyBuckets>, kLatencyParts> m_latency{};
+  std::atomic<MessageCounter *> m_messageCounter = nullptr;
+
+  mutable std::mutex m_mutex;
+  std::string m_name;
+};
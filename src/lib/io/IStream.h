@@ -8,8 +8,13 @@
 
 #pragma once
 
+#include "arch/MonotonicClock.h"
+
+#include <cstddef>
 #include <cstdint>
+#include <span>
 
+class ConnectionStats;
 class IEventQueue;
 
 namespace deskflow {
@@ -21,6 +26,20 @@ Defines the interface for all streams.
 class IStream
 {
 public:
+  //! Output counters
+  struct OutputStats
+  {
+    uint64_t m_batches = 0;         //!< Batches sent
+    uint64_t m_writes = 0;          //!< Writes sent in batches
+    uint64_t m_bytes = 0;           //!< Bytes sent in batches
+    uint64_t m_full = 0;            //!< Batches sent early because they reached the size limit
+    uint64_t m_urgent = 0;          //!< Batches sent early by \c sendBatch()
+    uint32_t m_maxWrites = 0;       //!< Most writes in one batch
+    uint64_t m_motionCoalesced = 0; //!< Held back mouse motion replaced by later motion
+    uint64_t m_compressed = 0;      //!< Messages sent compressed
+    uint64_t m_compressedSaved = 0; //!< Bytes saved by compressing messages
+  };
+
   IStream() = default;
   virtual ~IStream() = default;
   //! @name manipulators
@@ -53,12 +72,62 @@ public:
   */
   virtual void write(const void *buffer, uint32_t n) = 0;
 
+  //! Write several buffers to stream
+  /*!
+  Write the \c count buffers in \c buffers to the stream, in order, as
+  if by one \c write() of their concatenation.  Streams that buffer
+  output should override this to append all of them at once, so a
+  message and its framing cost one write and are never split by data
+  from another thread.  The default calls \c write() for each buffer.
+  */
+  virtual void writev(const std::span<const uint8_t> buffers[], size_t count)
+  {
+    for (size_t i = 0; i < count; ++i) {
+      write(buffers[i].data(), static_cast<uint32_t>(buffers[i].size()));
+    }
+  }
+
   //! Flush the stream
   /*!
   Waits until all buffered data has been written to the stream.
   */
   virtual void flush() = 0;
 
+  //! Batch writes
+  /*!
+  Let output written while nothing else is waiting to be sent wait up to
+  \c maxDelay, or until \c maxSize bytes are waiting, so that a run of
+  small writes goes out together.  A zero \c maxDelay sends every write
+  as soon as possible, which is the default.  Streams that can't batch
+  ignore this.
+  */
+  virtual void setWriteBatching(MonotonicClock::duration, uint32_t)
+  {
+    // do nothing
+  }
+
+  //! Send batched writes now
+  /*!
+  Sends any output held back by write batching without waiting for the
+  rest of the batch.  Call this after a write that shouldn't be delayed.
+  */
+  virtual void sendBatch()
+  {
+    // do nothing
+  }
+
+  //! Compress large messages
+  /*!
+  Compress messages written from now on that are large enough to be worth
+  it, and accept compressed messages read from now on.  Only enable this
+  once the peer is known to accept compressed messages.  Streams that
+  don't frame messages ignore this.
+  */
+  virtual void setCompression(bool)
+  {
+    // do nothing
+  }
+
   //! Shutdown input
   /*!
   Shutdown the input side of the stream.  Any pending input data is
@@ -102,6 +171,37 @@ public:
   */
   virtual uint32_t getSize() const = 0;
 
+  //! Get bytes waiting to be sent
+  /*!
+  Returns the number of bytes written to the stream that haven't been
+  sent yet, or zero if the stream doesn't know.
+  */
+  virtual uint32_t getOutputSize() const
+  {
+    return 0;
+  }
+
+  //! Get output counters
+  /*!
+  Returns counters for write batching since it was turned on and for
+  output dropped under backpressure.  Counters a stream doesn't keep
+  are zero.
+  */
+  virtual OutputStats getOutputStats() const
+  {
+    return {};
+  }
+
+  //! Get connection telemetry
+  /*!
+  Returns the telemetry of the connection the stream reads and writes,
+  or nullptr if it isn't a network connection.
+  */
+  virtual ConnectionStats *getConnectionStats()
+  {
+    return nullptr;
+  }
+
   //@}
 };
 
@@ -7,13 +7,16 @@
 
 #include "io/StreamBuffer.h"
 
+#include <algorithm>
 #include <assert.h>
+#include <cstring>
 
 //
 // StreamBuffer
 //
 
 const uint32_t StreamBuffer::kChunkSize = 4096;
+const size_t StreamBuffer::kMaxSpareChunks = 8;
 
 const void *StreamBuffer::peek(uint32_t n)
 {
@@ -25,47 +28,42 @@ const void *StreamBuffer::peek(uint32_t n)
     return nullptr;
   }
 
-  // reserve space in first chunk
-  auto head = m_chunks.begin();
-  head->reserve(n + m_headUsed);
-
-  // consolidate chunks into the first chunk until it has n bytes
-  ChunkList::iterator scan = head;
-  ++scan;
-  while (head->size() - m_headUsed < n && scan != m_chunks.end()) {
-    head->insert(head->end(), scan->begin(), scan->end());
-    scan = m_chunks.erase(scan);
+  // return the data in place if it doesn't cross a chunk boundary
+  if (m_headUsed + n <= kChunkSize) {
+    return m_chunks.front().get() + m_headUsed;
   }
 
-  return static_cast<const void *>(&(head->begin()[m_headUsed]));
+  m_peek.resize(n);
+  peek(m_peek.data(), n);
+  return m_peek.data();
 }
 
 void StreamBuffer::pop(uint32_t n)
 {
   // discard all chunks if n is greater than or equal to m_size
   if (n >= m_size) {
+    while (!m_chunks.empty()) {
+      recycleChunk(std::move(m_chunks.front()));
+      m_chunks.pop_front();
+    }
     m_size = 0;
     m_headUsed = 0;
-    m_chunks.clear();
+    m_tailUsed = 0;
+    m_tailIndex = 0;
     return;
   }
 
   // update size
   m_size -= n;
 
-  // discard chunks until more than n bytes would've been discarded
-  auto scan = m_chunks.begin();
-  assert(scan != m_chunks.end());
-  while (scan->size() - m_headUsed <= n) {
-    n -= (uint32_t)scan->size() - m_headUsed;
-    m_headUsed = 0;
-    scan = m_chunks.erase(scan);
-    assert(scan != m_chunks.end());
-  }
-
-  // remove left over bytes from the head chunk
-  if (n > 0) {
-    m_headUsed += n;
+  // discard chunks that have been completely read.  the tail is beyond
+  // the head so this never discards the chunk at m_tailIndex.
+  m_headUsed += n;
+  while (m_headUsed >= kChunkSize) {
+    m_headUsed -= kChunkSize;
+    recycleChunk(std::move(m_chunks.front()));
+    m_chunks.pop_front();
+    --m_tailIndex;
   }
 }
 
@@ -73,49 +71,120 @@ void StreamBuffer::write(const void *vdata, uint32_t n)
 {
   assert(vdata != nullptr);
 
-  // ignore if no data, otherwise update size
-  if (n == 0) {
-    return;
-  }
-  m_size += n;
-
   // cast data to bytes
   const auto *data = static_cast<const uint8_t *>(vdata);
 
-  // point to last chunk if it has space, otherwise append an empty chunk
-  auto scan = m_chunks.end();
-  if (scan != m_chunks.begin()) {
-    --scan;
-    if (scan->size() >= kChunkSize) {
-      ++scan;
-    }
+  // append data in chunks
+  while (n > 0) {
+    reserveTail();
+    const uint32_t count = std::min(n, kChunkSize - m_tailUsed);
+    memcpy(m_chunks[m_tailIndex].get() + m_tailUsed, data, count);
+    m_tailUsed += count;
+    m_size += count;
+    n -= count;
+    data += count;
   }
-  if (scan == m_chunks.end()) {
-    scan = m_chunks.emplace(scan, Chunk());
+}
+
+size_t StreamBuffer::writableSpans(WritableSpan spans[], size_t max, uint32_t n)
+{
+  if (max == 0) {
+    return 0;
   }
 
-  // append data in chunks
+  reserveTail();
+  size_t count = 0;
+  size_t index = m_tailIndex;
+  uint32_t offset = m_tailUsed;
+  uint32_t room = 0;
+  while (count < max && (count == 0 || room < n)) {
+    if (index == m_chunks.size()) {
+      m_chunks.push_back(newChunk());
+    }
+    spans[count++] = WritableSpan(m_chunks[index].get() + offset, kChunkSize - offset);
+    room += kChunkSize - offset;
+    offset = 0;
+    ++index;
+  }
+  return count;
+}
+
+void StreamBuffer::commit(uint32_t n)
+{
+  m_size += n;
   while (n > 0) {
-    // choose number of bytes for next chunk
-    assert(scan->size() <= kChunkSize);
-    uint32_t count = kChunkSize - (uint32_t)scan->size();
-    if (count > n)
-      count = n;
-
-    // transfer data
-    scan->insert(scan->end(), data, data + count);
+    reserveTail();
+    const uint32_t count = std::min(n, kChunkSize - m_tailUsed);
+    m_tailUsed += count;
     n -= count;
+  }
+}
+
+void StreamBuffer::peek(void *vdata, uint32_t n) const
+{
+  assert(n <= m_size);
+
+  auto *data = static_cast<uint8_t *>(vdata);
+  uint32_t offset = m_headUsed;
+  for (size_t i = 0; n > 0; ++i) {
+    const uint32_t count = std::min(n, kChunkSize - offset);
+    memcpy(data, m_chunks[i].get() + offset, count);
     data += count;
+    n -= count;
+    offset = 0;
+  }
+}
+
+size_t StreamBuffer::readableSpans(ReadableSpan spans[], size_t max) const
+{
+  if (m_size == 0) {
+    return 0;
+  }
 
-    // append another empty chunk if we're not done yet
-    if (n > 0) {
-      ++scan;
-      scan = m_chunks.emplace(scan, Chunk());
+  size_t count = 0;
+  for (size_t i = 0; i <= m_tailIndex && count < max; ++i) {
+    const uint32_t begin = (i == 0) ? m_headUsed : 0;
+    const uint32_t end = (i == m_tailIndex) ? m_tailUsed : kChunkSize;
+    if (end > begin) {
+      spans[count++] = ReadableSpan(m_chunks[i].get() + begin, end - begin);
     }
   }
+  return count;
 }
 
 uint32_t StreamBuffer::getSize() const
 {
   return m_size;
 }
+
+void StreamBuffer::reserveTail()
+{
+  if (m_chunks.empty()) {
+    m_chunks.push_back(newChunk());
+    m_tailIndex = 0;
+    m_tailUsed = 0;
+  } else if (m_tailUsed == kChunkSize) {
+    if (m_tailIndex + 1 == m_chunks.size()) {
+      m_chunks.push_back(newChunk());
+    }
+    ++m_tailIndex;
+    m_tailUsed = 0;
+  }
+}
+
+StreamBuffer::Chunk StreamBuffer::newChunk()
+{
+  if (m_spareChunks.empty()) {
+    return std::make_unique_for_overwrite<uint8_t[]>(kChunkSize);
+  }
+  Chunk chunk = std::move(m_spareChunks.back());
+  m_spareChunks.pop_back();
+  return chunk;
+}
+
+void StreamBuffer::recycleChunk(Chunk chunk)
+{
+  if (m_spareChunks.size() < kMaxSpareChunks) {
+    m_spareChunks.push_back(std::move(chunk));
+  }
+}
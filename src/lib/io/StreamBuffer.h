@@ -7,17 +7,31 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
-#include <list>
+#include <deque>
+#include <memory>
+#include <span>
 #include <vector>
 
 //! FIFO of bytes
 /*!
-This class maintains a FIFO (first-in, last-out) buffer of bytes.
+This class maintains a FIFO (first-in, first-out) buffer of bytes.
+
+Bytes are kept in fixed size chunks that never move once allocated, so
+the buffered data can be handed to scatter/gather I/O with
+\c readableSpans() and received data can be written in place through
+\c writableSpans().  Emptied chunks are kept for reuse, up to a limit.
 */
 class StreamBuffer
 {
 public:
+  //! A run of contiguous buffered bytes
+  using ReadableSpan = std::span<const uint8_t>;
+
+  //! A run of contiguous free space at the end of the buffer
+  using WritableSpan = std::span<uint8_t>;
+
   StreamBuffer() = default;
   ~StreamBuffer() = default;
 
@@ -28,7 +42,10 @@ public:
   /*!
   Return a pointer to memory with the next \c n bytes in the buffer
   (which must be <= getSize()).  The caller must not modify the returned
-  memory nor delete it.
+  memory nor delete it, and it is only valid until the buffer is next
+  changed.  This is free if the bytes are in one chunk, otherwise they
+  are copied once into scratch space; prefer \c readableSpans() for
+  large reads.
   */
   const void *peek(uint32_t n);
 
@@ -45,10 +62,43 @@ public:
   */
   void write(const void *data, uint32_t n);
 
+  //! Get free space to write into
+  /*!
+  Makes room for \c n more bytes and fills in up to \c max spans
+  covering it, or as much of it as fits in \c max spans, in order.
+  Returns the number of spans filled in.  The first span may be larger
+  or smaller than \c n.  Bytes written to the spans are not part of the
+  buffer until \c commit() is called, and the spans are only valid until
+  the buffer is next changed.
+  */
+  size_t writableSpans(WritableSpan spans[], size_t max, uint32_t n);
+
+  //! Append data written to free space
+  /*!
+  Appends the first \c n bytes of the spans most recently returned by
+  \c writableSpans().  \c n must not exceed their total size.
+  */
+  void commit(uint32_t n);
+
   //@}
   //! @name accessors
   //@{
 
+  //! Copy data without removing from buffer
+  /*!
+  Copies the next \c n bytes in the buffer (which must be <= getSize())
+  to \c data.
+  */
+  void peek(void *data, uint32_t n) const;
+
+  //! Get the buffered data
+  /*!
+  Fills in up to \c max spans with the buffered bytes, in order, and
+  returns the number filled in.  The spans are only valid until the
+  buffer is next changed.
+  */
+  size_t readableSpans(ReadableSpan spans[], size_t max) const;
+
   //! Get size of buffer
   /*!
   Returns the number of bytes in the buffer.
@@ -58,12 +108,25 @@ public:
   //@}
 
 private:
-  static const uint32_t kChunkSize;
+  using Chunk = std::unique_ptr<uint8_t[]>;
+
+  // move the write position to the next chunk if the current one is
+  // full, allocating a chunk if there isn't one
+  void reserveTail();
 
-  using Chunk = std::vector<uint8_t>;
-  using ChunkList = std::list<Chunk>;
+  Chunk newChunk();
+  void recycleChunk(Chunk chunk);
+
+  static const uint32_t kChunkSize;
+  static const size_t kMaxSpareChunks;
 
-  ChunkList m_chunks;
+  // data runs from m_headUsed in the first chunk to m_tailUsed in the
+  // chunk at m_tailIndex.  chunks after that are reserved free space.
+  std::deque<Chunk> m_chunks;
+  std::vector<Chunk> m_spareChunks;
+  std::vector<uint8_t> m_peek;
   uint32_t m_size = 0;
   uint32_t m_headUsed = 0;
+  uint32_t m_tailUsed = 0;
+  size_t m_tailIndex = 0;
 };
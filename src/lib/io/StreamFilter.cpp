@@ -46,11 +46,31 @@ void StreamFilter::write(const void *buffer, uint32_t n)
   getStream()->write(buffer, n);
 }
 
+void StreamFilter::writev(const std::span<const uint8_t> buffers[], size_t count)
+{
+  getStream()->writev(buffers, count);
+}
+
 void StreamFilter::flush()
 {
   getStream()->flush();
 }
 
+void StreamFilter::setWriteBatching(MonotonicClock::duration maxDelay, uint32_t maxSize)
+{
+  getStream()->setWriteBatching(maxDelay, maxSize);
+}
+
+void StreamFilter::sendBatch()
+{
+  getStream()->sendBatch();
+}
+
+void StreamFilter::setCompression(bool enabled)
+{
+  getStream()->setCompression(enabled);
+}
+
 void StreamFilter::shutdownInput()
 {
   getStream()->shutdownInput();
@@ -76,6 +96,21 @@ uint32_t StreamFilter::getSize() const
   return getStream()->getSize();
 }
 
+uint32_t StreamFilter::getOutputSize() const
+{
+  return getStream()->getOutputSize();
+}
+
+deskflow::IStream::OutputStats StreamFilter::getOutputStats() const
+{
+  return getStream()->getOutputStats();
+}
+
+ConnectionStats *StreamFilter::getConnectionStats()
+{
+  return getStream()->getConnectionStats();
+}
+
 deskflow::IStream *StreamFilter::getStream() const
 {
   return m_stream;
@@ -38,12 +38,19 @@ public:
   void close() override;
   uint32_t read(void *buffer, uint32_t n) override;
   void write(const void *buffer, uint32_t n) override;
+  void writev(const std::span<const uint8_t> buffers[], size_t count) override;
   void flush() override;
+  void setWriteBatching(MonotonicClock::duration maxDelay, uint32_t maxSize) override;
+  void sendBatch() override;
+  void setCompression(bool enabled) override;
   void shutdownInput() override;
   void shutdownOutput() override;
   void *getEventTarget() const override;
   bool isReady() const override;
   uint32_t getSize() const override;
+  uint32_t getOutputSize() const override;
+  OutputStats getOutputStats() const override;
+  ConnectionStats *getConnectionStats() override;
 
   //! Get the stream
   /*!
@@ -0,0 +1,215 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "net/HostResolver.h"
+
+#include "arch/Arch.h"
+#include "arch/ArchException.h"
+#include "base/IEventQueue.h"
+#include "base/Log.h"
+#include "base/TMethodJob.h"
+#include "mt/Thread.h"
+
+#include <algorithm>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace {
+
+using Key = std::pair<std::string, int>;
+
+Key keyFor(const NetworkAddress &address)
+{
+  return {address.getHostname(), address.getPort()};
+}
+
+} // namespace
+
+//
+// HostResolver::State
+//
+
+struct HostResolver::State
+{
+  struct Entry
+  {
+    std::vector<NetworkAddress> m_addresses;
+    std::string m_error;
+    MonotonicClock::time_point m_expires;
+  };
+
+  using Request = std::pair<NetworkAddress, void *>;
+
+  // what a lookup thread is given, it keeps the state alive
+  struct Job
+  {
+    std::shared_ptr<State> m_state;
+    NetworkAddress m_address;
+  };
+
+  // send a result to a request.  must have m_mutex locked.
+  void deliver(const Request &request, const Entry &entry) const;
+
+  // look up the address of the Job in arg, which it deletes, and send
+  // the result to the requests waiting for it.  runs on a lookup thread.
+  void lookup(const void *arg);
+
+  Lookup m_lookup;
+
+  std::mutex m_mutex;
+
+  // nullptr once the resolver is destroyed
+  IEventQueue *m_events = nullptr;
+
+  std::map<Key, Entry> m_cache;
+
+  // requests waiting for each running lookup
+  std::map<Key, std::vector<Request>> m_waiting;
+};
+
+void HostResolver::State::deliver(const Request &request, const Entry &entry) const
+{
+  auto *result = new Result;
+  result->m_request = request.first;
+  result->m_addresses = entry.m_addresses;
+  result->m_error = entry.m_error;
+  m_events->addEvent(Event(EventTypes::HostResolved, request.second, result));
+}
+
+void HostResolver::State::lookup(const void *arg)
+{
+  // the job, and so maybe this state, goes last
+  const std::unique_ptr<const Job> job(static_cast<const Job *>(arg));
+  const auto key = keyFor(job->m_address);
+
+  Entry entry;
+  try {
+    entry.m_addresses = m_lookup(job->m_address);
+  } catch (const ThreadException &) {
+    throw;
+  } catch (const std::exception &e) {
+    // normally a SocketAddressException
+    entry.m_error = e.what();
+  }
+
+  std::scoped_lock lock{m_mutex};
+  if (m_events == nullptr) {
+    return;
+  }
+  entry.m_expires = MonotonicClock::now() + (entry.m_error.empty() ? kPositiveTtl : kNegativeTtl);
+  for (const auto &request : m_waiting[key]) {
+    deliver(request, entry);
+  }
+  m_waiting.erase(key);
+  m_cache.insert_or_assign(key, std::move(entry));
+}
+
+//
+// HostResolver
+//
+
+HostResolver::HostResolver(IEventQueue *events, Lookup lookup) : m_state(std::make_shared<State>())
+{
+  if (!lookup) {
+    lookup = [](const NetworkAddress &address) { return interleaveFamilies(address.resolveAll()); };
+  }
+  m_state->m_lookup = std::move(lookup);
+  m_state->m_events = events;
+}
+
+HostResolver::~HostResolver()
+{
+  {
+    std::scoped_lock lock{m_state->m_mutex};
+    m_state->m_events = nullptr;
+    m_state->m_waiting.clear();
+  }
+
+  // a lookup blocked in the system resolver only stops once it returns,
+  // so don't hold up the owner waiting for one.  it has its own
+  // reference to the state and sends nothing once it's done.
+  const auto stop = MonotonicClock::now() + std::chrono::duration<double>(kStopTimeout);
+  for (Thread &thread : m_lookups) {
+    thread.cancel();
+    const std::chrono::duration<double> left = stop - MonotonicClock::now();
+    if (!thread.wait(std::max(left.count(), 0.0))) {
+      LOG_WARN("host name lookup still running, leaving it to finish");
+    }
+  }
+}
+
+void HostResolver::resolve(const NetworkAddress &address, void *target)
+{
+  const auto key = keyFor(address);
+  std::scoped_lock lock{m_state->m_mutex};
+
+  // answer from the cache if we can
+  if (const auto cached = m_state->m_cache.find(key); cached != m_state->m_cache.end()) {
+    if (MonotonicClock::now() < cached->second.m_expires) {
+      LOG_DEBUG("using cached addresses for %s", key.first.c_str());
+      m_state->deliver({address, target}, cached->second);
+      return;
+    }
+    m_state->m_cache.erase(cached);
+  }
+
+  // wait for a lookup already running
+  const bool running = m_state->m_waiting.contains(key);
+  m_state->m_waiting[key].emplace_back(address, target);
+  if (running) {
+    return;
+  }
+
+  // the lookup blocks for as long as the system resolver takes, so it
+  // runs on its own thread.  forget threads that have finished.
+  LOG_DEBUG("looking up %s", key.first.c_str());
+  std::erase_if(m_lookups, [](const Thread &thread) { return thread.wait(0.0); });
+  m_lookups.emplace_back(new TMethodJob<State>(m_state.get(), &State::lookup, new State::Job{m_state, address}));
+}
+
+void HostResolver::cancel(void *target)
+{
+  // the lookups keep running, to fill the cache
+  std::scoped_lock lock{m_state->m_mutex};
+  for (auto &[key, waiting] : m_state->m_waiting) {
+    std::erase_if(waiting, [target](const auto &request) { return request.second == target; });
+  }
+}
+
+void HostResolver::forget(const NetworkAddress &address)
+{
+  std::scoped_lock lock{m_state->m_mutex};
+  m_state->m_cache.erase(keyFor(address));
+}
+
+std::vector<NetworkAddress> HostResolver::interleaveFamilies(const std::vector<NetworkAddress> &addresses)
+{
+  if (addresses.empty()) {
+    return {};
+  }
+
+  // split into the first address's family and the rest, then alternate
+  const auto firstFamily = ARCH->getAddrFamily(addresses.front().getAddress());
+  std::vector<const NetworkAddress *> first;
+  std::vector<const NetworkAddress *> other;
+  for (const auto &address : addresses) {
+    (ARCH->getAddrFamily(address.getAddress()) == firstFamily ? first : other).push_back(&address);
+  }
+
+  std::vector<NetworkAddress> result;
+  result.reserve(addresses.size());
+  for (size_t i = 0; i < std::max(first.size(), other.size()); ++i) {
+    if (i < first.size()) {
+      result.push_back(*first[i]);
+    }
+    if (i < other.size()) {
+      result.push_back(*other[i]);
+    }
+  }
+  return result;
+}
@@ -0,0 +1,122 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include "arch/MonotonicClock.h"
+#include "base/Event.h"
+#include "net/NetworkAddress.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class IEventQueue;
+class Thread;
+
+//! Asynchronous, caching host name resolver
+/*!
+Looks up host names on a background thread, so a slow or unreachable
+DNS server never blocks the caller, and sends the result as a
+\c HostResolved event.  Results are cached: successful lookups for
+\c kPositiveTtl and failed lookups for \c kNegativeTtl.  Requests for a
+name that is already being looked up wait for that lookup.
+
+The system resolver doesn't report record TTLs so the cache uses fixed
+lifetimes.  Use \c forget() when an address turns out not to work.
+*/
+class HostResolver
+{
+public:
+  //! The data of a \c HostResolved event
+  class Result : public EventData
+  {
+  public:
+    //! The address as passed to \c resolve()
+    NetworkAddress m_request;
+
+    //! The addresses found, in the order to try them
+    std::vector<NetworkAddress> m_addresses;
+
+    //! Why the lookup failed, or empty if it didn't
+    std::string m_error;
+  };
+
+  //! Look up a host name, blocking
+  /*!
+  Returns the addresses for a host name and port or throws
+  \c SocketAddressException.  Called on a background thread.
+  */
+  using Lookup = std::function<std::vector<NetworkAddress>(const NetworkAddress &)>;
+
+  //! How long a successful lookup is cached
+  static constexpr auto kPositiveTtl = std::chrono::seconds(60);
+
+  //! How long a failed lookup is cached
+  static constexpr auto kNegativeTtl = std::chrono::seconds(5);
+
+  //! How long the destructor waits for lookups, in seconds
+  static constexpr double kStopTimeout = 0.5;
+
+  //! Resolve using \p lookup, the system resolver by default
+  explicit HostResolver(IEventQueue *events, Lookup lookup = {});
+  HostResolver(HostResolver const &) = delete;
+  HostResolver(HostResolver &&) = delete;
+
+  //! Cancels lookups still running
+  /*!
+  Waits at most \c kStopTimeout for lookups to finish, a lookup blocked
+  in the system resolver is logged and left to finish on its own.
+  */
+  ~HostResolver();
+
+  HostResolver &operator=(HostResolver const &) = delete;
+  HostResolver &operator=(HostResolver &&) = delete;
+
+  //! @name manipulators
+  //@{
+
+  //! Resolve an address
+  /*!
+  Sends a \c HostResolved event to \p target once the hostname and port
+  of \p address are resolved, straight away if they're in the cache.
+  */
+  void resolve(const NetworkAddress &address, void *target);
+
+  //! Stop sending results to a target
+  /*!
+  Drops every request from \p target that is still waiting for a lookup.
+  Results already sent are unaffected.
+  */
+  void cancel(void *target);
+
+  //! Drop an address from the cache
+  void forget(const NetworkAddress &address);
+
+  //@}
+  //! @name accessors
+  //@{
+
+  //! Order addresses for connecting
+  /*!
+  Alternates address families, starting with the family of the first
+  address, keeping the order within each family, so that connection
+  attempts quickly reach a family that works (RFC 8305).
+  */
+  static std::vector<NetworkAddress> interleaveFamilies(const std::vector<NetworkAddress> &addresses);
+
+  //@}
+
+private:
+  struct State;
+
+  // shared with the lookups, which may outlive the resolver
+  std::shared_ptr<State> m_state;
+
+  // lookup threads, only touched by the resolver's owner
+  std::vector<Thread> m_lookups;
+};
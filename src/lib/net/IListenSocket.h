@@ -9,7 +9,10 @@
 
 #include "net/ISocket.h"
 
+#include <functional>
 #include <memory>
+#include <string>
+#include <vector>
 
 class IDataSocket;
 
@@ -21,6 +24,13 @@ listen for incoming connections.
 class IListenSocket : public ISocket
 {
 public:
+  //! Decides whether to keep a connection
+  /*!
+  Called with the remote address of a newly accepted connection, as
+  text.  Returns false to close the connection.
+  */
+  using AdmissionCheck = std::function<bool(const std::string &peer)>;
+
   //! @name manipulators
   //@{
 
@@ -32,5 +42,14 @@ public:
   */
   virtual std::unique_ptr<IDataSocket> accept() = 0;
 
+  //! Accept waiting connections
+  /*!
+  Accepts up to \p max connections, stopping early when none are
+  waiting.  Each connection is passed to \p admit, if set, before any
+  other work is done for it, such as a TLS handshake, and is closed
+  straight away if refused.  Refused connections count towards \p max.
+  */
+  virtual std::vector<std::unique_ptr<IDataSocket>> acceptBatch(size_t max, const AdmissionCheck &admit) = 0;
+
   //@}
 };
@@ -114,45 +114,44 @@ NetworkAddress &NetworkAddress::operator=(const NetworkAddress &addr)
 
 size_t NetworkAddress::resolve(size_t index)
 {
-  size_t resolvedAddressesCount = 0;
   // discard previous address
   if (m_address != nullptr) {
     ARCH->closeAddr(m_address);
     m_address = nullptr;
   }
 
+  const auto addresses = resolveAll();
+  const auto &address = addresses[std::min(index, addresses.size() - 1)];
+  m_address = ARCH->copyAddr(address.m_address);
+  return addresses.size();
+}
+
+std::vector<NetworkAddress> NetworkAddress::resolveAll() const
+{
+  // each result is this hostname and port with one of its addresses
+  std::vector<NetworkAddress> result;
+  auto add = [this, &result](ArchNetAddress address) {
+    auto &added = result.emplace_back();
+    added.m_hostname = m_hostname;
+    added.m_port = m_port;
+    added.m_address = address;
+  };
+
   try {
     if (m_hostname.empty()) {
-      m_address = ARCH->newAnyAddr(IArchNetwork::AddressFamily::INet);
-      resolvedAddressesCount = 1;
+      add(ARCH->newAnyAddr(IArchNetwork::AddressFamily::INet));
     } else {
-      std::vector<ArchNetAddress> ipAddresses;
-      {
-        auto addresses = ARCH->nameToAddr(m_hostname);
-        for (auto address : addresses) {
-          if (ARCH->getAddrFamily(address) != IArchNetwork::AddressFamily::Unknown) {
-            ipAddresses.emplace_back(address);
-          } else {
-            ARCH->closeAddr(address);
-          }
+      for (auto address : ARCH->nameToAddr(m_hostname)) {
+        if (ARCH->getAddrFamily(address) != IArchNetwork::AddressFamily::Unknown) {
+          add(address);
+        } else {
+          ARCH->closeAddr(address);
         }
       }
 
-      resolvedAddressesCount = ipAddresses.size();
-      if (resolvedAddressesCount <= 0) {
+      if (result.empty()) {
         throw ArchNetworkNameUnknownException("Hostname lookup failed");
       }
-      if (index < resolvedAddressesCount - 1) {
-        m_address = ipAddresses[index];
-      } else {
-        m_address = ipAddresses[resolvedAddressesCount - 1];
-      }
-
-      for (auto address : ipAddresses) {
-        if (m_address != address) {
-          ARCH->closeAddr(address);
-        }
-      }
     }
   } catch (ArchNetworkNameUnknownException &) {
     throw SocketAddressException(SocketAddressException::SocketError::NotFound, m_hostname, m_port);
@@ -164,10 +163,11 @@ size_t NetworkAddress::resolve(size_t index)
     throw SocketAddressException(SocketAddressException::SocketError::Unknown, m_hostname, m_port);
   }
 
-  // set port in address
-  ARCH->setAddrPort(m_address, m_port);
-
-  return resolvedAddressesCount;
+  // set port in addresses
+  for (auto &address : result) {
+    ARCH->setAddrPort(address.m_address, m_port);
+  }
+  return result;
 }
 
 bool NetworkAddress::operator==(const NetworkAddress &addr) const
@@ -9,6 +9,9 @@
 
 #include "arch/IArchNetwork.h"
 
+#include <string>
+#include <vector>
+
 //! Network address type
 /*!
 This class represents a network address.
@@ -63,6 +66,15 @@ public:
   //! @name accessors
   //@{
 
+  //! Resolve address to all of its addresses
+  /*!
+  Looks up the hostname and returns a copy of this address for each of
+  the addresses found, in the order the system prefers them, with the
+  port set.  This can block for as long as the system's resolver takes.
+  Throws SocketAddressException if resolution is unsuccessful.
+  */
+  std::vector<NetworkAddress> resolveAll() const;
+
   //! Check address equality
   /*!
   Returns true if this address is equal to \p address.
@@ -28,17 +28,12 @@ SecureListenSocket::SecureListenSocket(
   // do nothing
 }
 
-std::unique_ptr<IDataSocket> SecureListenSocket::accept()
+std::unique_ptr<IDataSocket> SecureListenSocket::adoptSocket(ArchSocket socket)
 {
-  std::unique_ptr<SecureSocket> secureSocket;
   try {
-    secureSocket = std::make_unique<SecureSocket>(
-        events(), socketMultiplexer(), ARCH->acceptSocket(socket(), nullptr), m_securityLevel
-    );
+    auto secureSocket = std::make_unique<SecureSocket>(events(), socketMultiplexer(), socket, m_securityLevel);
     secureSocket->initSsl(true);
 
-    setListeningJob();
-
     // default location of the TLS cert file in users dir
     if (!secureSocket->loadCertificate(Settings::value(Settings::Security::Certificate).toString())) {
       return nullptr;
@@ -48,14 +43,6 @@ std::unique_ptr<IDataSocket> SecureListenSocket::accept()
 
     return secureSocket;
   } catch (ArchNetworkException &) {
-    if (secureSocket) {
-      setListeningJob();
-    }
     return nullptr;
-  } catch (std::exception &ex) {
-    if (secureSocket) {
-      setListeningJob();
-    }
-    throw ex;
   }
 }
@@ -22,8 +22,9 @@ public:
       SecurityLevel securityLevel = SecurityLevel::PlainText
   );
 
-  // IListenSocket overrides
-  std::unique_ptr<IDataSocket> accept() override;
+protected:
+  // TCPListenSocket overrides
+  std::unique_ptr<IDataSocket> adoptSocket(ArchSocket socket) override;
 
 private:
   const SecurityLevel m_securityLevel;
@@ -33,6 +33,9 @@ static const std::size_t s_maxInputBufferSize = 1024 * 1024;
 
 static const float s_retryDelay = 0.01f;
 
+// SSL_write() sends data in records of at most this many bytes
+static const int s_maxTlsRecordSize = 16 * 1024;
+
 struct Ssl
 {
   SSL_CTX *m_context = nullptr;
@@ -66,7 +69,6 @@ SecureSocket::SecureSocket(
 SecureSocket::~SecureSocket()
 {
   freeSSL();
-  free(m_writeStaticBuffer);
 }
 
 void SecureSocket::close()
@@ -118,14 +120,16 @@ void SecureSocket::secureAccept()
 TCPSocket::JobResult SecureSocket::doRead()
 {
   using enum JobResult;
-  static uint8_t buffer[4096];
-  static const auto bufferSize = std::size(buffer);
-  memset(buffer, 0, bufferSize);
   int bytesRead = 0;
   int status = 0;
+  bool wasEmpty = (m_inputBuffer.getSize() == 0);
+
+  // decrypt straight into the input buffer
+  StreamBuffer::WritableSpan span;
+  m_inputBuffer.writableSpans(&span, 1, 1);
 
   if (isSecureReady()) {
-    status = secureRead(buffer, bufferSize, bytesRead);
+    status = secureRead(span.data(), static_cast<int>(span.size()), bytesRead);
     if (status < 0) {
       return Break;
     } else if (status == 0) {
@@ -136,17 +140,19 @@ TCPSocket::JobResult SecureSocket::doRead()
   }
 
   if (bytesRead > 0) {
-    bool wasEmpty = (m_inputBuffer.getSize() == 0);
-
     // slurp up as much as possible
     do {
-      m_inputBuffer.write(buffer, bytesRead);
+      // SSL_read() returns no more than one record
+      m_inputBuffer.commit(bytesRead);
+      m_connectionStats.recordInput(bytesRead, m_inputBuffer.getSize());
+      m_connectionStats.recordTlsRecords(1, 0);
 
       if (m_inputBuffer.getSize() > s_maxInputBufferSize) {
         break;
       }
 
-      status = secureRead(buffer, bufferSize, bytesRead);
+      m_inputBuffer.writableSpans(&span, 1, 1);
+      status = secureRead(span.data(), static_cast<int>(span.size()), bytesRead);
       if (status < 0) {
         return Break;
       }
@@ -176,49 +182,37 @@ TCPSocket::JobResult SecureSocket::doWrite()
 {
   using enum JobResult;
 
-  // write data
-  int bufferSize = 0;
-  int bytesWrote = 0;
-  int status = 0;
-
-  if (m_writeRetry) {
-    bufferSize = m_writeRetrySize;
-  } else {
-    bufferSize = m_outputBuffer.getSize();
-    if (bufferSize != 0) {
-      if (bufferSize > m_writeStaticBufferSize) {
-        m_writeStaticBuffer = realloc(m_writeStaticBuffer, bufferSize);
-        m_writeStaticBufferSize = bufferSize;
-      }
-      memcpy(m_writeStaticBuffer, m_outputBuffer.peek(bufferSize), bufferSize);
+  // write data a chunk at a time straight from the output buffer.
+  // SSL_write() must be retried with the same buffer, which it is
+  // because a chunk doesn't move and isn't popped until it's written.
+  bool wrote = false;
+  StreamBuffer::ReadableSpan span;
+  while (m_outputBuffer.readableSpans(&span, 1) != 0) {
+    if (!isSecureReady()) {
+      return Retry;
     }
-  }
 
-  if (bufferSize == 0) {
-    return Retry;
-  }
-
-  if (isSecureReady()) {
-    status = secureWrite(m_writeStaticBuffer, bufferSize, bytesWrote);
-    if (status > 0) {
-      m_writeRetry = false;
-    } else if (status < 0) {
+    const int bufferSize = m_writeRetry ? m_writeRetrySize : static_cast<int>(span.size());
+    int bytesWrote = 0;
+    const int status = secureWrite(span.data(), bufferSize, bytesWrote);
+    if (status < 0) {
       return Break;
     } else if (status == 0) {
       m_writeRetry = true;
       m_writeRetrySize = bufferSize;
       return New;
     }
-  } else {
-    return Retry;
-  }
+    m_writeRetry = false;
 
-  if (bytesWrote > 0) {
+    if (bytesWrote <= 0) {
+      break;
+    }
     discardWrittenData(bytesWrote);
-    return New;
+    m_connectionStats.recordTlsRecords(0, (bytesWrote + s_maxTlsRecordSize - 1) / s_maxTlsRecordSize);
+    wrote = true;
   }
 
-  return Retry;
+  return wrote ? New : Retry;
 }
 
 int SecureSocket::secureRead(void *buffer, int size, int &read)
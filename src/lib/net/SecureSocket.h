@@ -99,6 +99,4 @@ private:
 
   bool m_writeRetry = false;
   int m_writeRetrySize = 0;
-  int m_writeStaticBufferSize = 0;
-  void *m_writeStaticBuffer = nullptr;
 };
@@ -0,0 +1,90 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "net/SocketJobRegistry.h"
+
+#include "net/ISocketMultiplexerJob.h"
+
+#include <cassert>
+
+//
+// SocketJobRegistry
+//
+
+SocketJobRegistry::~SocketJobRegistry()
+{
+  for (const Slot &slot : m_slots) {
+    delete slot.m_job;
+  }
+}
+
+SocketJobRegistry::Handle SocketJobRegistry::insert(ISocket *socket, ISocketMultiplexerJob *job)
+{
+  assert(socket != nullptr);
+  assert(job != nullptr);
+  assert(!m_index.contains(socket));
+
+  uint32_t index;
+  if (m_freeSlots.empty()) {
+    index = static_cast<uint32_t>(m_slots.size());
+    m_slots.emplace_back();
+  } else {
+    index = m_freeSlots.back();
+    m_freeSlots.pop_back();
+  }
+
+  Slot &slot = m_slots[index];
+  slot.m_socket = socket;
+  slot.m_job = job;
+  m_index.emplace(socket, index);
+  return makeHandle(index, slot.m_generation);
+}
+
+void SocketJobRegistry::replace(Handle handle, ISocketMultiplexerJob *job)
+{
+  if (job == nullptr) {
+    delete release(handle);
+    return;
+  }
+
+  ISocketMultiplexerJob *oldJob = find(handle);
+  if (oldJob == nullptr || oldJob == job) {
+    return;
+  }
+
+  delete oldJob;
+  m_slots[static_cast<uint32_t>(handle)].m_job = job;
+}
+
+ISocketMultiplexerJob *SocketJobRegistry::release(Handle handle)
+{
+  ISocketMultiplexerJob *job = find(handle);
+  if (job == nullptr) {
+    return nullptr;
+  }
+
+  const auto index = static_cast<uint32_t>(handle);
+  Slot &slot = m_slots[index];
+  m_index.erase(slot.m_socket);
+  slot.m_socket = nullptr;
+  slot.m_job = nullptr;
+
+  // outstanding handles to this slot are now stale
+  if (++slot.m_generation == 0) {
+    slot.m_generation = 1;
+  }
+  m_freeSlots.push_back(index);
+  return job;
+}
+
+SocketJobRegistry::Handle SocketJobRegistry::find(ISocket *socket) const
+{
+  const auto i = m_index.find(socket);
+  if (i == m_index.end()) {
+    return kInvalidHandle;
+  }
+  return makeHandle(i->second, m_slots[i->second].m_generation);
+}
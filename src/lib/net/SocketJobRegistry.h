@@ -0,0 +1,138 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class ISocket;
+class ISocketMultiplexerJob;
+
+//! Socket multiplexer job registry
+/*!
+Holds the job for each socket serviced by a \c SocketMultiplexer in a
+slot with a stable index.  A socket keeps its slot, and so its handle,
+while its job is replaced; removing the socket frees the slot for reuse.
+Each handle carries the generation of its slot so a handle saved before
+the socket was removed, e.g. by a poll set, is recognised as stale
+rather than finding whatever job now occupies the slot.
+
+The registry owns its jobs and deletes them when they are replaced or
+removed.  It does no locking of its own; \c SocketMultiplexer only
+touches it from its service thread.
+*/
+class SocketJobRegistry
+{
+public:
+  //! Slot index in the low 32 bits, slot generation in the high 32 bits
+  using Handle = uint64_t;
+
+  //! A handle that never refers to a job
+  static constexpr Handle kInvalidHandle = 0;
+
+  SocketJobRegistry() = default;
+  SocketJobRegistry(SocketJobRegistry const &) = delete;
+  SocketJobRegistry(SocketJobRegistry &&) = delete;
+  ~SocketJobRegistry();
+
+  SocketJobRegistry &operator=(SocketJobRegistry const &) = delete;
+  SocketJobRegistry &operator=(SocketJobRegistry &&) = delete;
+
+  //! @name manipulators
+  //@{
+
+  //! Add a socket
+  /*!
+  Adds \p socket, which must not already be in the registry, serviced by
+  \p job and returns its handle.  \p job must not be nullptr.
+  */
+  Handle insert(ISocket *socket, ISocketMultiplexerJob *job);
+
+  //! Replace a job
+  /*!
+  Deletes the job for \p handle and installs \p job in its place.  If
+  \p job is nullptr the socket is removed and \p handle becomes stale.
+  Does nothing if \p handle is stale.
+  */
+  void replace(Handle handle, ISocketMultiplexerJob *job);
+
+  //! Remove a socket without deleting its job
+  /*!
+  Removes the socket for \p handle, which becomes stale, and returns its
+  job for the caller to delete.  Returns nullptr if \p handle is stale.
+  */
+  ISocketMultiplexerJob *release(Handle handle);
+
+  //@}
+  //! @name accessors
+  //@{
+
+  //! Get the job for a handle
+  /*!
+  Returns nullptr if \p handle is stale.
+  */
+  ISocketMultiplexerJob *find(Handle handle) const
+  {
+    const auto index = static_cast<uint32_t>(handle);
+    if (index >= m_slots.size()) {
+      return nullptr;
+    }
+    const Slot &slot = m_slots[index];
+    return slot.m_generation == static_cast<uint32_t>(handle >> 32) ? slot.m_job : nullptr;
+  }
+
+  //! Get the handle for a socket
+  /*!
+  Returns \c kInvalidHandle if \p socket isn't in the registry.
+  */
+  Handle find(ISocket *socket) const;
+
+  //! Call \p function with the handle and job of every socket
+  template <typename Function> void forEach(Function &&function) const
+  {
+    for (size_t i = 0; i < m_slots.size(); ++i) {
+      if (m_slots[i].m_job != nullptr) {
+        function(makeHandle(static_cast<uint32_t>(i), m_slots[i].m_generation), m_slots[i].m_job);
+      }
+    }
+  }
+
+  //! Get the number of sockets
+  size_t size() const
+  {
+    return m_index.size();
+  }
+
+  //! Check if there are no sockets
+  bool empty() const
+  {
+    return m_index.empty();
+  }
+
+  //@}
+
+private:
+  struct Slot
+  {
+    ISocket *m_socket = nullptr;
+    ISocketMultiplexerJob *m_job = nullptr;
+
+    // never zero so no handle equals kInvalidHandle
+    uint32_t m_generation = 1;
+  };
+
+  static Handle makeHandle(uint32_t index, uint32_t generation)
+  {
+    return static_cast<Handle>(generation) << 32 | index;
+  }
+
+  std::vector<Slot> m_slots;
+  std::vector<uint32_t> m_freeSlots;
+  std::unordered_map<ISocket *, uint32_t> m_index;
+};
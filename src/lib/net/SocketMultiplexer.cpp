@@ -17,7 +17,28 @@
 #include "mt/Thread.h"
 #include "net/ISocketMultiplexerJob.h"
 
-#include <vector>
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+// most ready sockets handled per wakeup, any others stay ready and are
+// handled on the next one
+const size_t kMaxReadyJobs = 64;
+
+unsigned short pollEvents(const ISocketMultiplexerJob *job)
+{
+  unsigned short events = 0;
+  if (job->isReadable()) {
+    events |= IArchNetwork::PollEventMask::In;
+  }
+  if (job->isWritable()) {
+    events |= IArchNetwork::PollEventMask::Out;
+  }
+  return events;
+}
+
+} // namespace
 
 //
 // SocketMultiplexer
@@ -25,16 +46,11 @@
 
 SocketMultiplexer::SocketMultiplexer()
     : m_mutex(new Mutex),
-      m_jobsReady(new CondVar<bool>(m_mutex, false)),
-      m_jobListLock(new CondVar<bool>(m_mutex, false)),
-      m_jobListLockLocked(new CondVar<bool>(m_mutex, false))
+      m_changesReady(new CondVarBase(m_mutex)),
+      m_changesDone(new CondVarBase(m_mutex)),
+      m_ready(kMaxReadyJobs),
+      m_pollSet(ARCH->newPollSet())
 {
-  // this pointer just has to be unique and not nullptr.  it will
-  // never be dereferenced.  it's used to identify cursor nodes
-  // in the jobs list.
-  // TODO: Remove this evilness
-  m_cursorMark = reinterpret_cast<ISocketMultiplexerJob *>(this);
-
   // start thread
   auto tMethodJob = new TMethodJob<SocketMultiplexer>(this, &SocketMultiplexer::serviceThread);
   m_thread = new Thread(tMethodJob);
@@ -46,271 +62,382 @@ SocketMultiplexer::~SocketMultiplexer()
   m_thread->unblockPollSocket();
   m_thread->wait();
   delete m_thread;
-  delete m_jobsReady;
-  delete m_jobListLock;
-  delete m_jobListLockLocked;
-  delete m_jobListLocker;
-  delete m_jobListLockLocker;
-  delete m_mutex;
 
-  // clean up jobs
-  for (auto i = m_socketJobMap.begin(); i != m_socketJobMap.end(); ++i) {
-    delete *(i->second);
+  if (m_pollSet != nullptr) {
+    ARCH->closePollSet(m_pollSet);
+  }
+
+  // clean up jobs that were never applied, m_jobs deletes the rest
+  for (const Change &change : m_changes) {
+    delete change.m_job;
   }
+  delete m_changesReady;
+  delete m_changesDone;
+  delete m_mutex;
 }
 
 void SocketMultiplexer::addSocket(ISocket *socket, ISocketMultiplexerJob *job)
 {
   assert(socket != nullptr);
-  assert(job != nullptr);
-
-  // prevent other threads from locking the job list
-  lockJobListLock();
-
-  // break thread out of poll
-  m_thread->unblockPollSocket();
 
-  // lock the job list
-  lockJobList();
-
-  // insert/replace job
-  if (SocketJobMap::iterator i = m_socketJobMap.find(socket); i == m_socketJobMap.end()) {
-    // we *must* put the job at the end so the order of jobs in
-    // the list continue to match the order of jobs in pfds in
-    // serviceThread().
-    JobCursor j = m_socketJobs.insert(m_socketJobs.end(), job);
-    m_update = true;
-    m_socketJobMap.try_emplace(socket, j);
-  } else {
-    if (JobCursor j = i->second; *j != job) {
-      delete *j;
-      *j = job;
-    }
-    m_update = true;
+  bool wake;
+  {
+    Lock lock(m_mutex);
+    wake = m_changes.empty();
+    m_changes.push_back({socket, job});
+    ++m_changesQueued;
+    m_changesReady->signal();
   }
 
-  // unlock the job list
-  unlockJobList();
+  // break thread out of poll.  if changes were already queued whoever
+  // queued the first one has done that.
+  if (wake) {
+    m_thread->unblockPollSocket();
+  }
 }
 
 void SocketMultiplexer::removeSocket(ISocket *socket)
 {
   assert(socket != nullptr);
 
-  // prevent other threads from locking the job list
-  lockJobListLock();
+  uint64_t change;
+  bool wake;
+  {
+    Lock lock(m_mutex);
+
+    // a job removing a socket, maybe its own, can't wait for itself to
+    // finish.  the socket goes now and changes queued for it are dropped
+    // but other changes are left for the loop, they may replace the job
+    // that's running.
+    if (std::this_thread::get_id() == m_serviceThreadID) {
+      std::erase_if(m_changes, [socket](const Change &queued) {
+        if (queued.m_socket != socket) {
+          return false;
+        }
+        delete queued.m_job;
+        return true;
+      });
+      std::erase_if(m_newDeadlines, [socket](const Deadline &deadline) { return deadline.m_socket == socket; });
+      wake = false;
+      change = 0;
+    } else {
+      wake = m_changes.empty();
+      m_changes.push_back({socket, nullptr});
+      change = ++m_changesQueued;
+      m_changesReady->signal();
+    }
+  }
+
+  if (change == 0) {
+    removeJob(socket);
+    return;
+  }
 
   // break thread out of poll
-  m_thread->unblockPollSocket();
+  if (wake) {
+    m_thread->unblockPollSocket();
+  }
+
+  // wait until the job is gone
+  Lock lock(m_mutex);
+  while (m_changesApplied < change) {
+    m_changesDone->wait();
+  }
+}
 
-  // lock the job list
-  lockJobList();
+void SocketMultiplexer::scheduleWrite(ISocket *socket, MonotonicClock::time_point when)
+{
+  assert(socket != nullptr);
 
-  // remove job.  rather than removing it from the map we put nullptr
-  // in the list instead so the order of jobs in the list continues
-  // to match the order of jobs in pfds in serviceThread().
-  if (SocketJobMap::iterator i = m_socketJobMap.find(socket); i != m_socketJobMap.end() && (*(i->second) != nullptr)) {
-    delete *(i->second);
-    *(i->second) = nullptr;
-    m_update = true;
+  // only wake the thread if it would otherwise sleep past the deadline
+  bool wake;
+  {
+    Lock lock(m_mutex);
+    const uint64_t generation = ++m_lastWrite;
+    m_writes[socket] = generation;
+    m_newDeadlines.push_back({when, socket, generation});
+    wake = (when < m_wakeAt);
+    if (wake) {
+      m_wakeAt = when;
+    }
   }
 
-  // unlock the job list
-  unlockJobList();
+  if (wake) {
+    m_thread->unblockPollSocket();
+  }
+}
+
+void SocketMultiplexer::cancelWrite(ISocket *socket)
+{
+  assert(socket != nullptr);
+
+  // the deadline stays queued but won't match when it falls due
+  Lock lock(m_mutex);
+  m_writes.erase(socket);
 }
 
 [[noreturn]] void SocketMultiplexer::serviceThread(const void *)
 {
-  std::vector<IArchNetwork::PollEntry> pfds;
-  IArchNetwork::PollEntry pfd;
+  {
+    Lock lock(m_mutex);
+    m_serviceThreadID = std::this_thread::get_id();
+  }
 
   // service the connections
   for (;;) {
     Thread::testCancel();
 
     // wait until there are jobs to handle
-    {
-      Lock lock(m_mutex);
-      while (!(bool)*m_jobsReady) {
-        m_jobsReady->wait();
-      }
+    applyChanges(true);
+    if (m_jobs.empty()) {
+      continue;
     }
 
-    // lock the job list
-    lockJobListLock();
-    lockJobList();
-
-    // collect poll entries
-    if (m_update) {
-      m_update = false;
-      pfds.clear();
-      pfds.reserve(m_socketJobMap.size());
-
-      JobCursor cursor = newCursor();
-      JobCursor jobCursor = nextCursor(cursor);
-      while (jobCursor != m_socketJobs.end()) {
-        if (const ISocketMultiplexerJob *job = *jobCursor; job) {
-          pfd.m_socket = job->getSocket();
-          pfd.m_events = 0;
-          if (job->isReadable()) {
-            pfd.m_events |= IArchNetwork::PollEventMask::In;
-          }
-          if (job->isWritable()) {
-            pfd.m_events |= IArchNetwork::PollEventMask::Out;
-          }
-          pfds.push_back(pfd);
-        }
-        jobCursor = nextCursor(cursor);
-      }
-      deleteCursor(cursor);
+    if (m_pollSet != nullptr) {
+      runReadyJobs();
+    } else {
+      runPolledJobs();
     }
+    runDueJobs();
+  }
+}
 
-    int status;
-    try {
-      // check for status
-      if (!pfds.empty()) {
-        status = ARCH->pollSocket(&pfds[0], (int)pfds.size(), -1);
-      } else {
-        status = 0;
-      }
-    } catch (ArchNetworkException &e) {
-      LOG_WARN("error in socket multiplexer: %s", e.what());
-      status = 0;
+void SocketMultiplexer::applyChanges(bool wait)
+{
+  uint64_t queued;
+  {
+    Lock lock(m_mutex);
+    while (wait && m_changes.empty() && m_jobs.empty()) {
+      m_changesReady->wait();
     }
 
-    if (status != 0) {
-      // iterate over socket jobs, invoking each and saving the
-      // new job.
-      uint32_t i = 0;
-      JobCursor cursor = newCursor();
-      JobCursor jobCursor = nextCursor(cursor);
-      while (i < pfds.size() && jobCursor != m_socketJobs.end()) {
-        if (*jobCursor != nullptr) {
-          // get poll state
-          unsigned short revents = pfds[i].m_revents;
-          bool read = ((revents & int(IArchNetwork::PollEventMask::In)) != 0);
-          bool write = ((revents & int(IArchNetwork::PollEventMask::Out)) != 0);
-          bool error =
-              ((revents & (int(IArchNetwork::PollEventMask::Error) | int(IArchNetwork::PollEventMask::Invalid))) != 0);
-
-          // run job
-          ISocketMultiplexerJob *job = *jobCursor;
-
-          // save job, if different
-          if (ISocketMultiplexerJob *newJob = job->run(read, write, error); newJob != job) {
-            Lock lock(m_mutex);
-            delete job;
-            *jobCursor = newJob;
-            m_update = true;
-          }
-          ++i;
-        }
-
-        // next job
-        jobCursor = nextCursor(cursor);
-      }
-      deleteCursor(cursor);
+    // we'll next look at queued deadlines by the earliest known one
+    for (const Deadline &deadline : m_newDeadlines) {
+      m_deadlines.push_back(deadline);
+      std::push_heap(m_deadlines.begin(), m_deadlines.end(), std::greater<>());
     }
+    m_newDeadlines.clear();
+    m_wakeAt = m_deadlines.empty() ? MonotonicClock::time_point::max() : m_deadlines.front().m_when;
 
-    // delete any removed socket jobs
-    for (auto i = m_socketJobMap.begin(); i != m_socketJobMap.end();) {
-      if (*(i->second) == nullptr) {
-        m_socketJobs.erase(i->second);
-        m_socketJobMap.erase(i++);
-        m_update = true;
-      } else {
-        ++i;
-      }
+    if (m_changes.empty()) {
+      return;
     }
+    m_applying.swap(m_changes);
+    queued = m_changesQueued;
+  }
 
-    // unlock the job list
-    unlockJobList();
+  for (const Change &change : m_applying) {
+    if (change.m_job == nullptr) {
+      removeJob(change.m_socket);
+    } else if (Handle handle = m_jobs.find(change.m_socket); handle != SocketJobRegistry::kInvalidHandle) {
+      setJob(handle, change.m_job);
+    } else {
+      handle = m_jobs.insert(change.m_socket, change.m_job);
+      updatePollSet(handle, nullptr, change.m_job);
+      m_update = true;
+    }
   }
-}
+  m_applying.clear();
 
-SocketMultiplexer::JobCursor SocketMultiplexer::newCursor()
-{
   Lock lock(m_mutex);
-  return m_socketJobs.insert(m_socketJobs.begin(), m_cursorMark);
+  m_changesApplied = queued;
+  m_changesDone->broadcast();
 }
 
-SocketMultiplexer::JobCursor SocketMultiplexer::nextCursor(JobCursor cursor)
+void SocketMultiplexer::runPolledJobs()
 {
-  Lock lock(m_mutex);
-  auto j = m_socketJobs.end();
-  JobCursor i = cursor;
-  while (++i != m_socketJobs.end()) {
-    if (*i != m_cursorMark) {
-      // found a real job (as opposed to a cursor)
-      j = i;
-
-      // move our cursor just past the job
-      m_socketJobs.splice(++i, m_socketJobs, cursor);
-      break;
+  // collect poll entries
+  if (m_update) {
+    m_update = false;
+    m_pollEntries.clear();
+    m_pollHandles.clear();
+    m_jobs.forEach([this](Handle handle, const ISocketMultiplexerJob *job) {
+      m_pollEntries.push_back({job->getSocket(), pollEvents(job), 0});
+      m_pollHandles.push_back(handle);
+    });
+  }
+
+  int status;
+  try {
+    // check for status
+    status = ARCH->pollSocket(m_pollEntries.data(), static_cast<int>(m_pollEntries.size()), pollTimeout());
+  } catch (ArchNetworkException &e) {
+    LOG_WARN("error in socket multiplexer: %s", e.what());
+    status = 0;
+  }
+
+  if (status == 0) {
+    return;
+  }
+
+  // iterate over socket jobs, invoking each and saving the
+  // new job.  a job removed by an earlier one has a stale handle.
+  for (size_t i = 0; i < m_pollEntries.size(); ++i) {
+    ISocketMultiplexerJob *job = m_jobs.find(m_pollHandles[i]);
+    if (job == nullptr) {
+      continue;
     }
+
+    runJob(m_pollHandles[i], job, m_pollEntries[i].m_revents);
   }
-  return j;
 }
 
-void SocketMultiplexer::deleteCursor(JobCursor cursor)
+void SocketMultiplexer::runReadyJobs()
 {
-  Lock lock(m_mutex);
-  m_socketJobs.erase(cursor);
+  int n;
+  try {
+    n = ARCH->waitPollSet(m_pollSet, m_ready.data(), static_cast<int>(m_ready.size()), pollTimeout());
+  } catch (ArchNetworkException &e) {
+    LOG_WARN("error in socket multiplexer: %s", e.what());
+    n = 0;
+  }
+
+  // only ready sockets are reported so there's no need to walk the
+  // registry.  a job removed by an earlier one has a stale handle.
+  for (int i = 0; i < n; ++i) {
+    const Handle handle = m_ready[i].m_cookie;
+    ISocketMultiplexerJob *job = m_jobs.find(handle);
+    if (job == nullptr) {
+      continue;
+    }
+
+    runJob(handle, job, m_ready[i].m_revents);
+  }
 }
 
-void SocketMultiplexer::lockJobListLock()
+double SocketMultiplexer::pollTimeout() const
 {
-  Lock lock(m_mutex);
+  if (m_deadlines.empty()) {
+    return -1.0;
+  }
+  const auto remaining = m_deadlines.front().m_when - MonotonicClock::now();
+  return (remaining.count() > 0) ? MonotonicClock::toSeconds(remaining) : 0.0;
+}
 
-  // wait for the lock on the lock
-  while (*m_jobListLockLocked) {
-    m_jobListLockLocked->wait();
+void SocketMultiplexer::runDueJobs()
+{
+  if (m_deadlines.empty()) {
+    return;
   }
 
-  // take ownership of the lock on the lock
-  *m_jobListLockLocked = true;
-  m_jobListLockLocker = new Thread(Thread::getCurrentThread());
+  // a job may remove sockets, and with them their deadlines, so check
+  // the heap afresh each time
+  const auto now = MonotonicClock::now();
+  while (!m_deadlines.empty() && m_deadlines.front().m_when <= now) {
+    std::pop_heap(m_deadlines.begin(), m_deadlines.end(), std::greater<>());
+    const Deadline deadline = m_deadlines.back();
+    m_deadlines.pop_back();
+
+    // drop deadlines that were cancelled or superseded
+    if (!takeWrite(deadline)) {
+      continue;
+    }
+
+    ISocket *socket = deadline.m_socket;
+
+    const Handle handle = m_jobs.find(socket);
+    ISocketMultiplexerJob *job = m_jobs.find(handle);
+    if (job == nullptr) {
+      continue;
+    }
+
+    runJob(handle, job, IArchNetwork::PollEventMask::Out);
+  }
 }
 
-void SocketMultiplexer::lockJobList()
+bool SocketMultiplexer::takeWrite(const Deadline &deadline)
 {
   Lock lock(m_mutex);
+  const auto i = m_writes.find(deadline.m_socket);
+  if (i == m_writes.end() || i->second != deadline.m_generation) {
+    return false;
+  }
+  m_writes.erase(i);
+  return true;
+}
 
-  // make sure we're the one that called lockJobListLock()
-  assert(*m_jobListLockLocker == Thread::getCurrentThread());
+void SocketMultiplexer::runJob(Handle handle, ISocketMultiplexerJob *job, unsigned short revents)
+{
+  bool read = ((revents & IArchNetwork::PollEventMask::In) != 0);
+  bool write = ((revents & IArchNetwork::PollEventMask::Out) != 0);
+  bool error = ((revents & (IArchNetwork::PollEventMask::Error | IArchNetwork::PollEventMask::Invalid)) != 0);
+
+  m_running = handle;
+  ISocketMultiplexerJob *newJob = job->run(read, write, error);
+  m_running = SocketJobRegistry::kInvalidHandle;
+
+  // a job that removed its own socket was kept alive until it returned
+  if (m_retired != nullptr) {
+    if (newJob != m_retired) {
+      delete newJob;
+    }
+    delete m_retired;
+    m_retired = nullptr;
+    return;
+  }
 
-  // wait for the job list lock
-  while (*m_jobListLock) {
-    m_jobListLock->wait();
+  // save job, if different
+  if (newJob != job) {
+    setJob(handle, newJob);
   }
+}
 
-  // take ownership of the lock
-  *m_jobListLock = true;
-  m_jobListLocker = m_jobListLockLocker;
-  m_jobListLockLocker = nullptr;
+void SocketMultiplexer::removeJob(ISocket *socket)
+{
+  if (Handle handle = m_jobs.find(socket); handle != SocketJobRegistry::kInvalidHandle) {
+    if (handle == m_running) {
+      updatePollSet(handle, m_jobs.find(handle), nullptr);
+      m_retired = m_jobs.release(handle);
+      m_update = true;
+    } else {
+      setJob(handle, nullptr);
+    }
+  }
 
-  // release the lock on the lock
-  *m_jobListLockLocked = false;
-  m_jobListLockLocked->broadcast();
+  // a removed socket's deadlines must not fire for a new socket
+  // allocated at the same address
+  {
+    Lock lock(m_mutex);
+    m_writes.erase(socket);
+  }
+  const auto isRemoved = [socket](const Deadline &deadline) { return deadline.m_socket == socket; };
+  if (std::erase_if(m_deadlines, isRemoved) != 0) {
+    std::make_heap(m_deadlines.begin(), m_deadlines.end(), std::greater<>());
+  }
 }
 
-void SocketMultiplexer::unlockJobList()
+void SocketMultiplexer::setJob(Handle handle, ISocketMultiplexerJob *job)
 {
-  Lock lock(m_mutex);
+  ISocketMultiplexerJob *oldJob = m_jobs.find(handle);
+  if (oldJob == job) {
+    return;
+  }
 
-  // make sure we're the one that called lockJobList()
-  assert(*m_jobListLocker == Thread::getCurrentThread());
+  // update the poll set before the registry deletes the old job
+  // because the old job's reference keeps the registered socket open
+  updatePollSet(handle, oldJob, job);
+  m_jobs.replace(handle, job);
+  m_update = true;
+}
 
-  // release the lock
-  delete m_jobListLocker;
-  m_jobListLocker = nullptr;
-  *m_jobListLock = false;
-  m_jobListLock->signal();
+void SocketMultiplexer::updatePollSet(
+    Handle handle, const ISocketMultiplexerJob *oldJob, const ISocketMultiplexerJob *job
+)
+{
+  if (m_pollSet == nullptr) {
+    return;
+  }
 
-  // set new jobs ready state
-  bool isReady = !m_socketJobMap.empty();
-  if (*m_jobsReady != isReady) {
-    *m_jobsReady = isReady;
-    m_jobsReady->signal();
+  ArchSocket oldSocket = (oldJob != nullptr) ? oldJob->getSocket() : nullptr;
+  ArchSocket socket = (job != nullptr) ? job->getSocket() : nullptr;
+  try {
+    if (oldSocket != nullptr && oldSocket != socket) {
+      ARCH->removePollSetSocket(m_pollSet, oldSocket);
+    }
+    if (socket != nullptr) {
+      ARCH->setPollSetSocket(m_pollSet, socket, pollEvents(job), handle);
+    }
+  } catch (ArchNetworkException &e) {
+    LOG_WARN("error in socket multiplexer: %s", e.what());
   }
 }
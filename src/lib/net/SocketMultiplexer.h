@@ -7,10 +7,16 @@
 
 #pragma once
 
-#include <list>
-#include <map>
+#include "arch/IArchNetwork.h"
+#include "arch/MonotonicClock.h"
+#include "net/SocketJobRegistry.h"
 
-template <class T> class CondVar;
+#include <cstdint>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class CondVarBase;
 class Mutex;
 class Thread;
 class ISocket;
@@ -19,6 +25,19 @@ class ISocketMultiplexerJob;
 //! Socket multiplexer
 /*!
 A socket multiplexer services multiple sockets simultaneously.
+
+Jobs are kept in a \c SocketJobRegistry that only the service thread
+touches.  \c addSocket() and \c removeSocket() queue a change and wake
+the service thread, which applies every queued change in one batch
+between polls, so running ready jobs needs no locking.
+
+Where the architecture supports a persistent poll set (epoll on Linux)
+sockets are registered with it as jobs are added, replaced and removed,
+and each wakeup only visits the jobs whose sockets are ready.  Elsewhere
+every job is polled on every wakeup.
+
+\c scheduleWrite() lets a socket hold output back for a while; the
+service thread sleeps no longer than the earliest such deadline.
 */
 class SocketMultiplexer
 {
@@ -34,10 +53,49 @@ public:
   //! @name manipulators
   //@{
 
+  //! Service a socket
+  /*!
+  Makes \p job the job for \p socket, replacing and eventually deleting
+  any current job, or stops servicing \p socket if \p job is nullptr.
+  Returns without waiting for the service thread.
+
+  The change is applied between polls, after the current job may have run
+  once more and installed a job of its own.  Queued changes are applied
+  in order so callers should build and queue jobs while holding the lock
+  that guards the state they're built from, and a job must cope with
+  being run for state that has since changed.
+  */
   void addSocket(ISocket *, ISocketMultiplexerJob *);
 
+  //! Stop servicing a socket
+  /*!
+  Deletes the job for \p socket.  Once this returns the job is not
+  running and will not run again, so the socket may be destroyed.
+
+  Called by a job, on the service thread, the socket is removed at once
+  and changes queued for it are dropped.  If the running job is the
+  socket's own it's deleted once it returns.
+  */
   void removeSocket(ISocket *);
 
+  //! Run a socket's job at a deadline
+  /*!
+  Runs the job for \p socket as though its socket were writable at or
+  shortly after \p when, even if the job isn't waiting for that.  The
+  job must cope with the socket not really being writable.  Nothing
+  happens if the socket has been removed by then.  Deadlines are met to
+  within the resolution of the poll timeout, a millisecond.
+
+  A socket has at most one deadline, this replaces any earlier one.
+  */
+  void scheduleWrite(ISocket *socket, MonotonicClock::time_point when);
+
+  //! Cancel a socket's deadline
+  /*!
+  Cancels the deadline set by scheduleWrite(), if it hasn't been met.
+  */
+  void cancelWrite(ISocket *socket);
+
   //@}
   //! @name accessors
   //@{
@@ -48,55 +106,93 @@ public:
   //@}
 
 private:
-  // list of jobs.  we use a list so we can safely iterate over it
-  // while other threads modify it.
-  using SocketJobs = std::list<ISocketMultiplexerJob *>;
-  using JobCursor = SocketJobs::iterator;
-  using SocketJobMap = std::map<ISocket *, JobCursor>;
-
-  // service sockets.  the service thread will only access m_sockets
-  // and m_update while m_pollable and m_polling are true.  all other
-  // threads must only modify these when m_pollable and m_polling are
-  // false.  only the service thread sets m_polling.
+  using Handle = SocketJobRegistry::Handle;
+
+  // a change queued by addSocket() or removeSocket().  a nullptr job
+  // removes the socket.
+  struct Change
+  {
+    ISocket *m_socket;
+    ISocketMultiplexerJob *m_job;
+  };
+
+  // a write queued by scheduleWrite().  only the socket's latest
+  // deadline, with the generation in m_writes, runs its job.
+  struct Deadline
+  {
+    MonotonicClock::time_point m_when;
+    ISocket *m_socket;
+    uint64_t m_generation;
+
+    // orders a heap with the earliest deadline on top
+    bool operator>(const Deadline &other) const
+    {
+      return m_when > other.m_when;
+    }
+  };
+
+  // service sockets
   [[noreturn]] void serviceThread(const void *);
 
-  // create, iterate, and destroy a cursor.  a cursor is used to
-  // safely iterate through the job list while other threads modify
-  // the list.  it works by inserting a dummy item in the list and
-  // moving that item through the list.  the dummy item will never
-  // be removed by other edits so an iterator pointing at the item
-  // remains valid until we remove the dummy item in deleteCursor().
-  // nextCursor() finds the next non-dummy item, moves our dummy
-  // item just past it, and returns an iterator for the non-dummy
-  // item.  all cursor calls lock the mutex for their duration.
-  JobCursor newCursor();
-  JobCursor nextCursor(JobCursor);
-  void deleteCursor(JobCursor);
-
-  // lock out locking the job list.  this blocks if another thread
-  // has already locked out locking.  once it returns, only the
-  // calling thread will be able to lock the job list after any
-  // current lock is released.
-  void lockJobListLock();
-
-  // lock the job list.  this blocks if the job list is already
-  // locked.  the calling thread must have called requestJobLock.
-  void lockJobList();
-
-  // unlock the job list and the lock out on locking.
-  void unlockJobList();
+  // apply queued changes to the registry.  if wait is true, first wait
+  // until there is a change or a job to service.  service thread only.
+  void applyChanges(bool wait);
+
+  // poll every job and run those whose sockets are ready
+  void runPolledJobs();
+
+  // wait on the poll set and run the jobs it reports as ready
+  void runReadyJobs();
+
+  // get the poll timeout in seconds for the earliest deadline, -1 if none
+  double pollTimeout() const;
+
+  // run the jobs whose deadlines have passed
+  void runDueJobs();
+
+  // check if deadline is its socket's latest and, if so, clear that
+  bool takeWrite(const Deadline &deadline);
+
+  // run the job for handle with the poll events in revents and save
+  // the job it returns
+  void runJob(Handle handle, ISocketMultiplexerJob *job, unsigned short revents);
+
+  // remove socket's job and deadlines.  service thread only.
+  void removeJob(ISocket *socket);
+
+  // replace the job for handle, or remove its socket if job is nullptr.
+  // the current job is deleted.  service thread only.
+  void setJob(Handle handle, ISocketMultiplexerJob *job);
+
+  // register the socket of job with the poll set under handle, replacing
+  // the registration of oldJob's socket
+  void updatePollSet(Handle handle, const ISocketMultiplexerJob *oldJob, const ISocketMultiplexerJob *job);
 
 private:
   Mutex *m_mutex = nullptr;
   Thread *m_thread = nullptr;
+  std::thread::id m_serviceThreadID;
+
+  // guarded by m_mutex
+  std::vector<Change> m_changes;
+  uint64_t m_changesQueued = 0;
+  uint64_t m_changesApplied = 0;
+  CondVarBase *m_changesReady = nullptr;
+  CondVarBase *m_changesDone = nullptr;
+  std::vector<Deadline> m_newDeadlines;
+  std::unordered_map<ISocket *, uint64_t> m_writes;
+  uint64_t m_lastWrite = 0;
+  MonotonicClock::time_point m_wakeAt = MonotonicClock::time_point::max();
+
+  // service thread only
+  SocketJobRegistry m_jobs;
+  std::vector<Change> m_applying;
+  std::vector<Deadline> m_deadlines;
   bool m_update = false;
-  CondVar<bool> *m_jobsReady = nullptr;
-  CondVar<bool> *m_jobListLock = nullptr;
-  CondVar<bool> *m_jobListLockLocked = nullptr;
-  Thread *m_jobListLocker = nullptr;
-  Thread *m_jobListLockLocker = nullptr;
-
-  SocketJobs m_socketJobs = {};
-  SocketJobMap m_socketJobMap = {};
-  ISocketMultiplexerJob *m_cursorMark = nullptr;
+  Handle m_running = SocketJobRegistry::kInvalidHandle;
+  ISocketMultiplexerJob *m_retired = nullptr;
+  std::vector<IArchNetwork::PollEntry> m_pollEntries;
+  std::vector<Handle> m_pollHandles;
+  std::vector<IArchNetwork::PollSetEvent> m_ready;
+  ArchPollSet m_pollSet = nullptr;
 };
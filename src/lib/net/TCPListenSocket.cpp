@@ -97,22 +97,51 @@ void *TCPListenSocket::getEventTarget() const
 
 std::unique_ptr<IDataSocket> TCPListenSocket::accept()
 {
-  std::unique_ptr<IDataSocket> socket;
-  try {
-    socket = std::make_unique<TCPSocket>(m_events, m_socketMultiplexer, ARCH->acceptSocket(m_socket, nullptr));
-    setListeningJob();
-    return socket;
-  } catch (ArchNetworkException &) {
-    if (socket) {
-      setListeningJob();
-    }
+  auto sockets = acceptBatch(1, nullptr);
+  if (sockets.empty()) {
     return nullptr;
-  } catch (std::exception &ex) {
-    if (socket) {
-      setListeningJob();
+  }
+  return std::move(sockets.front());
+}
+
+std::vector<std::unique_ptr<IDataSocket>> TCPListenSocket::acceptBatch(size_t max, const AdmissionCheck &admit)
+{
+  std::vector<std::unique_ptr<IDataSocket>> sockets;
+  try {
+    for (size_t i = 0; i < max; ++i) {
+      ArchNetAddress peer = nullptr;
+      ArchSocket accepted = ARCH->acceptSocket(m_socket, &peer);
+      if (accepted == nullptr) {
+        // the backlog is drained
+        break;
+      }
+
+      const auto address = ARCH->addrToString(peer);
+      ARCH->closeAddr(peer);
+      if (admit && !admit(address)) {
+        ARCH->closeSocket(accepted);
+        continue;
+      }
+
+      if (auto socket = adoptSocket(accepted); socket) {
+        sockets.push_back(std::move(socket));
+      }
     }
-    throw ex;
+  } catch (ArchNetworkException &) {
+    // keep what was accepted before the error
+  } catch (...) {
+    setListeningJob();
+    throw;
   }
+
+  // poll again, there may be more waiting than we took
+  setListeningJob();
+  return sockets;
+}
+
+std::unique_ptr<IDataSocket> TCPListenSocket::adoptSocket(ArchSocket socket)
+{
+  return std::make_unique<TCPSocket>(m_events, m_socketMultiplexer, socket);
 }
 
 void TCPListenSocket::setListeningJob()
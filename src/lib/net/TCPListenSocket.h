@@ -38,12 +38,20 @@ public:
 
   // IListenSocket overrides
   std::unique_ptr<IDataSocket> accept() override;
+  std::vector<std::unique_ptr<IDataSocket>> acceptBatch(size_t max, const AdmissionCheck &admit) override;
 
   ISocketMultiplexerJob *serviceListening(ISocketMultiplexerJob *, bool, bool, bool);
 
 protected:
   void setListeningJob();
 
+  //! Wrap an accepted connection
+  /*!
+  Returns a data socket that adopts \p socket, or nullptr if the
+  connection can't be used.
+  */
+  virtual std::unique_ptr<IDataSocket> adoptSocket(ArchSocket socket);
+
   ArchSocket socket() const
   {
     return m_socket;
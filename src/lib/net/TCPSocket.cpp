@@ -17,11 +17,20 @@
 #include "net/SocketMultiplexer.h"
 #include "net/TSocketMultiplexerMethodJob.h"
 
+#include <algorithm>
+#include <array>
 #include <cstdlib>
 #include <cstring>
 
 static const std::size_t s_maxInputBufferSize = 1024 * 1024;
 
+// bytes read per system call and most buffer spans per system call
+static const uint32_t s_readSize = 16 * 1024;
+static const std::size_t s_maxIoSpans = 16;
+
+// how often the kernel's view of a connection is sampled
+static const auto s_tcpInfoInterval = std::chrono::seconds(1);
+
 //
 // TCPSocket
 //
@@ -122,7 +131,7 @@ uint32_t TCPSocket::read(void *buffer, uint32_t n)
     n = size;
   }
   if (buffer != nullptr && n != 0) {
-    memcpy(buffer, m_inputBuffer.peek(n), n);
+    m_inputBuffer.peek(buffer, n);
   }
   m_inputBuffer.pop(n);
 
@@ -137,92 +146,138 @@ uint32_t TCPSocket::read(void *buffer, uint32_t n)
 
 void TCPSocket::write(const void *buffer, uint32_t n)
 {
-  bool wasEmpty;
-  {
-    Lock lock(&m_mutex);
+  const std::span<const uint8_t> span(static_cast<const uint8_t *>(buffer), n);
+  writev(&span, 1);
+}
 
-    // must not have shutdown output
-    if (!m_writable) {
-      sendEvent(EventTypes::StreamOutputError);
-      return;
-    }
+void TCPSocket::writev(const std::span<const uint8_t> buffers[], size_t count)
+{
+  Lock lock(&m_mutex);
 
-    // ignore empty writes
-    if (n == 0) {
-      return;
+  // must not have shutdown output
+  if (!m_writable) {
+    sendEvent(EventTypes::StreamOutputError);
+    return;
+  }
+
+  // copy data to the output buffer, ignoring empty writes
+  const bool wasEmpty = (m_outputBuffer.getSize() == 0);
+  uint32_t written = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (!buffers[i].empty()) {
+      m_outputBuffer.write(buffers[i].data(), static_cast<uint32_t>(buffers[i].size()));
+      written += static_cast<uint32_t>(buffers[i].size());
     }
+  }
+  if (m_outputBuffer.getSize() == 0) {
+    return;
+  }
+  m_connectionStats.recordOutputBuffered(m_outputBuffer.getSize());
 
-    // copy data to the output buffer
-    wasEmpty = (m_outputBuffer.getSize() == 0);
-    m_outputBuffer.write(buffer, n);
+  // there's data to write
+  m_flushed = false;
+  bool armWrite = wasEmpty;
 
-    // there's data to write
-    m_flushed = false;
+  // when batching, output that isn't queued behind earlier output
+  // waits for more until the deadline or until there's enough of it
+  if (m_batchDelay.count() > 0 && m_connected) {
+    if (wasEmpty) {
+      m_batchOpen = true;
+      m_batchWrites = 0;
+      m_batchBytes = 0;
+      m_socketMultiplexer->scheduleWrite(this, MonotonicClock::now() + m_batchDelay);
+    }
+    if (m_batchOpen) {
+      ++m_batchWrites;
+      m_batchBytes += written;
+      armWrite = (m_outputBuffer.getSize() >= m_batchSize);
+      if (armWrite) {
+        endBatch(BatchEnd::Full);
+      }
+    }
   }
 
   // make sure we're waiting to write
-  if (wasEmpty) {
-    setJob(newJob());
+  if (armWrite) {
+    updateJob();
   }
 }
 
 void TCPSocket::flush()
 {
+  sendBatch();
+
   Lock lock(&m_mutex);
   while (m_flushed == false) {
     m_flushed.wait();
   }
 }
 
-void TCPSocket::shutdownInput()
+void TCPSocket::setWriteBatching(MonotonicClock::duration maxDelay, uint32_t maxSize)
 {
-  bool useNewJob = false;
-  {
-    Lock lock(&m_mutex);
+  Lock lock(&m_mutex);
+  if (m_batchDelay.count() <= 0 && maxDelay.count() > 0) {
+    m_batchStats = {};
+  }
+  m_batchDelay = std::max(maxDelay, MonotonicClock::duration::zero());
+  m_batchSize = maxSize;
 
-    // shutdown socket for reading
-    try {
-      ARCH->closeSocketForRead(m_socket);
-    } catch (const ArchNetworkException &e) {
-      // ignore, there's not much we can do
-      LOG_WARN("error closing socket: %s", e.what());
-    }
+  // stop holding back output if batching is now off
+  if (m_batchDelay.count() == 0 && m_batchOpen) {
+    endBatch(BatchEnd::Urgent);
+    updateJob();
+  }
+}
 
-    // shutdown buffer for reading
-    if (m_readable) {
-      sendEvent(EventTypes::StreamInputShutdown);
-      onInputShutdown();
-      useNewJob = true;
-    }
+void TCPSocket::sendBatch()
+{
+  Lock lock(&m_mutex);
+  if (!m_batchOpen) {
+    return;
   }
-  if (useNewJob) {
-    setJob(newJob());
+  endBatch(BatchEnd::Urgent);
+
+  // start waiting to write
+  updateJob();
+}
+
+void TCPSocket::shutdownInput()
+{
+  Lock lock(&m_mutex);
+
+  // shutdown socket for reading
+  try {
+    ARCH->closeSocketForRead(m_socket);
+  } catch (const ArchNetworkException &e) {
+    // ignore, there's not much we can do
+    LOG_WARN("error closing socket: %s", e.what());
+  }
+
+  // shutdown buffer for reading
+  if (m_readable) {
+    sendEvent(EventTypes::StreamInputShutdown);
+    onInputShutdown();
+    updateJob();
   }
 }
 
 void TCPSocket::shutdownOutput()
 {
-  bool useNewJob = false;
-  {
-    Lock lock(&m_mutex);
-
-    // shutdown socket for writing
-    try {
-      ARCH->closeSocketForWrite(m_socket);
-    } catch (const ArchNetworkException &e) {
-      // ignore, there's not much we can do
-      LOG_WARN("error closing socket: %s", e.what());
-    }
+  Lock lock(&m_mutex);
 
-    // shutdown buffer for writing
-    if (m_writable) {
-      sendEvent(EventTypes::StreamOutputShutdown);
-      onOutputShutdown();
-      useNewJob = true;
-    }
+  // shutdown socket for writing
+  try {
+    ARCH->closeSocketForWrite(m_socket);
+  } catch (const ArchNetworkException &e) {
+    // ignore, there's not much we can do
+    LOG_WARN("error closing socket: %s", e.what());
   }
-  if (useNewJob) {
-    setJob(newJob());
+
+  // shutdown buffer for writing
+  if (m_writable) {
+    sendEvent(EventTypes::StreamOutputShutdown);
+    onOutputShutdown();
+    updateJob();
   }
 }
 
@@ -245,30 +300,45 @@ uint32_t TCPSocket::getSize() const
   return m_inputBuffer.getSize();
 }
 
+uint32_t TCPSocket::getOutputSize() const
+{
+  Lock lock(&m_mutex);
+  return m_outputBuffer.getSize();
+}
+
+deskflow::IStream::OutputStats TCPSocket::getOutputStats() const
+{
+  Lock lock(&m_mutex);
+  return m_batchStats;
+}
+
+ConnectionStats *TCPSocket::getConnectionStats()
+{
+  return &m_connectionStats;
+}
+
 void TCPSocket::connect(const NetworkAddress &addr)
 {
-  {
-    Lock lock(&m_mutex);
+  Lock lock(&m_mutex);
 
-    // fail on attempts to reconnect
-    if (m_socket == nullptr || m_connected) {
-      sendConnectionFailedEvent("busy");
-      return;
-    }
+  // fail on attempts to reconnect
+  if (m_socket == nullptr || m_connected) {
+    sendConnectionFailedEvent("busy");
+    return;
+  }
 
-    try {
-      if (ARCH->connectSocket(m_socket, addr.getAddress())) {
-        sendEvent(EventTypes::DataSocketConnected);
-        onConnected();
-      } else {
-        // connection is in progress
-        m_writable = true;
-      }
-    } catch (const ArchNetworkException &e) {
-      throw SocketConnectException(e.what());
+  try {
+    if (ARCH->connectSocket(m_socket, addr.getAddress())) {
+      sendEvent(EventTypes::DataSocketConnected);
+      onConnected();
+    } else {
+      // connection is in progress
+      m_writable = true;
     }
+  } catch (const ArchNetworkException &e) {
+    throw SocketConnectException(e.what());
   }
-  setJob(newJob());
+  updateJob();
 }
 
 void TCPSocket::init()
@@ -300,24 +370,25 @@ void TCPSocket::init()
 
 TCPSocket::JobResult TCPSocket::doRead()
 {
-  uint8_t buffer[4096];
-  memset(buffer, 0, sizeof(buffer));
-  size_t bytesRead = 0;
+  bool wasEmpty = (m_inputBuffer.getSize() == 0);
 
-  bytesRead = ARCH->readSocket(m_socket, buffer, sizeof(buffer));
+  // read straight into the input buffer
+  std::array<StreamBuffer::WritableSpan, s_maxIoSpans> spans;
+  size_t count = m_inputBuffer.writableSpans(spans.data(), spans.size(), s_readSize);
+  size_t bytesRead = ARCH->readSocketv(m_socket, spans.data(), count);
 
   if (bytesRead > 0) {
-    bool wasEmpty = (m_inputBuffer.getSize() == 0);
-
     // slurp up as much as possible
     do {
-      m_inputBuffer.write(buffer, static_cast<uint32_t>(bytesRead));
+      m_inputBuffer.commit(static_cast<uint32_t>(bytesRead));
+      m_connectionStats.recordInput(bytesRead, m_inputBuffer.getSize());
 
       if (m_inputBuffer.getSize() > s_maxInputBufferSize) {
         break;
       }
 
-      bytesRead = ARCH->readSocket(m_socket, buffer, sizeof(buffer));
+      count = m_inputBuffer.writableSpans(spans.data(), spans.size(), s_readSize);
+      bytesRead = ARCH->readSocketv(m_socket, spans.data(), count);
     } while (bytesRead > 0);
 
     // send input ready if input buffer was empty
@@ -342,13 +413,15 @@ TCPSocket::JobResult TCPSocket::doRead()
 
 TCPSocket::JobResult TCPSocket::doWrite()
 {
-  // write data
-  uint32_t bufferSize = 0;
-  int bytesWrote = 0;
-
-  bufferSize = m_outputBuffer.getSize();
-  const void *buffer = m_outputBuffer.peek(bufferSize);
-  bytesWrote = (uint32_t)ARCH->writeSocket(m_socket, buffer, bufferSize);
+  // write data straight from the output buffer
+  std::array<StreamBuffer::ReadableSpan, s_maxIoSpans> spans;
+  const size_t count = m_outputBuffer.readableSpans(spans.data(), spans.size());
+  if (count == 0) {
+    // a job queued while there was output can run after it's written,
+    // replace it so it stops waiting to write
+    return JobResult::New;
+  }
+  const auto bytesWrote = static_cast<int>(ARCH->writeSocketv(m_socket, spans.data(), count));
 
   if (bytesWrote > 0) {
     discardWrittenData(bytesWrote);
@@ -368,6 +441,15 @@ void TCPSocket::setJob(ISocketMultiplexerJob *job)
   }
 }
 
+void TCPSocket::updateJob()
+{
+  // note -- must have m_mutex locked on entry
+
+  // a nullptr job stops servicing the socket without waiting, which
+  // would deadlock with a running job waiting for m_mutex
+  m_socketMultiplexer->addSocket(this, newJob());
+}
+
 ISocketMultiplexerJob *TCPSocket::newJob()
 {
   // note -- must have m_mutex locked on entry
@@ -386,8 +468,12 @@ ISocketMultiplexerJob *TCPSocket::newJob()
     if (!(m_readable || (m_writable && (m_outputBuffer.getSize() > 0)))) {
       return nullptr;
     }
+
+    // output held back for a batch is written when the multiplexer runs
+    // the job at the batch deadline, not as soon as the socket's writable
     return new TSocketMultiplexerMethodJob<TCPSocket>(
-        this, &TCPSocket::serviceConnected, m_socket, m_readable, m_writable && (m_outputBuffer.getSize() > 0)
+        this, &TCPSocket::serviceConnected, m_socket, m_readable,
+        m_writable && (m_outputBuffer.getSize() > 0) && !m_batchOpen
     );
   }
 }
@@ -408,6 +494,7 @@ void TCPSocket::sendEvent(EventTypes type)
 void TCPSocket::discardWrittenData(int bytesWrote)
 {
   m_outputBuffer.pop(bytesWrote);
+  m_connectionStats.recordOutput(bytesWrote);
   if (m_outputBuffer.getSize() == 0) {
     sendEvent(EventTypes::StreamOutputFlushed);
     m_flushed = true;
@@ -432,12 +519,50 @@ void TCPSocket::onOutputShutdown()
 {
   m_outputBuffer.pop(m_outputBuffer.getSize());
   m_writable = false;
+  if (m_batchOpen) {
+    m_socketMultiplexer->cancelWrite(this);
+    m_batchOpen = false;
+  }
 
   // we're now flushed
   m_flushed = true;
   m_flushed.broadcast();
 }
 
+void TCPSocket::endBatch(BatchEnd reason)
+{
+  // a batch that ends early must not end the next one at its deadline
+  if (reason != BatchEnd::Deadline) {
+    m_socketMultiplexer->cancelWrite(this);
+  }
+
+  m_batchOpen = false;
+  ++m_batchStats.m_batches;
+  m_batchStats.m_writes += m_batchWrites;
+  m_batchStats.m_bytes += m_batchBytes;
+  m_batchStats.m_maxWrites = std::max(m_batchStats.m_maxWrites, m_batchWrites);
+  if (reason == BatchEnd::Full) {
+    ++m_batchStats.m_full;
+  } else if (reason == BatchEnd::Urgent) {
+    ++m_batchStats.m_urgent;
+  }
+}
+
+void TCPSocket::sampleTcpInfo()
+{
+  const auto now = MonotonicClock::now();
+  if (now < m_nextTcpInfo || m_socket == nullptr || !m_connected) {
+    return;
+  }
+  m_nextTcpInfo = now + s_tcpInfoInterval;
+
+  if (IArchNetwork::TcpInfo info; ARCH->getTcpInfo(m_socket, info)) {
+    m_connectionStats.recordTcpInfo(
+        MonotonicClock::fromSeconds(info.m_rtt), MonotonicClock::fromSeconds(info.m_rttVariance), info.m_retransmits
+    );
+  }
+}
+
 void TCPSocket::onDisconnected()
 {
   // disconnected
@@ -502,6 +627,13 @@ ISocketMultiplexerJob *TCPSocket::serviceConnected(ISocketMultiplexerJob *job, b
   JobResult readResult = Retry;
   JobResult writeResult = Retry;
 
+  // only the batch deadline runs the job for writing while a batch is
+  // held back.  the job isn't waiting to write so it must be replaced.
+  const bool batchDue = write && m_batchOpen;
+  if (batchDue) {
+    endBatch(BatchEnd::Deadline);
+  }
+
   if (write) {
     try {
       writeResult = doWrite();
@@ -547,7 +679,9 @@ ISocketMultiplexerJob *TCPSocket::serviceConnected(ISocketMultiplexerJob *job, b
   if (readResult == Break || writeResult == Break)
     return nullptr;
 
-  if (writeResult == New || readResult == New)
+  sampleTcpInfo();
+
+  if (writeResult == New || readResult == New || batchDue)
     return newJob();
 
   return job;
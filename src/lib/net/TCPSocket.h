@@ -9,6 +9,7 @@
 
 #include "arch/IArchNetwork.h"
 #include "base/Event.h"
+#include "io/ConnectionStats.h"
 #include "io/StreamBuffer.h"
 #include "mt/CondVar.h"
 #include "mt/Mutex.h"
@@ -47,12 +48,18 @@ public:
   // IStream overrides
   uint32_t read(void *buffer, uint32_t n) override;
   void write(const void *buffer, uint32_t n) override;
+  void writev(const std::span<const uint8_t> buffers[], size_t count) override;
   void flush() override;
+  void setWriteBatching(MonotonicClock::duration maxDelay, uint32_t maxSize) override;
+  void sendBatch() override;
   void shutdownInput() override;
   void shutdownOutput() override;
   bool isReady() const override;
   bool isFatal() const override;
   uint32_t getSize() const override;
+  uint32_t getOutputSize() const override;
+  OutputStats getOutputStats() const override;
+  ConnectionStats *getConnectionStats() override;
 
   // IDataSocket overrides
   void connect(const NetworkAddress &) override;
@@ -80,6 +87,9 @@ protected:
 
   void setJob(ISocketMultiplexerJob *);
 
+  // queue the job for the current state.  must have m_mutex locked.
+  void updateJob();
+
   bool isConnected() const
   {
     return m_connected;
@@ -126,6 +136,7 @@ protected:
 
   StreamBuffer m_inputBuffer;
   StreamBuffer m_outputBuffer;
+  ConnectionStats m_connectionStats;
 
 private:
   void init();
@@ -136,6 +147,19 @@ private:
   void onOutputShutdown();
   void onDisconnected();
 
+  // the output batch is no longer held back.  must have m_mutex locked.
+  enum class BatchEnd
+  {
+    Deadline,
+    Full,
+    Urgent
+  };
+  void endBatch(BatchEnd reason);
+
+  // record the kernel's view of the connection if it's time to.  must
+  // have m_mutex locked.
+  void sampleTcpInfo();
+
   ISocketMultiplexerJob *serviceConnecting(ISocketMultiplexerJob *, bool, bool, bool);
   ISocketMultiplexerJob *serviceConnected(ISocketMultiplexerJob *, bool, bool, bool);
 
@@ -147,4 +171,15 @@ private:
   IEventQueue *m_events;
   CondVar<bool> m_flushed;
   SocketMultiplexer *m_socketMultiplexer;
+
+  // write batching, off while m_batchDelay is zero.  while m_batchOpen
+  // the output buffer is held back until the batch deadline.
+  MonotonicClock::duration m_batchDelay{};
+  uint32_t m_batchSize = 0;
+  bool m_batchOpen = false;
+  uint32_t m_batchWrites = 0;
+  uint32_t m_batchBytes = 0;
+  OutputStats m_batchStats;
+
+  MonotonicClock::time_point m_nextTcpInfo{};
 };
@@ -757,7 +757,7 @@ void EiScreen::onButtonEvent(ei_event *event)
 
   auto eventType = pressed ? EventTypes::PrimaryScreenButtonDown : EventTypes::PrimaryScreenButtonUp;
 
-  sendEvent(eventType, ButtonInfo::alloc(buttonID, mask));
+  sendEvent(eventType, ButtonInfo{buttonID, mask});
 }
 
 void EiScreen::onPointerScrollEvent(ei_event *event)
@@ -802,7 +802,7 @@ void EiScreen::onPointerScrollEvent(ei_event *event)
   if (x != 0 || y != 0)
     sendEvent(
         EventTypes::PrimaryScreenWheel,
-        WheelInfo::alloc((int32_t)-x * s_pixelToWheelRatio, (int32_t)-y * s_pixelToWheelRatio)
+        WheelInfo{(int32_t)-x * s_pixelToWheelRatio, (int32_t)-y * s_pixelToWheelRatio}
     );
 
   remainder->x = rx;
@@ -825,7 +825,7 @@ void EiScreen::onPointerScrollDiscreteEvent(ei_event *event)
   // libei and deskflow seem to use opposite directions, so we have
   // to send the opposite of the value reported by EI if we want to
   // remain compatible with other platforms (including X11).
-  sendEvent(EventTypes::PrimaryScreenWheel, WheelInfo::alloc(-dx, -dy));
+  sendEvent(EventTypes::PrimaryScreenWheel, WheelInfo{-dx, -dy});
 }
 
 void EiScreen::onMotionEvent(ei_event *event)
@@ -837,7 +837,7 @@ void EiScreen::onMotionEvent(ei_event *event)
 
   if (m_isOnScreen) {
     LOG_DEBUG("event: motion on primary x=%i y=%i)", m_cursorX, m_cursorY);
-    sendEvent(EventTypes::PrimaryScreenMotionOnPrimary, MotionInfo::alloc(m_cursorX, m_cursorY));
+    sendEvent(EventTypes::PrimaryScreenMotionOnPrimary, MotionInfo{m_cursorX, m_cursorY});
     if (m_portalInputCapture->isActive()) {
       m_portalInputCapture->release();
     }
@@ -848,7 +848,7 @@ void EiScreen::onMotionEvent(ei_event *event)
     auto pixelDy = static_cast<std::int32_t>(m_bufferDY);
     if (pixelDx || pixelDy) {
       LOG_VERBOSE("event: motion on secondary x=%d y=%d", pixelDx, pixelDy);
-      sendEvent(EventTypes::PrimaryScreenMotionOnSecondary, MotionInfo::alloc(pixelDx, pixelDy));
+      sendEvent(EventTypes::PrimaryScreenMotionOnSecondary, MotionInfo{pixelDx, pixelDy});
       m_bufferDX -= pixelDx;
       m_bufferDY -= pixelDy;
     }
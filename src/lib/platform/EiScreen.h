@@ -111,6 +111,12 @@ private:
   void initEi();
   void cleanupEi();
   void sendEvent(EventTypes type, void *data);
+  template <typename T>
+    requires std::is_class_v<T>
+  void sendEvent(EventTypes type, const T &data)
+  {
+    m_events->addEvent(Event(type, getEventTarget(), data));
+  }
   ButtonID mapButtonFromEvdev(ei_event *event) const;
   void onKeyEvent(ei_event *event);
   void onButtonEvent(ei_event *event);
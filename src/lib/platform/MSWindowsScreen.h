@@ -144,6 +144,12 @@ private:
   // convenience function to send events
 public: // HACK
   void sendEvent(EventTypes type, void * = nullptr);
+  template <typename T>
+    requires std::is_class_v<T>
+  void sendEvent(EventTypes type, const T &data)
+  {
+    m_events->addEvent(Event(type, getEventTarget(), data));
+  }
 
 private: // HACK
   void sendClipboardEvent(EventTypes type, ClipboardID id);
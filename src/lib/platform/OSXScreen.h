@@ -109,6 +109,12 @@ private:
 
   // convenience function to send events
   void sendEvent(EventTypes type, void * = nullptr) const;
+  template <typename T>
+    requires std::is_class_v<T>
+  void sendEvent(EventTypes type, const T &data) const
+  {
+    m_events->addEvent(Event(type, getEventTarget(), data));
+  }
   void sendClipboardEvent(EventTypes type, ClipboardID id) const;
 
   // message handlers
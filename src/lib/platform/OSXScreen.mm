@@ -1011,7 +1011,7 @@ bool OSXScreen::onMouseMove(CGEventRef event)
     m_xCursor = (int32_t)mx;
     m_yCursor = (int32_t)my;
 
-    sendEvent(EventTypes::PrimaryScreenMotionOnPrimary, MotionInfo::alloc(m_xCursor, m_yCursor));
+    sendEvent(EventTypes::PrimaryScreenMotionOnPrimary, MotionInfo{m_xCursor, m_yCursor});
   } else {
     // motion on secondary screen.  the cursor is frozen (see leave()), so read
     // raw deltas from the event instead of diffing position.
@@ -1021,7 +1021,7 @@ bool OSXScreen::onMouseMove(CGEventRef event)
     LOG_VERBOSE("mouse delta %+d,%+d", dx, dy);
 
     if (dx != 0 || dy != 0) {
-      sendEvent(EventTypes::PrimaryScreenMotionOnSecondary, MotionInfo::alloc(dx, dy));
+      sendEvent(EventTypes::PrimaryScreenMotionOnSecondary, MotionInfo{dx, dy});
     }
   }
 
@@ -1037,13 +1037,13 @@ bool OSXScreen::onMouseButton(bool pressed, uint16_t macButton)
     LOG_VERBOSE("event: button press button=%d", button);
     if (button != kButtonNone) {
       KeyModifierMask mask = m_keyState->getActiveModifiers();
-      sendEvent(EventTypes::PrimaryScreenButtonDown, ButtonInfo::alloc(button, mask));
+      sendEvent(EventTypes::PrimaryScreenButtonDown, ButtonInfo{button, mask});
     }
   } else {
     LOG_VERBOSE("event: button release button=%d", button);
     if (button != kButtonNone) {
       KeyModifierMask mask = m_keyState->getActiveModifiers();
-      sendEvent(EventTypes::PrimaryScreenButtonUp, ButtonInfo::alloc(button, mask));
+      sendEvent(EventTypes::PrimaryScreenButtonUp, ButtonInfo{button, mask});
     }
   }
 
@@ -1053,7 +1053,7 @@ bool OSXScreen::onMouseButton(bool pressed, uint16_t macButton)
 bool OSXScreen::onMouseWheel(int32_t xDelta, int32_t yDelta) const
 {
   LOG_VERBOSE("event: button wheel delta=%+d,%+d", xDelta, yDelta);
-  sendEvent(EventTypes::PrimaryScreenWheel, WheelInfo::alloc(xDelta, yDelta));
+  sendEvent(EventTypes::PrimaryScreenWheel, WheelInfo{xDelta, yDelta});
   return true;
 }
 
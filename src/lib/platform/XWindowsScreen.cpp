@@ -1446,7 +1446,7 @@ void XWindowsScreen::onMousePress(const XButtonEvent &xbutton)
   ButtonID button = mapButtonFromX(&xbutton);
   KeyModifierMask mask = m_keyState->mapModifiersFromX(xbutton.state);
   if (button != kButtonNone) {
-    sendEvent(EventTypes::PrimaryScreenButtonDown, ButtonInfo::alloc(button, mask));
+    sendEvent(EventTypes::PrimaryScreenButtonDown, ButtonInfo{button, mask});
   }
 }
 
@@ -1457,19 +1457,19 @@ void XWindowsScreen::onMouseRelease(const XButtonEvent &xbutton)
   ButtonID button = mapButtonFromX(&xbutton);
   KeyModifierMask mask = m_keyState->mapModifiersFromX(xbutton.state);
   if (button != kButtonNone) {
-    sendEvent(PrimaryScreenButtonUp, ButtonInfo::alloc(button, mask));
+    sendEvent(PrimaryScreenButtonUp, ButtonInfo{button, mask});
   } else if (xbutton.button == 4) {
     // wheel forward (away from user)
-    sendEvent(PrimaryScreenWheel, WheelInfo::alloc(0, s_scrollDelta));
+    sendEvent(PrimaryScreenWheel, WheelInfo{0, s_scrollDelta});
   } else if (xbutton.button == 5) {
     // wheel backward (toward user)
-    sendEvent(PrimaryScreenWheel, WheelInfo::alloc(0, -s_scrollDelta));
+    sendEvent(PrimaryScreenWheel, WheelInfo{0, -s_scrollDelta});
   } else if (xbutton.button == 6) {
     // wheel tilt left
-    sendEvent(PrimaryScreenWheel, WheelInfo::alloc(-s_scrollDelta, 0));
+    sendEvent(PrimaryScreenWheel, WheelInfo{-s_scrollDelta, 0});
   } else if (xbutton.button == 7) {
     // wheel tilt right
-    sendEvent(PrimaryScreenWheel, WheelInfo::alloc(s_scrollDelta, 0));
+    sendEvent(PrimaryScreenWheel, WheelInfo{s_scrollDelta, 0});
   }
 }
 
@@ -1504,7 +1504,7 @@ void XWindowsScreen::onMouseMove(const XMotionEvent &xmotion)
     cntr = 0;
   } else if (m_isOnScreen) {
     // motion on primary screen
-    sendEvent(EventTypes::PrimaryScreenMotionOnPrimary, MotionInfo::alloc(m_xCursor, m_yCursor));
+    sendEvent(EventTypes::PrimaryScreenMotionOnPrimary, MotionInfo{m_xCursor, m_yCursor});
   } else {
     // motion on secondary screen.  warp mouse back to
     // center.
@@ -1531,7 +1531,7 @@ void XWindowsScreen::onMouseMove(const XMotionEvent &xmotion)
     // warping to the primary screen's enter position,
     // effectively overriding it.
     if (x != 0 || y != 0) {
-      sendEvent(EventTypes::PrimaryScreenMotionOnSecondary, MotionInfo::alloc(x, y));
+      sendEvent(EventTypes::PrimaryScreenMotionOnSecondary, MotionInfo{x, y});
     }
   }
 }
@@ -86,6 +86,12 @@ protected:
 private:
   // event sending
   void sendEvent(EventTypes, void * = nullptr);
+  template <typename T>
+    requires std::is_class_v<T>
+  void sendEvent(EventTypes type, const T &data)
+  {
+    m_events->addEvent(Event(type, getEventTarget(), data));
+  }
   void sendClipboardEvent(EventTypes, ClipboardID);
 
   // create the transparent cursor
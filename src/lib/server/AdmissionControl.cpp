@@ -0,0 +1,60 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "server/AdmissionControl.h"
+
+#include <algorithm>
+#include <chrono>
+
+// sources tracked before full buckets are dropped
+static const size_t s_maxSources = 256;
+
+//
+// AdmissionControl
+//
+
+AdmissionControl::AdmissionControl(size_t maxPending, double burst, double rate)
+    : m_maxPending(maxPending),
+      m_burst(burst),
+      m_rate(rate)
+{
+  // do nothing
+}
+
+bool AdmissionControl::admit(const std::string &source, size_t pending, MonotonicClock::time_point now)
+{
+  if (pending >= m_maxPending) {
+    ++m_refused;
+    return false;
+  }
+
+  if (m_buckets.size() >= s_maxSources && !m_buckets.contains(source)) {
+    prune(now);
+  }
+
+  // a new source starts with a full bucket
+  Bucket &bucket = m_buckets.try_emplace(source, Bucket{m_burst, now}).first->second;
+  bucket.m_tokens = tokens(bucket, now);
+  bucket.m_updated = now;
+  if (bucket.m_tokens < 1.0) {
+    ++m_refused;
+    return false;
+  }
+  bucket.m_tokens -= 1.0;
+  return true;
+}
+
+double AdmissionControl::tokens(const Bucket &bucket, MonotonicClock::time_point now) const
+{
+  const std::chrono::duration<double> elapsed = now - bucket.m_updated;
+  return std::min(m_burst, bucket.m_tokens + std::max(elapsed.count(), 0.0) * m_rate);
+}
+
+void AdmissionControl::prune(MonotonicClock::time_point now)
+{
+  // a full bucket is the same as no bucket
+  std::erase_if(m_buckets, [this, now](const auto &entry) { return tokens(entry.second, now) >= m_burst; });
+}
@@ -0,0 +1,78 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include "arch/MonotonicClock.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+//! Connection admission control
+/*!
+Decides whether the server should start a handshake with a newly
+accepted connection.  A connection is refused while too many handshakes
+are already in progress, or if its source address is connecting too
+often: each source has a bucket of \c kBurst tokens that refills at
+\c kRate tokens per second, and every connection takes one.
+
+The check is cheap, so refused connections can be closed before any
+TLS work is done for them.
+*/
+class AdmissionControl
+{
+public:
+  //! Most handshakes in progress at once
+  static const size_t kMaxPending = 32;
+
+  //! Connections a source may make in a burst
+  static constexpr double kBurst = 5.0;
+
+  //! Connections per second a source may sustain
+  static constexpr double kRate = 1.0;
+
+  explicit AdmissionControl(size_t maxPending = kMaxPending, double burst = kBurst, double rate = kRate);
+
+  //! @name manipulators
+  //@{
+
+  //! Decide whether to admit a connection
+  /*!
+  Returns true if a connection from \p source may start its handshake
+  while \p pending other handshakes are in progress.
+  */
+  bool admit(const std::string &source, size_t pending, MonotonicClock::time_point now = MonotonicClock::now());
+
+  //@}
+  //! @name accessors
+  //@{
+
+  //! Get the number of connections refused so far
+  uint64_t getRefused() const
+  {
+    return m_refused;
+  }
+
+  //@}
+
+private:
+  struct Bucket
+  {
+    double m_tokens = 0.0;
+    MonotonicClock::time_point m_updated;
+  };
+
+  double tokens(const Bucket &bucket, MonotonicClock::time_point now) const;
+  void prune(MonotonicClock::time_point now);
+
+  size_t m_maxPending;
+  double m_burst;
+  double m_rate;
+  std::map<std::string, Bucket> m_buckets;
+  uint64_t m_refused = 0;
+};
@@ -20,6 +20,14 @@
 #include "server/ClientProxy.h"
 #include "server/ClientProxyUnknown.h"
 
+// hold back mouse motion for a client with more than this many bytes
+// waiting to be sent
+static const uint32_t s_motionLimit = 4096;
+
+// most connections accepted per connecting event.  the listen socket is
+// polled again afterwards so the rest are picked up on later events.
+static const size_t s_maxAcceptBatch = 16;
+
 //
 // ClientListener
 //
@@ -124,14 +132,30 @@ void ClientListener::removeUnknownClient(ClientProxyUnknown *unknownClient)
 
 void ClientListener::handleClientConnecting()
 {
-  // accept client connection
-  auto socket = m_listen->accept();
+  // accept the waiting connections, refusing any we have no room for
+  // before doing the TLS handshake
+  size_t admitted = 0;
+  auto sockets = m_listen->acceptBatch(s_maxAcceptBatch, [this, &admitted](const std::string &peer) {
+    if (!m_admission.admit(peer, m_handshakingSockets.size() + admitted)) {
+      LOG_DEBUG(
+          "refused connection from %s, %llu refused so far", peer.c_str(),
+          static_cast<unsigned long long>(m_admission.getRefused())
+      );
+      return false;
+    }
+    ++admitted;
+    return true;
+  });
 
-  if (!socket)
-    return;
+  for (auto &socket : sockets) {
+    addClientSocket(socket.release());
+  }
+}
 
-  auto rawSocketPointer = socket.release();
+void ClientListener::addClientSocket(IDataSocket *rawSocketPointer)
+{
   m_clientSockets.insert(rawSocketPointer);
+  m_handshakingSockets.insert(rawSocketPointer);
 
   m_events->addHandler(
       EventTypes::ClientListenerAccepted, rawSocketPointer->getEventTarget(),
@@ -158,7 +182,9 @@ void ClientListener::handleClientAccepted(IDataSocket *socket)
   LOG_INFO("accepted client connection");
 
   // filter socket messages, including a packetizing filter
-  deskflow::IStream *stream = new PacketStreamFilter(m_events, socket, false);
+  auto *packetStream = new PacketStreamFilter(m_events, socket, false);
+  packetStream->setMotionLimit(s_motionLimit);
+  deskflow::IStream *stream = packetStream;
   assert(m_server != nullptr);
 
   // create proxy for unknown client
@@ -167,8 +193,8 @@ void ClientListener::handleClientAccepted(IDataSocket *socket)
   m_newClients.insert(client);
 
   // watch for events from unknown client
-  m_events->addHandler(EventTypes::ClientProxyUnknownSuccess, client, [this, client](const auto &) {
-    handleUnknownClient(client);
+  m_events->addHandler(EventTypes::ClientProxyUnknownSuccess, client, [this, client, socket](const auto &) {
+    handleUnknownClient(client, socket);
   });
   m_events->addHandler(EventTypes::ClientProxyUnknownFailure, client, [this, client](const auto &) {
     auto *filter = dynamic_cast<StreamFilter *>(client->getStream());
@@ -183,10 +209,11 @@ void ClientListener::handleClientAccepted(IDataSocket *socket)
   });
 }
 
-void ClientListener::handleUnknownClient(ClientProxyUnknown *unknownClient)
+void ClientListener::handleUnknownClient(ClientProxyUnknown *unknownClient, IDataSocket *socket)
 {
   // we should have the client in our new client list
   assert(m_newClients.count(unknownClient) == 1);
+  m_handshakingSockets.erase(socket);
 
   // get the real client proxy and install it
   if (auto client = unknownClient->orphanClientProxy(); client) {
@@ -231,6 +258,7 @@ void ClientListener::handleClientDisconnected(ClientProxy *client)
 void ClientListener::removeClientSocket(IDataSocket *socket)
 {
   m_clientSockets.erase(socket);
+  m_handshakingSockets.erase(socket);
   m_events->removeHandlers(socket->getEventTarget());
   delete socket;
 }
@@ -246,4 +274,5 @@ void ClientListener::cleanupClientSockets()
     delete client;
   }
   m_clientSockets.clear();
+  m_handshakingSockets.clear();
 }
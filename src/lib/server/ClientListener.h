@@ -9,6 +9,7 @@
 #pragma once
 
 #include "net/SecurityLevel.h"
+#include "server/AdmissionControl.h"
 #include "server/Config.h"
 
 #include <deque>
@@ -68,9 +69,10 @@ private:
   // client connection event handlers
   void handleClientConnecting();
   void handleClientAccepted(IDataSocket *socket);
-  void handleUnknownClient(ClientProxyUnknown *unknownClient);
+  void handleUnknownClient(ClientProxyUnknown *unknownClient, IDataSocket *socket);
   void handleClientDisconnected(ClientProxy *client);
 
+  void addClientSocket(IDataSocket *socket);
   void removeClientSocket(IDataSocket *socket);
   void cleanupListenSocket();
   void cleanupClientSockets();
@@ -91,5 +93,7 @@ private:
   IEventQueue *m_events;
   SecurityLevel m_securityLevel;
   ClientSockets m_clientSockets;
+  ClientSockets m_handshakingSockets;
+  AdmissionControl m_admission;
   NetworkAddress m_address;
 };
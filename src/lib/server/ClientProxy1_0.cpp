@@ -11,7 +11,9 @@
 #include "base/IEventQueue.h"
 #include "base/Log.h"
 #include "deskflow/DeskflowException.h"
+#include "deskflow/ProtocolCodec.h"
 #include "deskflow/ProtocolUtil.h"
+#include "io/ConnectionStats.h"
 #include "io/IStream.h"
 
 #include <cstring>
@@ -42,6 +44,11 @@ ClientProxy1_0::ClientProxy1_0(const std::string &name, deskflow::IStream *strea
 
   setHeartbeatRate(kHeartRate, kHeartRate * kHeartBeatsUntilDeath);
 
+  // count the connection's messages in the handler table
+  if (auto *stats = stream->getConnectionStats(); stats != nullptr) {
+    stats->setMessageCounter(&m_handlers);
+  }
+
   LOG_VERBOSE("querying client \"%s\" info", getName().c_str());
   ProtocolUtil::writef(getStream(), kMsgQInfo);
 }
@@ -49,10 +56,16 @@ ClientProxy1_0::ClientProxy1_0(const std::string &name, deskflow::IStream *strea
 ClientProxy1_0::~ClientProxy1_0()
 {
   removeHandlers();
+  if (auto *stats = getStream()->getConnectionStats(); stats != nullptr) {
+    stats->setMessageCounter(nullptr);
+  }
 }
 
 void ClientProxy1_0::disconnect()
 {
+  if (!m_handlers.empty()) {
+    LOG_DEBUG("messages from \"%s\": %s", getName().c_str(), m_handlers.report().c_str());
+  }
   removeHandlers();
   getStream()->close();
   m_events->addEvent(Event(EventTypes::ClientProxyDisconnected, getEventTarget()));
@@ -91,8 +104,12 @@ void ClientProxy1_0::removeHeartbeatTimer()
 void ClientProxy1_0::resetHeartbeatTimer()
 {
   // reset the alarm
-  removeHeartbeatTimer();
-  addHeartbeatTimer();
+  if (m_heartbeatTimer != nullptr) {
+    m_events->resetTimer(m_heartbeatTimer);
+  } else {
+    // not virtual, subclasses call this to reset only the alarm
+    ClientProxy1_0::addHeartbeatTimer();
+  }
 }
 
 void ClientProxy1_0::resetHeartbeatRate()
@@ -153,6 +170,8 @@ bool ClientProxy1_0::parseHandshakeMessage(const uint8_t *code)
     return true;
   } else if (memcmp(code, kMsgDInfo, 4) == 0) {
     // future messages get parsed by parseMessage
+    m_handlers.clear();
+    addMessageHandlers(m_handlers);
     m_parser = &ClientProxy1_0::parseMessage;
     if (recvInfo()) {
       m_events->addEvent(Event(EventTypes::ClientProxyReady, getEventTarget()));
@@ -165,22 +184,26 @@ bool ClientProxy1_0::parseHandshakeMessage(const uint8_t *code)
 
 bool ClientProxy1_0::parseMessage(const uint8_t *code)
 {
-  if (memcmp(code, kMsgDInfo, 4) == 0) {
+  const auto *handler = m_handlers.find(code);
+  return handler != nullptr && (*handler)();
+}
+
+void ClientProxy1_0::addMessageHandlers(MessageHandlers &handlers)
+{
+  handlers.add(kMsgDInfo, [this] {
     if (recvInfo()) {
       m_events->addEvent(Event(EventTypes::ScreenShapeChanged, getEventTarget()));
       return true;
     }
     return false;
-  } else if (memcmp(code, kMsgCNoop, 4) == 0) {
+  });
+  handlers.add(kMsgCNoop, [this] {
     // discard no-ops
     LOG_VERBOSE("no-op from", getName().c_str());
     return true;
-  } else if (memcmp(code, kMsgCClipboard, 4) == 0) {
-    return recvGrabClipboard();
-  } else if (memcmp(code, kMsgDClipboard, 4) == 0) {
-    return recvClipboard();
-  }
-  return false;
+  });
+  handlers.add(kMsgCClipboard, [this] { return recvGrabClipboard(); });
+  handlers.add(kMsgDClipboard, [this] { return recvClipboard(); });
 }
 
 void ClientProxy1_0::handleDisconnect()
@@ -226,13 +249,13 @@ void ClientProxy1_0::getCursorPos(int32_t &x, int32_t &y) const
 void ClientProxy1_0::enter(int32_t xAbs, int32_t yAbs, uint32_t seqNum, KeyModifierMask mask, bool)
 {
   LOG_VERBOSE("send enter to \"%s\", %d,%d %d %04x", getName().c_str(), xAbs, yAbs, seqNum, mask);
-  ProtocolUtil::writef(getStream(), kMsgCEnter, xAbs, yAbs, seqNum, mask);
+  deskflow::protocol::Enter::write(getStream(), xAbs, yAbs, seqNum, mask);
 }
 
 bool ClientProxy1_0::leave()
 {
   LOG_VERBOSE("send leave to \"%s\"", getName().c_str());
-  ProtocolUtil::writef(getStream(), kMsgCLeave);
+  deskflow::protocol::Leave::write(getStream());
 
   // we can never prevent the user from leaving
   return true;
@@ -260,37 +283,42 @@ void ClientProxy1_0::setClipboardDirty(ClipboardID id, bool dirty)
 void ClientProxy1_0::keyDown(KeyID key, KeyModifierMask mask, KeyButton, const std::string &)
 {
   LOG_VERBOSE("send key down to \"%s\" id=%d, mask=0x%04x", getName().c_str(), key, mask);
-  ProtocolUtil::writef(getStream(), kMsgDKeyDown1_0, key, mask);
+  deskflow::protocol::KeyDown1_0::write(getStream(), key, mask);
+  getStream()->sendBatch();
 }
 
 void ClientProxy1_0::keyRepeat(KeyID key, KeyModifierMask mask, int32_t count, KeyButton, const std::string &)
 {
   LOG_VERBOSE("send key repeat to \"%s\" id=%d, mask=0x%04x, count=%d", getName().c_str(), key, mask, count);
-  ProtocolUtil::writef(getStream(), kMsgDKeyRepeat1_0, key, mask, count);
+  deskflow::protocol::KeyRepeat1_0::write(getStream(), key, mask, count);
+  getStream()->sendBatch();
 }
 
 void ClientProxy1_0::keyUp(KeyID key, KeyModifierMask mask, KeyButton)
 {
   LOG_VERBOSE("send key up to \"%s\" id=%d, mask=0x%04x", getName().c_str(), key, mask);
-  ProtocolUtil::writef(getStream(), kMsgDKeyUp1_0, key, mask);
+  deskflow::protocol::KeyUp1_0::write(getStream(), key, mask);
+  getStream()->sendBatch();
 }
 
 void ClientProxy1_0::mouseDown(ButtonID button)
 {
   LOG_VERBOSE("send mouse down to \"%s\" id=%d", getName().c_str(), button);
-  ProtocolUtil::writef(getStream(), kMsgDMouseDown, button);
+  deskflow::protocol::MouseDown::write(getStream(), button);
+  getStream()->sendBatch();
 }
 
 void ClientProxy1_0::mouseUp(ButtonID button)
 {
   LOG_VERBOSE("send mouse up to \"%s\" id=%d", getName().c_str(), button);
-  ProtocolUtil::writef(getStream(), kMsgDMouseUp, button);
+  deskflow::protocol::MouseUp::write(getStream(), button);
+  getStream()->sendBatch();
 }
 
 void ClientProxy1_0::mouseMove(int32_t xAbs, int32_t yAbs)
 {
   LOG_VERBOSE("send mouse move to \"%s\" %d,%d", getName().c_str(), xAbs, yAbs);
-  ProtocolUtil::writef(getStream(), kMsgDMouseMove, xAbs, yAbs);
+  deskflow::protocol::MouseMove::write(getStream(), xAbs, yAbs);
 }
 
 void ClientProxy1_0::mouseRelativeMove(int32_t, int32_t)
@@ -302,7 +330,7 @@ void ClientProxy1_0::mouseWheel(int32_t, int32_t yDelta)
 {
   // clients prior to 1.3 only support the y axis
   LOG_VERBOSE("send mouse wheel to \"%s\" %+d", getName().c_str(), yDelta);
-  ProtocolUtil::writef(getStream(), kMsgDMouseWheel1_0, yDelta);
+  deskflow::protocol::MouseWheel1_0::write(getStream(), yDelta);
 }
 
 void ClientProxy1_0::sendDragInfo(uint32_t, const char *, size_t)
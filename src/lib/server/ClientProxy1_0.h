@@ -9,9 +9,12 @@
 #pragma once
 
 #include "deskflow/Clipboard.h"
+#include "deskflow/MessageTable.h"
 #include "deskflow/ProtocolTypes.h"
 #include "server/ClientProxy.h"
 
+#include <functional>
+
 class Event;
 class EventQueueTimer;
 class IEventQueue;
@@ -56,8 +59,19 @@ public:
   void secureInputNotification(const std::string &app) const override;
 
 protected:
+  //! Handles one message, returns false if it was invalid
+  using MessageHandler = std::function<bool()>;
+  using MessageHandlers = deskflow::MessageTable<MessageHandler>;
+
   virtual bool parseHandshakeMessage(const uint8_t *code);
-  virtual bool parseMessage(const uint8_t *code);
+  bool parseMessage(const uint8_t *code);
+
+  //! Add the handlers for the messages this protocol version receives
+  /*!
+  Called once the handshake is complete.  Overrides add the messages of
+  their version to those of the version before.
+  */
+  virtual void addMessageHandlers(MessageHandlers &handlers);
 
   virtual void resetHeartbeatRate();
   virtual void setHeartbeatRate(double rate, double alarm);
@@ -99,5 +113,6 @@ private:
   double m_heartbeatAlarm;
   EventQueueTimer *m_heartbeatTimer = nullptr;
   MessageParser m_parser = &ClientProxy1_0::parseHandshakeMessage;
+  MessageHandlers m_handlers;
   IEventQueue *m_events;
 };
@@ -8,7 +8,8 @@
 #include "server/ClientProxy1_1.h"
 
 #include "base/Log.h"
-#include "deskflow/ProtocolUtil.h"
+#include "deskflow/ProtocolCodec.h"
+#include "io/IStream.h"
 
 //
 // ClientProxy1_1
@@ -23,7 +24,8 @@ ClientProxy1_1::ClientProxy1_1(const std::string &name, deskflow::IStream *strea
 void ClientProxy1_1::keyDown(KeyID key, KeyModifierMask mask, KeyButton button, const std::string &)
 {
   LOG_VERBOSE("send key down to \"%s\" id=%d, mask=0x%04x, button=0x%04x", getName().c_str(), key, mask, button);
-  ProtocolUtil::writef(getStream(), kMsgDKeyDown, key, mask, button);
+  deskflow::protocol::KeyDown::write(getStream(), key, mask, button);
+  getStream()->sendBatch();
 }
 
 void ClientProxy1_1::keyRepeat(
@@ -35,11 +37,13 @@ void ClientProxy1_1::keyRepeat(
                     "button=0x%04x, lang=\"%s\"",
        getName().c_str(), key, mask, count, button, lang.c_str())
   );
-  ProtocolUtil::writef(getStream(), kMsgDKeyRepeat, key, mask, count, button, &lang);
+  deskflow::protocol::KeyRepeat::write(getStream(), key, mask, count, button, lang);
+  getStream()->sendBatch();
 }
 
 void ClientProxy1_1::keyUp(KeyID key, KeyModifierMask mask, KeyButton button)
 {
   LOG_VERBOSE("send key up to \"%s\" id=%d, mask=0x%04x, button=0x%04x", getName().c_str(), key, mask, button);
-  ProtocolUtil::writef(getStream(), kMsgDKeyUp, key, mask, button);
+  deskflow::protocol::KeyUp::write(getStream(), key, mask, button);
+  getStream()->sendBatch();
 }
@@ -10,9 +10,9 @@
 
 #include "base/IEventQueue.h"
 #include "base/Log.h"
-#include "deskflow/ProtocolUtil.h"
-
-#include <cstring>
+#include "deskflow/ProtocolCodec.h"
+#include "io/ConnectionStats.h"
+#include "io/IStream.h"
 
 //
 // ClientProxy1_3
@@ -34,19 +34,13 @@ ClientProxy1_3::~ClientProxy1_3()
 void ClientProxy1_3::mouseWheel(int32_t xDelta, int32_t yDelta)
 {
   LOG_VERBOSE("send mouse wheel to \"%s\" %+d,%+d", getName().c_str(), xDelta, yDelta);
-  ProtocolUtil::writef(getStream(), kMsgDMouseWheel, xDelta, yDelta);
+  deskflow::protocol::MouseWheel::write(getStream(), xDelta, yDelta);
 }
 
-bool ClientProxy1_3::parseMessage(const uint8_t *code)
+void ClientProxy1_3::addMessageHandlers(MessageHandlers &handlers)
 {
-  // process message
-  if (memcmp(code, kMsgCKeepAlive, 4) == 0) {
-    // reset alarm
-    resetHeartbeatTimer();
-    return true;
-  } else {
-    return ClientProxy1_2::parseMessage(code);
-  }
+  ClientProxy1_2::addMessageHandlers(handlers);
+  handlers.add(kMsgCKeepAlive, [this] { return recvKeepAlive(); });
 }
 
 void ClientProxy1_3::resetHeartbeatRate()
@@ -63,8 +57,7 @@ void ClientProxy1_3::setHeartbeatRate(double rate, double)
 void ClientProxy1_3::resetHeartbeatTimer()
 {
   // reset the alarm but not the keep alive timer
-  ClientProxy1_2::removeHeartbeatTimer();
-  ClientProxy1_2::addHeartbeatTimer();
+  ClientProxy1_2::resetHeartbeatTimer();
 }
 
 void ClientProxy1_3::addHeartbeatTimer()
@@ -94,5 +87,22 @@ void ClientProxy1_3::removeHeartbeatTimer()
 
 void ClientProxy1_3::keepAlive()
 {
-  ProtocolUtil::writef(getStream(), kMsgCKeepAlive);
+  m_keepAliveSent = MonotonicClock::now();
+  deskflow::protocol::KeepAlive::write(getStream());
+
+  // don't let write batching add to the round trip
+  getStream()->sendBatch();
+}
+
+bool ClientProxy1_3::recvKeepAlive()
+{
+  // the client echoes our keep alives, so this is a round trip
+  if (auto *stats = getStream()->getConnectionStats(); stats != nullptr && m_keepAliveSent.has_value()) {
+    stats->recordRtt(MonotonicClock::now() - *m_keepAliveSent);
+  }
+  m_keepAliveSent.reset();
+
+  // reset alarm
+  resetHeartbeatTimer();
+  return true;
 }
@@ -8,8 +8,11 @@
 
 #pragma once
 
+#include "arch/MonotonicClock.h"
 #include "server/ClientProxy1_2.h"
 
+#include <optional>
+
 //! Proxy for client implementing protocol version 1.3
 class ClientProxy1_3 : public ClientProxy1_2
 {
@@ -27,7 +30,7 @@ public:
 
 protected:
   // ClientProxy overrides
-  bool parseMessage(const uint8_t *code) override;
+  void addMessageHandlers(MessageHandlers &handlers) override;
   void resetHeartbeatRate() override;
   void setHeartbeatRate(double rate, double alarm) override;
   void resetHeartbeatTimer() override;
@@ -36,7 +39,12 @@ protected:
   virtual void keepAlive();
 
 private:
+  bool recvKeepAlive();
+
   double m_keepAliveRate = kKeepAliveRate;
   EventQueueTimer *m_keepAliveTimer = nullptr;
   IEventQueue *m_events = nullptr;
+
+  // when the keep alive the client hasn't yet echoed was sent
+  std::optional<MonotonicClock::time_point> m_keepAliveSent;
 };
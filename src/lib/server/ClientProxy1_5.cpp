@@ -11,8 +11,6 @@
 #include "io/IStream.h"
 #include "server/Server.h"
 
-#include <cstring>
-
 //
 // ClientProxy1_5
 //
@@ -33,17 +31,17 @@ void ClientProxy1_5::fileChunkSending(uint8_t mark, char *data, size_t dataSize)
   // do nothing
 }
 
-bool ClientProxy1_5::parseMessage(const uint8_t *code)
+void ClientProxy1_5::addMessageHandlers(MessageHandlers &handlers)
 {
-  if (memcmp(code, kMsgDFileTransfer, 4) == 0) {
+  ClientProxy1_4::addMessageHandlers(handlers);
+  handlers.add(kMsgDFileTransfer, [this] {
     fileChunkReceived();
-  } else if (memcmp(code, kMsgDDragInfo, 4) == 0) {
+    return true;
+  });
+  handlers.add(kMsgDDragInfo, [this] {
     dragInfoReceived();
-  } else {
-    return ClientProxy1_4::parseMessage(code);
-  }
-
-  return true;
+    return true;
+  });
 }
 
 void ClientProxy1_5::fileChunkReceived() const
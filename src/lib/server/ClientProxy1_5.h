@@ -25,7 +25,10 @@ public:
 
   void sendDragInfo(uint32_t fileCount, const char *info, size_t size) override;
   void fileChunkSending(uint8_t mark, char *data, size_t dataSize) override;
-  bool parseMessage(const uint8_t *code) override;
   void fileChunkReceived() const;
   void dragInfoReceived() const;
+
+protected:
+  // ClientProxy overrides
+  void addMessageHandlers(MessageHandlers &handlers) override;
 };
@@ -6,7 +6,9 @@
 
 #include "base/Log.h"
 #include "deskflow/KeyboardLayoutManager.h"
+#include "deskflow/ProtocolCodec.h"
 #include "deskflow/ProtocolUtil.h"
+#include "io/IStream.h"
 
 #include "ClientProxy1_8.h"
 
@@ -36,5 +38,6 @@ void ClientProxy1_8::keyDown(KeyID key, KeyModifierMask mask, KeyButton button,
       (CLOG_VERBOSE "send key down to \"%s\" id=%d, mask=0x%04x, button=0x%04x, layout=%s", getName().c_str(), key,
        mask, button, language.c_str())
   );
-  ProtocolUtil::writef(getStream(), kMsgDKeyDownLang, key, mask, button, &language);
+  deskflow::protocol::KeyDownLang::write(getStream(), key, mask, button, language);
+  getStream()->sendBatch();
 }
@@ -0,0 +1,263 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "server/ClientProxy1_9.h"
+
+#include "arch/MonotonicClock.h"
+#include "base/IEventQueue.h"
+#include "base/Log.h"
+#include "deskflow/InputLatency.h"
+#include "deskflow/ProtocolCodec.h"
+#include "deskflow/ProtocolTypes.h"
+#include "io/IStream.h"
+
+#include <algorithm>
+
+//
+// ClientProxy1_9
+//
+
+ClientProxy1_9::ClientProxy1_9(const std::string &name, deskflow::IStream *stream, Server *server, IEventQueue *events)
+    : ClientProxy1_8(name, stream, server, events),
+      m_events(events)
+{
+  m_events->addHandler(EventTypes::ClientProxyInputBatch, this, [this](const auto &) {
+    m_sendQueued = false;
+    sendInput();
+  });
+}
+
+ClientProxy1_9::~ClientProxy1_9()
+{
+  m_events->removeHandler(EventTypes::ClientProxyInputBatch, this);
+}
+
+void ClientProxy1_9::enter(int32_t xAbs, int32_t yAbs, uint32_t seqNum, KeyModifierMask mask, bool forScreensaver)
+{
+  sendInput();
+  ClientProxy1_8::enter(xAbs, yAbs, seqNum, mask, forScreensaver);
+}
+
+bool ClientProxy1_9::leave()
+{
+  sendInput();
+  return ClientProxy1_8::leave();
+}
+
+void ClientProxy1_9::setClipboard(ClipboardID id, const IClipboard *clipboard)
+{
+  sendInput();
+  ClientProxy1_8::setClipboard(id, clipboard);
+}
+
+void ClientProxy1_9::grabClipboard(ClipboardID id)
+{
+  sendInput();
+  ClientProxy1_8::grabClipboard(id);
+}
+
+void ClientProxy1_9::keyDown(KeyID key, KeyModifierMask mask, KeyButton button, const std::string &language)
+{
+  LOG(
+      (CLOG_VERBOSE "send key down to \"%s\" id=%d, mask=0x%04x, button=0x%04x, layout=%s", getName().c_str(), key,
+       mask, button, language.c_str())
+  );
+  Record record;
+  record.m_type = Record::Type::KeyDown;
+  record.m_id = key;
+  record.m_mask = mask;
+  record.m_button = button;
+  record.m_language = language;
+  addInput(record, true);
+}
+
+void ClientProxy1_9::keyRepeat(
+    KeyID key, KeyModifierMask mask, int32_t count, KeyButton button, const std::string &language
+)
+{
+  LOG(
+      (CLOG_VERBOSE "send key repeat to \"%s\" id=%d, mask=0x%04x, count=%d, button=0x%04x, lang=\"%s\"",
+       getName().c_str(), key, mask, count, button, language.c_str())
+  );
+  Record record;
+  record.m_type = Record::Type::KeyRepeat;
+  record.m_id = key;
+  record.m_mask = mask;
+  record.m_count = static_cast<uint32_t>(count);
+  record.m_button = button;
+  record.m_language = language;
+  addInput(record, true);
+}
+
+void ClientProxy1_9::keyUp(KeyID key, KeyModifierMask mask, KeyButton button)
+{
+  LOG_VERBOSE("send key up to \"%s\" id=%d, mask=0x%04x, button=0x%04x", getName().c_str(), key, mask, button);
+  Record record;
+  record.m_type = Record::Type::KeyUp;
+  record.m_id = key;
+  record.m_mask = mask;
+  record.m_button = button;
+  addInput(record, true);
+}
+
+void ClientProxy1_9::mouseDown(ButtonID button)
+{
+  LOG_VERBOSE("send mouse down to \"%s\" id=%d", getName().c_str(), button);
+  Record record;
+  record.m_type = Record::Type::MouseDown;
+  record.m_id = button;
+  addInput(record, true);
+}
+
+void ClientProxy1_9::mouseUp(ButtonID button)
+{
+  LOG_VERBOSE("send mouse up to \"%s\" id=%d", getName().c_str(), button);
+  Record record;
+  record.m_type = Record::Type::MouseUp;
+  record.m_id = button;
+  addInput(record, true);
+}
+
+void ClientProxy1_9::mouseMove(int32_t xAbs, int32_t yAbs)
+{
+  LOG_VERBOSE("send mouse move to \"%s\" %d,%d", getName().c_str(), xAbs, yAbs);
+  Record record;
+  record.m_type = Record::Type::MouseMove;
+  record.m_x = xAbs;
+  record.m_y = yAbs;
+  addInput(record, false);
+}
+
+void ClientProxy1_9::mouseRelativeMove(int32_t xRel, int32_t yRel)
+{
+  LOG_VERBOSE("send mouse relative move to \"%s\" %d,%d", getName().c_str(), xRel, yRel);
+  Record record;
+  record.m_type = Record::Type::MouseRelativeMove;
+  record.m_x = xRel;
+  record.m_y = yRel;
+  addInput(record, false);
+}
+
+void ClientProxy1_9::mouseWheel(int32_t xDelta, int32_t yDelta)
+{
+  LOG_VERBOSE("send mouse wheel to \"%s\" %+d,%+d", getName().c_str(), xDelta, yDelta);
+  Record record;
+  record.m_type = Record::Type::MouseWheel;
+  record.m_x = xDelta;
+  record.m_y = yDelta;
+  addInput(record, false);
+}
+
+void ClientProxy1_9::screensaver(bool on)
+{
+  sendInput();
+  ClientProxy1_8::screensaver(on);
+}
+
+void ClientProxy1_9::resetOptions()
+{
+  sendInput();
+  ClientProxy1_8::resetOptions();
+}
+
+void ClientProxy1_9::setOptions(const OptionsList &options)
+{
+  sendInput();
+  ClientProxy1_8::setOptions(options);
+}
+
+void ClientProxy1_9::sendDragInfo(uint32_t fileCount, const char *info, size_t size)
+{
+  sendInput();
+  ClientProxy1_8::sendDragInfo(fileCount, info, size);
+}
+
+void ClientProxy1_9::fileChunkSending(uint8_t mark, char *data, size_t dataSize)
+{
+  sendInput();
+  ClientProxy1_8::fileChunkSending(mark, data, dataSize);
+}
+
+void ClientProxy1_9::secureInputNotification(const std::string &app) const
+{
+  // the notification is const in BaseClientProxy but must still follow
+  // the input batched before it, and this proxy is never const itself
+  const_cast<ClientProxy1_9 *>(this)->sendInput();
+  ClientProxy1_8::secureInputNotification(app);
+}
+
+void ClientProxy1_9::keepAlive()
+{
+  sendInput();
+  ClientProxy1_8::keepAlive();
+}
+
+void ClientProxy1_9::addMessageHandlers(MessageHandlers &handlers)
+{
+  ClientProxy1_8::addMessageHandlers(handlers);
+
+  // the client ignores motion until its screen info is acknowledged, so
+  // motion batched before the info must not arrive after the ack
+  const auto &entries = handlers.getEntries();
+  const auto info = std::ranges::find(entries, deskflow::messageCode(kMsgDInfo), &MessageHandlers::Entry::m_code);
+  if (info != entries.end()) {
+    handlers.add(kMsgDInfo, [this, recvInfo = info->m_handler] {
+      sendInput();
+      return recvInfo();
+    });
+  }
+
+  handlers.add(kMsgQClock, [this] {
+    uint32_t clientTime = 0;
+    deskflow::protocol::QueryClock::read(getStream(), clientTime);
+
+    // answer straight away, the client takes the reply's delay as the round trip
+    const auto now = deskflow::InputRecords::toTime(MonotonicClock::now());
+    deskflow::protocol::Clock::write(getStream(), clientTime, now);
+    getStream()->sendBatch();
+    return true;
+  });
+  handlers.add(kMsgDLatency, [this] {
+    std::vector<uint32_t> report;
+    deskflow::protocol::LatencyReport::read(getStream(), report);
+
+    // the message was read whole, so a report this version can't use is
+    // only skipped
+    if (!deskflow::InputLatency::addReport(report, getStream()->getConnectionStats())) {
+      LOG_WARN("ignoring latency report of %d counts from \"%s\"", static_cast<int>(report.size()), getName().c_str());
+    }
+    return true;
+  });
+}
+
+void ClientProxy1_9::addInput(Record &record, bool urgent)
+{
+  record.m_time = deskflow::InputRecords::toTime(MonotonicClock::now());
+  m_input.add(record);
+
+  if (urgent) {
+    // buttons and keys shouldn't wait, nor wait for write batching
+    sendInput();
+    getStream()->sendBatch();
+  } else if (m_input.getCount() >= deskflow::InputRecords::kMaxRecords) {
+    sendInput();
+  } else if (!m_sendQueued) {
+    // send once the events queued now have been handled, so that motion
+    // arriving together goes out together
+    m_sendQueued = true;
+    m_events->addEvent(Event(EventTypes::ClientProxyInputBatch, this));
+  }
+}
+
+void ClientProxy1_9::sendInput()
+{
+  if (m_input.empty()) {
+    return;
+  }
+  LOG_VERBOSE("send %d input events to \"%s\"", static_cast<int>(m_input.getCount()), getName().c_str());
+  deskflow::protocol::InputBatch::write(getStream(), m_input.getBase(), m_input.getRecords());
+  m_input.clear();
+}
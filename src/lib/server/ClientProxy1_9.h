@@ -0,0 +1,72 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include "deskflow/InputRecords.h"
+#include "server/ClientProxy1_8.h"
+
+//! Proxy for client implementing protocol version 1.9
+/*!
+Sends input events in batches.  Mouse motion and wheel events are held
+until the events already queued have been handled, or until a batch is
+full, and go out together as one message.  Button and key events are
+sent straight away, together with any motion before them.  Every other
+message sent after the handshake, including the acknowledgement of the
+client's screen info, sends the batch first so nothing is reordered.
+
+Answers the client's clock queries and counts the input latency it
+reports in the connection's ConnectionStats.
+*/
+class ClientProxy1_9 : public ClientProxy1_8
+{
+public:
+  ClientProxy1_9(const std::string &name, deskflow::IStream *adoptedStream, Server *server, IEventQueue *events);
+  ClientProxy1_9(ClientProxy1_9 const &) = delete;
+  ClientProxy1_9(ClientProxy1_9 &&) = delete;
+  ~ClientProxy1_9() override;
+
+  ClientProxy1_9 &operator=(ClientProxy1_9 const &) = delete;
+  ClientProxy1_9 &operator=(ClientProxy1_9 &&) = delete;
+
+  // IClient overrides
+  void enter(int32_t xAbs, int32_t yAbs, uint32_t seqNum, KeyModifierMask mask, bool forScreensaver) override;
+  bool leave() override;
+  void setClipboard(ClipboardID, const IClipboard *) override;
+  void grabClipboard(ClipboardID) override;
+  void keyDown(KeyID, KeyModifierMask, KeyButton, const std::string &) override;
+  void keyRepeat(KeyID, KeyModifierMask, int32_t count, KeyButton, const std::string &) override;
+  void keyUp(KeyID, KeyModifierMask, KeyButton) override;
+  void mouseDown(ButtonID) override;
+  void mouseUp(ButtonID) override;
+  void mouseMove(int32_t xAbs, int32_t yAbs) override;
+  void mouseRelativeMove(int32_t xRel, int32_t yRel) override;
+  void mouseWheel(int32_t xDelta, int32_t yDelta) override;
+  void screensaver(bool activate) override;
+  void resetOptions() override;
+  void setOptions(const OptionsList &options) override;
+  void sendDragInfo(uint32_t fileCount, const char *info, size_t size) override;
+  void fileChunkSending(uint8_t mark, char *data, size_t dataSize) override;
+  void secureInputNotification(const std::string &app) const override;
+
+protected:
+  // ClientProxy1_3 overrides
+  void keepAlive() override;
+  void addMessageHandlers(MessageHandlers &handlers) override;
+
+private:
+  using Record = deskflow::InputRecords::Record;
+
+  // add an event to the batch, sending the batch now if it's urgent
+  void addInput(Record &record, bool urgent);
+
+  // send the batched events, if any
+  void sendInput();
+
+  deskflow::InputRecords m_input;
+  bool m_sendQueued = false;
+  IEventQueue *m_events = nullptr;
+};
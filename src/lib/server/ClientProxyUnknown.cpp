@@ -23,6 +23,7 @@
 #include "server/ClientProxy1_6.h"
 #include "server/ClientProxy1_7.h"
 #include "server/ClientProxy1_8.h"
+#include "server/ClientProxy1_9.h"
 #include "server/Server.h"
 
 //
@@ -177,6 +178,10 @@ void ClientProxyUnknown::initProxy(const std::string &name, int major, int minor
       m_proxy = new ClientProxy1_8(name, m_stream, m_server, m_events);
       break;
 
+    case 9:
+      m_proxy = new ClientProxy1_9(name, m_stream, m_server, m_events);
+      break;
+
     default:
       break;
     }
@@ -221,6 +226,11 @@ void ClientProxyUnknown::handleData()
     // create client proxy for highest version supported by the client
     initProxy(name, major, minor);
 
+    // the client accepts compressed packets from here on
+    if (minor >= kCompressionMinorVersion) {
+      m_stream->setCompression(true);
+    }
+
     // the proxy is created and now proxy now owns the stream
     LOG_VERBOSE("created proxy for client \"%s\" version %d.%d", name.c_str(), major, minor);
     m_stream = nullptr;
@@ -19,6 +19,7 @@
 #include "deskflow/Screen.h"
 #include "deskflow/StreamChunker.h"
 #include "deskflow/ipc/CoreIpc.h"
+#include "io/ConnectionStats.h"
 #include "net/TCPSocket.h"
 #include "server/ClientListener.h"
 #include "server/ClientProxy.h"
@@ -36,6 +37,10 @@
 
 using namespace deskflow::server;
 
+// a batch of client output is sent once it reaches this size, about a
+// full ethernet frame
+static const uint32_t s_writeBatchSize = 1400;
+
 //
 // Server
 //
@@ -158,6 +163,7 @@ Server::~Server()
   m_events->removeHandler(PrimaryScreenFakeInputBegin, m_inputFilter);
   m_events->removeHandler(PrimaryScreenFakeInputEnd, m_inputFilter);
   m_events->removeHandler(Timer, this);
+  setMotionCoalescing(false);
   stopSwitch();
 
   try {
@@ -253,6 +259,14 @@ void Server::adoptClient(BaseClientProxy *client)
     return;
   }
   LOG_DEBUG("client \"%s\" has connected", getName(client).c_str());
+  if (auto *stream = client->getStream(); stream != nullptr) {
+    if (m_writeBatchDelay.count() > 0) {
+      stream->setWriteBatching(m_writeBatchDelay, s_writeBatchSize);
+    }
+    if (auto *stats = stream->getConnectionStats(); stats != nullptr) {
+      stats->setName("client " + getName(client));
+    }
+  }
   ipcSendConnectionState(deskflow::core::ConnectionState::Connected);
   sendConnectedClientsIpc();
 
@@ -280,6 +294,47 @@ void Server::disconnect()
   }
 }
 
+void Server::setMotionCoalescing(bool enabled)
+{
+  if (enabled == m_coalesceMotion) {
+    return;
+  }
+  m_coalesceMotion = enabled;
+
+  using enum EventTypes;
+  if (!enabled) {
+    m_events->setCoalescer(PrimaryScreenMotionOnPrimary, nullptr);
+    m_events->setCoalescer(PrimaryScreenMotionOnSecondary, nullptr);
+    return;
+  }
+
+  LOG_DEBUG("coalescing queued motion events");
+
+  // absolute moves, only the latest position matters
+  m_events->setCoalescer(PrimaryScreenMotionOnPrimary, [](Event &queued, const Event &next) {
+    *static_cast<IPlatformScreen::MotionInfo *>(queued.getData()) =
+        *static_cast<const IPlatformScreen::MotionInfo *>(next.getData());
+    return true;
+  });
+
+  // relative moves, the deltas add up
+  m_events->setCoalescer(PrimaryScreenMotionOnSecondary, [](Event &queued, const Event &next) {
+    auto *info = static_cast<IPlatformScreen::MotionInfo *>(queued.getData());
+    const auto *nextInfo = static_cast<const IPlatformScreen::MotionInfo *>(next.getData());
+    info->m_x += nextInfo->m_x;
+    info->m_y += nextInfo->m_y;
+    return true;
+  });
+}
+
+void Server::setWriteBatching(MonotonicClock::duration maxDelay)
+{
+  m_writeBatchDelay = maxDelay;
+  if (maxDelay.count() > 0) {
+    LOG_DEBUG("batching writes to clients for up to %lldus", static_cast<long long>(maxDelay.count() / 1000));
+  }
+}
+
 std::string Server::protocolString() const
 {
   if (m_protocol == NetworkProtocol::Unknown)
@@ -1279,6 +1334,36 @@ void Server::handleClientDisconnected(BaseClientProxy *client)
   removeActiveClient(client);
   removeOldClient(client);
 
+  // report how write batching, motion holding and compression did for this client
+  if (auto *stream = client->getStream(); stream != nullptr) {
+    const auto stats = stream->getOutputStats();
+    if (stats.m_batches != 0) {
+      LOG_DEBUG(
+          "client \"%s\" sent %llu write batches, %llu writes and %llu bytes, at most %u writes per batch, "
+          "%llu sent early when full and %llu by key or button events",
+          getName(client).c_str(), static_cast<unsigned long long>(stats.m_batches),
+          static_cast<unsigned long long>(stats.m_writes), static_cast<unsigned long long>(stats.m_bytes),
+          stats.m_maxWrites, static_cast<unsigned long long>(stats.m_full),
+          static_cast<unsigned long long>(stats.m_urgent)
+      );
+    }
+    if (stats.m_motionCoalesced != 0) {
+      LOG_DEBUG(
+          "client \"%s\" fell behind, %llu mouse motions were replaced by later motion", getName(client).c_str(),
+          static_cast<unsigned long long>(stats.m_motionCoalesced)
+      );
+    }
+    if (stats.m_compressed != 0) {
+      LOG_DEBUG(
+          "client \"%s\" was sent %llu messages compressed, saving %llu bytes", getName(client).c_str(),
+          static_cast<unsigned long long>(stats.m_compressed), static_cast<unsigned long long>(stats.m_compressedSaved)
+      );
+    }
+    if (const auto *connectionStats = stream->getConnectionStats(); connectionStats != nullptr) {
+      LOG_DEBUG("connection stats: %s", connectionStats->report().c_str());
+    }
+  }
+
   // m_clients always contains the primary (server) screen, so 1 means no remote clients.
   using enum deskflow::core::ConnectionState;
   ipcSendConnectionState(m_clients.size() <= 1 ? Listening : Connected);
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "arch/MonotonicClock.h"
 #include "base/Event.h"
 #include "base/Stopwatch.h"
 #include "common/NetworkProtocol.h"
@@ -170,6 +171,24 @@ public:
   */
   void disconnect();
 
+  //! Coalesce queued motion
+  /*!
+  When enabled, primary screen motion that piles up while the event
+  thread is busy is merged before it is dispatched.  Absolute moves
+  collapse to the latest position and relative moves sum their deltas.
+  Motion is never merged across other input.
+  */
+  void setMotionCoalescing(bool enabled);
+
+  //! Batch writes to clients
+  /*!
+  When \p maxDelay is non-zero, output to each client that connects
+  afterwards may wait up to \p maxDelay so that bursts of motion go out
+  in fewer, larger writes.  Key and button events are never delayed.
+  Zero turns this off.
+  */
+  void setWriteBatching(MonotonicClock::duration maxDelay);
+
   //! Store ClientListener pointer
   void setListener(ClientListener *p)
   {
@@ -468,4 +487,6 @@ private:
   bool m_defaultLockToScreenState = false;
   bool m_disableLockToScreen = false;
   bool m_enableClipboard = true;
+  bool m_coalesceMotion = false;
+  MonotonicClock::duration m_writeBatchDelay{};
 };
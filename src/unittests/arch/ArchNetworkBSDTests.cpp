@@ -0,0 +1,179 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "ArchNetworkBSDTests.h"
+
+#include "arch/ArchException.h"
+#include "base/FunctionJob.h"
+#include "base/Stopwatch.h"
+#include "mt/Thread.h"
+
+#include <QTest>
+
+#include <array>
+#include <atomic>
+
+namespace {
+
+using PollSetEvent = IArchNetwork::PollSetEvent;
+
+// loopback ports tried for the listening socket
+const int s_firstPort = 25100;
+const int s_lastPort = 25300;
+
+// wait on a poll set, returning the number of ready sockets
+int wait(ArchPollSet set, double timeout)
+{
+  std::array<PollSetEvent, 4> events{};
+  return ARCH->waitPollSet(set, events.data(), static_cast<int>(events.size()), timeout);
+}
+
+struct WaitState
+{
+  std::atomic<bool> m_polling = false;
+  double m_waited = 0.0;
+};
+
+// wait on a poll set of its own for up to 5 seconds, timing the wait
+void waitLong(void *arg)
+{
+  auto *state = static_cast<WaitState *>(arg);
+  ArchPollSet set = ARCH->newPollSet();
+
+  // the first wait sets up the thread's wakeup channel
+  wait(set, 0.0);
+  state->m_polling = true;
+
+  Stopwatch timer;
+  wait(set, 5.0);
+  state->m_waited = timer.getTime();
+  ARCH->closePollSet(set);
+}
+
+// wake the calling thread's poll set waits
+void wakeSelf()
+{
+  ArchThread self = ARCH->newCurrentThread();
+  ARCH->unblockPollSocket(self);
+  ARCH->closeThread(self);
+}
+
+} // namespace
+
+void ArchNetworkBSDTests::initTestCase()
+{
+  m_arch.init();
+  ArchPollSet set = ARCH->newPollSet();
+  if (set == nullptr) {
+    QSKIP("poll sets aren't supported on this platform");
+  }
+  ARCH->closePollSet(set);
+}
+
+void ArchNetworkBSDTests::waitPollSet_wokenBeforeWait_returnsAtOnce()
+{
+  ArchPollSet set = ARCH->newPollSet();
+  wait(set, 0.0);
+
+  // a wake while not waiting is remembered, the next wait doesn't block
+  wakeSelf();
+  Stopwatch timer;
+  QCOMPARE(wait(set, 5.0), 0);
+  QVERIFY(timer.getTime() < 1.0);
+
+  // and is used up by it
+  timer.reset();
+  QCOMPARE(wait(set, 0.2), 0);
+  QVERIFY(timer.getTime() >= 0.19);
+
+  ARCH->closePollSet(set);
+}
+
+void ArchNetworkBSDTests::waitPollSet_wokenWhileWaiting_returnsAtOnce()
+{
+  WaitState state;
+  Thread thread(new FunctionJob(&waitLong, &state));
+  while (!state.m_polling) {
+    ARCH->sleep(0.001);
+  }
+
+  // give the thread time to block in the wait
+  ARCH->sleep(0.05);
+  thread.unblockPollSocket();
+  QVERIFY(thread.wait(5.0));
+  QVERIFY(state.m_waited < 1.0);
+}
+
+void ArchNetworkBSDTests::waitPollSet_wokenTwice_wakesOnce()
+{
+  ArchPollSet set = ARCH->newPollSet();
+  wait(set, 0.0);
+
+  wakeSelf();
+  wakeSelf();
+
+  Stopwatch timer;
+  QCOMPARE(wait(set, 5.0), 0);
+  QVERIFY(timer.getTime() < 1.0);
+
+  // the second wake didn't leave another behind
+  timer.reset();
+  QCOMPARE(wait(set, 0.2), 0);
+  QVERIFY(timer.getTime() >= 0.19);
+
+  ARCH->closePollSet(set);
+}
+
+void ArchNetworkBSDTests::waitPollSet_readySocket_reportedUntilRemoved()
+{
+  auto addresses = ARCH->nameToAddr("127.0.0.1");
+  ArchNetAddress address = addresses.front();
+  for (size_t i = 1; i < addresses.size(); ++i) {
+    ARCH->closeAddr(addresses[i]);
+  }
+
+  // there's no asking which port a bind to port 0 got, so find a free one
+  ArchSocket listen = ARCH->newSocket(IArchNetwork::AddressFamily::INet, IArchNetwork::SocketType::Stream);
+  for (int port = s_firstPort;; ++port) {
+    ARCH->setAddrPort(address, port);
+    try {
+      ARCH->bindSocket(listen, address);
+      break;
+    } catch (const ArchNetworkException &) {
+      if (port == s_lastPort) {
+        throw;
+      }
+    }
+  }
+  ARCH->listenOnSocket(listen);
+
+  // a connection waiting to be accepted makes the listening socket readable
+  ArchSocket client = ARCH->newSocket(IArchNetwork::AddressFamily::INet, IArchNetwork::SocketType::Stream);
+  ARCH->connectSocket(client, address);
+
+  ArchPollSet set = ARCH->newPollSet();
+  const uint64_t cookie = 7;
+  ARCH->setPollSetSocket(set, listen, IArchNetwork::PollEventMask::In, cookie);
+
+  std::array<PollSetEvent, 4> events{};
+  QCOMPARE(ARCH->waitPollSet(set, events.data(), static_cast<int>(events.size()), 5.0), 1);
+  QCOMPARE(events[0].m_cookie, cookie);
+  QVERIFY((events[0].m_revents & IArchNetwork::PollEventMask::In) != 0);
+
+  // level triggered, so still reported while not accepted
+  QCOMPARE(wait(set, 0.0), 1);
+
+  // but not once it's out of the set
+  ARCH->removePollSetSocket(set, listen);
+  QCOMPARE(wait(set, 0.1), 0);
+
+  ARCH->closePollSet(set);
+  ARCH->closeSocket(client);
+  ARCH->closeSocket(listen);
+  ARCH->closeAddr(address);
+}
+
+QTEST_MAIN(ArchNetworkBSDTests)
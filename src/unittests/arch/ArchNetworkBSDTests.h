@@ -0,0 +1,28 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include "arch/Arch.h"
+#include "base/Log.h"
+
+#include <QObject>
+
+class ArchNetworkBSDTests : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void initTestCase();
+  void waitPollSet_wokenBeforeWait_returnsAtOnce();
+  void waitPollSet_wokenWhileWaiting_returnsAtOnce();
+  void waitPollSet_wokenTwice_wakesOnce();
+  void waitPollSet_readySocket_reportedUntilRemoved();
+
+private:
+  Arch m_arch;
+  Log m_log;
+};
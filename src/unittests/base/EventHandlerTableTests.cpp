@@ -0,0 +1,82 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "EventHandlerTableTests.h"
+
+#include "base/EventHandlerTable.h"
+
+#include <QTest>
+
+#include <array>
+#include <vector>
+
+namespace {
+
+EventHandlerTable::HandlerPtr makeHandler(int *called, int value)
+{
+  return std::make_shared<const IEventQueue::EventHandler>([called, value](const Event &) { *called = value; });
+}
+
+} // namespace
+
+void EventHandlerTableTests::find_empty_returnsNull()
+{
+  EventHandlerTable table;
+  int target = 0;
+
+  QVERIFY(table.find(EventTypes::ClientConnected, &target) == nullptr);
+}
+
+void EventHandlerTableTests::find_matchesTargetAndType()
+{
+  int called = 0;
+  int target1 = 0;
+  int target2 = 0;
+  EventHandlerTable table(
+      {{&target1, EventTypes::ClientConnected, makeHandler(&called, 1)},
+       {&target1, EventTypes::ClientDisconnected, makeHandler(&called, 2)},
+       {&target2, EventTypes::ClientConnected, makeHandler(&called, 3)}}
+  );
+
+  QCOMPARE(table.size(), static_cast<size_t>(3));
+
+  const auto *handler = table.find(EventTypes::ClientDisconnected, &target1);
+  QVERIFY(handler != nullptr);
+  (*handler)(Event());
+  QCOMPARE(called, 2);
+
+  handler = table.find(EventTypes::ClientConnected, &target2);
+  QVERIFY(handler != nullptr);
+  (*handler)(Event());
+  QCOMPARE(called, 3);
+
+  QVERIFY(table.find(EventTypes::ClientDisconnected, &target2) == nullptr);
+}
+
+void EventHandlerTableTests::find_manyEntries_findsEach()
+{
+  // adjacent targets collide in the low bits, which the hash must spread
+  std::array<int, 500> targets{};
+  int called = 0;
+
+  std::vector<EventHandlerTable::Entry> entries;
+  for (int i = 0; i < static_cast<int>(targets.size()); ++i) {
+    entries.push_back({&targets[i], EventTypes::ClientConnected, makeHandler(&called, i)});
+    entries.push_back({&targets[i], EventTypes::Unknown, makeHandler(&called, -i)});
+  }
+  EventHandlerTable table(std::move(entries));
+
+  for (int i = 0; i < static_cast<int>(targets.size()); ++i) {
+    const auto *handler = table.find(EventTypes::ClientConnected, &targets[i]);
+    QVERIFY(handler != nullptr);
+    (*handler)(Event());
+    QCOMPARE(called, i);
+
+    QVERIFY(table.find(EventTypes::ClientDisconnected, &targets[i]) == nullptr);
+  }
+}
+
+QTEST_MAIN(EventHandlerTableTests)
@@ -0,0 +1,19 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include <QObject>
+
+class EventHandlerTableTests : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void find_empty_returnsNull();
+  void find_matchesTargetAndType();
+  void find_manyEntries_findsEach();
+};
@@ -0,0 +1,90 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "EventQueueStatsTests.h"
+
+#include "base/EventQueueStats.h"
+
+#include <QTest>
+
+using namespace std::chrono_literals;
+
+void EventQueueStatsTests::isEnabled_default_isFalse()
+{
+  EventQueueStats stats;
+
+  QVERIFY(!stats.isEnabled());
+  stats.setEnabled(true);
+  QVERIFY(stats.isEnabled());
+}
+
+void EventQueueStatsTests::recordQueued_tracksMaxDepth()
+{
+  EventQueueStats stats;
+  stats.recordQueued(EventTypes::ClientConnected, 3);
+  stats.recordQueued(EventTypes::ClientConnected, 7);
+  stats.recordQueued(EventTypes::ClientConnected, 2);
+  stats.recordQueued(EventTypes::ClipboardChanged, 9);
+
+  const auto snapshot = stats.snapshot();
+  QCOMPARE(snapshot.size(), static_cast<size_t>(2));
+  QCOMPARE(snapshot[0].m_type, EventTypes::ClientConnected);
+  QCOMPARE(snapshot[0].m_queued, static_cast<uint64_t>(3));
+  QCOMPARE(snapshot[0].m_maxDepth, static_cast<size_t>(7));
+  QCOMPARE(snapshot[1].m_maxDepth, static_cast<size_t>(9));
+  QCOMPARE(stats.maxDepth(), static_cast<size_t>(9));
+}
+
+void EventQueueStatsTests::percentile_returnsBucketUpperBound()
+{
+  EventQueueStats stats;
+  for (int i = 0; i < 99; ++i) {
+    stats.recordDispatched(EventTypes::ClientConnected, 1000ns);
+  }
+  stats.recordDispatched(EventTypes::ClientConnected, 5ms);
+
+  const auto handlerTime = stats.snapshot().at(0).m_handlerTime;
+  QCOMPARE(handlerTime.m_count, static_cast<uint64_t>(100));
+  QCOMPARE(handlerTime.m_max, MonotonicClock::duration(5ms));
+
+  // 1000ns falls in the bucket below 1024ns
+  QCOMPARE(handlerTime.percentile(50.0), MonotonicClock::duration(1024));
+  QCOMPARE(handlerTime.percentile(99.0), MonotonicClock::duration(1024));
+
+  // the top bucket is capped at the largest duration seen
+  QCOMPARE(handlerTime.percentile(100.0), MonotonicClock::duration(5ms));
+}
+
+void EventQueueStatsTests::report_onlyListsSeenTypes()
+{
+  EventQueueStats stats;
+  QVERIFY(stats.report().empty());
+
+  stats.recordQueued(EventTypes::ClientConnected, 1);
+  stats.recordLatency(EventTypes::ClientConnected, 2us);
+  stats.recordDispatched(EventTypes::ClientConnected, 3us);
+  stats.recordUnhandled(EventTypes::ClipboardChanged);
+
+  const auto report = stats.report();
+  QCOMPARE(report.size(), static_cast<size_t>(2));
+  QVERIFY(report[0].starts_with("type 4: queued 1, dispatched 1, unhandled 0, max depth 1"));
+  QVERIFY(report[0].find("handler p50 ") != std::string::npos);
+  QVERIFY(report[1].ends_with("unhandled 1, max depth 0, wait -, handler -"));
+}
+
+void EventQueueStatsTests::reset_clearsCounters()
+{
+  EventQueueStats stats;
+  stats.recordQueued(EventTypes::ClientConnected, 4);
+  stats.recordDispatched(EventTypes::ClientConnected, 1ms);
+
+  stats.reset();
+
+  QVERIFY(stats.snapshot().empty());
+  QCOMPARE(stats.maxDepth(), static_cast<size_t>(0));
+}
+
+QTEST_MAIN(EventQueueStatsTests)
@@ -0,0 +1,21 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include <QObject>
+
+class EventQueueStatsTests : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void isEnabled_default_isFalse();
+  void recordQueued_tracksMaxDepth();
+  void percentile_returnsBucketUpperBound();
+  void report_onlyListsSeenTypes();
+  void reset_clearsCounters();
+};
@@ -7,10 +7,48 @@
 #include "EventQueueTests.h"
 
 #include "base/EventQueue.h"
+#include "deskflow/IPrimaryScreen.h"
 
 #include <QTest>
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
 #include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+std::atomic<bool> s_countAllocations = false;
+std::atomic<int> s_allocations = 0;
+
+} // namespace
+
+// count every allocation made by any thread while s_countAllocations is set
+void *operator new(std::size_t size)
+{
+  if (s_countAllocations) {
+    ++s_allocations;
+  }
+  if (void *p = std::malloc(size == 0 ? 1 : size); p != nullptr) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+  std::free(p);
+}
 
 void EventQueueTests::initTestCase()
 {
@@ -55,4 +93,371 @@ void EventQueueTests::dispatchEvent_handlerRemovesItself_keepsHandlerAliveUntilR
   QVERIFY(handlerLifetimeObserver.expired());
 }
 
+void EventQueueTests::event_inputData_storedInline()
+{
+  Event event(EventTypes::PrimaryScreenMotionOnPrimary, this, IPrimaryScreen::MotionInfo{10, 20});
+  Event moved = std::move(event);
+
+  QVERIFY(moved.hasInlineData());
+  const auto *info = static_cast<const IPrimaryScreen::MotionInfo *>(moved.getData());
+  QCOMPARE(info->m_x, 10);
+  QCOMPARE(info->m_y, 20);
+
+  // must not attempt to free the inline data
+  Event::deleteData(moved);
+}
+
+void EventQueueTests::loop_inputEvents_noHeapAllocations()
+{
+  struct Counters
+  {
+    std::atomic<int> handled = 0;
+    int32_t sum = 0;
+  } counters;
+
+  EventQueue events(EventQueue::DefaultBuffer::LockFree);
+  auto *c = &counters;
+  events.addHandler(EventTypes::PrimaryScreenMotionOnPrimary, this, [c](const Event &e) {
+    c->sum += static_cast<const IPrimaryScreen::MotionInfo *>(e.getData())->m_x;
+    ++c->handled;
+  });
+  events.addHandler(EventTypes::PrimaryScreenButtonDown, this, [c](const Event &e) {
+    c->sum += static_cast<const IPrimaryScreen::ButtonInfo *>(e.getData())->m_button;
+    ++c->handled;
+  });
+  events.addHandler(EventTypes::PrimaryScreenWheel, this, [c](const Event &e) {
+    c->sum += static_cast<const IPrimaryScreen::WheelInfo *>(e.getData())->m_yDelta;
+    ++c->handled;
+  });
+
+  std::thread loop([&events] { events.loop(); });
+  events.waitForReady();
+
+  auto sendAndWait = [this, &events, c](int count) {
+    const int target = c->handled + count * 3;
+    for (int i = 0; i < count; ++i) {
+      events.addEvent(Event(EventTypes::PrimaryScreenMotionOnPrimary, this, IPrimaryScreen::MotionInfo{1, 1}));
+      events.addEvent(Event(EventTypes::PrimaryScreenButtonDown, this, IPrimaryScreen::ButtonInfo{kButtonLeft, 0}));
+      events.addEvent(Event(EventTypes::PrimaryScreenWheel, this, IPrimaryScreen::WheelInfo{0, 1}));
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (c->handled < target && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::yield();
+    }
+  };
+
+  // warm up, bursts are kept below the initial slab capacity so it never
+  // has to grow
+  sendAndWait(50);
+
+  s_allocations = 0;
+  s_countAllocations = true;
+  for (int burst = 0; burst < 20; ++burst) {
+    sendAndWait(50);
+  }
+  s_countAllocations = false;
+
+  events.addEvent(Event(EventTypes::Quit));
+  loop.join();
+
+  QCOMPARE(counters.handled.load(), 3150);
+  QCOMPARE(counters.sum, 3150);
+  QCOMPARE(s_allocations.load(), 0);
+}
+
+void EventQueueTests::addHandler_whileDispatching_dispatchesAllEvents()
+{
+  EventQueue events(EventQueue::DefaultBuffer::LockFree);
+  std::atomic<int> handled = 0;
+  events.addHandler(EventTypes::ClientConnected, this, [&handled](const Event &) { ++handled; });
+
+  std::thread loop([&events] { events.loop(); });
+  events.waitForReady();
+
+  // churn handlers for other targets while the loop is dispatching
+  std::atomic<bool> stop = false;
+  std::thread registrar([&events, &stop] {
+    std::array<int, 64> targets{};
+    while (!stop) {
+      for (auto &target : targets) {
+        events.addHandler(EventTypes::ClientDisconnected, &target, [](const Event &) {});
+      }
+      for (auto &target : targets) {
+        events.removeHandlers(&target);
+      }
+    }
+  });
+
+  const int count = 10000;
+  for (int i = 0; i < count; ++i) {
+    events.addEvent(Event(EventTypes::ClientConnected, this));
+    if (i % 100 == 0) {
+      std::this_thread::yield();
+    }
+  }
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (handled < count && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::yield();
+  }
+  stop = true;
+  registrar.join();
+
+  events.addEvent(Event(EventTypes::Quit));
+  loop.join();
+
+  QCOMPARE(handled.load(), count);
+}
+
+void EventQueueTests::getEvent_timers_expireInDeadlineOrder()
+{
+  EventQueue events;
+  auto *timer1 = events.newOneShotTimer(0.03, nullptr);
+  auto *timer2 = events.newOneShotTimer(0.01, nullptr);
+  auto *timer3 = events.newOneShotTimer(0.02, nullptr);
+  auto *timer4 = events.newOneShotTimer(0.04, nullptr);
+  events.deleteTimer(timer3);
+
+  std::vector<void *> targets;
+  Event event;
+  while (events.getEvent(event, 1.0) && event.getType() == EventTypes::Timer) {
+    targets.push_back(event.getTarget());
+    if (targets.size() == 3) {
+      break;
+    }
+  }
+
+  QCOMPARE(targets, (std::vector<void *>{timer2, timer1, timer4}));
+
+  events.deleteTimer(timer1);
+  events.deleteTimer(timer2);
+  events.deleteTimer(timer4);
+}
+
+void EventQueueTests::resetTimer_beforeExpiry_pushesDeadlineBack()
+{
+  EventQueue events;
+  auto *timer = events.newOneShotTimer(0.2, nullptr);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(150));
+  events.resetTimer(timer);
+
+  // the original deadline passes without an event
+  Event event;
+  QVERIFY(!events.getEvent(event, 0.1));
+
+  QVERIFY(events.getEvent(event, 1.0));
+  QCOMPARE(event.getType(), EventTypes::Timer);
+  QCOMPARE(event.getTarget(), static_cast<void *>(timer));
+
+  events.deleteTimer(timer);
+}
+
+void EventQueueTests::resetTimer_expiredOneShot_rearms()
+{
+  EventQueue events;
+  auto *timer = events.newOneShotTimer(0.01, nullptr);
+
+  Event event;
+  QVERIFY(events.getEvent(event, 1.0));
+  QCOMPARE(event.getType(), EventTypes::Timer);
+  QVERIFY(!events.getEvent(event, 0.05));
+
+  events.resetTimer(timer);
+
+  QVERIFY(events.getEvent(event, 1.0));
+  QCOMPARE(event.getType(), EventTypes::Timer);
+  QCOMPARE(event.getTarget(), static_cast<void *>(timer));
+
+  events.deleteTimer(timer);
+}
+
+void EventQueueTests::stats_enabled_recordsQueuedAndDispatched()
+{
+  EventQueue events;
+  events.stats().setEnabled(true);
+  std::atomic<int> handled = 0;
+  events.addHandler(EventTypes::ClientConnected, this, [&handled](const Event &) { ++handled; });
+
+  std::thread loop([&events] { events.loop(); });
+  events.waitForReady();
+
+  const int count = 100;
+  for (int i = 0; i < count; ++i) {
+    events.addEvent(Event(EventTypes::ClientConnected, this));
+  }
+  events.addEvent(Event(EventTypes::ClientDisconnected, this));
+  events.addEvent(Event(EventTypes::Quit));
+  loop.join();
+
+  // the quit event is queued too but never dispatched
+  const auto snapshot = events.stats().snapshot();
+  QCOMPARE(snapshot.size(), static_cast<size_t>(3));
+  QCOMPARE(snapshot[0].m_type, EventTypes::Quit);
+  QCOMPARE(snapshot[0].m_queued, static_cast<uint64_t>(1));
+  QCOMPARE(snapshot[0].m_dispatched, static_cast<uint64_t>(0));
+  QCOMPARE(snapshot[1].m_type, EventTypes::ClientConnected);
+  QCOMPARE(snapshot[1].m_queued, static_cast<uint64_t>(count));
+  QCOMPARE(snapshot[1].m_dispatched, static_cast<uint64_t>(count));
+  QCOMPARE(snapshot[1].m_latency.m_count, static_cast<uint64_t>(count));
+  QCOMPARE(snapshot[1].m_handlerTime.m_count, static_cast<uint64_t>(count));
+  QVERIFY(snapshot[1].m_maxDepth >= 1);
+  QCOMPARE(snapshot[2].m_type, EventTypes::ClientDisconnected);
+  QCOMPARE(snapshot[2].m_unhandled, static_cast<uint64_t>(1));
+  QCOMPARE(handled.load(), count);
+}
+
+void EventQueueTests::stats_disabled_recordsNothing()
+{
+  EventQueue events;
+  events.addHandler(EventTypes::ClientConnected, this, [](const Event &) {});
+
+  std::thread loop([&events] { events.loop(); });
+  events.waitForReady();
+  events.addEvent(Event(EventTypes::ClientConnected, this));
+  events.addEvent(Event(EventTypes::Quit));
+  loop.join();
+
+  QVERIFY(events.stats().snapshot().empty());
+  QCOMPARE(events.stats().maxDepth(), static_cast<size_t>(0));
+}
+
+void EventQueueTests::loop_bulkEvents_dispatchedAfterInteractive()
+{
+  EventQueue events;
+  std::vector<EventTypes> order;
+  events.addHandler(EventTypes::ClientConnected, this, [&order](const Event &e) { order.push_back(e.getType()); });
+  events.addHandler(EventTypes::ClipboardSending, this, [this, &events, &order](const Event &e) {
+    order.push_back(e.getType());
+    if (order.size() == 6) {
+      events.addEvent(Event(EventTypes::Quit));
+    }
+  });
+
+  // queued before the loop starts so they all reach the queue together
+  for (int i = 0; i < 3; ++i) {
+    events.addEvent(Event(EventTypes::ClipboardSending, this));
+    events.addEvent(Event(EventTypes::ClientConnected, this));
+  }
+
+  std::thread loop([&events] { events.loop(); });
+  loop.join();
+
+  using enum EventTypes;
+  QCOMPARE(
+      order,
+      (std::vector<EventTypes>{
+          ClientConnected, ClientConnected, ClientConnected, ClipboardSending, ClipboardSending, ClipboardSending
+      })
+  );
+}
+
+void EventQueueTests::loop_steadyInteractive_bulkEventsNotStarved()
+{
+  using namespace std::chrono_literals;
+
+  EventQueue events;
+  const auto start = std::chrono::steady_clock::now();
+  const auto giveUp = start + 5s;
+  int interactive = 0;
+  std::chrono::steady_clock::duration bulkWaited{};
+
+  // each interactive event queues the next, so there's always one waiting
+  events.addHandler(EventTypes::ClientConnected, this, [&](const Event &) {
+    ++interactive;
+    if (std::chrono::steady_clock::now() < giveUp) {
+      events.addEvent(Event(EventTypes::ClientConnected, this));
+    } else {
+      events.addEvent(Event(EventTypes::Quit));
+    }
+  });
+  events.addHandler(EventTypes::ClipboardSending, this, [&](const Event &) {
+    bulkWaited = std::chrono::steady_clock::now() - start;
+    events.removeHandler(EventTypes::ClientConnected, this);
+    events.addEvent(Event(EventTypes::Quit));
+  });
+
+  events.addEvent(Event(EventTypes::ClientConnected, this));
+  events.addEvent(Event(EventTypes::ClipboardSending, this));
+
+  std::thread loop([&events] { events.loop(); });
+  loop.join();
+
+  QVERIFY(bulkWaited != std::chrono::steady_clock::duration{});
+  QVERIFY(bulkWaited >= EventQueue::kBulkMaxWait);
+  QVERIFY(interactive > 1);
+}
+
+void EventQueueTests::setBulkBudget_pacesBulkHandlers()
+{
+  using namespace std::chrono_literals;
+
+  EventQueue events;
+  events.setBulkBudget(1ms);
+  std::atomic<int> handled = 0;
+  events.addHandler(EventTypes::ClipboardSending, this, [&handled](const Event &) {
+    std::this_thread::sleep_for(2ms);
+    ++handled;
+  });
+
+  std::thread loop([&events] { events.loop(); });
+  events.waitForReady();
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 4; ++i) {
+    events.addEvent(Event(EventTypes::ClipboardSending, this));
+  }
+  const auto deadline = start + 10s;
+  while (handled < 4 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(1ms);
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+
+  events.addEvent(Event(EventTypes::Quit));
+  loop.join();
+
+  // each 2ms handler costs 20ms of a 1ms per 10ms budget, so the last
+  // three have to wait for the debt to be paid back
+  QCOMPARE(handled.load(), 4);
+  QVERIFY(elapsed >= 50ms);
+}
+
+void EventQueueTests::setCoalescer_mergesOnlyConsecutiveEvents()
+{
+  using MotionInfo = IPrimaryScreen::MotionInfo;
+  using enum EventTypes;
+
+  EventQueue events;
+  events.setCoalescer(PrimaryScreenMotionOnSecondary, [](Event &queued, const Event &next) {
+    auto *info = static_cast<MotionInfo *>(queued.getData());
+    info->m_x += static_cast<const MotionInfo *>(next.getData())->m_x;
+    return true;
+  });
+
+  int other = 0;
+  int buttons = 0;
+  std::vector<std::pair<void *, int32_t>> moves;
+  auto onMotion = [&moves](const Event &e) {
+    moves.emplace_back(e.getTarget(), static_cast<const MotionInfo *>(e.getData())->m_x);
+  };
+  events.addHandler(PrimaryScreenMotionOnSecondary, this, onMotion);
+  events.addHandler(PrimaryScreenMotionOnSecondary, &other, onMotion);
+  events.addHandler(PrimaryScreenButtonDown, this, [&buttons](const Event &) { ++buttons; });
+
+  // queued before the loop starts so none are taken while adding
+  events.addEvent(Event(PrimaryScreenMotionOnSecondary, this, MotionInfo{1, 0}));
+  events.addEvent(Event(PrimaryScreenMotionOnSecondary, this, MotionInfo{2, 0}));
+  events.addEvent(Event(PrimaryScreenButtonDown, this, IPrimaryScreen::ButtonInfo{kButtonLeft, 0}));
+  events.addEvent(Event(PrimaryScreenMotionOnSecondary, this, MotionInfo{4, 0}));
+  events.addEvent(Event(PrimaryScreenMotionOnSecondary, &other, MotionInfo{8, 0}));
+  events.addEvent(Event(PrimaryScreenMotionOnSecondary, &other, MotionInfo{16, 0}));
+  events.addEvent(Event(Quit));
+
+  std::thread loop([&events] { events.loop(); });
+  loop.join();
+
+  QCOMPARE(buttons, 1);
+  QCOMPARE(moves, (std::vector<std::pair<void *, int32_t>>{{this, 3}, {this, 4}, {&other, 24}}));
+}
+
 QTEST_MAIN(EventQueueTests)
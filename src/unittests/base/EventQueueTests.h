@@ -7,6 +7,7 @@
 #pragma once
 
 #include "arch/Arch.h"
+#include "base/Log.h"
 
 #include <QObject>
 
@@ -19,7 +20,20 @@ private Q_SLOTS:
   void dispatchEvent_noHandler_returnsFalse();
   void dispatchEvent_noTypeHandler_dispatchesUnknownHandler();
   void dispatchEvent_handlerRemovesItself_keepsHandlerAliveUntilReturn();
+  void event_inputData_storedInline();
+  void loop_inputEvents_noHeapAllocations();
+  void addHandler_whileDispatching_dispatchesAllEvents();
+  void getEvent_timers_expireInDeadlineOrder();
+  void resetTimer_beforeExpiry_pushesDeadlineBack();
+  void resetTimer_expiredOneShot_rearms();
+  void stats_enabled_recordsQueuedAndDispatched();
+  void stats_disabled_recordsNothing();
+  void loop_bulkEvents_dispatchedAfterInteractive();
+  void loop_steadyInteractive_bulkEventsNotStarved();
+  void setBulkBudget_pacesBulkHandlers();
+  void setCoalescer_mergesOnlyConsecutiveEvents();
 
 private:
   Arch m_arch;
+  Log m_log;
 };
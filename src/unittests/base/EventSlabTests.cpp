@@ -0,0 +1,73 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "EventSlabTests.h"
+
+#include "base/EventSlab.h"
+
+#include <QTest>
+
+#include <vector>
+
+void EventSlabTests::insert_remove_returnsSameEvent()
+{
+  EventSlab slab;
+  int target = 0;
+
+  const auto id = slab.insert(Event(EventTypes::ClientConnected, &target));
+  QCOMPARE(slab.size(), static_cast<size_t>(1));
+
+  const auto event = slab.remove(id);
+  QCOMPARE(event.getType(), EventTypes::ClientConnected);
+  QCOMPARE(event.getTarget(), static_cast<void *>(&target));
+  QVERIFY(slab.empty());
+}
+
+void EventSlabTests::remove_staleID_returnsUnknown()
+{
+  EventSlab slab;
+
+  const auto oldID = slab.insert(Event(EventTypes::ClientConnected));
+  slab.remove(oldID);
+
+  // the slot is reused with a new generation
+  const auto newID = slab.insert(Event(EventTypes::ClientDisconnected));
+  QVERIFY(oldID != newID);
+
+  QCOMPARE(slab.remove(oldID).getType(), EventTypes::Unknown);
+  QCOMPARE(slab.remove(newID).getType(), EventTypes::ClientDisconnected);
+}
+
+void EventSlabTests::insert_pastInitialCapacity_grows()
+{
+  EventSlab slab(4);
+  std::vector<uint32_t> ids;
+
+  for (int i = 0; i < 100; ++i) {
+    ids.push_back(slab.insert(Event(EventTypes::ClientConnected)));
+    QVERIFY(ids.back() != EventSlab::kInvalidID);
+  }
+  QCOMPARE(slab.size(), static_cast<size_t>(100));
+  QVERIFY(slab.capacity() >= 100);
+
+  for (auto id : ids) {
+    QCOMPARE(slab.remove(id).getType(), EventTypes::ClientConnected);
+  }
+  QVERIFY(slab.empty());
+}
+
+void EventSlabTests::clear_discardsEvents()
+{
+  EventSlab slab;
+
+  const auto id = slab.insert(Event(EventTypes::ClientConnected, nullptr, malloc(16)));
+  slab.clear();
+
+  QVERIFY(slab.empty());
+  QCOMPARE(slab.remove(id).getType(), EventTypes::Unknown);
+}
+
+QTEST_MAIN(EventSlabTests)
@@ -0,0 +1,20 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include <QObject>
+
+class EventSlabTests : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void insert_remove_returnsSameEvent();
+  void remove_staleID_returnsUnknown();
+  void insert_pastInitialCapacity_grows();
+  void clear_discardsEvents();
+};
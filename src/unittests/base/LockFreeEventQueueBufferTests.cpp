@@ -0,0 +1,169 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "LockFreeEventQueueBufferTests.h"
+
+#include "base/Event.h"
+#include "base/LockFreeEventQueueBuffer.h"
+
+#include <QTest>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using Type = IEventQueueBuffer::Type;
+
+void LockFreeEventQueueBufferTests::initTestCase()
+{
+  m_arch.init();
+}
+
+void LockFreeEventQueueBufferTests::getEvent_empty_returnsUnknown()
+{
+  LockFreeEventQueueBuffer buffer;
+  Event event;
+  uint32_t dataID = 0;
+
+  QVERIFY(buffer.isEmpty());
+  QCOMPARE(buffer.getEvent(event, dataID), Type::Unknown);
+}
+
+void LockFreeEventQueueBufferTests::addEvent_full_returnsFalse()
+{
+  LockFreeEventQueueBuffer buffer(4);
+  Event event;
+  uint32_t dataID = 0;
+
+  for (uint32_t i = 0; i < 4; ++i) {
+    QVERIFY(buffer.addEvent(i));
+  }
+  QVERIFY(!buffer.addEvent(4));
+
+  // draining one event frees a cell again
+  QCOMPARE(buffer.getEvent(event, dataID), Type::User);
+  QCOMPARE(dataID, 0u);
+  QVERIFY(buffer.addEvent(4));
+}
+
+void LockFreeEventQueueBufferTests::getEvent_singleProducer_preservesOrder()
+{
+  LockFreeEventQueueBuffer buffer(8);
+  Event event;
+  uint32_t dataID = 0;
+
+  // go around the ring several times
+  for (uint32_t i = 0; i < 100; ++i) {
+    QVERIFY(buffer.addEvent(i));
+    QVERIFY(!buffer.isEmpty());
+    QCOMPARE(buffer.getEvent(event, dataID), Type::User);
+    QCOMPARE(dataID, i);
+  }
+  QVERIFY(buffer.isEmpty());
+}
+
+void LockFreeEventQueueBufferTests::waitForEvent_timeout_returns()
+{
+  LockFreeEventQueueBuffer buffer;
+
+  buffer.waitForEvent(0.01);
+
+  QVERIFY(buffer.isEmpty());
+}
+
+void LockFreeEventQueueBufferTests::waitForEvent_parked_wokenByProducer()
+{
+  LockFreeEventQueueBuffer buffer;
+
+  std::thread producer([&buffer] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    buffer.addEvent(42);
+  });
+
+  // a 10 second timeout would fail the test if the wakeup is lost
+  const auto start = std::chrono::steady_clock::now();
+  while (buffer.isEmpty() && std::chrono::steady_clock::now() - start < std::chrono::seconds(10)) {
+    buffer.waitForEvent(10.0);
+  }
+  producer.join();
+
+  Event event;
+  uint32_t dataID = 0;
+  QCOMPARE(buffer.getEvent(event, dataID), Type::User);
+  QCOMPARE(dataID, 42u);
+}
+
+void LockFreeEventQueueBufferTests::waitForEvent_parked_cancelled()
+{
+  LockFreeEventQueueBuffer buffer;
+
+  auto consume = [](void *arg) -> void * {
+    auto *parked = static_cast<LockFreeEventQueueBuffer *>(arg);
+    while (true) {
+      parked->waitForEvent(10.0);
+    }
+  };
+  ArchThread consumer = ARCH->newThread(consume, &buffer);
+
+  // a cancel must end the wait rather than wait for an event or the timeout
+  ARCH->sleep(0.05);
+  ARCH->cancelThread(consumer);
+  QVERIFY(ARCH->wait(consumer, 5.0));
+  ARCH->closeThread(consumer);
+}
+
+void LockFreeEventQueueBufferTests::stress_manyProducers_noEventsLostAndOrdered()
+{
+  // the data id encodes the producer in the top byte and a per-producer
+  // sequence number in the rest so the consumer can check ordering
+  const uint32_t producerCount = 4;
+  const uint32_t eventsPerProducer = 100000;
+  LockFreeEventQueueBuffer buffer(256);
+
+  std::atomic<bool> go = false;
+  std::vector<std::thread> producers;
+  for (uint32_t p = 0; p < producerCount; ++p) {
+    producers.emplace_back([&buffer, &go, p] {
+      while (!go) {
+        std::this_thread::yield();
+      }
+      for (uint32_t i = 0; i < eventsPerProducer; ++i) {
+        while (!buffer.addEvent((p << 24) | i)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  std::vector<uint32_t> nextExpected(producerCount, 0);
+  uint32_t received = 0;
+  bool ordered = true;
+  Event event;
+  go = true;
+  while (received < producerCount * eventsPerProducer) {
+    buffer.waitForEvent(1.0);
+    uint32_t dataID;
+    while (buffer.getEvent(event, dataID) == Type::User) {
+      const uint32_t producer = dataID >> 24;
+      const uint32_t sequence = dataID & 0xffffff;
+      ordered = ordered && producer < producerCount && nextExpected[producer] == sequence;
+      if (producer < producerCount) {
+        nextExpected[producer] = sequence + 1;
+      }
+      ++received;
+    }
+  }
+
+  for (auto &producer : producers) {
+    producer.join();
+  }
+
+  QVERIFY(ordered);
+  QCOMPARE(received, producerCount * eventsPerProducer);
+  QVERIFY(buffer.isEmpty());
+}
+
+QTEST_MAIN(LockFreeEventQueueBufferTests)
@@ -0,0 +1,29 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include "arch/Arch.h"
+
+#include <QObject>
+
+class LockFreeEventQueueBufferTests : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void initTestCase();
+  void getEvent_empty_returnsUnknown();
+  void addEvent_full_returnsFalse();
+  void getEvent_singleProducer_preservesOrder();
+  void waitForEvent_timeout_returns();
+  void waitForEvent_parked_wokenByProducer();
+  void waitForEvent_parked_cancelled();
+  void stress_manyProducers_noEventsLostAndOrdered();
+
+private:
+  Arch m_arch;
+};
@@ -0,0 +1,59 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "StopwatchTests.h"
+
+#include "base/Stopwatch.h"
+
+#include <QTest>
+
+#include <thread>
+
+using namespace std::chrono_literals;
+
+void StopwatchTests::monotonicClock_convertsSeconds()
+{
+  QCOMPARE(MonotonicClock::fromSeconds(1.5), MonotonicClock::duration(1'500'000'000));
+  QCOMPARE(MonotonicClock::fromSeconds(-0.25), MonotonicClock::duration(-250'000'000));
+  QCOMPARE(MonotonicClock::toSeconds(250ms), 0.25);
+
+  // rounds to the nearest tick rather than truncating
+  QCOMPARE(MonotonicClock::fromSeconds(0.001), MonotonicClock::duration(1'000'000));
+}
+
+void StopwatchTests::getElapsed_running_advances()
+{
+  Stopwatch stopwatch;
+  std::this_thread::sleep_for(5ms);
+
+  const auto elapsed = stopwatch.getElapsed();
+  QVERIFY(elapsed >= 5ms);
+  QVERIFY(stopwatch.getElapsed() >= elapsed);
+  QVERIFY(stopwatch.getTime() >= 0.005);
+}
+
+void StopwatchTests::getElapsed_stopped_isFrozen()
+{
+  Stopwatch stopwatch;
+  std::this_thread::sleep_for(1ms);
+  stopwatch.stop();
+
+  const auto elapsed = stopwatch.getElapsed();
+  std::this_thread::sleep_for(5ms);
+  QCOMPARE(stopwatch.getElapsed(), elapsed);
+}
+
+void StopwatchTests::getElapsed_triggered_startsClock()
+{
+  Stopwatch stopwatch(true);
+  std::this_thread::sleep_for(5ms);
+
+  // the first call starts the clock and returns zero
+  QCOMPARE(stopwatch.getElapsed(), MonotonicClock::duration::zero());
+  QVERIFY(!stopwatch.isStopped());
+}
+
+QTEST_MAIN(StopwatchTests)
@@ -0,0 +1,20 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include <QObject>
+
+class StopwatchTests : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void monotonicClock_convertsSeconds();
+  void getElapsed_running_advances();
+  void getElapsed_stopped_isFrozen();
+  void getElapsed_triggered_startsClock();
+};
@@ -179,6 +179,14 @@ public:
   {
   }
 
+  void resetTimer(EventQueueTimer *) override
+  {
+  }
+
+  void setCoalescer(EventTypes, const EventCoalescer &) override
+  {
+  }
+
   void addHandler(EventTypes type, void *target, const EventHandler &handler) override
   {
     m_handlers[HandlerKey{type, target}] = handler;
@@ -0,0 +1,138 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "InputLatencyTests.h"
+
+#include "deskflow/InputLatency.h"
+
+#include <QTest>
+
+#include <chrono>
+
+using deskflow::InputLatency;
+using enum ConnectionStats::LatencyPart;
+using namespace std::chrono_literals;
+
+namespace {
+
+const auto s_read = MonotonicClock::time_point(20s);
+
+// a sample with a 100ms round trip putting the server 4s ahead
+void addSample(InputLatency &latency)
+{
+  latency.addClockSample(1000, 5050, 1100);
+}
+
+uint64_t count(const ConnectionStats &stats, ConnectionStats::LatencyPart part, size_t bucket)
+{
+  return stats.snapshot().m_latency[static_cast<size_t>(part)][bucket];
+}
+
+} // namespace
+
+void InputLatencyTests::addClockSample_shortestRoundTrip_used()
+{
+  InputLatency latency;
+  QVERIFY(!latency.hasClockOffset());
+
+  addSample(latency);
+  QVERIFY(latency.hasClockOffset());
+  QCOMPARE(latency.getClockOffset(), 4000);
+  QCOMPARE(latency.getClockRtt(), uint32_t{100});
+
+  latency.addClockSample(2000, 6012, 2020);
+  latency.addClockSample(3000, 7500, 3200);
+  QCOMPARE(latency.getClockOffset(), 4002);
+  QCOMPARE(latency.getClockRtt(), uint32_t{20});
+}
+
+void InputLatencyTests::addClockSample_wrappedClock_offsetKept()
+{
+  InputLatency latency;
+
+  latency.addClockSample(0xffffffc0, 10, 0x20);
+
+  QCOMPARE(latency.getClockRtt(), uint32_t{0x60});
+  QCOMPARE(latency.getClockOffset(), 26);
+}
+
+void InputLatencyTests::addClockSample_afterWindow_followsDrift()
+{
+  InputLatency latency;
+  latency.addClockSample(1000, 5005, 1010);
+  for (int i = 1; i < InputLatency::kClockWindow; ++i) {
+    latency.addClockSample(2000, 6125, 2050);
+  }
+  QCOMPARE(latency.getClockOffset(), 4000);
+
+  for (int i = 0; i < InputLatency::kClockWindow; ++i) {
+    latency.addClockSample(2000, 6125, 2050);
+  }
+  QCOMPARE(latency.getClockOffset(), 4100);
+  QCOMPARE(latency.getClockRtt(), uint32_t{50});
+}
+
+void InputLatencyTests::record_noClockOffset_ignored()
+{
+  InputLatency latency;
+  ConnectionStats stats;
+
+  latency.record(24000, s_read, s_read, s_read + 1ms, &stats);
+
+  QVERIFY(latency.takeReport().empty());
+  QCOMPARE(count(stats, Injection, 10), uint64_t{0});
+}
+
+void InputLatencyTests::record_injectedEvent_splitIntoParts()
+{
+  InputLatency latency;
+  ConnectionStats stats;
+  addSample(latency);
+
+  // captured 3ms before the read on the client's clock
+  latency.record(23997, s_read, s_read + 100us, s_read + 5100us, &stats);
+
+  QCOMPARE(count(stats, Network, ConnectionStats::latencyBucket(3ms)), uint64_t{1});
+  QCOMPARE(count(stats, Queue, ConnectionStats::latencyBucket(100us)), uint64_t{1});
+  QCOMPARE(count(stats, Injection, ConnectionStats::latencyBucket(5ms)), uint64_t{1});
+
+  // apparently captured after it was read, which the offset's error allows
+  latency.record(24010, s_read, s_read, s_read, nullptr);
+
+  const auto report = latency.takeReport();
+  QCOMPARE(report.size(), InputLatency::kReportSize);
+  QCOMPARE(report[ConnectionStats::latencyBucket(3ms)], uint32_t{1});
+  QCOMPARE(report[0], uint32_t{1});
+  QCOMPARE(report[ConnectionStats::kLatencyBuckets], uint32_t{1});
+  QCOMPARE(report[ConnectionStats::kLatencyBuckets + ConnectionStats::latencyBucket(100us)], uint32_t{1});
+  QVERIFY(latency.takeReport().empty());
+}
+
+void InputLatencyTests::addReport_takenReport_addsToStats()
+{
+  InputLatency latency;
+  ConnectionStats client;
+  ConnectionStats server;
+  addSample(latency);
+  latency.record(23990, s_read, s_read + 2ms, s_read + 3ms, &client);
+  latency.record(23999, s_read, s_read + 1ms, s_read + 4ms, &client);
+
+  QVERIFY(InputLatency::addReport(latency.takeReport(), &server));
+
+  QCOMPARE(server.snapshot().m_latency, client.snapshot().m_latency);
+}
+
+void InputLatencyTests::addReport_wrongSize_fails()
+{
+  ConnectionStats stats;
+
+  QVERIFY(!InputLatency::addReport(std::vector<uint32_t>(InputLatency::kReportSize + 1, 1), &stats));
+  QVERIFY(!InputLatency::addReport({}, nullptr));
+  QVERIFY(InputLatency::addReport(std::vector<uint32_t>(InputLatency::kReportSize), nullptr));
+  QCOMPARE(count(stats, Network, 0), uint64_t{0});
+}
+
+QTEST_MAIN(InputLatencyTests)
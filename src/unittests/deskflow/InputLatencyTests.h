@@ -0,0 +1,23 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include <QObject>
+
+class InputLatencyTests : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void addClockSample_shortestRoundTrip_used();
+  void addClockSample_wrappedClock_offsetKept();
+  void addClockSample_afterWindow_followsDrift();
+  void record_noClockOffset_ignored();
+  void record_injectedEvent_splitIntoParts();
+  void addReport_takenReport_addsToStats();
+  void addReport_wrongSize_fails();
+};
@@ -0,0 +1,147 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "InputRecordsTests.h"
+
+#include "deskflow/InputRecords.h"
+
+#include <QTest>
+
+using deskflow::InputRecords;
+using Record = InputRecords::Record;
+using enum Record::Type;
+
+namespace {
+
+Record makeRecord(Record::Type type, uint32_t time, int32_t x = 0, int32_t y = 0)
+{
+  Record record;
+  record.m_type = type;
+  record.m_time = time;
+  record.m_x = x;
+  record.m_y = y;
+  return record;
+}
+
+Record makeKey(Record::Type type, uint32_t time, uint32_t id, const std::string &language)
+{
+  Record record = makeRecord(type, time);
+  record.m_id = id;
+  record.m_mask = 0x2002;
+  record.m_button = 0xfff0;
+  record.m_count = type == KeyRepeat ? 300 : 0;
+  record.m_language = type == KeyUp ? "" : language;
+  return record;
+}
+
+bool sameRecord(const Record &a, const Record &b)
+{
+  return a.m_type == b.m_type && a.m_time == b.m_time && a.m_x == b.m_x && a.m_y == b.m_y && a.m_id == b.m_id &&
+         a.m_mask == b.m_mask && a.m_count == b.m_count && a.m_button == b.m_button && a.m_language == b.m_language;
+}
+
+} // namespace
+
+void InputRecordsTests::decode_everyType_roundTrips()
+{
+  Record down = makeRecord(MouseDown, 0xfffffff0U);
+  down.m_id = 3;
+  Record up = makeRecord(MouseUp, 0x00000010U);
+  up.m_id = 3;
+  const std::vector<Record> records = {
+      makeRecord(MouseMove, 0xffffffe0U, 1920, -1080),
+      makeRecord(MouseMove, 0xffffffe8U, -32768, 32767),
+      makeRecord(MouseMove, 0xffffffe8U, INT32_MIN, INT32_MAX),
+      makeRecord(MouseRelativeMove, 0xffffffeaU, -1, 70000),
+      makeRecord(MouseWheel, 0xffffffebU, 0, -120),
+      down,
+      up,
+      makeKey(KeyDown, 0x00000020U, 0xef61, "en"),
+      makeKey(KeyRepeat, 0x00000030U, 0x10ffff, "de"),
+      makeKey(KeyUp, 0x00000040U, 0xef61, ""),
+  };
+  InputRecords batch;
+  for (const auto &record : records) {
+    batch.add(record);
+  }
+
+  std::vector<Record> decoded;
+  QVERIFY(InputRecords::decode(batch.getBase(), batch.getRecords(), decoded));
+
+  QCOMPARE(batch.getCount(), records.size());
+  QCOMPARE(decoded.size(), records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    QVERIFY(sameRecord(decoded[i], records[i]));
+  }
+}
+
+void InputRecordsTests::add_smallMotion_isCompact()
+{
+  InputRecords batch;
+  batch.add(makeRecord(MouseMove, 1000, 50, 60));
+  const size_t first = batch.getRecords().size();
+
+  for (int i = 1; i <= 10; ++i) {
+    batch.add(makeRecord(MouseMove, 1000 + i, 50 + i * 3, 60 - i * 2));
+  }
+
+  // type, time, x and y in one byte each
+  QCOMPARE(batch.getRecords().size() - first, size_t{40});
+  QCOMPARE(batch.getBase(), uint32_t{1000});
+}
+
+void InputRecordsTests::clear_startsNewBatch()
+{
+  InputRecords batch;
+  batch.add(makeRecord(MouseMove, 5, 100, 100));
+  batch.clear();
+  QVERIFY(batch.empty());
+
+  batch.add(makeRecord(MouseMove, 9, 100, 100));
+
+  std::vector<Record> decoded;
+  QVERIFY(InputRecords::decode(batch.getBase(), batch.getRecords(), decoded));
+  QCOMPARE(decoded.size(), size_t{1});
+  QVERIFY(sameRecord(decoded[0], makeRecord(MouseMove, 9, 100, 100)));
+}
+
+void InputRecordsTests::decode_truncated_fails()
+{
+  InputRecords batch;
+  batch.add(makeRecord(MouseMove, 0, 1000, 1000));
+  batch.add(makeKey(KeyDown, 0, 0x61, "en"));
+  const std::string &records = batch.getRecords();
+
+  std::vector<Record> decoded;
+  for (size_t n = 1; n < records.size(); ++n) {
+    const bool atBoundary = n == 6; // the whole of the first record
+    QCOMPARE(InputRecords::decode(0, std::string_view(records).substr(0, n), decoded), atBoundary);
+  }
+}
+
+void InputRecordsTests::decode_unknownType_fails()
+{
+  std::vector<Record> decoded;
+
+  QVERIFY(!InputRecords::decode(0, std::string("\x00\x00", 2), decoded));
+  QVERIFY(!InputRecords::decode(0, std::string("\x7f\x00\x01\x01", 4), decoded));
+}
+
+void InputRecordsTests::isMotionOnly_batches_onlyAbsoluteMotion()
+{
+  InputRecords batch;
+  batch.add(makeRecord(MouseMove, 100, 10, 20));
+  batch.add(makeRecord(MouseMove, 101, 11, 21));
+  QVERIFY(InputRecords::isMotionOnly(batch.getRecords()));
+
+  batch.add(makeRecord(MouseWheel, 102, 0, 120));
+  QVERIFY(!InputRecords::isMotionOnly(batch.getRecords()));
+
+  QVERIFY(!InputRecords::isMotionOnly(""));
+  QVERIFY(!InputRecords::isMotionOnly(std::string("\x01\x00\x02", 3)));
+}
+
+QTEST_MAIN(InputRecordsTests)
@@ -0,0 +1,22 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include <QObject>
+
+class InputRecordsTests : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void decode_everyType_roundTrips();
+  void add_smallMotion_isCompact();
+  void clear_startsNewBatch();
+  void decode_truncated_fails();
+  void decode_unknownType_fails();
+  void isMotionOnly_batches_onlyAbsoluteMotion();
+};
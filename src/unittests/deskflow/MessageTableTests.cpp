@@ -0,0 +1,116 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "MessageTableTests.h"
+
+#include "deskflow/MessageTable.h"
+#include "deskflow/ProtocolTypes.h"
+
+#include <QTest>
+
+using deskflow::MessageTable;
+
+namespace {
+
+const uint8_t *bytes(const char *code)
+{
+  return reinterpret_cast<const uint8_t *>(code);
+}
+
+} // namespace
+
+void MessageTableTests::messageCode_bigEndian()
+{
+  static_assert(deskflow::messageCode("DMMV") == 0x444d4d56);
+  static_assert(deskflow::messageCode("CALV") < deskflow::messageCode("DMMV"));
+
+  QCOMPARE(deskflow::messageCode(bytes("\xff\x00\x01\x02")), uint32_t{0xff000102});
+}
+
+void MessageTableTests::add_unordered_keptSorted()
+{
+  MessageTable<int> table;
+
+  table.add(kMsgDMouseMove, 1);
+  table.add(kMsgCKeepAlive, 2);
+  table.add(kMsgDKeyDown, 3);
+
+  const auto &entries = table.getEntries();
+  QCOMPARE(entries.size(), size_t{3});
+  QCOMPARE(entries[0].m_code, deskflow::messageCode("CALV"));
+  QCOMPARE(entries[1].m_code, deskflow::messageCode("DKDN"));
+  QCOMPARE(entries[2].m_code, deskflow::messageCode("DMMV"));
+  QCOMPARE(*table.find(bytes("DMMV")), 1);
+  QCOMPARE(*table.find(bytes("CALV")), 2);
+  QCOMPARE(*table.find(bytes("DKDN")), 3);
+}
+
+void MessageTableTests::add_existingCode_replacesHandler()
+{
+  MessageTable<int> table;
+  table.add(kMsgCKeepAlive, 1);
+
+  table.add(kMsgCKeepAlive, 2);
+
+  QCOMPARE(table.getEntries().size(), size_t{1});
+  QCOMPARE(*table.find(bytes("CALV")), 2);
+}
+
+void MessageTableTests::find_unknownCode_returnsNull()
+{
+  MessageTable<int> table;
+  QVERIFY(table.empty());
+  QVERIFY(table.find(bytes("DMMV")) == nullptr);
+
+  table.add(kMsgDMouseMove, 1);
+
+  QVERIFY(!table.empty());
+  QVERIFY(table.find(bytes("DMRM")) == nullptr);
+  QVERIFY(table.find(bytes("ZZZZ")) == nullptr);
+}
+
+void MessageTableTests::report_counts_busiestFirst()
+{
+  MessageTable<int> table;
+  table.add(kMsgDMouseMove, 1);
+  table.add(kMsgDKeyDown, 2);
+  table.add(kMsgCNoop, 3);
+
+  for (int i = 0; i < 3; ++i) {
+    table.find(bytes("DMMV"));
+  }
+  table.find(bytes("DKDN"));
+
+  QCOMPARE(table.report(), std::string("DMMV 3, DKDN 1"));
+}
+
+void MessageTableTests::messageCounts_receivedAndSent_mergedByCode()
+{
+  MessageTable<int> table;
+  table.add(kMsgDMouseMove, 1);
+  table.add(kMsgCKeepAlive, 2);
+
+  table.find(bytes("DMMV"));
+  table.find(bytes("CALV"));
+  table.countSent("CALV");
+  table.countSent("QINF");
+  table.countSent("QINF");
+
+  const auto counts = table.messageCounts();
+  QCOMPARE(counts.size(), size_t{3});
+  QCOMPARE(std::string(counts[0].m_code.data(), 4), std::string("CALV"));
+  QCOMPARE(counts[0].m_in, uint64_t{1});
+  QCOMPARE(counts[0].m_out, uint64_t{1});
+  QCOMPARE(std::string(counts[1].m_code.data(), 4), std::string("DMMV"));
+  QCOMPARE(counts[1].m_in, uint64_t{1});
+  QCOMPARE(counts[1].m_out, uint64_t{0});
+  QCOMPARE(std::string(counts[2].m_code.data(), 4), std::string("QINF"));
+  QCOMPARE(counts[2].m_in, uint64_t{0});
+  QCOMPARE(counts[2].m_out, uint64_t{2});
+  QCOMPARE(table.getEntries().size(), size_t{2});
+}
+
+QTEST_MAIN(MessageTableTests)
@@ -0,0 +1,22 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include <QObject>
+
+class MessageTableTests : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void messageCode_bigEndian();
+  void add_unordered_keptSorted();
+  void add_existingCode_replacesHandler();
+  void find_unknownCode_returnsNull();
+  void report_counts_busiestFirst();
+  void messageCounts_receivedAndSent_mergedByCode();
+};
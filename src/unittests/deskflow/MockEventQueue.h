@@ -73,6 +73,16 @@ public:
     // do nothing
   }
 
+  void resetTimer(EventQueueTimer *) override
+  {
+    // do nothing
+  }
+
+  void setCoalescer(EventTypes, const EventCoalescer &) override
+  {
+    // do nothing
+  }
+
   void waitForReady() const override
   {
     // do nothing
@@ -0,0 +1,515 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "PacketStreamFilterTests.h"
+
+#include "MockEventQueue.h"
+#include "deskflow/InputRecords.h"
+#include "deskflow/MessageTable.h"
+#include "deskflow/PacketStreamFilter.h"
+#include "io/ConnectionStats.h"
+
+#include <QTest>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+//! Records each write or gathered write as one call, and reads its input
+class RecordingStream : public deskflow::IStream
+{
+public:
+  void close() override
+  {
+  }
+
+  uint32_t read(void *buffer, uint32_t n) override
+  {
+    n = std::min(n, static_cast<uint32_t>(m_input.size()));
+    memcpy(buffer, m_input.data(), n);
+    m_input.erase(0, n);
+    return n;
+  }
+
+  void write(const void *buffer, uint32_t n) override
+  {
+    m_calls.emplace_back(static_cast<const char *>(buffer), n);
+  }
+
+  void writev(const std::span<const uint8_t> buffers[], size_t count) override
+  {
+    std::string call;
+    for (size_t i = 0; i < count; ++i) {
+      call.append(reinterpret_cast<const char *>(buffers[i].data()), buffers[i].size());
+    }
+    m_calls.push_back(call);
+  }
+
+  void flush() override
+  {
+  }
+
+  void shutdownInput() override
+  {
+  }
+
+  void shutdownOutput() override
+  {
+  }
+
+  void *getEventTarget() const override
+  {
+    return const_cast<RecordingStream *>(this);
+  }
+
+  bool isReady() const override
+  {
+    return false;
+  }
+
+  uint32_t getSize() const override
+  {
+    return 0;
+  }
+
+  uint32_t getOutputSize() const override
+  {
+    return m_outputSize;
+  }
+
+  ConnectionStats *getConnectionStats() override
+  {
+    return &m_stats;
+  }
+
+  std::vector<std::string> m_calls;
+  std::string m_input;
+  uint32_t m_outputSize = 0;
+  ConnectionStats m_stats;
+};
+
+//! Keeps the stream's event handler, so input can be signalled
+class HandlerEventQueue : public MockEventQueue
+{
+public:
+  void addHandler(EventTypes, void *, const EventHandler &handler) override
+  {
+    m_handler = handler;
+  }
+
+  void addEvent(Event &&event) override
+  {
+    m_added.push_back(event.getType());
+  }
+
+  EventHandler m_handler;
+  std::vector<EventTypes> m_added;
+};
+
+std::span<const uint8_t> spanOf(const std::string &s)
+{
+  return {reinterpret_cast<const uint8_t *>(s.data()), s.size()};
+}
+
+// an input batch message holding the given events
+std::string inputBatch(const std::vector<deskflow::InputRecords::Record> &records)
+{
+  deskflow::InputRecords batch;
+  for (const auto &record : records) {
+    batch.add(record);
+  }
+
+  std::string message("DINB");
+  for (const auto value : {batch.getBase(), static_cast<uint32_t>(batch.getRecords().size())}) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+      message += static_cast<char>(value >> shift);
+    }
+  }
+  return message + batch.getRecords();
+}
+
+deskflow::InputRecords::Record inputRecord(deskflow::InputRecords::Record::Type type, int32_t x, int32_t y)
+{
+  deskflow::InputRecords::Record record;
+  record.m_type = type;
+  record.m_x = x;
+  record.m_y = y;
+  return record;
+}
+
+// the bytes a single write of message is framed as
+std::string packet(const std::string &message)
+{
+  std::string framed(4, '\0');
+  for (int i = 0; i < 4; ++i) {
+    framed[i] = static_cast<char>(message.size() >> (24 - 8 * i));
+  }
+  return framed + message;
+}
+
+// synthetic clipboard contents, roughly as compressible as prose
+std::string makeText(size_t size)
+{
+  static const char *const s_words[] = {"the",   "screen", "of",     "keyboard", "and",   "mouse", "a",
+                                        "share", "to",     "client", "server",   "with",  "is",    "on",
+                                        "from",  "copy",   "paste",  "network",  "in",    "that",  "text"};
+  std::mt19937 random(20261018);
+  std::string text;
+  while (text.size() < size) {
+    text += s_words[random() % std::size(s_words)];
+    text += random() % 12 == 0 ? ".\n" : " ";
+  }
+  text.resize(size);
+  return text;
+}
+
+std::string makeHtml(size_t size)
+{
+  std::string html;
+  const std::string text = makeText(size);
+  for (size_t i = 0; html.size() < size; i += 60) {
+    html += "<p class=\"MsoNormal\" style=\"margin:0\"><span lang=\"EN-GB\">";
+    html += text.substr(i % size, 60);
+    html += "</span></p>\n";
+  }
+  html.resize(size);
+  return html;
+}
+
+std::string makeBinary(size_t size)
+{
+  std::mt19937 random(20261018);
+  std::string data(size, '\0');
+  for (auto &c : data) {
+    c = static_cast<char>(random());
+  }
+  return data;
+}
+
+} // namespace
+
+void PacketStreamFilterTests::write_payload_framedInOneWrite()
+{
+  MockEventQueue events;
+  RecordingStream stream;
+  PacketStreamFilter filter(&events, &stream, false);
+
+  filter.write("DMMV", 4);
+
+  QCOMPARE(stream.m_calls.size(), size_t{1});
+  QCOMPARE(stream.m_calls[0], std::string("\0\0\0\4DMMV", 8));
+}
+
+void PacketStreamFilterTests::writev_buffers_framedAsOnePacket()
+{
+  MockEventQueue events;
+  RecordingStream stream;
+  PacketStreamFilter filter(&events, &stream, false);
+
+  const std::string head = "DCLP";
+  const std::string body = "clipboard";
+  const std::span<const uint8_t> buffers[] = {spanOf(head), spanOf(body)};
+  filter.writev(buffers, 2);
+
+  QCOMPARE(stream.m_calls.size(), size_t{1});
+  QCOMPARE(stream.m_calls[0], std::string("\0\0\0\x0d", 4) + head + body);
+}
+
+void PacketStreamFilterTests::writev_manyBuffers_framedAsOnePacket()
+{
+  MockEventQueue events;
+  RecordingStream stream;
+  PacketStreamFilter filter(&events, &stream, false);
+
+  // more pieces than the filter gathers without copying
+  const std::vector<std::string> pieces(20, "ab");
+  std::vector<std::span<const uint8_t>> buffers;
+  for (const auto &piece : pieces) {
+    buffers.push_back(spanOf(piece));
+  }
+  filter.writev(buffers.data(), buffers.size());
+
+  QCOMPARE(stream.m_calls.size(), size_t{1});
+  QCOMPARE(stream.m_calls[0].size(), size_t{44});
+  QCOMPARE(stream.m_calls[0].substr(0, 4), std::string("\0\0\0\x28", 4));
+}
+
+void PacketStreamFilterTests::write_motionWhileBackedUp_latestKept()
+{
+  MockEventQueue events;
+  RecordingStream stream;
+  PacketStreamFilter filter(&events, &stream, false);
+  filter.setMotionLimit(100);
+  stream.m_outputSize = 101;
+
+  filter.write("DMMV\0\1\0\1", 8);
+  filter.write("DMMV\0\2\0\2", 8);
+  filter.write("DMMV\0\3\0\3", 8);
+  QCOMPARE(stream.m_calls.size(), size_t{0});
+
+  // turning the limit off sends what's held
+  filter.setMotionLimit(0);
+
+  QCOMPARE(stream.m_calls.size(), size_t{1});
+  QCOMPARE(stream.m_calls[0], std::string("\0\0\0\x08" "DMMV\0\3\0\3", 12));
+  QCOMPARE(filter.getOutputStats().m_motionCoalesced, uint64_t{2});
+}
+
+void PacketStreamFilterTests::write_keyWhileMotionHeld_motionSentFirst()
+{
+  MockEventQueue events;
+  RecordingStream stream;
+  PacketStreamFilter filter(&events, &stream, false);
+  filter.setMotionLimit(100);
+  stream.m_outputSize = 101;
+
+  filter.write("DMMV\0\1\0\1", 8);
+  filter.write("DKDN", 4);
+
+  QCOMPARE(stream.m_calls.size(), size_t{2});
+  QCOMPARE(stream.m_calls[0], std::string("\0\0\0\x08" "DMMV\0\1\0\1", 12));
+  QCOMPARE(stream.m_calls[1], std::string("\0\0\0\4DKDN", 8));
+  QCOMPARE(filter.getOutputStats().m_motionCoalesced, uint64_t{0});
+}
+
+void PacketStreamFilterTests::write_motionBatchWhileBackedUp_latestKept()
+{
+  using enum deskflow::InputRecords::Record::Type;
+  MockEventQueue events;
+  RecordingStream stream;
+  PacketStreamFilter filter(&events, &stream, false);
+  filter.setMotionLimit(100);
+  stream.m_outputSize = 101;
+
+  const auto first = inputBatch({inputRecord(MouseMove, 1, 1), inputRecord(MouseMove, 2, 2)});
+  const auto second = inputBatch({inputRecord(MouseMove, 3, 3)});
+  filter.write(first.data(), static_cast<uint32_t>(first.size()));
+  filter.write(second.data(), static_cast<uint32_t>(second.size()));
+  QCOMPARE(stream.m_calls.size(), size_t{0});
+
+  // the next other message sends the latest held batch first
+  filter.write("DKDN", 4);
+
+  QCOMPARE(stream.m_calls.size(), size_t{2});
+  QCOMPARE(stream.m_calls[0], packet(second));
+  QCOMPARE(filter.getOutputStats().m_motionCoalesced, uint64_t{1});
+}
+
+void PacketStreamFilterTests::write_mixedBatchWhileBackedUp_notHeld()
+{
+  using enum deskflow::InputRecords::Record::Type;
+  MockEventQueue events;
+  RecordingStream stream;
+  PacketStreamFilter filter(&events, &stream, false);
+  filter.setMotionLimit(100);
+  stream.m_outputSize = 101;
+
+  // a wheel event can't be dropped, so nor can the batch
+  const auto batch = inputBatch({inputRecord(MouseMove, 1, 1), inputRecord(MouseWheel, 0, 120)});
+  filter.write(batch.data(), static_cast<uint32_t>(batch.size()));
+
+  QCOMPARE(stream.m_calls.size(), size_t{1});
+  QCOMPARE(stream.m_calls[0], packet(batch));
+}
+
+void PacketStreamFilterTests::write_heldMotion_replacedByNewer()
+{
+  MockEventQueue events;
+  RecordingStream stream;
+  PacketStreamFilter filter(&events, &stream, false);
+  filter.setMotionLimit(100);
+  stream.m_outputSize = 101;
+
+  filter.write("DMMV\0\1\0\1", 8);
+
+  // once the stream catches up the newer motion replaces the held one
+  stream.m_outputSize = 100;
+  filter.write("DMMV\0\2\0\2", 8);
+
+  QCOMPARE(stream.m_calls.size(), size_t{1});
+  QCOMPARE(stream.m_calls[0], std::string("\0\0\0\x08" "DMMV\0\2\0\2", 12));
+  QCOMPARE(filter.getOutputStats().m_motionCoalesced, uint64_t{1});
+}
+
+void PacketStreamFilterTests::write_messages_countedByCode()
+{
+  MockEventQueue events;
+  RecordingStream stream;
+  deskflow::MessageTable<int> handlers;
+  handlers.add("CALV", 1);
+  stream.m_stats.setMessageCounter(&handlers);
+  PacketStreamFilter filter(&events, &stream, false);
+
+  filter.write("DMMV\0\1\0\1", 8);
+  filter.write("DMMV\0\2\0\2", 8);
+  filter.write("DKDN", 4);
+  handlers.find(reinterpret_cast<const uint8_t *>("CALV"));
+
+  const auto messages = stream.m_stats.snapshot().m_messages;
+  QCOMPARE(messages.size(), size_t{3});
+  QCOMPARE(std::string(messages[0].m_code.data(), 4), std::string("CALV"));
+  QCOMPARE(messages[0].m_in, uint64_t{1});
+  QCOMPARE(messages[0].m_out, uint64_t{0});
+  QCOMPARE(std::string(messages[1].m_code.data(), 4), std::string("DKDN"));
+  QCOMPARE(messages[1].m_out, uint64_t{1});
+  QCOMPARE(std::string(messages[2].m_code.data(), 4), std::string("DMMV"));
+  QCOMPARE(messages[2].m_out, uint64_t{2});
+  stream.m_stats.setMessageCounter(nullptr);
+}
+
+void PacketStreamFilterTests::write_largeCompressed_readsBack()
+{
+  HandlerEventQueue events;
+  RecordingStream stream;
+  PacketStreamFilter filter(&events, &stream, false);
+  filter.setCompression(true);
+  const std::string message = "DCLP" + makeText(64 * 1024);
+
+  filter.write(message.data(), static_cast<uint32_t>(message.size()));
+
+  QCOMPARE(stream.m_calls.size(), size_t{1});
+  QVERIFY(stream.m_calls[0].size() < message.size() / 2);
+  QVERIFY((static_cast<uint8_t>(stream.m_calls[0][0]) & 0x80) != 0);
+  QCOMPARE(filter.getOutputStats().m_compressed, uint64_t{1});
+
+  // read it back, followed by a packet that isn't compressed
+  stream.m_input = stream.m_calls[0] + std::string("\0\0\0\4DKDN", 8);
+  events.m_handler(Event(EventTypes::StreamInputReady, &stream));
+
+  QCOMPARE(filter.getSize(), static_cast<uint32_t>(message.size()));
+  std::string read(message.size(), '\0');
+  QCOMPARE(filter.read(read.data(), 100), uint32_t{100});
+  QCOMPARE(filter.read(read.data() + 100, 1 << 20), static_cast<uint32_t>(message.size() - 100));
+  QCOMPARE(read, message);
+
+  char code[4];
+  QCOMPARE(filter.read(code, sizeof(code)), uint32_t{4});
+  QCOMPARE(std::string(code, 4), std::string("DKDN"));
+  QVERIFY(!filter.isReady());
+}
+
+void PacketStreamFilterTests::write_smallCompressed_sentAsIs()
+{
+  MockEventQueue events;
+  RecordingStream stream;
+  PacketStreamFilter filter(&events, &stream, false);
+  filter.setCompression(true);
+
+  filter.write("DMMV\0\1\0\1", 8);
+
+  QCOMPARE(stream.m_calls.size(), size_t{1});
+  QCOMPARE(stream.m_calls[0], std::string("\0\0\0\x08" "DMMV\0\1\0\1", 12));
+  QCOMPARE(filter.getOutputStats().m_compressed, uint64_t{0});
+}
+
+void PacketStreamFilterTests::write_incompressible_sentAsIs()
+{
+  MockEventQueue events;
+  RecordingStream stream;
+  PacketStreamFilter filter(&events, &stream, false);
+  filter.setCompression(true);
+  const std::string message = "DCLP" + makeBinary(4096);
+
+  filter.write(message.data(), static_cast<uint32_t>(message.size()));
+
+  QCOMPARE(stream.m_calls.size(), size_t{1});
+  QCOMPARE(stream.m_calls[0], std::string("\0\0\x10\x04", 4) + message);
+  QCOMPARE(filter.getOutputStats().m_compressed, uint64_t{0});
+}
+
+void PacketStreamFilterTests::read_badCompressed_formatError()
+{
+  HandlerEventQueue events;
+  RecordingStream stream;
+  PacketStreamFilter filter(&events, &stream, false);
+  filter.setCompression(true);
+
+  // claims to inflate to 16 bytes, but isn't a zlib stream
+  stream.m_input = std::string("\x80\0\0\x08\0\0\0\x10junk", 12);
+  events.m_handler(Event(EventTypes::StreamInputReady, &stream));
+
+  QVERIFY(!filter.isReady());
+  QCOMPARE(events.m_added.size(), size_t{1});
+  QVERIFY(events.m_added[0] == EventTypes::StreamInputFormatError);
+}
+
+void PacketStreamFilterTests::read_compressedWithoutCompression_formatError()
+{
+  // a valid compressed packet, from a peer that never agreed to send one
+  MockEventQueue senderEvents;
+  RecordingStream sent;
+  PacketStreamFilter sender(&senderEvents, &sent, false);
+  sender.setCompression(true);
+  const std::string message = "DCLP" + makeText(64 * 1024);
+  sender.write(message.data(), static_cast<uint32_t>(message.size()));
+  QCOMPARE(sender.getOutputStats().m_compressed, uint64_t{1});
+
+  HandlerEventQueue events;
+  RecordingStream stream;
+  PacketStreamFilter filter(&events, &stream, false);
+  stream.m_input = sent.m_calls[0];
+  events.m_handler(Event(EventTypes::StreamInputReady, &stream));
+
+  QVERIFY(!filter.isReady());
+  QCOMPARE(events.m_added.size(), size_t{1});
+  QVERIFY(events.m_added[0] == EventTypes::StreamInputFormatError);
+}
+
+void PacketStreamFilterTests::read_emptyCompressed_formatError()
+{
+  HandlerEventQueue events;
+  RecordingStream stream;
+  PacketStreamFilter filter(&events, &stream, false);
+  filter.setCompression(true);
+
+  // flagged as compressed with no payload, followed by a valid packet
+  stream.m_input = std::string("      DKDN", 12);
+  events.m_handler(Event(EventTypes::StreamInputReady, &stream));
+
+  QVERIFY(!filter.isReady());
+  QCOMPARE(events.m_added.size(), size_t{1});
+  QVERIFY(events.m_added[0] == EventTypes::StreamInputFormatError);
+}
+
+void PacketStreamFilterTests::benchmark_write_data()
+{
+  QTest::addColumn<std::string>("message");
+  QTest::addColumn<bool>("compress");
+
+  const std::string motion("DMMV\0\1\0\1", 8);
+  const std::string text = "DCLP" + makeText(512 * 1024);
+  const std::string html = "DCLP" + makeHtml(512 * 1024);
+  const std::string binary = "DCLP" + makeBinary(512 * 1024);
+  QTest::newRow("motion") << motion << false;
+  QTest::newRow("motion compressed") << motion << true;
+  QTest::newRow("text") << text << false;
+  QTest::newRow("text compressed") << text << true;
+  QTest::newRow("html") << html << false;
+  QTest::newRow("html compressed") << html << true;
+  QTest::newRow("binary") << binary << false;
+  QTest::newRow("binary compressed") << binary << true;
+}
+
+void PacketStreamFilterTests::benchmark_write()
+{
+  QFETCH(std::string, message);
+  QFETCH(bool, compress);
+  MockEventQueue events;
+  RecordingStream stream;
+  PacketStreamFilter filter(&events, &stream, false);
+  filter.setCompression(compress);
+
+  QBENCHMARK {
+    filter.write(message.data(), static_cast<uint32_t>(message.size()));
+    stream.m_calls.clear();
+  }
+
+  QVERIFY(filter.getOutputStats().m_compressed == 0 || compress);
+}
+
+QTEST_MAIN(PacketStreamFilterTests)
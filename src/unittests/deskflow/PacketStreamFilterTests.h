@@ -0,0 +1,33 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include <QObject>
+
+class PacketStreamFilterTests : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void write_payload_framedInOneWrite();
+  void writev_buffers_framedAsOnePacket();
+  void writev_manyBuffers_framedAsOnePacket();
+  void write_motionWhileBackedUp_latestKept();
+  void write_keyWhileMotionHeld_motionSentFirst();
+  void write_motionBatchWhileBackedUp_latestKept();
+  void write_mixedBatchWhileBackedUp_notHeld();
+  void write_heldMotion_replacedByNewer();
+  void write_messages_countedByCode();
+  void write_largeCompressed_readsBack();
+  void write_smallCompressed_sentAsIs();
+  void write_incompressible_sentAsIs();
+  void read_badCompressed_formatError();
+  void read_compressedWithoutCompression_formatError();
+  void read_emptyCompressed_formatError();
+  void benchmark_write_data();
+  void benchmark_write();
+};
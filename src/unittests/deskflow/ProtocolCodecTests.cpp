@@ -0,0 +1,290 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "ProtocolCodecTests.h"
+
+#include "deskflow/ProtocolCodec.h"
+#include "deskflow/ProtocolUtil.h"
+
+#include <QTest>
+
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace deskflow::protocol;
+
+namespace {
+
+// fuzz iterations per message
+const int s_rounds = 200;
+
+//! Keeps what is written for reading back
+class MemoryStream : public deskflow::IStream
+{
+public:
+  void close() override
+  {
+  }
+
+  uint32_t read(void *buffer, uint32_t n) override
+  {
+    n = std::min(n, getSize());
+    memcpy(buffer, m_data.data() + m_read, n);
+    m_read += n;
+    return n;
+  }
+
+  void write(const void *buffer, uint32_t n) override
+  {
+    m_data.append(static_cast<const char *>(buffer), n);
+  }
+
+  void flush() override
+  {
+  }
+
+  void shutdownInput() override
+  {
+  }
+
+  void shutdownOutput() override
+  {
+  }
+
+  void *getEventTarget() const override
+  {
+    return const_cast<MemoryStream *>(this);
+  }
+
+  bool isReady() const override
+  {
+    return getSize() != 0;
+  }
+
+  uint32_t getSize() const override
+  {
+    return static_cast<uint32_t>(m_data.size() - m_read);
+  }
+
+  std::span<const uint8_t> bytes() const
+  {
+    return {reinterpret_cast<const uint8_t *>(m_data.data()), m_data.size()};
+  }
+
+  std::string m_data;
+  size_t m_read = 0;
+};
+
+class Random
+{
+public:
+  template <typename T> T next()
+  {
+    return static_cast<T>(m_engine());
+  }
+
+  std::string nextString()
+  {
+    std::string text(m_engine() % 40, '\0');
+    for (auto &c : text) {
+      c = static_cast<char>(m_engine());
+    }
+    return text;
+  }
+
+  std::vector<uint32_t> nextList()
+  {
+    std::vector<uint32_t> list(m_engine() % 10);
+    for (auto &value : list) {
+      value = m_engine();
+    }
+    return list;
+  }
+
+private:
+  std::mt19937 m_engine{20260101};
+};
+
+// ProtocolUtil takes integers by value and everything else by pointer
+template <typename T> auto legacyArg(const T &value)
+{
+  if constexpr (std::is_integral_v<T>) {
+    return value;
+  } else {
+    return &value;
+  }
+}
+
+// ... and reads everything through a pointer
+template <typename T> auto legacyOut(T &value)
+{
+  return &value;
+}
+
+template <typename Codec, typename... Values> std::string legacyBytes(const Values &...values)
+{
+  MemoryStream stream;
+  ProtocolUtil::writef(&stream, Codec::kFormat.m_text, legacyArg(values)...);
+  return stream.m_data;
+}
+
+template <typename Codec, typename... Values> std::string codecBytes(const Values &...values)
+{
+  MemoryStream stream;
+  Codec::write(&stream, values...);
+  return stream.m_data;
+}
+
+template <typename Codec, typename... Values> bool codecReadsLegacy(const Values &...values)
+{
+  MemoryStream stream;
+  ProtocolUtil::writef(&stream, Codec::kFormat.m_text, legacyArg(values)...);
+  stream.m_read = 4;
+  std::tuple<Values...> decoded;
+  const bool ok = std::apply([&stream](auto &...out) { return Codec::read(&stream, out...); }, decoded);
+  return ok && stream.getSize() == 0 && decoded == std::tuple(values...);
+}
+
+template <typename Codec, typename... Values> bool legacyReadsCodec(const Values &...values)
+{
+  MemoryStream stream;
+  Codec::write(&stream, values...);
+  stream.m_read = 4;
+  std::tuple<Values...> decoded;
+  const bool ok = std::apply(
+      [&stream](auto &...out) { return ProtocolUtil::readf(&stream, Codec::kFormat.m_text + 4, legacyOut(out)...); },
+      decoded
+  );
+  return ok && stream.getSize() == 0 && decoded == std::tuple(values...);
+}
+
+// runs a check on random values of each message's field types
+template <typename Check> void forRandomMessages(Check check)
+{
+  Random random;
+  for (int i = 0; i < s_rounds; ++i) {
+    const auto x = random.next<int16_t>();
+    const auto y = random.next<int16_t>();
+    const auto key = random.next<uint16_t>();
+    const auto mask = random.next<uint16_t>();
+    const auto button = random.next<uint16_t>();
+    const auto count = random.next<uint16_t>();
+    const auto id = random.next<uint8_t>();
+    const auto seqNum = random.next<uint32_t>();
+    const auto text = random.nextString();
+    const auto list = random.nextList();
+
+    QVERIFY(check.template operator()<KeepAlive>());
+    QVERIFY(check.template operator()<MouseMove>(x, y));
+    QVERIFY(check.template operator()<MouseRelMove>(x, y));
+    QVERIFY(check.template operator()<MouseWheel>(x, y));
+    QVERIFY(check.template operator()<MouseDown>(id));
+    QVERIFY(check.template operator()<Enter>(x, y, seqNum, mask));
+    QVERIFY(check.template operator()<KeyDown>(key, mask, button));
+    QVERIFY(check.template operator()<KeyDownLang>(key, mask, button, text));
+    QVERIFY(check.template operator()<KeyRepeat>(key, mask, count, button, text));
+    QVERIFY(check.template operator()<GrabClipboard>(id, seqNum));
+    QVERIFY(check.template operator()<Clipboard>(id, seqNum, id, text));
+    QVERIFY(check.template operator()<SetOptions>(list));
+    QVERIFY(check.template operator()<DragInfo>(count, text));
+    QVERIFY(check.template operator()<QueryClock>(seqNum));
+    QVERIFY(check.template operator()<Clock>(seqNum, seqNum));
+    QVERIFY(check.template operator()<LatencyReport>(list));
+  }
+}
+
+} // namespace
+
+void ProtocolCodecTests::formats_matchProtocolTypes()
+{
+  QCOMPARE(MouseMove::kFormat.view(), std::string_view(kMsgDMouseMove));
+  QCOMPARE(KeyDownLang::kFormat.view(), std::string_view(kMsgDKeyDownLang));
+  QCOMPARE(KeepAlive::kFormat.view(), std::string_view(kMsgCKeepAlive));
+  QCOMPARE(Enter::kFormat.view(), std::string_view(kMsgCEnter));
+  QCOMPARE(SetOptions::kFormat.view(), std::string_view(kMsgDSetOptions));
+
+  static_assert(MouseMove::kFixedSize && MouseMove::kMinSize == 8);
+  static_assert(!KeyDownLang::kFixedSize && KeyDownLang::kMinSize == 14);
+  static_assert(Enter::kValues == 4);
+}
+
+void ProtocolCodecTests::encode_mouseMove_bigEndian()
+{
+  std::array<uint8_t, MouseMove::kMinSize> buffer{};
+
+  const auto n = MouseMove::encode(buffer, int16_t{-5}, int16_t{300});
+
+  QCOMPARE(n, buffer.size());
+  const std::string bytes(reinterpret_cast<const char *>(buffer.data()), buffer.size());
+  QCOMPARE(bytes, std::string("DMMV\xff\xfb\x01\x2c", 8));
+}
+
+void ProtocolCodecTests::write_randomMessages_matchesLegacy()
+{
+  forRandomMessages([]<typename Codec, typename... Values>(const Values &...values) {
+    const auto bytes = codecBytes<Codec>(values...);
+    return bytes == legacyBytes<Codec>(values...) && bytes.size() == Codec::size(values...);
+  });
+}
+
+void ProtocolCodecTests::read_legacyMessages_roundTrips()
+{
+  forRandomMessages([]<typename Codec, typename... Values>(const Values &...values) {
+    return codecReadsLegacy<Codec>(values...);
+  });
+}
+
+void ProtocolCodecTests::readf_codecMessages_roundTrips()
+{
+  forRandomMessages([]<typename Codec, typename... Values>(const Values &...values) {
+    return legacyReadsCodec<Codec>(values...);
+  });
+}
+
+void ProtocolCodecTests::decode_truncated_fails()
+{
+  const std::string text = "en";
+  const auto bytes = codecBytes<KeyDownLang>(uint16_t{1}, uint16_t{2}, uint16_t{3}, text);
+  uint16_t key = 0;
+  uint16_t mask = 0;
+  uint16_t button = 0;
+  std::string lang;
+
+  const std::span<const uint8_t> data(reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size() - 1);
+
+  QVERIFY(!KeyDownLang::decode(data, key, mask, button, lang));
+
+  MemoryStream stream;
+  stream.m_data = bytes.substr(0, bytes.size() - 1);
+  stream.m_read = 4;
+  QVERIFY(!KeyDownLang::read(&stream, key, mask, button, lang));
+}
+
+void ProtocolCodecTests::decode_wrongCode_fails()
+{
+  const auto bytes = codecBytes<MouseRelMove>(int16_t{1}, int16_t{2});
+  int16_t x = 0;
+  int16_t y = 0;
+
+  const std::span<const uint8_t> data(reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size());
+
+  QVERIFY(MouseRelMove::decode(data, x, y));
+  QVERIFY(!MouseMove::decode(data, x, y));
+}
+
+void ProtocolCodecTests::read_tooLongString_throws()
+{
+  MemoryStream stream;
+  stream.m_data = std::string("SECN\x7f\xff\xff\xff", 8);
+  stream.m_read = 4;
+  std::string app;
+
+  QVERIFY_THROWS_EXCEPTION(BadClientException, SecureInputNotification::read(&stream, app));
+}
+
+QTEST_MAIN(ProtocolCodecTests)
@@ -0,0 +1,29 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include "base/Log.h"
+
+#include <QObject>
+
+class ProtocolCodecTests : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void formats_matchProtocolTypes();
+  void encode_mouseMove_bigEndian();
+  void write_randomMessages_matchesLegacy();
+  void read_legacyMessages_roundTrips();
+  void readf_codecMessages_roundTrips();
+  void decode_truncated_fails();
+  void decode_wrongCode_fails();
+  void read_tooLongString_throws();
+
+private:
+  Log m_log;
+};
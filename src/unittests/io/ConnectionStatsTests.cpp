@@ -0,0 +1,151 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "ConnectionStatsTests.h"
+
+#include "io/ConnectionStats.h"
+
+#include <QTest>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+//! Counts sent messages and reports received ones it was given
+class TestMessageCounter : public ConnectionStats::MessageCounter
+{
+public:
+  void countSent(const void *code) override
+  {
+    count(code).m_out++;
+  }
+
+  std::vector<ConnectionStats::MessageCount> messageCounts() const override
+  {
+    return m_counts;
+  }
+
+  ConnectionStats::MessageCount &count(const void *code)
+  {
+    for (auto &count : m_counts) {
+      if (memcmp(count.m_code.data(), code, count.m_code.size()) == 0) {
+        return count;
+      }
+    }
+    auto &count = m_counts.emplace_back();
+    memcpy(count.m_code.data(), code, count.m_code.size());
+    return count;
+  }
+
+  std::vector<ConnectionStats::MessageCount> m_counts;
+};
+
+} // namespace
+
+void ConnectionStatsTests::record_bytes_countsAndHighWater()
+{
+  ConnectionStats stats;
+  stats.recordInput(100, 100);
+  stats.recordInput(50, 30);
+  stats.recordOutputBuffered(200);
+  stats.recordOutputBuffered(10);
+  stats.recordOutput(210);
+
+  const auto snapshot = stats.snapshot();
+  QCOMPARE(snapshot.m_bytesIn, uint64_t{150});
+  QCOMPARE(snapshot.m_bytesOut, uint64_t{210});
+  QCOMPARE(snapshot.m_inputHighWater, uint32_t{100});
+  QCOMPARE(snapshot.m_outputHighWater, uint32_t{200});
+}
+
+void ConnectionStatsTests::recordMessage_byCode_countedEachWay()
+{
+  ConnectionStats stats;
+  TestMessageCounter counter;
+  stats.recordMessageOut("CNOP");
+  stats.setMessageCounter(&counter);
+  stats.recordMessageOut("DMMV");
+  stats.recordMessageOut("DMMV");
+  counter.count("CALV").m_in++;
+  stats.recordMessageOut("CALV");
+
+  auto snapshot = stats.snapshot();
+  QCOMPARE(snapshot.m_messages.size(), size_t{2});
+  const auto &motion = snapshot.m_messages[0];
+  QCOMPARE(std::string(motion.m_code.data(), 4), std::string("DMMV"));
+  QCOMPARE(motion.m_in, uint64_t{0});
+  QCOMPARE(motion.m_out, uint64_t{2});
+  const auto &keepAlive = snapshot.m_messages[1];
+  QCOMPARE(keepAlive.m_in, uint64_t{1});
+  QCOMPARE(keepAlive.m_out, uint64_t{1});
+  QVERIFY(stats.report().find(", DMMV 0/2, CALV 1/1") != std::string::npos);
+
+  stats.setMessageCounter(nullptr);
+  stats.recordMessageOut("DMMV");
+  QVERIFY(stats.snapshot().m_messages.empty());
+  QCOMPARE(counter.m_counts[0].m_out, uint64_t{2});
+}
+
+void ConnectionStatsTests::recordRtt_samples_latestMinMax()
+{
+  ConnectionStats stats;
+  stats.recordRtt(5ms);
+  stats.recordRtt(2ms);
+  stats.recordRtt(9ms);
+  stats.recordRtt(4ms);
+
+  const auto snapshot = stats.snapshot();
+  QCOMPARE(snapshot.m_rttSamples, uint64_t{4});
+  QCOMPARE(snapshot.m_rtt, MonotonicClock::duration(4ms));
+  QCOMPARE(snapshot.m_minRtt, MonotonicClock::duration(2ms));
+  QCOMPARE(snapshot.m_maxRtt, MonotonicClock::duration(9ms));
+}
+
+void ConnectionStatsTests::recordLatency_samples_bucketedAndReported()
+{
+  using enum ConnectionStats::LatencyPart;
+
+  ConnectionStats stats;
+  stats.recordLatency(Network, 0us);
+  stats.recordLatency(Network, 3us);
+  stats.recordLatency(Network, 1500us);
+  stats.recordLatency(Injection, 1h);
+  ConnectionStats::LatencyHistogram remote{};
+  remote[11] = 97;
+  stats.addLatency(Network, remote);
+
+  const auto snapshot = stats.snapshot();
+  const auto &network = snapshot.m_latency[static_cast<size_t>(Network)];
+  QCOMPARE(network[0], uint64_t{1});
+  QCOMPARE(network[2], uint64_t{1});
+  QCOMPARE(network[11], uint64_t{98});
+  QCOMPARE(snapshot.m_latency[static_cast<size_t>(Injection)].back(), uint64_t{1});
+
+  const auto line = stats.report();
+  QVERIFY(line.find("network latency p50 <2.0ms p99 <2.0ms") != std::string::npos);
+  QVERIFY(line.find("queue latency") == std::string::npos);
+}
+
+void ConnectionStatsTests::reportAll_liveConnections_oneLineEach()
+{
+  const auto before = ConnectionStats::reportAll().size();
+  auto stats = std::make_unique<ConnectionStats>();
+  stats->setName("client test");
+
+  const auto lines = ConnectionStats::reportAll();
+  QCOMPARE(lines.size(), before + 1);
+  QVERIFY(std::ranges::any_of(lines, [](const std::string &line) { return line.starts_with("client test: "); }));
+
+  stats.reset();
+  QCOMPARE(ConnectionStats::reportAll().size(), before);
+}
+
+QTEST_MAIN(ConnectionStatsTests)
@@ -0,0 +1,21 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include <QObject>
+
+class ConnectionStatsTests : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void record_bytes_countsAndHighWater();
+  void recordMessage_byCode_countedEachWay();
+  void recordRtt_samples_latestMinMax();
+  void recordLatency_samples_bucketedAndReported();
+  void reportAll_liveConnections_oneLineEach();
+};
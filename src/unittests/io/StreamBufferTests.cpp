@@ -0,0 +1,143 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "StreamBufferTests.h"
+
+#include "io/StreamBuffer.h"
+
+#include <QTest>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+std::vector<uint8_t> makeData(size_t size)
+{
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = static_cast<uint8_t>(i * 7 + 3);
+  }
+  return data;
+}
+
+} // namespace
+
+void StreamBufferTests::write_acrossChunks_peeksAndPopsInOrder()
+{
+  const auto data = makeData(10000);
+  StreamBuffer buffer;
+  buffer.write(data.data(), 3000);
+  buffer.write(data.data() + 3000, 7000);
+  QCOMPARE(buffer.getSize(), uint32_t{10000});
+
+  // straddles the first chunk boundary
+  buffer.pop(4000);
+  const auto *peeked = static_cast<const uint8_t *>(buffer.peek(1000));
+  QVERIFY(memcmp(peeked, data.data() + 4000, 1000) == 0);
+
+  std::vector<uint8_t> copy(6000);
+  buffer.peek(copy.data(), 6000);
+  QVERIFY(memcmp(copy.data(), data.data() + 4000, 6000) == 0);
+  QCOMPARE(buffer.getSize(), uint32_t{6000});
+}
+
+void StreamBufferTests::peek_withinChunk_returnsDataInPlace()
+{
+  const auto data = makeData(100);
+  StreamBuffer buffer;
+  buffer.write(data.data(), 100);
+
+  StreamBuffer::ReadableSpan span;
+  QCOMPARE(buffer.readableSpans(&span, 1), size_t{1});
+  QCOMPARE(buffer.peek(100), static_cast<const void *>(span.data()));
+}
+
+void StreamBufferTests::readableSpans_acrossChunks_coverAllData()
+{
+  const auto data = makeData(9000);
+  StreamBuffer buffer;
+  buffer.write(data.data(), 9000);
+  buffer.pop(100);
+
+  StreamBuffer::ReadableSpan spans[8];
+  const size_t count = buffer.readableSpans(spans, 8);
+  QCOMPARE(count, size_t{3});
+
+  std::vector<uint8_t> joined;
+  for (size_t i = 0; i < count; ++i) {
+    joined.insert(joined.end(), spans[i].begin(), spans[i].end());
+  }
+  QCOMPARE(joined.size(), size_t{8900});
+  QVERIFY(memcmp(joined.data(), data.data() + 100, joined.size()) == 0);
+
+  // fewer spans than chunks gives a prefix of the data
+  QCOMPARE(buffer.readableSpans(spans, 1), size_t{1});
+  QVERIFY(memcmp(spans[0].data(), data.data() + 100, spans[0].size()) == 0);
+}
+
+void StreamBufferTests::writableSpans_commit_appendsData()
+{
+  const auto data = makeData(6000);
+  StreamBuffer buffer;
+  buffer.write(data.data(), 1000);
+
+  StreamBuffer::WritableSpan spans[4];
+  const size_t count = buffer.writableSpans(spans, 4, 5000);
+  QCOMPARE(count, size_t{2});
+
+  size_t written = 0;
+  for (size_t i = 0; i < count && written < 5000; ++i) {
+    const size_t n = std::min(spans[i].size(), size_t{5000} - written);
+    memcpy(spans[i].data(), data.data() + 1000 + written, n);
+    written += n;
+  }
+  buffer.commit(5000);
+  QCOMPARE(buffer.getSize(), uint32_t{6000});
+
+  std::vector<uint8_t> copy(6000);
+  buffer.peek(copy.data(), 6000);
+  QVERIFY(copy == data);
+}
+
+void StreamBufferTests::writableSpans_uncommitted_notBuffered()
+{
+  const auto data = makeData(200);
+  StreamBuffer buffer;
+
+  StreamBuffer::WritableSpan span;
+  QCOMPARE(buffer.writableSpans(&span, 1, 100), size_t{1});
+  memset(span.data(), 0xff, 100);
+  QCOMPARE(buffer.getSize(), uint32_t{0});
+
+  // a later write goes into the same free space
+  buffer.write(data.data(), 200);
+  std::vector<uint8_t> copy(200);
+  buffer.peek(copy.data(), 200);
+  QVERIFY(copy == data);
+}
+
+void StreamBufferTests::pop_all_emptiesBuffer()
+{
+  const auto data = makeData(10000);
+  StreamBuffer buffer;
+  buffer.write(data.data(), 10000);
+  buffer.pop(20000);
+  QCOMPARE(buffer.getSize(), uint32_t{0});
+
+  StreamBuffer::ReadableSpan span;
+  QCOMPARE(buffer.readableSpans(&span, 1), size_t{0});
+  QVERIFY(buffer.peek(0) == nullptr);
+
+  // recycled chunks are reused
+  buffer.write(data.data(), 5000);
+  std::vector<uint8_t> copy(5000);
+  buffer.peek(copy.data(), 5000);
+  QVERIFY(memcmp(copy.data(), data.data(), 5000) == 0);
+}
+
+QTEST_MAIN(StreamBufferTests)
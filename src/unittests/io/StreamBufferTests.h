@@ -0,0 +1,22 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include <QObject>
+
+class StreamBufferTests : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void write_acrossChunks_peeksAndPopsInOrder();
+  void peek_withinChunk_returnsDataInPlace();
+  void readableSpans_acrossChunks_coverAllData();
+  void writableSpans_commit_appendsData();
+  void writableSpans_uncommitted_notBuffered();
+  void pop_all_emptiesBuffer();
+};
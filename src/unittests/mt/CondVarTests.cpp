@@ -0,0 +1,120 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "CondVarTests.h"
+
+#include "base/FunctionJob.h"
+#include "base/Stopwatch.h"
+#include "mt/CondVar.h"
+#include "mt/Lock.h"
+#include "mt/Mutex.h"
+#include "mt/Thread.h"
+
+#include <QTest>
+
+#include <atomic>
+
+namespace {
+
+struct WaitState
+{
+  Mutex m_mutex;
+  CondVar<bool> m_ready{&m_mutex, false};
+  std::atomic<bool> m_waiting = false;
+  std::atomic<int> m_waiters = 0;
+  std::atomic<int> m_woken = 0;
+};
+
+void waitForever(void *arg)
+{
+  auto *state = static_cast<WaitState *>(arg);
+  Lock lock(&state->m_mutex);
+  state->m_waiting = true;
+  while (!state->m_ready) {
+    state->m_ready.wait();
+  }
+}
+
+void waitOnce(void *arg)
+{
+  auto *state = static_cast<WaitState *>(arg);
+  Lock lock(&state->m_mutex);
+  ++state->m_waiters;
+  state->m_ready.wait();
+  ++state->m_woken;
+}
+
+} // namespace
+
+void CondVarTests::initTestCase()
+{
+  m_arch.init();
+}
+
+void CondVarTests::wait_timeout_waitsWholeTimeout()
+{
+  Mutex mutex;
+  CondVar<bool> condVar(&mutex, false);
+
+  // used to return early every 100ms to poll for cancellation
+  Lock lock(&mutex);
+  Stopwatch timer;
+  QVERIFY(!condVar.wait(0.3));
+  QVERIFY(timer.getTime() >= 0.29);
+}
+
+void CondVarTests::wait_cancelled_wakesThreadPromptly()
+{
+  WaitState state;
+  Thread thread(new FunctionJob(&waitForever, &state));
+  while (!state.m_waiting) {
+    Arch::sleep(0.001);
+  }
+  Arch::sleep(0.01);
+
+  Stopwatch timer;
+  thread.cancel();
+  QVERIFY(thread.wait(5.0));
+  QVERIFY(timer.getTime() < 1.0);
+}
+
+void CondVarTests::cancel_holdingWaitersMutex_doesNotBlock()
+{
+  WaitState state;
+  Thread thread(new FunctionJob(&waitForever, &state));
+  while (!state.m_waiting) {
+    Arch::sleep(0.001);
+  }
+
+  // used to spin until the waiter's mutex was free
+  {
+    Lock lock(&state.m_mutex);
+    thread.cancel();
+  }
+  QVERIFY(thread.wait(5.0));
+}
+
+void CondVarTests::signal_twoWaiters_wakesOne()
+{
+  WaitState state;
+  Thread first(new FunctionJob(&waitOnce, &state));
+  Thread second(new FunctionJob(&waitOnce, &state));
+  while (state.m_waiters != 2) {
+    Arch::sleep(0.001);
+  }
+  Arch::sleep(0.01);
+
+  state.m_ready.signal();
+  Arch::sleep(0.1);
+  QCOMPARE(state.m_woken.load(), 1);
+
+  state.m_ready.broadcast();
+  QVERIFY(first.wait(5.0));
+  QVERIFY(second.wait(5.0));
+  QCOMPARE(state.m_woken.load(), 2);
+}
+
+QTEST_MAIN(CondVarTests)
@@ -0,0 +1,28 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include "arch/Arch.h"
+#include "base/Log.h"
+
+#include <QObject>
+
+class CondVarTests : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void initTestCase();
+  void wait_timeout_waitsWholeTimeout();
+  void wait_cancelled_wakesThreadPromptly();
+  void cancel_holdingWaitersMutex_doesNotBlock();
+  void signal_twoWaiters_wakesOne();
+
+private:
+  Arch m_arch;
+  Log m_log;
+};
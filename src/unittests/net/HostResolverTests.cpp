@@ -0,0 +1,274 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "HostResolverTests.h"
+
+#include "base/EventQueue.h"
+#include "net/HostResolver.h"
+#include "net/SocketException.h"
+
+#include <QTest>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+NetworkAddress resolved(const std::string &ip, int port)
+{
+  NetworkAddress address(ip, port);
+  address.resolve();
+  return address;
+}
+
+// counts lookups and answers each with the loopback address
+class CountingLookup
+{
+public:
+  std::vector<NetworkAddress> operator()(const NetworkAddress &address) const
+  {
+    ++*m_lookups;
+    if (m_delay.count() != 0) {
+      std::this_thread::sleep_for(m_delay);
+    }
+    ++*m_finished;
+    if (m_fail) {
+      using enum SocketAddressException::SocketError;
+      throw SocketAddressException(NotFound, address.getHostname(), address.getPort());
+    }
+    return {resolved("127.0.0.1", address.getPort())};
+  }
+
+  std::shared_ptr<std::atomic<int>> m_lookups = std::make_shared<std::atomic<int>>(0);
+  std::shared_ptr<std::atomic<int>> m_finished = std::make_shared<std::atomic<int>>(0);
+  std::chrono::milliseconds m_delay{0};
+  bool m_fail = false;
+};
+
+// blocks, as the system resolver does with an unreachable DNS server,
+// until released
+class BlockingLookup
+{
+public:
+  std::vector<NetworkAddress> operator()(const NetworkAddress &address) const
+  {
+    const auto giveUp = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!*m_released && std::chrono::steady_clock::now() < giveUp) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ++*m_finished;
+    return {resolved("127.0.0.1", address.getPort())};
+  }
+
+  std::shared_ptr<std::atomic<bool>> m_released = std::make_shared<std::atomic<bool>>(false);
+  std::shared_ptr<std::atomic<int>> m_finished = std::make_shared<std::atomic<int>>(0);
+};
+
+// runs an event loop and keeps the results sent to it
+class Collector
+{
+public:
+  struct Received
+  {
+    std::string m_hostname;
+    std::vector<int> m_ports;
+    std::string m_error;
+  };
+
+  explicit Collector(EventQueue &events) : m_events(events)
+  {
+    m_events.addHandler(EventTypes::HostResolved, this, [this](const Event &e) {
+      const auto *result = static_cast<const HostResolver::Result *>(e.getDataObject());
+      Received received{result->m_request.getHostname(), {}, result->m_error};
+      for (const auto &address : result->m_addresses) {
+        received.m_ports.push_back(address.getPort());
+      }
+      std::scoped_lock lock{m_mutex};
+      m_received.push_back(std::move(received));
+    });
+    m_loop = std::thread([this] { m_events.loop(); });
+    m_events.waitForReady();
+  }
+
+  ~Collector()
+  {
+    m_events.addEvent(Event(EventTypes::Quit));
+    m_loop.join();
+    m_events.removeHandler(EventTypes::HostResolved, this);
+  }
+
+  // wait until \p count results have arrived and return them
+  std::vector<Received> waitFor(size_t count)
+  {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline) {
+      {
+        std::scoped_lock lock{m_mutex};
+        if (m_received.size() >= count) {
+          return m_received;
+        }
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::scoped_lock lock{m_mutex};
+    return m_received;
+  }
+
+private:
+  EventQueue &m_events;
+  std::thread m_loop;
+  std::mutex m_mutex;
+  std::vector<Received> m_received;
+};
+
+} // namespace
+
+void HostResolverTests::initTestCase()
+{
+  m_arch.init();
+}
+
+void HostResolverTests::resolve_lookupSucceeds_sendsAddresses()
+{
+  EventQueue events;
+  Collector collector(events);
+  CountingLookup lookup;
+  HostResolver resolver(&events, lookup);
+
+  resolver.resolve(NetworkAddress("server", 24800), &collector);
+
+  const auto received = collector.waitFor(1);
+  QCOMPARE(received.size(), size_t(1));
+  QCOMPARE(received[0].m_hostname, std::string("server"));
+  QCOMPARE(received[0].m_ports, std::vector<int>({24800}));
+  QVERIFY(received[0].m_error.empty());
+}
+
+void HostResolverTests::resolve_cached_doesNotLookUpAgain()
+{
+  EventQueue events;
+  Collector collector(events);
+  CountingLookup lookup;
+  HostResolver resolver(&events, lookup);
+
+  resolver.resolve(NetworkAddress("server", 24800), &collector);
+  QCOMPARE(collector.waitFor(1).size(), size_t(1));
+  resolver.resolve(NetworkAddress("server", 24800), &collector);
+
+  const auto received = collector.waitFor(2);
+  QCOMPARE(received.size(), size_t(2));
+  QCOMPARE(received[1].m_ports, std::vector<int>({24800}));
+  QCOMPARE(lookup.m_lookups->load(), 1);
+}
+
+void HostResolverTests::resolve_lookupFails_cachesError()
+{
+  EventQueue events;
+  Collector collector(events);
+  CountingLookup lookup;
+  lookup.m_fail = true;
+  HostResolver resolver(&events, lookup);
+
+  resolver.resolve(NetworkAddress("missing", 24800), &collector);
+  QCOMPARE(collector.waitFor(1).size(), size_t(1));
+  resolver.resolve(NetworkAddress("missing", 24800), &collector);
+
+  const auto received = collector.waitFor(2);
+  QCOMPARE(received.size(), size_t(2));
+  QVERIFY(!received[0].m_error.empty());
+  QCOMPARE(received[1].m_error, received[0].m_error);
+  QVERIFY(received[1].m_ports.empty());
+  QCOMPARE(lookup.m_lookups->load(), 1);
+}
+
+void HostResolverTests::resolve_concurrentRequests_shareOneLookup()
+{
+  EventQueue events;
+  Collector collector(events);
+  CountingLookup lookup;
+  lookup.m_delay = std::chrono::milliseconds(50);
+  HostResolver resolver(&events, lookup);
+
+  resolver.resolve(NetworkAddress("server", 24800), &collector);
+  resolver.resolve(NetworkAddress("server", 24800), &collector);
+
+  QCOMPARE(collector.waitFor(2).size(), size_t(2));
+  QCOMPARE(lookup.m_lookups->load(), 1);
+}
+
+void HostResolverTests::forget_cached_looksUpAgain()
+{
+  EventQueue events;
+  Collector collector(events);
+  CountingLookup lookup;
+  HostResolver resolver(&events, lookup);
+
+  resolver.resolve(NetworkAddress("server", 24800), &collector);
+  QCOMPARE(collector.waitFor(1).size(), size_t(1));
+  resolver.forget(NetworkAddress("server", 24800));
+  resolver.resolve(NetworkAddress("server", 24800), &collector);
+
+  QCOMPARE(collector.waitFor(2).size(), size_t(2));
+  QCOMPARE(lookup.m_lookups->load(), 2);
+}
+
+void HostResolverTests::destroy_lookupRunning_waitsForLookup()
+{
+  EventQueue events;
+  CountingLookup lookup;
+  lookup.m_delay = std::chrono::milliseconds(50);
+
+  {
+    HostResolver resolver(&events, lookup);
+    resolver.resolve(NetworkAddress("server", 24800), &events);
+  }
+
+  QCOMPARE(lookup.m_finished->load(), 1);
+}
+
+void HostResolverTests::destroy_lookupBlocked_doesNotWaitForLookup()
+{
+  EventQueue events;
+  BlockingLookup lookup;
+
+  const auto start = std::chrono::steady_clock::now();
+  {
+    HostResolver resolver(&events, lookup);
+    resolver.resolve(NetworkAddress("server", 24800), &events);
+  }
+  QVERIFY(std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+  QCOMPARE(lookup.m_finished->load(), 0);
+
+  // the lookup finishes after the resolver is gone and sends nothing
+  *lookup.m_released = true;
+  while (lookup.m_finished->load() == 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  Event event;
+  QVERIFY(!events.getEvent(event, 0.0));
+}
+
+void HostResolverTests::interleaveFamilies_mixed_alternatesFamilies()
+{
+  const std::vector<NetworkAddress> addresses = {
+      resolved("::1", 1), resolved("::1", 2), resolved("::1", 3), resolved("127.0.0.1", 4), resolved("127.0.0.1", 5)
+  };
+
+  const auto ordered = HostResolver::interleaveFamilies(addresses);
+
+  std::vector<int> ports;
+  for (const auto &address : ordered) {
+    ports.push_back(address.getPort());
+  }
+  QCOMPARE(ports, std::vector<int>({1, 4, 2, 5, 3}));
+}
+
+QTEST_MAIN(HostResolverTests)
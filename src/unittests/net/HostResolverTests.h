@@ -0,0 +1,32 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include "arch/Arch.h"
+#include "base/Log.h"
+
+#include <QObject>
+
+class HostResolverTests : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void initTestCase();
+  void resolve_lookupSucceeds_sendsAddresses();
+  void resolve_cached_doesNotLookUpAgain();
+  void resolve_lookupFails_cachesError();
+  void resolve_concurrentRequests_shareOneLookup();
+  void forget_cached_looksUpAgain();
+  void destroy_lookupRunning_waitsForLookup();
+  void destroy_lookupBlocked_doesNotWaitForLookup();
+  void interleaveFamilies_mixed_alternatesFamilies();
+
+private:
+  Arch m_arch;
+  Log m_log;
+};
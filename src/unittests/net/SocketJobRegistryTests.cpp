@@ -0,0 +1,225 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "SocketJobRegistryTests.h"
+
+#include "net/ISocketMultiplexerJob.h"
+#include "net/SocketJobRegistry.h"
+
+#include <QTest>
+
+#include <vector>
+
+namespace {
+
+class CountingJob : public ISocketMultiplexerJob
+{
+public:
+  explicit CountingJob(int *deleted = nullptr) : m_deleted(deleted)
+  {
+  }
+
+  ~CountingJob() override
+  {
+    if (m_deleted != nullptr) {
+      ++*m_deleted;
+    }
+  }
+
+  ISocketMultiplexerJob *run(bool, bool, bool) override
+  {
+    ++m_runs;
+    return this;
+  }
+
+  ArchSocket getSocket() const override
+  {
+    return nullptr;
+  }
+
+  bool isReadable() const override
+  {
+    return true;
+  }
+
+  bool isWritable() const override
+  {
+    return false;
+  }
+
+  int m_runs = 0;
+
+private:
+  int *m_deleted;
+};
+
+// the registry only uses sockets as keys, any distinct addresses will do
+std::vector<ISocket *> makeSockets(std::vector<char> &storage, int count)
+{
+  storage.assign(static_cast<size_t>(count), 0);
+  std::vector<ISocket *> sockets;
+  for (auto &byte : storage) {
+    sockets.push_back(reinterpret_cast<ISocket *>(&byte));
+  }
+  return sockets;
+}
+
+void addSocketCounts()
+{
+  QTest::addColumn<int>("sockets");
+  QTest::newRow("1") << 1;
+  QTest::newRow("10") << 10;
+  QTest::newRow("500") << 500;
+}
+
+} // namespace
+
+void SocketJobRegistryTests::insert_newSocket_findsJob()
+{
+  std::vector<char> storage;
+  const auto sockets = makeSockets(storage, 2);
+  SocketJobRegistry registry;
+  auto *job = new CountingJob;
+
+  const auto handle = registry.insert(sockets[0], job);
+
+  QVERIFY(handle != SocketJobRegistry::kInvalidHandle);
+  QCOMPARE(registry.find(handle), static_cast<ISocketMultiplexerJob *>(job));
+  QCOMPARE(registry.find(sockets[0]), handle);
+  QCOMPARE(registry.find(sockets[1]), SocketJobRegistry::kInvalidHandle);
+  QCOMPARE(registry.size(), static_cast<size_t>(1));
+}
+
+void SocketJobRegistryTests::replace_job_keepsHandleAndDeletesOldJob()
+{
+  std::vector<char> storage;
+  const auto sockets = makeSockets(storage, 1);
+  int deleted = 0;
+  SocketJobRegistry registry;
+  const auto handle = registry.insert(sockets[0], new CountingJob(&deleted));
+  auto *job = new CountingJob(&deleted);
+
+  registry.replace(handle, job);
+
+  QCOMPARE(deleted, 1);
+  QCOMPARE(registry.find(handle), static_cast<ISocketMultiplexerJob *>(job));
+  QCOMPARE(registry.find(sockets[0]), handle);
+}
+
+void SocketJobRegistryTests::replace_nullptr_makesHandleStale()
+{
+  std::vector<char> storage;
+  const auto sockets = makeSockets(storage, 1);
+  int deleted = 0;
+  SocketJobRegistry registry;
+  const auto handle = registry.insert(sockets[0], new CountingJob(&deleted));
+
+  registry.replace(handle, nullptr);
+
+  QCOMPARE(deleted, 1);
+  QVERIFY(registry.empty());
+  QVERIFY(registry.find(handle) == nullptr);
+  QCOMPARE(registry.find(sockets[0]), SocketJobRegistry::kInvalidHandle);
+
+  // replacing through a stale handle does nothing
+  auto *job = new CountingJob(&deleted);
+  registry.replace(handle, job);
+  QVERIFY(registry.empty());
+  delete job;
+}
+
+void SocketJobRegistryTests::release_job_makesHandleStaleWithoutDeleting()
+{
+  std::vector<char> storage;
+  const auto sockets = makeSockets(storage, 1);
+  int deleted = 0;
+  SocketJobRegistry registry;
+  auto *job = new CountingJob(&deleted);
+  const auto handle = registry.insert(sockets[0], job);
+
+  QCOMPARE(registry.release(handle), static_cast<ISocketMultiplexerJob *>(job));
+
+  QCOMPARE(deleted, 0);
+  QVERIFY(registry.empty());
+  QVERIFY(registry.find(handle) == nullptr);
+  QVERIFY(registry.release(handle) == nullptr);
+  delete job;
+}
+
+void SocketJobRegistryTests::insert_reusedSlot_oldHandleStaysStale()
+{
+  std::vector<char> storage;
+  const auto sockets = makeSockets(storage, 2);
+  SocketJobRegistry registry;
+  const auto oldHandle = registry.insert(sockets[0], new CountingJob);
+  registry.replace(oldHandle, nullptr);
+  auto *job = new CountingJob;
+
+  const auto handle = registry.insert(sockets[1], job);
+
+  // same slot, new generation
+  QCOMPARE(static_cast<uint32_t>(handle), static_cast<uint32_t>(oldHandle));
+  QVERIFY(handle != oldHandle);
+  QVERIFY(registry.find(oldHandle) == nullptr);
+  QCOMPARE(registry.find(handle), static_cast<ISocketMultiplexerJob *>(job));
+}
+
+void SocketJobRegistryTests::benchmark_addRemove_data()
+{
+  addSocketCounts();
+}
+
+void SocketJobRegistryTests::benchmark_addRemove()
+{
+  QFETCH(int, sockets);
+  std::vector<char> storage;
+  const auto keys = makeSockets(storage, sockets);
+  std::vector<SocketJobRegistry::Handle> handles(keys.size());
+  SocketJobRegistry registry;
+
+  QBENCHMARK {
+    for (size_t i = 0; i < keys.size(); ++i) {
+      handles[i] = registry.insert(keys[i], new CountingJob);
+    }
+    for (const auto handle : handles) {
+      registry.replace(handle, nullptr);
+    }
+  }
+
+  QVERIFY(registry.empty());
+}
+
+void SocketJobRegistryTests::benchmark_dispatch_data()
+{
+  addSocketCounts();
+}
+
+void SocketJobRegistryTests::benchmark_dispatch()
+{
+  QFETCH(int, sockets);
+  std::vector<char> storage;
+  const auto keys = makeSockets(storage, sockets);
+  std::vector<SocketJobRegistry::Handle> handles;
+  SocketJobRegistry registry;
+  for (auto *key : keys) {
+    handles.push_back(registry.insert(key, new CountingJob));
+  }
+
+  // what the service thread does for each ready socket
+  QBENCHMARK {
+    for (const auto handle : handles) {
+      if (ISocketMultiplexerJob *job = registry.find(handle); job != nullptr) {
+        if (ISocketMultiplexerJob *newJob = job->run(true, false, false); newJob != job) {
+          registry.replace(handle, newJob);
+        }
+      }
+    }
+  }
+
+  QVERIFY(static_cast<CountingJob *>(registry.find(handles.front()))->m_runs > 0);
+}
+
+QTEST_MAIN(SocketJobRegistryTests)
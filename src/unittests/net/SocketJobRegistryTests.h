@@ -0,0 +1,27 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include <QObject>
+
+class SocketJobRegistryTests : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void insert_newSocket_findsJob();
+  void replace_job_keepsHandleAndDeletesOldJob();
+  void replace_nullptr_makesHandleStale();
+  void release_job_makesHandleStaleWithoutDeleting();
+  void insert_reusedSlot_oldHandleStaysStale();
+
+  // microbenchmarks, each run with 1, 10 and 500 sockets
+  void benchmark_addRemove_data();
+  void benchmark_addRemove();
+  void benchmark_dispatch_data();
+  void benchmark_dispatch();
+};
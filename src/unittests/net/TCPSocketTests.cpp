@@ -0,0 +1,216 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "TCPSocketTests.h"
+
+#include "arch/ArchException.h"
+#include "base/EventQueue.h"
+#include "net/SocketMultiplexer.h"
+#include "net/TCPSocket.h"
+
+#include <QTest>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// loopback ports tried for the listening socket
+const int s_firstPort = 24900;
+const int s_lastPort = 25100;
+
+// a TCPSocket connected over loopback to a plain socket the test reads
+class Connection
+{
+public:
+  Connection(IEventQueue *events, SocketMultiplexer *multiplexer)
+  {
+    auto addresses = ARCH->nameToAddr("127.0.0.1");
+    m_address = addresses.front();
+    for (size_t i = 1; i < addresses.size(); ++i) {
+      ARCH->closeAddr(addresses[i]);
+    }
+
+    // there's no asking which port a bind to port 0 got, so find a free one
+    m_listen = ARCH->newSocket(IArchNetwork::AddressFamily::INet, IArchNetwork::SocketType::Stream);
+    for (int port = s_firstPort;; ++port) {
+      ARCH->setAddrPort(m_address, port);
+      try {
+        ARCH->bindSocket(m_listen, m_address);
+        break;
+      } catch (const ArchNetworkException &) {
+        if (port == s_lastPort) {
+          throw;
+        }
+      }
+    }
+    ARCH->listenOnSocket(m_listen);
+
+    m_peer = ARCH->newSocket(IArchNetwork::AddressFamily::INet, IArchNetwork::SocketType::Stream);
+    ARCH->connectSocket(m_peer, m_address);
+    IArchNetwork::PollEntry entry{m_listen, IArchNetwork::PollEventMask::In, 0};
+    ARCH->pollSocket(&entry, 1, 5.0);
+    m_socket = std::make_unique<TCPSocket>(events, multiplexer, ARCH->acceptSocket(m_listen, nullptr));
+  }
+
+  Connection(Connection const &) = delete;
+  Connection &operator=(Connection const &) = delete;
+
+  ~Connection()
+  {
+    m_socket.reset();
+    ARCH->closeSocket(m_peer);
+    ARCH->closeSocket(m_listen);
+    ARCH->closeAddr(m_address);
+  }
+
+  // what the socket has sent, waiting up to timeout for it
+  std::string receive(std::chrono::milliseconds timeout) const
+  {
+    IArchNetwork::PollEntry entry{m_peer, IArchNetwork::PollEventMask::In, 0};
+    if (ARCH->pollSocket(&entry, 1, std::chrono::duration<double>(timeout).count()) <= 0) {
+      return {};
+    }
+    char buffer[256];
+    const auto n = ARCH->readSocket(m_peer, buffer, sizeof(buffer));
+    return std::string(buffer, n);
+  }
+
+  TCPSocket &socket() const
+  {
+    return *m_socket;
+  }
+
+private:
+  ArchNetAddress m_address = nullptr;
+  ArchSocket m_listen = nullptr;
+  ArchSocket m_peer = nullptr;
+  std::unique_ptr<TCPSocket> m_socket;
+};
+
+} // namespace
+
+void TCPSocketTests::initTestCase()
+{
+  m_arch.init();
+}
+
+void TCPSocketTests::write_batching_sentAtDeadline()
+{
+  EventQueue events;
+  SocketMultiplexer multiplexer;
+  Connection connection(&events, &multiplexer);
+  connection.socket().setWriteBatching(100ms, 1024);
+
+  const auto start = MonotonicClock::now();
+  connection.socket().write("abc", 3);
+  connection.socket().write("def", 3);
+
+  QCOMPARE(connection.receive(0ms), std::string());
+  QCOMPARE(connection.receive(5s), std::string("abcdef"));
+  QVERIFY(MonotonicClock::now() - start >= 100ms);
+
+  const auto stats = connection.socket().getOutputStats();
+  QCOMPARE(stats.m_batches, uint64_t{1});
+  QCOMPARE(stats.m_writes, uint64_t{2});
+  QCOMPARE(stats.m_bytes, uint64_t{6});
+  QCOMPARE(stats.m_maxWrites, uint32_t{2});
+  QCOMPARE(stats.m_full, uint64_t{0});
+  QCOMPARE(stats.m_urgent, uint64_t{0});
+}
+
+void TCPSocketTests::write_batchReachesSize_sentAtOnce()
+{
+  EventQueue events;
+  SocketMultiplexer multiplexer;
+  Connection connection(&events, &multiplexer);
+  connection.socket().setWriteBatching(10s, 8);
+
+  const auto start = MonotonicClock::now();
+  connection.socket().write("abcd", 4);
+  QCOMPARE(connection.receive(0ms), std::string());
+  connection.socket().write("efgh", 4);
+
+  QCOMPARE(connection.receive(5s), std::string("abcdefgh"));
+  QVERIFY(MonotonicClock::now() - start < 10s);
+
+  const auto stats = connection.socket().getOutputStats();
+  QCOMPARE(stats.m_batches, uint64_t{1});
+  QCOMPARE(stats.m_maxWrites, uint32_t{2});
+  QCOMPARE(stats.m_full, uint64_t{1});
+  QCOMPARE(stats.m_urgent, uint64_t{0});
+}
+
+void TCPSocketTests::sendBatch_openBatch_sentBeforeDeadline()
+{
+  EventQueue events;
+  SocketMultiplexer multiplexer;
+  Connection connection(&events, &multiplexer);
+  connection.socket().setWriteBatching(10s, 1024);
+
+  const auto start = MonotonicClock::now();
+  connection.socket().write("motion", 6);
+  connection.socket().write("key", 3);
+  connection.socket().sendBatch();
+
+  QCOMPARE(connection.receive(5s), std::string("motionkey"));
+  QVERIFY(MonotonicClock::now() - start < 10s);
+
+  const auto stats = connection.socket().getOutputStats();
+  QCOMPARE(stats.m_batches, uint64_t{1});
+  QCOMPARE(stats.m_full, uint64_t{0});
+  QCOMPARE(stats.m_urgent, uint64_t{1});
+}
+
+void TCPSocketTests::sendBatch_endedBatch_deadlineDoesNotEndNextBatch()
+{
+  EventQueue events;
+  SocketMultiplexer multiplexer;
+  Connection connection(&events, &multiplexer);
+  connection.socket().setWriteBatching(300ms, 1024);
+
+  // end the first batch early, its deadline is cancelled
+  connection.socket().write("a", 1);
+  connection.socket().sendBatch();
+  QCOMPARE(connection.receive(5s), std::string("a"));
+
+  // the next batch's deadline is after the first batch's would have been
+  std::this_thread::sleep_for(150ms);
+  const auto start = MonotonicClock::now();
+  connection.socket().write("b", 1);
+
+  // so nothing arrives when the first deadline passes
+  QCOMPARE(connection.receive(250ms), std::string());
+  QCOMPARE(connection.receive(5s), std::string("b"));
+  QVERIFY(MonotonicClock::now() - start >= 300ms);
+
+  const auto stats = connection.socket().getOutputStats();
+  QCOMPARE(stats.m_batches, uint64_t{2});
+  QCOMPARE(stats.m_urgent, uint64_t{1});
+}
+
+void TCPSocketTests::setWriteBatching_off_sentAtOnce()
+{
+  EventQueue events;
+  SocketMultiplexer multiplexer;
+  Connection connection(&events, &multiplexer);
+  connection.socket().setWriteBatching(10s, 1024);
+  connection.socket().write("held", 4);
+
+  // turning batching off sends what it held back
+  connection.socket().setWriteBatching(0s, 0);
+  QCOMPARE(connection.receive(5s), std::string("held"));
+
+  connection.socket().write("now", 3);
+  QCOMPARE(connection.receive(5s), std::string("now"));
+  QCOMPARE(connection.socket().getOutputStats().m_batches, uint64_t{1});
+}
+
+QTEST_MAIN(TCPSocketTests)
@@ -0,0 +1,29 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include "arch/Arch.h"
+#include "base/Log.h"
+
+#include <QObject>
+
+class TCPSocketTests : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void initTestCase();
+  void write_batching_sentAtDeadline();
+  void write_batchReachesSize_sentAtOnce();
+  void sendBatch_openBatch_sentBeforeDeadline();
+  void sendBatch_endedBatch_deadlineDoesNotEndNextBatch();
+  void setWriteBatching_off_sentAtOnce();
+
+private:
+  Arch m_arch;
+  Log m_log;
+};
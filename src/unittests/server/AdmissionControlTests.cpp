@@ -0,0 +1,57 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#include "AdmissionControlTests.h"
+
+#include "server/AdmissionControl.h"
+
+#include <QTest>
+
+#include <chrono>
+
+void AdmissionControlTests::admit_burstFromOneSource_refusesExcess()
+{
+  AdmissionControl admission(10, 3.0, 1.0);
+  const auto now = MonotonicClock::now();
+
+  QVERIFY(admission.admit("10.0.0.1", 0, now));
+  QVERIFY(admission.admit("10.0.0.1", 0, now));
+  QVERIFY(admission.admit("10.0.0.1", 0, now));
+  QVERIFY(!admission.admit("10.0.0.1", 0, now));
+  QCOMPARE(admission.getRefused(), uint64_t(1));
+}
+
+void AdmissionControlTests::admit_afterWaiting_refillsTokens()
+{
+  AdmissionControl admission(10, 1.0, 2.0);
+  const auto now = MonotonicClock::now();
+
+  QVERIFY(admission.admit("10.0.0.1", 0, now));
+  QVERIFY(!admission.admit("10.0.0.1", 0, now + std::chrono::milliseconds(100)));
+  QVERIFY(admission.admit("10.0.0.1", 0, now + std::chrono::milliseconds(700)));
+}
+
+void AdmissionControlTests::admit_otherSource_hasOwnBucket()
+{
+  AdmissionControl admission(10, 1.0, 1.0);
+  const auto now = MonotonicClock::now();
+
+  QVERIFY(admission.admit("10.0.0.1", 0, now));
+  QVERIFY(!admission.admit("10.0.0.1", 0, now));
+  QVERIFY(admission.admit("10.0.0.2", 0, now));
+}
+
+void AdmissionControlTests::admit_tooManyPending_refuses()
+{
+  AdmissionControl admission(2, 5.0, 1.0);
+  const auto now = MonotonicClock::now();
+
+  QVERIFY(admission.admit("10.0.0.1", 1, now));
+  QVERIFY(!admission.admit("10.0.0.2", 2, now));
+  QCOMPARE(admission.getRefused(), uint64_t(1));
+}
+
+QTEST_MAIN(AdmissionControlTests)
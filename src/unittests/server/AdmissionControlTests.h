@@ -0,0 +1,20 @@
+/*
+ * Deskflow -- mouse and keyboard sharing utility
+ * SPDX-FileCopyrightText: (C) 2026 Deskflow Developers
+ * SPDX-License-Identifier: GPL-2.0-only WITH LicenseRef-OpenSSL-Exception
+ */
+
+#pragma once
+
+#include <QObject>
+
+class AdmissionControlTests : public QObject
+{
+  Q_OBJECT
+
+private Q_SLOTS:
+  void admit_burstFromOneSource_refusesExcess();
+  void admit_afterWaiting_refillsTokens();
+  void admit_otherSource_hasOwnBucket();
+  void admit_tooManyPending_refuses();
+};